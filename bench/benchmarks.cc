@@ -0,0 +1,363 @@
+/** \file
+ * Definitions of the benchmarks run by ql_bench.
+ */
+
+#include "benchmarks.h"
+
+#include <memory>
+#include "ql/utils/json.h"
+#include "ql/utils/arena.h"
+#include "ql/com/topology.h"
+#include "ql/com/ddg/build.h"
+#include "ql/com/ddg/ops.h"
+#include "ql/ir/compat/platform.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/cqasm/read.h"
+#include "ql/ir/cqasm/write.h"
+#include "ql/ir/synthetic.h"
+#include "ql/pmgr/manager.h"
+#include "circuits.h"
+
+namespace ql {
+namespace bench {
+
+/**
+ * Generator for the cQASM code of an input circuit.
+ */
+using Generator = std::function<utils::Str()>;
+
+/**
+ * An input for a benchmark: a platform configuration file and a circuit. The
+ * IR is constructed on first use and then shared between all repetitions of
+ * (and all benchmarks using) the input, so its construction is never timed.
+ */
+class Input {
+private:
+
+    /**
+     * Full path to the platform configuration file.
+     */
+    utils::Str config;
+
+    /**
+     * Generator for the circuit.
+     */
+    Generator generate;
+
+    /**
+     * The cQASM code for the circuit, once generated.
+     */
+    utils::Str cqasm;
+
+    /**
+     * The IR, once constructed.
+     */
+    ir::Ref ir;
+
+public:
+
+    /**
+     * Constructs an input from a platform configuration file and circuit
+     * generator.
+     */
+    Input(utils::Str config, Generator generate) :
+        config(std::move(config)), generate(std::move(generate))
+    {}
+
+    /**
+     * Returns the cQASM code for the circuit.
+     */
+    const utils::Str &get_cqasm() {
+        if (cqasm.empty()) {
+            cqasm = generate();
+        }
+        return cqasm;
+    }
+
+    /**
+     * Returns the IR for the platform, without a program.
+     */
+    ir::Ref get_platform() {
+        auto platform = ir::compat::Platform::build("bench", config);
+        return ir::convert_old_to_new(platform);
+    }
+
+    /**
+     * Returns the IR for the platform and circuit. Must not be modified; use
+     * get_copy() for that.
+     */
+    const ir::Ref &get() {
+        if (ir.empty()) {
+            ir = get_platform();
+            ir::cqasm::read(ir, get_cqasm());
+        }
+        return ir;
+    }
+
+    /**
+     * Returns a copy of the IR that may be modified.
+     */
+    ir::Ref get_copy() {
+        return get().clone();
+    }
+
+};
+
+/**
+ * Shared reference to an input.
+ */
+using InputRef = std::shared_ptr<Input>;
+
+/**
+ * Returns a setup function that runs the given passes on a copy of the input
+ * without timing them, followed by timing the given pass.
+ */
+static Setup run_pass(
+    const InputRef &input,
+    const utils::Str &type,
+    const utils::Map<utils::Str, utils::Str> &options = {},
+    const utils::Vec<utils::Pair<utils::Str, utils::Map<utils::Str, utils::Str>>> &prepare = {}
+) {
+    return [=]() -> Body {
+        auto ir = input->get_copy();
+        if (!prepare.empty()) {
+            pmgr::Manager preparation;
+            for (const auto &pass : prepare) {
+                preparation.append_pass(pass.first, "", pass.second);
+            }
+            preparation.compile(ir);
+        }
+        auto manager = std::make_shared<pmgr::Manager>();
+        manager->append_pass(type, "", options);
+        manager->construct();
+        return [manager, ir]() {
+            manager->compile(ir);
+        };
+    };
+}
+
+/**
+ * Registers the com::Topology construction benchmarks.
+ */
+static void register_topology(Registry &registry, const utils::Str &res_dir) {
+    for (const utils::Str name : {"4x4", "64x16", "8x1024"}) {
+        auto file = res_dir + "/test_multi_core_" + name + "_full.json";
+        registry.add("topology/multi_core_" + name, [file]() -> Body {
+            auto json = std::make_shared<utils::Json>(utils::load_json(file));
+            utils::UInt num_qubits = (*json)["hardware_settings"]["qubit_number"];
+            return [json, num_qubits]() {
+                com::Topology topology(num_qubits, (*json)["topology"]);
+            };
+        });
+    }
+}
+
+/**
+ * Registers the data dependency graph construction benchmarks.
+ */
+static void register_ddg(Registry &registry, const utils::Str &res_dir) {
+    auto config = res_dir + "/test_multi_core_64x16_full.json";
+    for (utils::UInt num_gates : {10000, 100000}) {
+        auto input = std::make_shared<Input>(config, [num_gates]() {
+            return random_circuit(512, num_gates, 0.5, 1);
+        });
+        registry.add("ddg/build/random_512q_" + utils::to_string(num_gates), [input]() -> Body {
+            auto ir = input->get_copy();
+            return [ir]() {
+                auto block = ir->program->blocks[0].as<ir::BlockBase>();
+                com::ddg::build(ir->platform, block);
+                com::ddg::clear(block);
+            };
+        });
+    }
+    auto qft = std::make_shared<Input>(config, []() { return qft_circuit(128); });
+    registry.add("ddg/build/qft_128", [qft]() -> Body {
+        auto ir = qft->get_copy();
+        return [ir]() {
+            auto block = ir->program->blocks[0].as<ir::BlockBase>();
+            com::ddg::build(ir->platform, block);
+            com::ddg::clear(block);
+        };
+    });
+}
+
+/**
+ * Registers the list scheduler benchmarks, one for each heuristic.
+ */
+static void register_scheduler(Registry &registry, const utils::Str &res_dir) {
+    auto input = std::make_shared<Input>(res_dir + "/test_multi_core_4x4_full.json", []() {
+        return random_circuit(16, 10000, 0.3, 2);
+    });
+    for (const utils::Str heuristic : {"none", "critical_path", "deep_criticality", "uniform"}) {
+        for (const utils::Str target : {"asap", "alap"}) {
+            registry.add(
+                "sch/" + heuristic + "/" + target + "/random_16q_10000",
+                run_pass(input, "sch.ListSchedule", {
+                    {"scheduler_heuristic", heuristic},
+                    {"scheduler_target", target}
+                })
+            );
+        }
+    }
+
+    auto surface = std::make_shared<Input>(res_dir + "/test_multi_core_64x16_full.json", []() {
+        ir::synthetic::Parameters parameters;
+        parameters.family = ir::synthetic::Family::SURFACE_CODE;
+        parameters.distance = 11;
+        parameters.num_rounds = 10;
+        return ir::synthetic::generate_cqasm(parameters);
+    });
+    registry.add(
+        "sch/critical_path/asap/surface_code_d11_r10",
+        run_pass(surface, "sch.ListSchedule", {{"scheduler_heuristic", "critical_path"}})
+    );
+}
+
+/**
+ * Registers the mapper and initial placement benchmarks.
+ */
+static void register_mapper(Registry &registry, const utils::Str &res_dir) {
+    auto config = res_dir + "/test_multi_core_4x4_full.json";
+    utils::Vec<utils::Pair<utils::Str, InputRef>> inputs;
+    for (utils::UInt num_gates : {1000, 10000}) {
+        inputs.push_back({
+            "random_16q_" + utils::to_string(num_gates),
+            std::make_shared<Input>(config, [num_gates]() {
+                return random_circuit(16, num_gates, 0.3, 3);
+            })
+        });
+    }
+    inputs.push_back({"qft_8", std::make_shared<Input>(config, []() { return qft_circuit(8); })});
+    inputs.push_back({"qft_16", std::make_shared<Input>(config, []() { return qft_circuit(16); })});
+    inputs.push_back({"adder_3", std::make_shared<Input>(config, []() { return adder_circuit(3); })});
+    inputs.push_back({"adder_7", std::make_shared<Input>(config, []() { return adder_circuit(7); })});
+    for (const utils::Str heuristic : {"base", "minextend", "sabre"}) {
+        for (const auto &input : inputs) {
+            registry.add(
+                "map/" + heuristic + "/" + input.first,
+                run_pass(input.second, "map.qubits.Map", {{"route_heuristic", heuristic}})
+            );
+        }
+    }
+
+    auto large = std::make_shared<Input>(res_dir + "/test_multi_core_64x16_full.json", []() {
+        return random_circuit(512, 10000, 0.3, 4);
+    });
+    for (const utils::Str heuristic : {"base", "sabre"}) {
+        registry.add(
+            "map/" + heuristic + "/random_512q_10000",
+            run_pass(large, "map.qubits.Map", {{"route_heuristic", heuristic}})
+        );
+    }
+
+    auto place = std::make_shared<Input>(config, []() {
+        return random_circuit(16, 100, 0.5, 5);
+    });
+    registry.add("place_mip/random_16q_100", run_pass(place, "map.qubits.PlaceMIP"));
+}
+
+/**
+ * Registers the cQASM reader and writer benchmarks.
+ */
+static void register_cqasm(Registry &registry, const utils::Str &res_dir) {
+    auto config = res_dir + "/test_multi_core_4x4_full.json";
+    for (utils::UInt num_gates : {10000, 100000}) {
+        auto input = std::make_shared<Input>(config, [num_gates]() {
+            return random_circuit(16, num_gates, 0.3, 6);
+        });
+        auto suffix = "random_16q_" + utils::to_string(num_gates);
+        registry.add("cqasm/read/" + suffix, [input]() -> Body {
+            auto ir = input->get_platform();
+            const auto &cqasm = input->get_cqasm();
+            return [ir, &cqasm]() {
+                ir::cqasm::read(ir, cqasm);
+            };
+        });
+        registry.add("cqasm/write/" + suffix, [input]() -> Body {
+            auto ir = input->get();
+            return [ir]() {
+                utils::StrStrm ss;
+                ir::cqasm::write(ir, {}, ss);
+            };
+        });
+    }
+}
+
+/**
+ * Registers the benchmarks for building synthetic programs directly in the
+ * IR, as a baseline for reading the equivalent cQASM.
+ */
+static void register_synthetic(Registry &registry, const utils::Str &res_dir) {
+    auto config = res_dir + "/test_multi_core_64x16_full.json";
+    for (utils::UInt num_gates : {10000, 100000}) {
+        auto input = std::make_shared<Input>(config, Generator());
+        registry.add("synthetic/ir/random_512q_" + utils::to_string(num_gates), [input, num_gates]() -> Body {
+            auto ir = input->get_platform();
+            return [ir, num_gates]() {
+                ir::synthetic::Parameters parameters;
+                parameters.num_qubits = 512;
+                parameters.num_gates = num_gates;
+                parameters.seed = 7;
+                ir::synthetic::generate_ir(parameters, ir);
+            };
+        });
+    }
+}
+
+/**
+ * Registers the benchmarks comparing allocation of IR nodes from a memory
+ * arena to allocating them individually on the heap. Destruction of the nodes
+ * is timed as well.
+ */
+static void register_arena(Registry &registry) {
+    for (utils::Bool use_arena : {false, true}) {
+        utils::Str kind = use_arena ? "arena" : "heap";
+        for (utils::UInt num_nodes : {100000, 1000000}) {
+            registry.add("arena/make/" + kind + "/int_literal_" + utils::to_string(num_nodes), [use_arena, num_nodes]() -> Body {
+                return [use_arena, num_nodes]() {
+                    utils::ArenaScope scope(use_arena ? std::make_shared<utils::Arena>() : utils::ArenaRef());
+                    utils::Vec<utils::One<ir::IntLiteral>> nodes;
+                    nodes.reserve(num_nodes);
+                    for (utils::UInt i = 0; i < num_nodes; i++) {
+                        nodes.push_back(utils::make<ir::IntLiteral>((utils::Int)i));
+                    }
+                };
+            });
+        }
+    }
+}
+
+/**
+ * Registers the CC backend benchmarks. The program is scheduled as part of
+ * the untimed preparation, since the backend requires a scheduled program.
+ */
+static void register_cc(Registry &registry, const utils::Str &res_dir) {
+    for (utils::UInt num_rounds : {100, 1000}) {
+        auto input = std::make_shared<Input>(res_dir + "/test_cfg_cc.json", [num_rounds]() {
+            return cc_circuit(num_rounds);
+        });
+        registry.add(
+            "arch.cc.gen.VQ1Asm/rounds_" + utils::to_string(num_rounds),
+            run_pass(input, "arch.cc.gen.VQ1Asm", {}, {{"sch.ListSchedule", {}}})
+        );
+    }
+}
+
+/**
+ * Registers all benchmarks with the given registry. res_dir is the directory
+ * containing the platform configuration files, normally res/v1x/json in the
+ * source tree.
+ */
+void register_benchmarks(Registry &registry, const utils::Str &res_dir) {
+    register_topology(registry, res_dir);
+    register_ddg(registry, res_dir);
+    register_scheduler(registry, res_dir);
+    register_mapper(registry, res_dir);
+    register_cqasm(registry, res_dir);
+    register_synthetic(registry, res_dir);
+    register_arena(registry);
+    register_cc(registry, res_dir);
+}
+
+} // namespace bench
+} // namespace ql
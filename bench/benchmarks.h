@@ -0,0 +1,21 @@
+/** \file
+ * Definitions of the benchmarks run by ql_bench.
+ */
+
+#pragma once
+
+#include "ql/utils/str.h"
+#include "harness.h"
+
+namespace ql {
+namespace bench {
+
+/**
+ * Registers all benchmarks with the given registry. res_dir is the directory
+ * containing the platform configuration files, normally res/v1x/json in the
+ * source tree.
+ */
+void register_benchmarks(Registry &registry, const utils::Str &res_dir);
+
+} // namespace bench
+} // namespace ql
@@ -0,0 +1,144 @@
+/** \file
+ * Deterministic circuit generators for ql_bench, producing cQASM 1.0 code.
+ * The generic families are provided by ql::ir::synthetic; this adds the
+ * benchmark-specific ones.
+ */
+
+#include "circuits.h"
+
+#include "ql/ir/synthetic.h"
+
+namespace ql {
+namespace bench {
+
+/**
+ * Returns the cQASM header for a circuit with the given number of qubits.
+ */
+static void header(utils::StrStrm &ss, utils::UInt num_qubits) {
+    ss << "version 1.0\n";
+    ss << "qubits " << num_qubits << "\n\n";
+}
+
+/**
+ * Generates a random circuit of single-qubit gates and CNOTs on the given
+ * number of qubits. two_qubit_fraction is the probability for each gate to
+ * be a CNOT.
+ */
+utils::Str random_circuit(
+    utils::UInt num_qubits,
+    utils::UInt num_gates,
+    utils::Real two_qubit_fraction,
+    utils::UInt seed
+) {
+    ir::synthetic::Parameters parameters;
+    parameters.family = ir::synthetic::Family::RANDOM;
+    parameters.num_qubits = num_qubits;
+    parameters.num_gates = num_gates;
+    parameters.two_qubit_density = two_qubit_fraction;
+    parameters.seed = seed;
+    return ir::synthetic::generate_cqasm(parameters);
+}
+
+/**
+ * Generates a quantum Fourier transform on the given number of qubits, with
+ * the controlled phase rotations decomposed into CNOTs and Z rotations.
+ */
+utils::Str qft_circuit(utils::UInt num_qubits) {
+    ir::synthetic::Parameters parameters;
+    parameters.family = ir::synthetic::Family::QFT;
+    parameters.num_qubits = num_qubits;
+    return ir::synthetic::generate_cqasm(parameters);
+}
+
+/**
+ * Emits a Toffoli gate decomposed into CNOTs and single-qubit gates.
+ */
+static void toffoli(utils::StrStrm &ss, utils::UInt a, utils::UInt b, utils::UInt c) {
+    ss << "h q[" << c << "]\n";
+    ss << "cnot q[" << b << "], q[" << c << "]\n";
+    ss << "tdag q[" << c << "]\n";
+    ss << "cnot q[" << a << "], q[" << c << "]\n";
+    ss << "t q[" << c << "]\n";
+    ss << "cnot q[" << b << "], q[" << c << "]\n";
+    ss << "tdag q[" << c << "]\n";
+    ss << "cnot q[" << a << "], q[" << c << "]\n";
+    ss << "t q[" << b << "]\n";
+    ss << "t q[" << c << "]\n";
+    ss << "h q[" << c << "]\n";
+    ss << "cnot q[" << a << "], q[" << b << "]\n";
+    ss << "t q[" << a << "]\n";
+    ss << "tdag q[" << b << "]\n";
+    ss << "cnot q[" << a << "], q[" << b << "]\n";
+}
+
+/**
+ * Emits the majority-in-place block of the Cuccaro adder.
+ */
+static void maj(utils::StrStrm &ss, utils::UInt a, utils::UInt b, utils::UInt c) {
+    ss << "cnot q[" << c << "], q[" << b << "]\n";
+    ss << "cnot q[" << c << "], q[" << a << "]\n";
+    toffoli(ss, a, b, c);
+}
+
+/**
+ * Emits the unmajority-and-add block of the Cuccaro adder.
+ */
+static void uma(utils::StrStrm &ss, utils::UInt a, utils::UInt b, utils::UInt c) {
+    toffoli(ss, a, b, c);
+    ss << "cnot q[" << c << "], q[" << a << "]\n";
+    ss << "cnot q[" << a << "], q[" << b << "]\n";
+}
+
+/**
+ * Generates a ripple-carry adder (Cuccaro et al.) for two numbers of the
+ * given number of bits, using 2 * num_bits + 2 qubits. Toffoli gates are
+ * decomposed into CNOTs and single-qubit gates.
+ */
+utils::Str adder_circuit(utils::UInt num_bits) {
+
+    // Qubit 0 is the incoming carry, then a and b are interleaved, and the
+    // last qubit receives the outgoing carry.
+    auto a = [](utils::UInt i) { return 2 * i + 2; };
+    auto b = [](utils::UInt i) { return 2 * i + 1; };
+    utils::UInt carry_out = 2 * num_bits + 1;
+
+    utils::StrStrm ss;
+    header(ss, 2 * num_bits + 2);
+    for (utils::UInt i = 0; i < num_bits; i++) {
+        ss << "x q[" << a(i) << "]\n";
+    }
+    maj(ss, 0, b(0), a(0));
+    for (utils::UInt i = 1; i < num_bits; i++) {
+        maj(ss, a(i - 1), b(i), a(i));
+    }
+    ss << "cnot q[" << a(num_bits - 1) << "], q[" << carry_out << "]\n";
+    for (utils::UInt i = num_bits - 1; i > 0; i--) {
+        uma(ss, a(i - 1), b(i), a(i));
+    }
+    uma(ss, 0, b(0), a(0));
+    return ss.str();
+}
+
+/**
+ * Generates the given number of rounds of single-qubit gates, flux gates,
+ * and measurements for the qubits and couplings of test_cfg_cc.json.
+ */
+utils::Str cc_circuit(utils::UInt num_rounds) {
+    utils::StrStrm ss;
+    header(ss, 17);
+    for (utils::UInt round = 0; round < num_rounds; round++) {
+        for (utils::UInt q = 6; q < 17; q++) {
+            ss << (round % 2 ? "ry90" : "rx180") << " q[" << q << "]\n";
+        }
+        ss << "cz q[6], q[7]\n";
+        ss << "cz q[12], q[13]\n";
+        ss << "cz q[10], q[15]\n";
+        for (utils::UInt q = 6; q < 17; q++) {
+            ss << "measure q[" << q << "]\n";
+        }
+    }
+    return ss.str();
+}
+
+} // namespace bench
+} // namespace ql
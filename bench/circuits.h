@@ -0,0 +1,47 @@
+/** \file
+ * Deterministic circuit generators for ql_bench, producing cQASM 1.0 code.
+ * The generic families are provided by ql::ir::synthetic; this adds the
+ * benchmark-specific ones.
+ */
+
+#pragma once
+
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+
+namespace ql {
+namespace bench {
+
+/**
+ * Generates a random circuit of single-qubit gates and CNOTs on the given
+ * number of qubits. two_qubit_fraction is the probability for each gate to
+ * be a CNOT.
+ */
+utils::Str random_circuit(
+    utils::UInt num_qubits,
+    utils::UInt num_gates,
+    utils::Real two_qubit_fraction,
+    utils::UInt seed
+);
+
+/**
+ * Generates a quantum Fourier transform on the given number of qubits, with
+ * the controlled phase rotations decomposed into CNOTs and Z rotations.
+ */
+utils::Str qft_circuit(utils::UInt num_qubits);
+
+/**
+ * Generates a ripple-carry adder (Cuccaro et al.) for two numbers of the
+ * given number of bits, using 2 * num_bits + 2 qubits. Toffoli gates are
+ * decomposed into CNOTs and single-qubit gates.
+ */
+utils::Str adder_circuit(utils::UInt num_bits);
+
+/**
+ * Generates the given number of rounds of single-qubit gates, flux gates,
+ * and measurements for the qubits and couplings of test_cfg_cc.json.
+ */
+utils::Str cc_circuit(utils::UInt num_rounds);
+
+} // namespace bench
+} // namespace ql
@@ -0,0 +1,137 @@
+/** \file
+ * Minimal benchmark harness for ql_bench.
+ */
+
+#include "harness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <regex>
+#include "ql/version.h"
+
+namespace ql {
+namespace bench {
+
+/**
+ * Registers a benchmark.
+ */
+void Registry::add(const utils::Str &name, const Setup &setup) {
+    benchmarks.push_back({name, setup});
+}
+
+/**
+ * Writes the names of all registered benchmarks matching the filter to
+ * the given stream, one per line.
+ */
+void Registry::list(const RunOptions &options, std::ostream &os) const {
+    std::regex filter(options.filter);
+    for (const auto &benchmark : benchmarks) {
+        if (std::regex_search(benchmark.name, filter)) {
+            os << benchmark.name << "\n";
+        }
+    }
+}
+
+/**
+ * Runs a single repetition of the given benchmark, returning the time taken
+ * by the timed part in seconds.
+ */
+static utils::Real run_once(const Benchmark &benchmark) {
+    auto body = benchmark.setup();
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<utils::Real>(end - start).count();
+}
+
+/**
+ * Returns a description of the build, so results from different builds are
+ * not accidentally compared.
+ */
+static utils::Json get_context(const RunOptions &options) {
+    auto json = utils::Json::object();
+    json["openql_version"] = OPENQL_VERSION_STRING;
+#ifdef NDEBUG
+    json["build_type"] = "release";
+#else
+    json["build_type"] = "debug";
+#endif
+#if defined(__VERSION__)
+    json["compiler"] = __VERSION__;
+#elif defined(_MSC_FULL_VER)
+    json["compiler"] = "MSVC " + utils::to_string(_MSC_FULL_VER);
+#else
+    json["compiler"] = "unknown";
+#endif
+    json["repetitions"] = options.repetitions;
+    json["warmup"] = options.warmup;
+    return json;
+}
+
+/**
+ * Runs all registered benchmarks matching the filter, printing progress
+ * to the given stream, and returns the results as JSON. Benchmarks that
+ * throw an exception are reported as failed, but do not abort the run.
+ */
+utils::Json Registry::run(const RunOptions &options, std::ostream &progress) const {
+    std::regex filter(options.filter);
+    auto results = utils::Json::array();
+    for (const auto &benchmark : benchmarks) {
+        if (!std::regex_search(benchmark.name, filter)) {
+            continue;
+        }
+        progress << benchmark.name << "... " << std::flush;
+        auto result = utils::Json::object();
+        result["name"] = benchmark.name;
+        try {
+            for (utils::UInt i = 0; i < options.warmup; i++) {
+                run_once(benchmark);
+            }
+            utils::Vec<utils::Real> samples;
+            for (utils::UInt i = 0; i < options.repetitions; i++) {
+                samples.push_back(run_once(benchmark));
+            }
+            auto sorted = samples;
+            std::sort(sorted.begin(), sorted.end());
+            utils::Real sum = 0.0;
+            for (auto sample : samples) {
+                sum += sample;
+            }
+            auto mean = samples.empty() ? 0.0 : sum / samples.size();
+            utils::Real variance = 0.0;
+            for (auto sample : samples) {
+                variance += (sample - mean) * (sample - mean);
+            }
+            if (samples.size() > 1) {
+                variance /= samples.size() - 1;
+            }
+            auto median = sorted.empty() ? 0.0 : (
+                sorted.size() % 2 ? sorted[sorted.size() / 2]
+                : (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2
+            );
+            result["min_s"] = sorted.empty() ? 0.0 : sorted.front();
+            result["median_s"] = median;
+            result["mean_s"] = mean;
+            result["max_s"] = sorted.empty() ? 0.0 : sorted.back();
+            result["stddev_s"] = std::sqrt(variance);
+            auto samples_json = utils::Json::array();
+            for (auto sample : samples) {
+                samples_json.push_back(sample);
+            }
+            result["samples_s"] = std::move(samples_json);
+            progress << "median " << median << " s" << std::endl;
+        } catch (std::exception &e) {
+            result["error"] = e.what();
+            progress << "FAILED: " << e.what() << std::endl;
+        }
+        results.push_back(std::move(result));
+    }
+    auto json = utils::Json::object();
+    json["context"] = get_context(options);
+    json["benchmarks"] = std::move(results);
+    return json;
+}
+
+} // namespace bench
+} // namespace ql
@@ -0,0 +1,104 @@
+/** \file
+ * Minimal benchmark harness for ql_bench.
+ */
+
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/json.h"
+
+namespace ql {
+namespace bench {
+
+/**
+ * The timed part of a benchmark.
+ */
+using Body = std::function<void()>;
+
+/**
+ * Prepares the inputs for a single repetition of a benchmark, and returns the
+ * function that should be timed. The preparation itself is not timed, so it
+ * can be used to for instance clone the IR that the timed part modifies.
+ */
+using Setup = std::function<Body()>;
+
+/**
+ * A registered benchmark.
+ */
+struct Benchmark {
+
+    /**
+     * Hierarchical name of the benchmark, using / as separator, for instance
+     * `map/base/qft_16`.
+     */
+    utils::Str name;
+
+    /**
+     * Function that prepares a repetition and returns its timed part.
+     */
+    Setup setup;
+
+};
+
+/**
+ * Options for running the benchmarks.
+ */
+struct RunOptions {
+
+    /**
+     * Only benchmarks whose name matches this regular expression (searched,
+     * not fully matched) are run.
+     */
+    utils::Str filter = "";
+
+    /**
+     * Number of timed repetitions per benchmark.
+     */
+    utils::UInt repetitions = 5;
+
+    /**
+     * Number of untimed warmup repetitions per benchmark.
+     */
+    utils::UInt warmup = 1;
+
+};
+
+/**
+ * Collection of benchmarks.
+ */
+class Registry {
+private:
+
+    /**
+     * The registered benchmarks, in registration order.
+     */
+    utils::Vec<Benchmark> benchmarks;
+
+public:
+
+    /**
+     * Registers a benchmark.
+     */
+    void add(const utils::Str &name, const Setup &setup);
+
+    /**
+     * Writes the names of all registered benchmarks matching the filter to
+     * the given stream, one per line.
+     */
+    void list(const RunOptions &options, std::ostream &os) const;
+
+    /**
+     * Runs all registered benchmarks matching the filter, printing progress
+     * to the given stream, and returns the results as JSON. Benchmarks that
+     * throw an exception are reported as failed, but do not abort the run.
+     */
+    utils::Json run(const RunOptions &options, std::ostream &progress) const;
+
+};
+
+} // namespace bench
+} // namespace ql
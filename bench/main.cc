@@ -0,0 +1,99 @@
+/** \file
+ * Entry point for ql_bench, the benchmark suite for the compiler hot paths.
+ *
+ * Usage:
+ *
+ *     ql_bench [--filter <regex>] [--repetitions <n>] [--warmup <n>]
+ *              [--res-dir <dir>] [--output <file.json>] [--list]
+ *
+ * Results are written as JSON to the given output file, or to stdout if no
+ * output file is specified. Progress is printed to stderr.
+ */
+
+#include <iostream>
+#include <exception>
+#include "ql/utils/str.h"
+#include "ql/utils/exception.h"
+#include "ql/utils/filesystem.h"
+#include "harness.h"
+#include "benchmarks.h"
+
+using namespace ql;
+
+/**
+ * Prints usage information to the given stream.
+ */
+static void print_usage(std::ostream &os) {
+    os << "Usage: ql_bench [options]\n"
+       << "\n"
+       << "Options:\n"
+       << "  --filter <regex>     only run benchmarks whose name matches regex\n"
+       << "  --repetitions <n>    number of timed repetitions (default 5)\n"
+       << "  --warmup <n>         number of untimed warmup repetitions (default 1)\n"
+       << "  --res-dir <dir>      directory containing the platform configuration\n"
+       << "                       files (default res/v1x/json)\n"
+       << "  --output <file>      write the JSON results to file instead of stdout\n"
+       << "  --list               list the matching benchmarks and exit\n"
+       << "  --help               print this message and exit\n";
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        bench::RunOptions options;
+        utils::Str res_dir = "res/v1x/json";
+        utils::Str output;
+        utils::Bool list = false;
+
+        for (int i = 1; i < argc; i++) {
+            utils::Str arg = argv[i];
+            auto value = [&]() -> utils::Str {
+                if (i + 1 >= argc) {
+                    throw utils::Exception("missing value for " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--filter") {
+                options.filter = value();
+            } else if (arg == "--repetitions") {
+                options.repetitions = utils::parse_uint(value());
+            } else if (arg == "--warmup") {
+                options.warmup = utils::parse_uint(value());
+            } else if (arg == "--res-dir") {
+                res_dir = value();
+            } else if (arg == "--output") {
+                output = value();
+            } else if (arg == "--list") {
+                list = true;
+            } else if (arg == "--help" || arg == "-h") {
+                print_usage(std::cout);
+                return 0;
+            } else {
+                throw utils::Exception("unknown argument " + arg);
+            }
+        }
+        if (options.repetitions == 0) {
+            throw utils::Exception("at least one repetition is needed");
+        }
+
+        bench::Registry registry;
+        bench::register_benchmarks(registry, res_dir);
+
+        if (list) {
+            registry.list(options, std::cout);
+            return 0;
+        }
+
+        auto results = registry.run(options, std::cerr);
+        if (output.empty()) {
+            std::cout << results.dump(4) << std::endl;
+        } else {
+            utils::OutFile(output).write(results.dump(4));
+        }
+        return 0;
+
+    } catch (std::exception &e) {
+        std::cerr << "ql_bench: " << e.what() << std::endl;
+        print_usage(std::cerr);
+        return 1;
+    }
+}
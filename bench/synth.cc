@@ -0,0 +1,114 @@
+/** \file
+ * Entry point for ql_synth, which generates large synthetic cQASM programs for
+ * stress testing and benchmarking.
+ *
+ * Usage:
+ *
+ *     ql_synth <family> [--qubits <n>] [--gates <n>] [--density <f>]
+ *              [--layers <n>] [--degree <n>] [--distance <n>] [--rounds <n>]
+ *              [--depth <n>] [--iterations <n>] [--seed <n>]
+ *              [--output <file.cq>]
+ *
+ * The program is streamed to the output file, or to stdout if no output file
+ * is specified, so even very large programs are never held in memory.
+ */
+
+#include <iostream>
+#include <exception>
+#include "ql/utils/str.h"
+#include "ql/utils/exception.h"
+#include "ql/utils/filesystem.h"
+#include "ql/ir/synthetic.h"
+
+using namespace ql;
+
+/**
+ * Prints usage information to the given stream.
+ */
+static void print_usage(std::ostream &os) {
+    os << "Usage: ql_synth <family> [options]\n"
+       << "\n"
+       << "Families: random, qft, qaoa, surface_code, nested_loops\n"
+       << "\n"
+       << "Options:\n"
+       << "  --qubits <n>         number of qubits (default 16)\n"
+       << "  --gates <n>          number of gates for random, or per loop body\n"
+       << "                       for nested_loops (default 1000)\n"
+       << "  --density <f>        fraction of two-qubit gates for random and\n"
+       << "                       nested_loops (default 0.3)\n"
+       << "  --layers <n>         number of QAOA layers (default 1)\n"
+       << "  --degree <n>         average degree of the QAOA graph (default 3)\n"
+       << "  --distance <n>       surface code distance (default 3)\n"
+       << "  --rounds <n>         surface code rounds (default 1)\n"
+       << "  --depth <n>          loop nesting depth (default 2)\n"
+       << "  --iterations <n>     iterations per loop (default 10)\n"
+       << "  --seed <n>           random seed (default 0)\n"
+       << "  --output <file>      write to file instead of stdout\n"
+       << "  --help               print this message and exit\n";
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        ir::synthetic::Parameters parameters;
+        utils::Str output;
+        utils::Bool have_family = false;
+
+        for (int i = 1; i < argc; i++) {
+            utils::Str arg = argv[i];
+            auto value = [&]() -> utils::Str {
+                if (i + 1 >= argc) {
+                    throw utils::Exception("missing value for " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--qubits") {
+                parameters.num_qubits = utils::parse_uint(value());
+            } else if (arg == "--gates") {
+                parameters.num_gates = utils::parse_uint(value());
+            } else if (arg == "--density") {
+                parameters.two_qubit_density = utils::parse_real(value());
+            } else if (arg == "--layers") {
+                parameters.num_layers = utils::parse_uint(value());
+            } else if (arg == "--degree") {
+                parameters.degree = utils::parse_uint(value());
+            } else if (arg == "--distance") {
+                parameters.distance = utils::parse_uint(value());
+            } else if (arg == "--rounds") {
+                parameters.num_rounds = utils::parse_uint(value());
+            } else if (arg == "--depth") {
+                parameters.loop_depth = utils::parse_uint(value());
+            } else if (arg == "--iterations") {
+                parameters.loop_iterations = utils::parse_uint(value());
+            } else if (arg == "--seed") {
+                parameters.seed = utils::parse_uint(value());
+            } else if (arg == "--output") {
+                output = value();
+            } else if (arg == "--help" || arg == "-h") {
+                print_usage(std::cout);
+                return 0;
+            } else if (!have_family && !utils::starts_with(arg, "-")) {
+                parameters.family = ir::synthetic::parse_family(arg);
+                have_family = true;
+            } else {
+                throw utils::Exception("unknown argument " + arg);
+            }
+        }
+        if (!have_family) {
+            throw utils::Exception("no program family specified");
+        }
+
+        if (output.empty()) {
+            ir::synthetic::generate_cqasm(parameters, std::cout);
+        } else {
+            utils::OutFile file(output);
+            ir::synthetic::generate_cqasm(parameters, file.unwrap());
+            file.close();
+        }
+        return 0;
+
+    } catch (std::exception &e) {
+        std::cerr << "ql_synth: " << e.what() << std::endl;
+        print_usage(std::cerr);
+        return 1;
+    }
+}
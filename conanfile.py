@@ -13,6 +13,7 @@ class OpenQLConan(ConanFile):
         "shared": [True, False],
         "build_python": [True, False],
         "build_tests": [True, False],
+        "build_benchmarks": [True, False],
         "debug_symbols": [True, False],
         "disable_unitary": [True, False],
         "python_dir": [None, "ANY"],
@@ -22,13 +23,14 @@ class OpenQLConan(ConanFile):
         "shared": False,
         "build_python": False,
         "build_tests": False,
+        "build_benchmarks": False,
         "debug_symbols": False,
         "disable_unitary": True,
         "python_dir": None,
         "python_ext": None
     }
 
-    exports_sources = "CMakeLists.txt", "include/*", "python/*", "res/*", "src/*", "test/*"
+    exports_sources = "CMakeLists.txt", "include/*", "python/*", "res/*", "src/*", "test/*", "bench/*"
 
     def build_requirements(self):
         self.requires("backward-cpp/1.6")
@@ -73,6 +75,7 @@ class OpenQLConan(ConanFile):
         tc = CMakeToolchain(self)
         tc.variables["OPENQL_BUILD_PYTHON"] = self.options.build_python
         tc.variables["OPENQL_BUILD_TESTS"] = self.options.build_tests
+        tc.variables["OPENQL_BUILD_BENCHMARKS"] = self.options.build_benchmarks
         tc.variables["OPENQL_DEBUG_SYMBOLS"] = self.options.debug_symbols
         tc.variables["OPENQL_PYTHON_DIR"] = self.options.python_dir
         tc.variables["OPENQL_PYTHON_EXT"] = self.options.python_ext
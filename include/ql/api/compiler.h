@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <functional>
 #include "ql/config.h"
 #include "ql/pmgr/manager.h"
 #include "ql/api/declarations.h"
@@ -37,6 +38,14 @@ private:
      */
     explicit Compiler(const ql::pmgr::Ref &pass_manager);
 
+    /**
+     * Runs the given compilation function. If the `output_to_memory` global
+     * option is set, the files written in the process are collected in memory
+     * and returned; otherwise they are written to disk, and the result is
+     * empty.
+     */
+    static OutputFiles run_with_output_sink(const std::function<void()> &compile);
+
 public:
 
     /**
@@ -352,17 +361,19 @@ public:
     /**
      * Ensures that all passes have been constructed, and then runs the passes
      * on the given program. This is the same as Program.compile() when the
-     * program is referencing the same compiler.
+     * program is referencing the same compiler. If the `output_to_memory`
+     * global option is set, the output files are returned instead of written.
      */
-    void compile(const Program &program);
+    OutputFiles compile(const Program &program);
 
     /**
      * Ensures that all passes have been constructed, and then runs the passes
      * without specification of an input program. The first pass should then act
      * as a language frontend. The cQASM reader satisfies this requirement, for
-     * instance.
+     * instance. If the `output_to_memory` global option is set, the output
+     * files are returned instead of written.
      */
-    void compile_with_frontend(const Platform &platform);
+    OutputFiles compile_with_frontend(const Platform &platform);
 
 };
 
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+
 namespace ql {
 namespace api {
 
@@ -15,8 +18,15 @@ class CReg;
 class Operation;
 class Unitary;
 class Program;
+class Schedule;
 class Kernel;
 class cQasmReader;
 
+/**
+ * Files produced by a compilation when the `output_to_memory` global option
+ * is set, mapping file names to contents.
+ */
+using OutputFiles = std::map<std::string, std::string>;
+
 } // namespace api
 } // namespace ql
@@ -214,6 +214,32 @@ public:
         const std::vector<size_t> &condregs
     );
 
+    /**
+     * Appends a sequence of quantum gates specified as parallel arrays, in a
+     * single call. This is equivalent to calling gate() for each element, but
+     * avoids the per-gate overhead of crossing the language boundary when
+     * large programs are constructed from Python.
+     *
+     * names is a table of gate names, and gate_ids specifies the gates to
+     * append as indices into that table. qubit_operands is a row-major matrix
+     * with one row per gate; its width is derived from its size. Rows of gates
+     * with fewer qubit operands than the matrix is wide must be padded at the
+     * end with SIZE_MAX (-1 from Python).
+     *
+     * durations and angles must either be empty or specify one value per
+     * gate. The same goes for condition_bits; for each gate, it specifies
+     * the bit register that the gate is conditional on (COND_UNARY), or
+     * SIZE_MAX (-1 from Python) for unconditional gates.
+     */
+    void gates(
+        const std::vector<std::string> &names,
+        const std::vector<size_t> &gate_ids,
+        const std::vector<size_t> &qubit_operands,
+        const std::vector<size_t> &durations = {},
+        const std::vector<double> &angles = {},
+        const std::vector<size_t> &condition_bits = {}
+    );
+
     /**
      * Appends a classical assignment gate to the circuit. The classical integer
      * register is assigned to the result of the given operation.
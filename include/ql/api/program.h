@@ -8,6 +8,7 @@
 #include "ql/pmgr/manager.h"
 #include "ql/api/declarations.h"
 #include "ql/api/platform.h"
+#include "ql/api/schedule.h"
 #include "ql/api/program.h"
 
 //============================================================================//
@@ -40,6 +41,14 @@ private:
      */
     ql::pmgr::Ref pass_manager;
 
+    /**
+     * The IR resulting from the most recent call to compile() or
+     * Compiler::compile(), used by get_schedule(). Empty if the program has
+     * not been compiled yet. Mutable because Compiler::compile() takes the
+     * program by const reference.
+     */
+    mutable ql::ir::Ref compiled;
+
 public:
 
     /**
@@ -170,9 +179,10 @@ public:
     void set_compiler(const Compiler &compiler);
 
     /**
-     * Compiles the program.
+     * Compiles the program. If the `output_to_memory` global option is set,
+     * the output files are returned instead of written.
      */
-    void compile();
+    OutputFiles compile();
 
     /**
      * Prints the interaction matrix for each kernel in the program.
@@ -186,6 +196,21 @@ public:
      */
     void write_interaction_matrix() const;
 
+    /**
+     * Returns the names of the blocks of the program as compiled by the most
+     * recent call to compile() or Compiler::compile(), for use with
+     * get_schedule().
+     */
+    std::vector<std::string> get_schedule_names() const;
+
+    /**
+     * Returns the scheduled instructions of the block with the given name of
+     * the program as compiled by the most recent call to compile() or
+     * Compiler::compile(), in columnar form. Structured control-flow
+     * statements within the block are not included.
+     */
+    Schedule get_schedule(const std::string &name) const;
+
 };
 
 } // namespace api
@@ -0,0 +1,114 @@
+/** \file
+ * API header for inspecting the schedule of a compiled program.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "ql/ir/columnar.h"
+#include "ql/api/declarations.h"
+
+//============================================================================//
+//                               W A R N I N G                                //
+//----------------------------------------------------------------------------//
+//         Docstrings in this file must manually be kept in sync with         //
+//     schedule.i! This should be automated at some point, but isn't yet.     //
+//============================================================================//
+
+namespace ql {
+namespace api {
+
+/**
+ * The instructions of a block of a compiled program in columnar form. All
+ * columns are stored in a single contiguous buffer of 64-bit signed
+ * integers, one column after the other. The available columns are:
+ *
+ *  - "instruction": index into instruction_names.
+ *  - "cycle": start cycle of the instruction.
+ *  - "duration": duration of the instruction in cycles.
+ *  - "qubits": qubit operands, num_qubit_operands per instruction, padded
+ *    with -1.
+ *  - "bits": bit operands, num_bit_operands per instruction, padded with -1.
+ *    The implicit bit of qubit i is bit i; explicit bit register i is bit
+ *    qubit_count + i.
+ *  - "condition": the condition type, using the ordering of the condition
+ *    strings accepted by Kernel.gate() (0 = always, 1 = never, 2 = unary,
+ *    3 = not, 4 = and, 5 = nand, 6 = or, 7 = nor, 8 = xor, 9 = nxor), or -1
+ *    if the condition cannot be represented that way.
+ *  - "condition_bits": the bit operands of the condition, two per
+ *    instruction, padded with -1.
+ */
+class Schedule {
+private:
+    friend class Program;
+
+    /**
+     * The wrapped columnar block.
+     */
+    ql::utils::Ptr<ql::ir::ColumnarBlock> schedule;
+
+    /**
+     * Wraps the given columnar block.
+     */
+    explicit Schedule(const ql::utils::Ptr<ql::ir::ColumnarBlock> &schedule);
+
+public:
+
+    /**
+     * The name of the block.
+     */
+    const std::string name;
+
+    /**
+     * The number of instructions in the block.
+     */
+    const size_t num_instructions;
+
+    /**
+     * The maximum number of qubit operands of any instruction, i.e. the
+     * width of the "qubits" column.
+     */
+    const size_t num_qubit_operands;
+
+    /**
+     * The maximum number of bit operands of any instruction, i.e. the width
+     * of the "bits" column.
+     */
+    const size_t num_bit_operands;
+
+    /**
+     * The table of instruction names indexed by the "instruction" column.
+     */
+    const std::vector<std::string> instruction_names;
+
+    /**
+     * The names of the columns, in the order in which they are stored in the
+     * buffer.
+     */
+    const std::vector<std::string> column_names;
+
+    /**
+     * Returns the number of values per instruction for the given column.
+     */
+    size_t get_column_width(const std::string &column) const;
+
+    /**
+     * Returns the offset of the given column in the buffer, in elements.
+     */
+    size_t get_column_offset(const std::string &column) const;
+
+    /**
+     * Returns the total number of elements in the buffer.
+     */
+    size_t get_size() const;
+
+    /**
+     * Returns a pointer to the buffer. It remains valid for as long as any
+     * copy of this object exists.
+     */
+    const int64_t *get_data() const;
+
+};
+
+} // namespace api
+} // namespace ql
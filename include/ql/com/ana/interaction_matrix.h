@@ -4,10 +4,13 @@
 
 #pragma once
 
+#include <functional>
+#include <unordered_map>
 #include "ql/utils/num.h"
 #include "ql/utils/str.h"
 #include "ql/utils/vec.h"
 #include "ql/ir/compat/compat.h"
+#include "ql/ir/ir.h"
 
 namespace ql {
 namespace com {
@@ -72,6 +75,147 @@ public:
 
 };
 
+/**
+ * Sparse qubit interaction matrix for the new IR. Counts the instructions that
+ * operate on exactly two qubits, regardless of their name, grouped by their
+ * qubit operands in operand order. Only the nonzero entries are stored, so
+ * memory usage does not depend on the number of qubits in the platform.
+ */
+class SparseInteractionMatrix {
+public:
+
+    /**
+     * A nonzero entry of the matrix.
+     */
+    struct Entry {
+
+        /**
+         * The first qubit operand.
+         */
+        utils::UInt first;
+
+        /**
+         * The second qubit operand.
+         */
+        utils::UInt second;
+
+        /**
+         * The number of two-qubit instructions with these operands.
+         */
+        utils::UInt count;
+
+    };
+
+private:
+
+    /**
+     * The number of qubits, i.e. the size of the matrix.
+     */
+    utils::UInt num_qubits;
+
+    /**
+     * The nonzero counts, keyed by first * num_qubits + second.
+     */
+    std::unordered_map<utils::UInt, utils::UInt> counts;
+
+    /**
+     * Adds the two-qubit instructions in the given block and its sub-blocks
+     * to the matrix.
+     */
+    void add_block(const ir::Ref &ir, const ir::BlockBaseRef &block);
+
+public:
+
+    /**
+     * Callback function prototype for for_each_interaction().
+     */
+    using InteractionCallback = std::function<void(utils::UInt first, utils::UInt second)>;
+
+    /**
+     * Calls the given callback for each instruction in the given block and its
+     * structured control-flow sub-blocks that operates on exactly two
+     * different qubits, in program order. These are the instructions counted
+     * by the interaction matrix. Qubit operands that were turned into template
+     * operands by instruction specialization are taken into account as well.
+     */
+    static void for_each_interaction(
+        const ir::Ref &ir,
+        const ir::BlockBaseRef &block,
+        const InteractionCallback &callback
+    );
+
+    /**
+     * Constructs an empty interaction matrix for the given number of qubits.
+     */
+    explicit SparseInteractionMatrix(utils::UInt num_qubits = 0);
+
+    /**
+     * Computes the interaction matrix for the given block, including its
+     * structured control-flow sub-blocks.
+     */
+    static SparseInteractionMatrix from_block(
+        const ir::Ref &ir,
+        const ir::BlockBaseRef &block
+    );
+
+    /**
+     * Computes the interaction matrix for all blocks of the program. The
+     * top-level blocks are processed in parallel using up to the given number
+     * of threads.
+     */
+    static SparseInteractionMatrix from_program(
+        const ir::Ref &ir,
+        utils::UInt num_threads = 1
+    );
+
+    /**
+     * Adds the given count to the entry for the given pair of qubits.
+     */
+    void add(utils::UInt first, utils::UInt second, utils::UInt count = 1);
+
+    /**
+     * Adds all entries of the given matrix to this matrix. The matrices must
+     * have the same size.
+     */
+    void merge(const SparseInteractionMatrix &other);
+
+    /**
+     * Returns the number of qubits, i.e. the size of the matrix.
+     */
+    utils::UInt get_num_qubits() const;
+
+    /**
+     * Returns the number of two-qubit instructions with the given operands, in
+     * the given order.
+     */
+    utils::UInt get_directed(utils::UInt first, utils::UInt second) const;
+
+    /**
+     * Returns the number of two-qubit instructions between the given qubits,
+     * regardless of operand order. This corresponds to the entries of the
+     * symmetric matrix computed by InteractionMatrix.
+     */
+    utils::UInt get(utils::UInt a, utils::UInt b) const;
+
+    /**
+     * Returns the number of nonzero (directed) entries.
+     */
+    utils::UInt get_num_nonzero() const;
+
+    /**
+     * Returns the nonzero (directed) entries, sorted by first and then second
+     * qubit, i.e. in compressed-sparse-row order.
+     */
+    utils::Vec<Entry> get_entries() const;
+
+    /**
+     * Returns the nonzero entries of the matrix as a string, one
+     * `<first> <second> <count>` line per entry.
+     */
+    utils::Str get_string() const;
+
+};
+
 } // namespace ana
 } // namespace com
 } // namespace ql
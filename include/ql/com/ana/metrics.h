@@ -8,6 +8,7 @@
 #pragma once
 
 #include "ql/utils/num.h"
+#include "ql/utils/vec.h"
 #include "ql/utils/map.h"
 #include "ql/utils/exception.h"
 #include "ql/ir/ir.h"
@@ -266,6 +267,83 @@ public:
     ) override;
 };
 
+/**
+ * The basic statistics of a block or program, as computed by StatisticsMetric.
+ * The per-qubit counters are indexed by qubit index, and are only as long as
+ * needed to hold the highest qubit index that was encountered.
+ */
+struct Statistics {
+
+    /**
+     * The duration in cycles of the last top-level block processed, like
+     * Latency.
+     */
+    utils::UInt latency = 0;
+
+    /**
+     * The number of quantum gates, like QuantumGateCount.
+     */
+    utils::UInt quantum_gate_count = 0;
+
+    /**
+     * The number of multi-qubit gates, like MultiQubitGateCount.
+     */
+    utils::UInt multi_qubit_gate_count = 0;
+
+    /**
+     * The number of classical operations, like ClassicalOperationCount.
+     */
+    utils::UInt classical_operation_count = 0;
+
+    /**
+     * The number of times each qubit is used, like QubitUsageCount.
+     */
+    utils::Vec<utils::UInt> qubit_usage_count;
+
+    /**
+     * The number of cycles each qubit is used for, like QubitUsedCycleCount.
+     */
+    utils::Vec<utils::UInt> qubit_used_cycle_count;
+
+    /**
+     * Returns the number of qubits that are used at least once.
+     */
+    utils::UInt get_num_qubits_used() const;
+
+    /**
+     * Accumulates the statistics of a subsequent block or program into these
+     * statistics. The result is the same as when both had been processed by
+     * the same StatisticsMetric; in particular, the latency is replaced.
+     */
+    void merge(const Statistics &other);
+
+};
+
+/**
+ * A metric that computes all the metrics in Statistics in a single traversal
+ * of the IR. Use this instead of computing the individual metrics when more
+ * than one of them is needed.
+ */
+class StatisticsMetric : public SimpleClassMetric<Statistics> {
+private:
+
+    /**
+     * Current block nesting depth, used to compute the latency only for
+     * top-level blocks.
+     */
+    utils::UInt depth = 0;
+
+public:
+    void process_instruction(
+        const ir::Ref &ir,
+        const ir::InstructionRef &instruction
+    ) override;
+    void process_block(
+        const ir::Ref &ir,
+        const ir::BlockBaseRef &block
+    ) override;
+};
+
 } // namespace ana
 } // namespace com
 } // namespace ql
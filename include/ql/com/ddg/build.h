@@ -122,6 +122,19 @@ void build(
     utils::Bool commute_single_qubit = true
 );
 
+/**
+ * Same as build(), but if the block already has a data dependency graph
+ * attached to it that was built with the same commutation flags and is still
+ * valid according to is_valid(), that graph is reused instead. Returns whether
+ * the graph was (re)built.
+ */
+utils::Bool build_or_reuse(
+    const ir::PlatformRef &platform,
+    const ir::BlockBaseRef &block,
+    utils::Bool commute_multi_qubit = true,
+    utils::Bool commute_single_qubit = true
+);
+
 } // namespace ddg
 } // namespace com
 } // namespace ql
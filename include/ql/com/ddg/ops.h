@@ -47,6 +47,20 @@ EdgeCRef get_edge(const ir::StatementRef &from, const ir::StatementRef &to);
  */
 utils::Int get_direction(const ir::BlockBaseRef &block);
 
+/**
+ * Returns whether the given block has a data dependency graph attached to it
+ * that is still usable, i.e. one that was built with the given commutation
+ * flags, has not been reversed, and still covers exactly the statements of the
+ * block in their original order. Note that this cannot detect in-place
+ * modifications of the statements themselves; passes that do that must clear
+ * the graph.
+ */
+utils::Bool is_valid(
+    const ir::BlockBaseRef &block,
+    utils::Bool commute_multi_qubit = true,
+    utils::Bool commute_single_qubit = true
+);
+
 /**
  * Removes the data dependency graph annotations from the given block.
  */
@@ -68,6 +82,16 @@ void clear(const ir::BlockBaseRef &block);
  */
 void reverse(const ir::BlockBaseRef &block);
 
+/**
+ * Updates the instruction order of the nodes of the (forward) data dependency
+ * graph associated with the given block to match the current order of the
+ * statements in the block. This must be called after a pass reorders the
+ * statements in a way that respects the dependencies, such as a scheduler, to
+ * keep the graph valid for reuse by subsequent passes. The resulting orders
+ * are the same as those a rebuild of the graph would produce.
+ */
+void renumber(const ir::BlockBaseRef &block);
+
 /**
  * Add the Remaining annotation to nodes in the graph.
  * Remaining gives the remaining length of the critical path.
@@ -421,6 +421,18 @@ struct Graph {
      */
     utils::Int direction;
 
+    /**
+     * Whether commutation rules for multi-qubit gates were considered when
+     * building the graph.
+     */
+    utils::Bool commute_multi_qubit = true;
+
+    /**
+     * Whether commutation rules for single-qubit gates were considered when
+     * building the graph.
+     */
+    utils::Bool commute_single_qubit = true;
+
 };
 
 struct Remaining {
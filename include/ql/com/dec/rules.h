@@ -15,6 +15,14 @@ namespace dec {
  */
 using RulePredicate = std::function<utils::Bool(const ir::DecompositionRef&)>;
 
+/**
+ * Compiles the decomposition rules of all instruction types in the given
+ * platform to a form that can be applied more quickly. This must be called
+ * again when rules are added or changed; stale compiled rules are detected
+ * and ignored, but then the slower generic method is used to apply them.
+ */
+void compile_decomposition_rules(const ir::PlatformRef &platform);
+
 /**
  * Recursively applies all available decomposition rules (that match the
  * predicate, if given) to the given block. Sub-blocks are not considered; in
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include "ql/utils/num.h"
 #include "ql/utils/str.h"
@@ -20,9 +21,10 @@ namespace map {
 const utils::UInt UNDEFINED_QUBIT = utils::MAX;
 
 /**
- * The state of a real qubit.
+ * The state of a real qubit. Stored as a single byte, such that the state
+ * vector of a mapping stays compact.
  */
-enum struct QubitState {
+enum struct QubitState : std::uint8_t {
 
     /**
      * Qubit has no relevant state needing preservation, i.e. is garbage.
@@ -49,6 +51,11 @@ std::ostream &operator<<(std::ostream &os, QubitState qs);
 /**
  * Virtual to real qubit mapping. Maintains the mapping (in both directions), as
  * well as information about whether the state of a real qubit is in use or not.
+ *
+ * All state is kept in flat arrays indexed by qubit, such that lookups in
+ * either direction, swap(), and allocate() are all O(1), and copying a mapping
+ * (for instance to speculate in the router) boils down to copying three
+ * contiguous arrays.
  */
 class QubitMapping {
 private:
@@ -63,11 +70,39 @@ private:
      */
     utils::Vec<utils::UInt> virt_to_real;
 
+    /**
+     * Maps real qubit indices to virtual qubit indices or UNDEFINED_QUBIT.
+     * This is the inverse of virt_to_real.
+     */
+    utils::Vec<utils::UInt> real_to_virt;
+
     /**
      * Maps real qubit indices to their state.
      */
     utils::Vec<QubitState> real_state;
 
+    /**
+     * The real qubits that have no virtual qubit mapped to them, in no
+     * particular order.
+     */
+    utils::Vec<utils::UInt> free_reals;
+
+    /**
+     * Maps real qubit indices to their index in free_reals, or UNDEFINED_QUBIT
+     * if a virtual qubit is mapped to them.
+     */
+    utils::Vec<utils::UInt> free_index;
+
+    /**
+     * Marks the given real qubit as free, i.e. adds it to free_reals.
+     */
+    void mark_free(utils::UInt real);
+
+    /**
+     * Marks the given real qubit as used, i.e. removes it from free_reals.
+     */
+    void mark_used(utils::UInt real);
+
 public:
 
     /**
@@ -96,11 +131,6 @@ public:
         QubitState initial_state = QubitState::NONE
     );
 
-    /**
-     * Map virtual qubit index to real qubit index.
-     */
-    utils::UInt &operator[](utils::UInt v);
-
     /**
      * Map virtual qubit index to real qubit index.
      */
@@ -113,11 +143,15 @@ public:
 
     /**
      * Map real qubit to the virtual qubit index that is mapped to it (i.e.
-     * backward map). When none, return UNDEFINED_QUBIT. This currently loops
-     * over all qubits, so it isn't particularly fast.
+     * backward map). When none, return UNDEFINED_QUBIT.
      */
     utils::UInt get_virtual(utils::UInt real) const;
 
+    /**
+     * Returns the underlying real to virtual qubit vector.
+     */
+    const utils::Vec<utils::UInt> &get_real_to_virt() const;
+
     /**
      * Returns the current state for the given real qubit.
      */
@@ -134,7 +168,8 @@ public:
     const utils::Vec<QubitState> &get_state() const;
 
     /**
-     * Allocate a real qubit for the given unmapped virtual qubit.
+     * Allocate a real qubit for the given unmapped virtual qubit. Any real
+     * qubit that has no virtual qubit mapped to it may be chosen.
      */
     utils::UInt allocate(utils::UInt virt);
 
@@ -145,6 +180,13 @@ public:
      */
     void swap(utils::UInt r0, utils::UInt r1);
 
+    /**
+     * Overwrites this mapping with the given snapshot of a mapping of the
+     * same size. Unlike assignment, this never reallocates; it only copies
+     * the contents of the arrays.
+     */
+    void restore(const QubitMapping &snapshot);
+
     /**
      * Returns a string representation of the state of the given real qubit.
      */
@@ -329,6 +329,21 @@ public:
         return result;
     }
 
+    /**
+     * Returns the most critical statement that is currently available, or an
+     * empty reference if no statement is available in the current cycle. This
+     * is equivalent to the front of get_available(), but only walks the
+     * availability list up to the first statement that the resources allow.
+     */
+    ir::StatementRef get_most_critical() const {
+        for (const auto &statement : available) {
+            if (resource_state->available(cycle, statement)) {
+                return statement;
+            }
+        }
+        return {};
+    }
+
     /**
      * Tries to schedule either the given statement or (if no statement is
      * specified) the most critical available statement in the current cycle.
@@ -0,0 +1,53 @@
+/** \file
+ * Defines a uniform (bundle-size balancing) list scheduler.
+ */
+
+#pragma once
+
+#include "ql/utils/num.h"
+#include "ql/ir/ir.h"
+#include "ql/rmgr/manager.h"
+
+namespace ql {
+namespace com {
+namespace sch {
+
+/**
+ * Schedules the given block such that the number of statements per cycle is
+ * as uniform as possible, without making the schedule longer than the critical
+ * path requires. This is a replacement for the balanced scheduling algorithm
+ * of the legacy scheduler, built on top of Scheduler.
+ *
+ * The latest cycle in which each statement can start without extending the
+ * schedule (its deadline) follows from the critical path length, so the usage
+ * pattern is the same as for CriticalPathHeuristic:
+ *
+ *  - construct a data dependency graph for the block in question, in the
+ *    desired scheduling direction;
+ *  - pre-schedule in the reverse direction using Scheduler<>, with cycle
+ *    numbers still referenced such that the source node is at cycle 0; and
+ *  - call schedule_uniform().
+ *
+ * The statements are then list-scheduled in order of increasing slack. In each
+ * cycle, statements that reached their deadline are always scheduled, while
+ * other statements are only scheduled as long as the bundle is smaller than
+ * the number of statements still to be scheduled divided by the number of
+ * distinct deadlines still ahead, i.e. the number of non-empty bundles still
+ * to come. The available statements are kept ordered by deadline and the
+ * remaining statements are bucketed by deadline, so scheduling takes
+ * O(n log n) time for n statements when there are no resource constraints.
+ *
+ * Like Scheduler::run(), max_resource_block_cycles is used for resource
+ * deadlock detection, and may be set to 0 to disable the check. Unlike
+ * Scheduler::run(), the cycle numbers are converted using
+ * Scheduler::convert_cycles() afterwards.
+ */
+void schedule_uniform(
+    const ir::BlockBaseRef &block,
+    const rmgr::CRef &resources = {},
+    utils::UInt max_resource_block_cycles = 0
+);
+
+} // namespace sch
+} // namespace com
+} // namespace ql
@@ -279,6 +279,11 @@ public:
      */
     utils::UInt get_core_index(Qubit qubit) const;
 
+    /**
+     * Returns the number of communication qubits per core.
+     */
+    utils::UInt get_num_comm_qubits() const;
+
     /**
      * Returns whether communication between the given two qubits involves
      * inter-core communication.
@@ -330,6 +335,25 @@ public:
      */
     utils::UInt get_min_hops(Qubit source, Qubit target) const;
 
+    /**
+     * Returns the neighbors n of src from which tgt can be reached in fewer
+     * than budget hops, i.e. get_distance(n, tgt) < budget, in the same order
+     * as get_neighbors(src). These are the candidates for the next hop of a
+     * path from src to tgt of at most budget hops.
+     *
+     * For multi-core topologies, this uses the two-level structure of the
+     * topology rather than scanning all qubits: within a core all qubits are
+     * connected, and cores are connected via their communication qubits. The
+     * distance from a qubit to tgt then only depends on its core and on
+     * whether it is a communication qubit, so these classes of qubits are
+     * accepted or rejected as a whole, and the cost scales with the size of a
+     * core rather than with the total number of qubits. Detours via cores
+     * other than those of src and tgt are not returned: these consist of at
+     * least two inter-core hops, so within get_min_hops(src, tgt) hops they
+     * never leave an intra-core hop to host the two-qubit gate.
+     */
+    Neighbors get_path_neighbors(Qubit src, Qubit tgt, utils::UInt budget) const;
+
     /**
      * Returns whether qubits have coordinates associated with them.
      */
@@ -0,0 +1,156 @@
+/** \file
+ * Columnar export of the instructions of a (scheduled) block, for consumption
+ * by external analysis tools without going through cQASM.
+ */
+
+#pragma once
+
+#include <ostream>
+#include <vector>
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/vec.h"
+#include "ql/ir/ir.h"
+
+namespace ql {
+namespace ir {
+
+/**
+ * The columns of a ColumnarBlock, in the order in which they are stored in
+ * its buffer.
+ */
+enum class Column {
+
+    /**
+     * Index of the instruction type in ColumnarBlock::instruction_names.
+     */
+    INSTRUCTION,
+
+    /**
+     * Start cycle of the instruction.
+     */
+    CYCLE,
+
+    /**
+     * Duration of the instruction in cycles.
+     */
+    DURATION,
+
+    /**
+     * Qubit operand indices, ColumnarBlock::num_qubit_operands per
+     * instruction, padded with -1.
+     */
+    QUBITS,
+
+    /**
+     * Bit operand indices, ColumnarBlock::num_bit_operands per instruction,
+     * padded with -1. Bits are numbered as in the old IR: the implicit bit
+     * associated with qubit i is bit i, and explicit bit register i is bit
+     * num_qubits + i.
+     */
+    BITS,
+
+    /**
+     * The condition of the instruction, as the integer value of the
+     * corresponding compat::ConditionType, or -1 if the condition cannot be
+     * represented that way.
+     */
+    CONDITION,
+
+    /**
+     * The bit operands of the condition, two per instruction, padded with -1.
+     */
+    CONDITION_BITS
+
+};
+
+/**
+ * The number of columns in a ColumnarBlock.
+ */
+const utils::UInt NUM_COLUMNS = 7;
+
+/**
+ * String conversion for Column.
+ */
+std::ostream &operator<<(std::ostream &os, Column column);
+
+/**
+ * Parses a column name as printed by operator<<. Throws a user error if the
+ * name is not recognized.
+ */
+Column parse_column(const utils::Str &name);
+
+/**
+ * The instructions of a block in columnar form. All columns are stored in a
+ * single contiguous buffer of 64-bit integers, with one row per instruction
+ * for each column, such that external tools can consume it without copying.
+ * Columns with more than one value per instruction are stored as row-major
+ * matrices.
+ */
+struct ColumnarBlock {
+
+    /**
+     * The name of the exported block.
+     */
+    utils::Str name;
+
+    /**
+     * The number of exported instructions.
+     */
+    utils::UInt num_instructions = 0;
+
+    /**
+     * The width of the QUBITS column, i.e. the maximum number of qubit
+     * operands of any exported instruction.
+     */
+    utils::UInt num_qubit_operands = 0;
+
+    /**
+     * The width of the BITS column, i.e. the maximum number of bit operands
+     * of any exported instruction.
+     */
+    utils::UInt num_bit_operands = 0;
+
+    /**
+     * The table of instruction names that the INSTRUCTION column indexes
+     * into. These are the names of the instruction types of the platform,
+     * followed by the names of the non-custom instruction kinds ("set",
+     * "wait", and "goto").
+     */
+    utils::Vec<utils::Str> instruction_names;
+
+    /**
+     * The buffer containing all columns. This is a std::vector rather than a
+     * utils::Vec, because the latter does not guarantee contiguous storage in
+     * checked builds.
+     */
+    std::vector<utils::Int> data;
+
+    /**
+     * Returns the number of values per instruction for the given column.
+     */
+    utils::UInt get_width(Column column) const;
+
+    /**
+     * Returns the offset of the given column in data, in elements.
+     */
+    utils::UInt get_offset(Column column) const;
+
+    /**
+     * Returns a pointer to the start of the given column.
+     */
+    const utils::Int *get_column(Column column) const;
+
+};
+
+/**
+ * Exports the instructions of the given block to columnar form. Structured
+ * control-flow statements are not exported, as their bodies are scheduled
+ * separately. The block is expected to belong to the given IR, which should
+ * be compatible with the old IR (i.e. have been constructed via
+ * convert_old_to_new()).
+ */
+ColumnarBlock export_columnar(const Ref &ir, const BlockBaseRef &block);
+
+} // namespace ir
+} // namespace ql
@@ -10,12 +10,56 @@ namespace ql {
 namespace ir {
 
 /**
- * Performs a consistency check of the IR. An exception is thrown if a problem
+ * How thoroughly check_consistency() checks the IR.
+ */
+enum class ConsistencyCheckLevel {
+
+    /**
+     * No checks are performed. Only suitable for trusted inputs.
+     */
+    NONE,
+
+    /**
+     * Only the structure of the tree is checked: whether it is well-formed
+     * (all required nodes exist and all links point into the tree), and the
+     * program-level constraints on the entry point and block names. The
+     * contents of the blocks and the platform are not checked further.
+     */
+    STRUCTURAL,
+
+    /**
+     * All constraints are checked.
+     */
+    FULL
+
+};
+
+/**
+ * String representation for ConsistencyCheckLevel.
+ */
+std::ostream &operator<<(std::ostream &os, ConsistencyCheckLevel level);
+
+/**
+ * Returns the consistency check level selected using the ir_consistency_check
+ * global option.
+ */
+ConsistencyCheckLevel get_consistency_check_level();
+
+/**
+ * Performs a consistency check of the IR at the level selected using the
+ * ir_consistency_check global option. An exception is thrown if a problem
  * is found. The constraints checked by this must be met on any interface that
  * passes an IR reference, although actually checking it on every interface
  * might be detrimental for performance.
  */
 void check_consistency(const Ref &ir);
 
+/**
+ * Performs a consistency check of the IR at the given level. For the full
+ * check, the blocks of the program are checked in parallel using up to the
+ * given number of threads.
+ */
+void check_consistency(const Ref &ir, ConsistencyCheckLevel level, utils::UInt num_threads = 1);
+
 } // namespace ir
 } // namespace ql
@@ -92,5 +92,27 @@ using ObjectLink = utils::Link<Object>;
  */
 static const std::regex IDENTIFIER_RE{"[a-zA-Z_][a-zA-Z0-9_]*"};
 
+/**
+ * Returns whether the given string is a valid identifier, i.e. whether it
+ * matches IDENTIFIER_RE. This is a hand-written equivalent of matching against
+ * the regular expression, which is much faster.
+ */
+inline utils::Bool is_identifier(const utils::Str &s) {
+    if (s.empty()) {
+        return false;
+    }
+    for (utils::UInt i = 0; i < s.size(); i++) {
+        auto c = s[i];
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_') {
+            continue;
+        }
+        if (i > 0 && c >= '0' && c <= '9') {
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
+
 } // namespace ir
 } // namespace ql
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "ql/utils/map.h"
+#include "ql/utils/arena.h"
 #include "ql/ir/ir.h"
 #include "ql/ir/ir_gen_ex.h"
 
@@ -35,7 +36,7 @@ DataTypeLink add_type(const Ref &ir, Args... args) {
 
     // Check its name. Note: some types may have additional parameters that are
     // not consistency-checked here.
-    if (!std::regex_match(dtyp->name, IDENTIFIER_RE)) {
+    if (!is_identifier(dtyp->name)) {
         throw utils::Exception(
             "invalid name for new data type: \"" + dtyp->name + "\" is not a valid identifier"
         );
@@ -88,6 +89,16 @@ ObjectLink add_physical_object(const Ref &ir, const utils::One<PhysicalObject> &
  */
 ObjectLink find_physical_object(const Ref &ir, const utils::Str &name);
 
+/**
+ * (Re)builds the indices used to quickly find instruction specializations by
+ * template operand for all instruction types in the given platform. Indices
+ * are maintained automatically when instruction types are added, so this only
+ * needs to be called for platforms that were constructed in another way, such
+ * as by cloning or deserialization. Platforms without up-to-date indices
+ * still work, but specialization lookups are slower.
+ */
+void index_specializations(const PlatformRef &platform);
+
 /**
  * Adds an instruction type to the platform. The instruction_type object should
  * be fully generalized; template operands can be attached with the optional
@@ -317,6 +328,17 @@ utils::UInt get_duration_of_block(const BlockBaseRef &block);
  */
 utils::UInt get_number_of_qubits_involved(const InstructionRef &insn);
 
+/**
+ * Returns the memory arena that nodes should be allocated from when
+ * bulk-constructing the program for the given IR, or an empty reference if
+ * arena allocation is disabled through the `ir_arena_allocation` global
+ * option. The arena is created on first use and attached to the root node, so
+ * all bulk construction for one IR shares the same arena. The root node owns
+ * the arena, so nodes allocated from it must not outlive the IR. Use it with
+ * utils::ArenaScope.
+ */
+utils::ArenaRef get_program_arena(const Ref &ir);
+
 class OperandsHelper {
 public:
     OperandsHelper(const PlatformRef p, const CustomInstruction &instruction) : platform(p), instr(instruction) {};
@@ -361,13 +383,13 @@ public:
     }
 
     utils::UInt numberOfQubitOperands() {
-        auto& instr_type = *instr.instruction_type;
-        while (!instr_type.generalization.empty()) {
-            instr_type = *instr_type.generalization;
+        const InstructionType *instr_type = &*instr.instruction_type;
+        while (!instr_type->generalization.empty()) {
+            instr_type = &*instr_type->generalization;
         }
 
         utils::UInt nQubitOperands = 0;
-        for (const auto& op: instr_type.operand_types) {
+        for (const auto& op: instr_type->operand_types) {
             if (op->data_type->type() == NodeType::QubitType) {
                 ++nQubitOperands;
             }
@@ -0,0 +1,54 @@
+/** \file
+ * Provides an on-disk cache for platforms converted to the new IR.
+ */
+
+#pragma once
+
+#include "ql/utils/str.h"
+#include "ql/ir/compat/compat.h"
+#include "ql/ir/ir.h"
+
+namespace ql {
+namespace ir {
+
+/**
+ * Returns the data that the cache key is derived from, i.e. everything that
+ * affects the result of convert_old_to_new() for the given platform.
+ */
+utils::Str get_platform_cache_key(const compat::PlatformRef &old);
+
+/**
+ * Returns the filename of the cache file for the given cache key, based on the
+ * `platform_cache_dir` global option. Returns an empty string if caching is
+ * disabled.
+ */
+utils::Str get_platform_cache_file(const utils::Str &key);
+
+/**
+ * Tries to load the converted platform for the given old platform from the
+ * given cache file, which must have been stored for the given cache key. The
+ * topology, architecture, and resources are taken from the old platform, as
+ * they are in convert_old_to_new(). Returns an empty reference if the file
+ * does not exist or is not a valid cache file for this key; the latter also
+ * results in a warning.
+ */
+Ref load_platform_cache(
+    const utils::Str &filename,
+    const utils::Str &key,
+    const compat::PlatformRef &old
+);
+
+/**
+ * Stores the given freshly converted platform in the given cache file, along
+ * with the given cache key. The file is written atomically, so concurrent
+ * compilations using the same cache directory are safe. Failure to write the
+ * cache only results in a warning.
+ */
+void store_platform_cache(
+    const utils::Str &filename,
+    const utils::Str &key,
+    const Ref &ir
+);
+
+} // namespace ir
+} // namespace ql
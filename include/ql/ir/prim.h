@@ -508,7 +508,8 @@ public:
 };
 
 /**
- * Wrapper for a reference to a topology.
+ * Wrapper for a reference to a topology. An empty wrapper serializes to a
+ * placeholder that deserializes to an empty wrapper again.
  */
 using Topology = Wrapper<com::CTopologyRef, com::Topology>;
 template <>
@@ -518,7 +519,8 @@ Topology deserialize(const utils::tree::cbor::MapReader &map);
 std::ostream &operator<<(std::ostream &os, const Topology &top);
 
 /**
- * Wrapper for a reference to an architecture.
+ * Wrapper for a reference to an architecture. An empty wrapper serializes to a
+ * placeholder that deserializes to an empty wrapper again.
  */
 using Architecture = Wrapper<arch::CArchitectureRef, arch::Architecture>;
 template <>
@@ -0,0 +1,372 @@
+/** \file
+ * Deterministic generators for large synthetic programs, used for stress
+ * testing and benchmarking.
+ */
+
+#pragma once
+
+#include <ostream>
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/vec.h"
+#include "ql/ir/ir.h"
+
+namespace ql {
+namespace ir {
+namespace synthetic {
+
+/**
+ * Small deterministic pseudo-random number generator (xorshift64*). This is
+ * used instead of the standard library distributions, because the output of
+ * those is implementation-defined, and the generated programs must be the
+ * same everywhere for a given seed.
+ */
+class Random {
+private:
+
+    /**
+     * The generator state; never zero.
+     */
+    utils::UInt state;
+
+public:
+
+    /**
+     * Constructs a generator from the given seed.
+     */
+    explicit Random(utils::UInt seed);
+
+    /**
+     * Returns the next 64-bit pseudo-random number.
+     */
+    utils::UInt next();
+
+    /**
+     * Returns a pseudo-random number in the range [0, n). n must be nonzero.
+     */
+    utils::UInt below(utils::UInt n);
+
+    /**
+     * Returns a pseudo-random number in the range [0, 1).
+     */
+    utils::Real uniform();
+
+};
+
+/**
+ * The available families of synthetic programs.
+ */
+enum class Family {
+
+    /**
+     * Random single-qubit gates and CNOTs between arbitrary qubit pairs.
+     */
+    RANDOM,
+
+    /**
+     * Quantum Fourier transform, with the controlled phase rotations
+     * decomposed into CNOTs and Z rotations.
+     */
+    QFT,
+
+    /**
+     * QAOA layers for MaxCut on a random graph.
+     */
+    QAOA,
+
+    /**
+     * Syndrome extraction cycles of a rotated surface code, with ancilla
+     * reset via measurement feedback.
+     */
+    SURFACE_CODE,
+
+    /**
+     * Random gates within nested static loops.
+     */
+    NESTED_LOOPS
+
+};
+
+/**
+ * String conversion for Family.
+ */
+std::ostream &operator<<(std::ostream &os, Family family);
+
+/**
+ * Parses a family name as printed by operator<<. Throws a user error if the
+ * name is not recognized.
+ */
+Family parse_family(const utils::Str &name);
+
+/**
+ * Parameters for the generators. Which parameters are used depends on the
+ * family.
+ */
+struct Parameters {
+
+    /**
+     * The family of programs to generate.
+     */
+    Family family = Family::RANDOM;
+
+    /**
+     * Number of qubits. Not used for SURFACE_CODE, where the number of qubits
+     * follows from the distance.
+     */
+    utils::UInt num_qubits = 16;
+
+    /**
+     * Total number of gates for RANDOM, or number of gates per loop body for
+     * NESTED_LOOPS.
+     */
+    utils::UInt num_gates = 1000;
+
+    /**
+     * Fraction of the random gates that are two-qubit gates, for RANDOM and
+     * NESTED_LOOPS.
+     */
+    utils::Real two_qubit_density = 0.3;
+
+    /**
+     * Number of QAOA layers.
+     */
+    utils::UInt num_layers = 1;
+
+    /**
+     * Average vertex degree of the random QAOA problem graph.
+     */
+    utils::UInt degree = 3;
+
+    /**
+     * Code distance for SURFACE_CODE.
+     */
+    utils::UInt distance = 3;
+
+    /**
+     * Number of syndrome extraction rounds for SURFACE_CODE.
+     */
+    utils::UInt num_rounds = 1;
+
+    /**
+     * Loop nesting depth for NESTED_LOOPS.
+     */
+    utils::UInt loop_depth = 2;
+
+    /**
+     * Number of iterations of each loop for NESTED_LOOPS.
+     */
+    utils::UInt loop_iterations = 10;
+
+    /**
+     * Seed for the pseudo-random number generator. The same parameters always
+     * yield the same program.
+     */
+    utils::UInt seed = 0;
+
+    /**
+     * Returns the number of qubits of the generated program.
+     */
+    utils::UInt get_num_qubits() const;
+
+};
+
+/**
+ * A single gate emitted by a generator.
+ */
+struct Operation {
+
+    /**
+     * Name of the gate.
+     */
+    utils::Str name;
+
+    /**
+     * Qubit operands.
+     */
+    utils::Vec<utils::UInt> qubits;
+
+    /**
+     * Angle operands, following the qubit operands.
+     */
+    utils::Vec<utils::Real> angles;
+
+    /**
+     * Whether the gate is conditional on a measurement result.
+     */
+    utils::Bool conditional = false;
+
+    /**
+     * When conditional is set, the qubit whose implicit measurement bit is the
+     * condition.
+     */
+    utils::UInt condition_bit = 0;
+
+};
+
+/**
+ * Receiver for the output of a generator. Generators call begin() once, then
+ * emit operations and loops in program order, and finally call end(). Sinks
+ * are expected to process the operations as they come in, such that a
+ * generated program never needs to be in memory in its entirety unless the
+ * sink itself constructs it.
+ */
+class Sink {
+public:
+
+    /**
+     * Virtual destructor.
+     */
+    virtual ~Sink() = default;
+
+    /**
+     * Called before anything else, with the number of qubits of the program
+     * and the maximum loop nesting depth that will be used.
+     */
+    virtual void begin(utils::UInt num_qubits, utils::UInt max_loop_depth) = 0;
+
+    /**
+     * Called for each gate.
+     */
+    virtual void operation(const Operation &op) = 0;
+
+    /**
+     * Called at the start of a loop with the given iteration count. The
+     * operations up to the matching end_loop() call form the loop body.
+     */
+    virtual void begin_loop(utils::UInt iterations) = 0;
+
+    /**
+     * Called at the end of a loop body.
+     */
+    virtual void end_loop() = 0;
+
+    /**
+     * Called after everything else.
+     */
+    virtual void end() = 0;
+
+};
+
+/**
+ * Sink that writes cQASM to the given stream. cQASM 1.0 is written unless the
+ * program contains loops, in which case cQASM 1.2 is needed.
+ */
+class CQasmSink : public Sink {
+private:
+
+    /**
+     * The stream to write to.
+     */
+    std::ostream &os;
+
+    /**
+     * The current loop nesting depth.
+     */
+    utils::UInt depth = 0;
+
+    /**
+     * The formatting flags of the stream before begin() was called, restored
+     * by end().
+     */
+    std::ios_base::fmtflags saved_flags;
+
+    /**
+     * The precision of the stream before begin() was called, restored by
+     * end().
+     */
+    std::streamsize saved_precision;
+
+    /**
+     * Writes the indentation for the current nesting depth.
+     */
+    void indent();
+
+public:
+
+    /**
+     * Constructs a sink that writes to the given stream.
+     */
+    explicit CQasmSink(std::ostream &os);
+
+    void begin(utils::UInt num_qubits, utils::UInt max_loop_depth) override;
+    void operation(const Operation &op) override;
+    void begin_loop(utils::UInt iterations) override;
+    void end_loop() override;
+    void end() override;
+
+};
+
+/**
+ * Sink that builds the program in the new IR, using the platform of the given
+ * IR tree. Any existing program is replaced. The platform must support all
+ * the gates used by the generated family, and have enough qubits.
+ */
+class IrSink : public Sink {
+private:
+
+    /**
+     * The IR to build the program in.
+     */
+    Ref ir;
+
+    /**
+     * The name of the program to build.
+     */
+    utils::Str name;
+
+    /**
+     * The real data type used for angle operands, if the platform has one.
+     */
+    DataTypeLink real_type;
+
+    /**
+     * The block that statements are currently added to, and those of the
+     * enclosing loops.
+     */
+    utils::Vec<utils::One<BlockBase>> blocks;
+
+    /**
+     * The loop variables, one for each nesting depth.
+     */
+    utils::Vec<ObjectLink> loop_variables;
+
+public:
+
+    /**
+     * Constructs a sink that builds a program named name in the given IR.
+     */
+    explicit IrSink(const Ref &ir, const utils::Str &name = "synthetic");
+
+    void begin(utils::UInt num_qubits, utils::UInt max_loop_depth) override;
+    void operation(const Operation &op) override;
+    void begin_loop(utils::UInt iterations) override;
+    void end_loop() override;
+    void end() override;
+
+};
+
+/**
+ * Generates a program with the given parameters into the given sink.
+ */
+void generate(const Parameters &parameters, Sink &sink);
+
+/**
+ * Generates a program with the given parameters and writes it as cQASM to the
+ * given stream.
+ */
+void generate_cqasm(const Parameters &parameters, std::ostream &os);
+
+/**
+ * Generates a program with the given parameters and returns it as cQASM.
+ */
+utils::Str generate_cqasm(const Parameters &parameters);
+
+/**
+ * Generates a program with the given parameters into the given IR, replacing
+ * its program, if any.
+ */
+void generate_ir(const Parameters &parameters, const Ref &ir);
+
+} // namespace synthetic
+} // namespace ir
+} // namespace ql
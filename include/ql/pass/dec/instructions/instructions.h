@@ -15,7 +15,7 @@ namespace instructions {
 /**
  * Instruction decomposition pass.
  */
-class DecomposeInstructionsPass : public pmgr::pass_types::Transformation {
+class DecomposeInstructionsPass : public pmgr::pass_types::BlockTransformation {
     static bool is_pass_registered;
 
 protected:
@@ -47,22 +47,31 @@ public:
 private:
 
     /**
-     * Runs the instruction decomposer on the given block.
+     * Runs the instruction decomposer on the given block and recursively its
+     * sub-blocks.
      */
-    static utils::UInt run_on_block(
+    static utils::UInt decompose_block(
         const ir::Ref &ir,
         const ir::BlockBaseRef &block,
         utils::Bool ignore_schedule,
         const com::dec::RulePredicate &predicate
     );
 
-public:
+protected:
+
+    /**
+     * Returns that decomposing the instructions in a block does not affect any
+     * other block.
+     */
+    utils::Bool is_block_local() const override;
 
     /**
-     * Runs the instruction decomposer.
+     * Runs the instruction decomposer on the given top-level block.
      */
-    utils::Int run(
+    utils::Int run_on_block(
         const ir::Ref &ir,
+        const ir::BlockBaseRef &block,
+        const utils::Str &block_name,
         const pmgr::pass_types::Context &context
     ) const override;
 
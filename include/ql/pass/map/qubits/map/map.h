@@ -66,6 +66,16 @@ public:
         pmgr::condition::Ref &condition
     ) override;
 
+    /**
+     * Returns that the mapper uses the data dependency graph.
+     */
+    pmgr::analysis::Types get_required_analyses() const override;
+
+    /**
+     * Returns that the mapper does not affect the control-flow graph.
+     */
+    pmgr::analysis::Types get_preserved_analyses() const override;
+
     /**
      * Runs the qubit mapper.
      */
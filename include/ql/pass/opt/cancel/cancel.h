@@ -0,0 +1,71 @@
+/** \file
+ * Commutation-aware gate cancellation pass.
+ */
+
+#pragma once
+
+#include "ql/pmgr/pass_types/specializations.h"
+
+namespace ql {
+namespace pass {
+namespace opt {
+namespace cancel {
+
+/**
+ * Commutation-aware gate cancellation pass.
+ */
+class CancelGatesPass : public pmgr::pass_types::BlockTransformation {
+    static bool is_pass_registered;
+
+public:
+
+    /**
+     * Constructs a gate cancellation pass.
+     */
+    CancelGatesPass(
+        const utils::Ptr<const pmgr::Factory> &pass_factory,
+        const utils::Str &instance_name,
+        const utils::Str &type_name
+    );
+
+    /**
+     * Returns a user-friendly type name for this pass.
+     */
+    utils::Str get_friendly_type() const override;
+
+protected:
+
+    /**
+     * Returns that cancelling gates in a block does not affect any other block.
+     */
+    utils::Bool is_block_local() const override;
+
+    /**
+     * Runs the gate cancellation pass on the given top-level block.
+     */
+    utils::Int run_on_block(
+        const ir::Ref &ir,
+        const ir::BlockBaseRef &block,
+        const utils::Str &block_name,
+        const pmgr::pass_types::Context &context
+    ) const override;
+
+    /**
+     * Dumps docs for the gate cancellation pass.
+     */
+    void dump_docs(
+        std::ostream &os,
+        const utils::Str &line_prefix
+    ) const override;
+
+};
+
+/**
+ * Shorthand for referring to the pass using namespace notation.
+ */
+using Pass = CancelGatesPass;
+
+} // namespace cancel
+} // namespace opt
+} // namespace pass
+} // namespace ql
@@ -14,7 +14,7 @@ namespace dead_code_elim {
 /**
  * Dead code elimination pass.
  */
-class DeadCodeEliminationPass : public pmgr::pass_types::Transformation {
+class DeadCodeEliminationPass : public pmgr::pass_types::BlockTransformation {
     static bool is_pass_registered;
 
 public:
@@ -33,16 +33,24 @@ public:
      */
     utils::Str get_friendly_type() const override;
 
+protected:
+
+    /**
+     * Returns that dead code elimination in a block does not affect any other
+     * block.
+     */
+    utils::Bool is_block_local() const override;
+
     /**
-     * Runs the dead code elimination pass.
+     * Runs the dead code elimination pass on the given top-level block.
      */
-    utils::Int run(
+    utils::Int run_on_block(
         const ir::Ref &ir,
+        const ir::BlockBaseRef &block,
+        const utils::Str &block_name,
         const pmgr::pass_types::Context &context
     ) const override;
 
-protected:
-
     /**
      * Dumps docs for dead code elimination pass.
      */
@@ -53,9 +61,10 @@ protected:
 
 private:
     /**
-     * Runs the dead code elimination pass on the given block.
+     * Runs the dead code elimination pass on the given block and recursively
+     * its sub-blocks.
      */
-    static void run_on_block(
+    static void eliminate_in_block(
         const ir::BlockBaseRef &block,
         utils::UInt level = 0
     );
@@ -0,0 +1,235 @@
+/** \file
+ * Single-qubit unitary arithmetic and resynthesis into native gates for the
+ * single-qubit gate fusion pass.
+ */
+
+#pragma once
+
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/pair.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/map.h"
+
+namespace ql {
+namespace pass {
+namespace opt {
+namespace fuse_single_qubit {
+namespace detail {
+
+/**
+ * Rotation axis of a parameterized single-qubit gate.
+ */
+enum class Axis {
+    X, Y, Z
+};
+
+/**
+ * A single-qubit unitary as a row-major 2x2 complex matrix.
+ */
+struct Matrix {
+
+    /**
+     * The matrix elements in row-major order.
+     */
+    utils::Complex m[4];
+
+    /**
+     * Returns the identity matrix.
+     */
+    static Matrix identity();
+
+    /**
+     * Returns exp(-i*angle/2*sigma), where sigma is the Pauli matrix for the
+     * given axis.
+     */
+    static Matrix rotation(Axis axis, utils::Real angle);
+
+    /**
+     * Returns the rotation by the given angle about the given unit vector.
+     */
+    static Matrix rotation(utils::Real nx, utils::Real ny, utils::Real nz, utils::Real angle);
+
+    /**
+     * Returns the matrix product of this and rhs.
+     */
+    Matrix operator*(const Matrix &rhs) const;
+
+    /**
+     * Returns the conjugate transpose of this matrix.
+     */
+    Matrix adjoint() const;
+
+    /**
+     * Returns whether this matrix equals the given matrix up to global phase.
+     */
+    utils::Bool equivalent(const Matrix &other) const;
+
+    /**
+     * Returns a string that is the same for matrices that are equal up to
+     * global phase (and rounding), for use as a cache key.
+     */
+    utils::Str get_key() const;
+
+};
+
+/**
+ * The semantics and cost of a native single-qubit gate of the platform.
+ */
+struct NativeGate {
+
+    /**
+     * Name of the instruction.
+     */
+    utils::Str name;
+
+    /**
+     * Whether this is a rotation that takes an angle operand.
+     */
+    utils::Bool parameterized = false;
+
+    /**
+     * The rotation axis for parameterized gates.
+     */
+    Axis axis = Axis::Z;
+
+    /**
+     * The unitary of non-parameterized gates.
+     */
+    Matrix matrix = Matrix::identity();
+
+    /**
+     * The duration of the gate in cycles.
+     */
+    utils::UInt duration = 1;
+
+};
+
+/**
+ * Returns the semantics of the single-qubit gate with the given name, based
+ * on the names of OpenQL's default gates. Returns false if the name is not
+ * recognized. The duration is left untouched.
+ */
+utils::Bool get_default_semantics(const utils::Str &name, NativeGate &gate);
+
+/**
+ * A gate in a synthesized sequence.
+ */
+struct SynthesizedGate {
+
+    /**
+     * Index of the native gate.
+     */
+    utils::UInt native;
+
+    /**
+     * The angle operand for parameterized native gates.
+     */
+    utils::Real angle;
+
+};
+
+/**
+ * A sequence of native gates in execution order.
+ */
+using Sequence = utils::Vec<SynthesizedGate>;
+
+/**
+ * Resynthesizes single-qubit unitaries into the cheapest sequence of native
+ * gates that could be found, with a cache of previous results.
+ */
+class Synthesizer {
+private:
+
+    /**
+     * The available native gates.
+     */
+    utils::Vec<NativeGate> natives;
+
+    /**
+     * The maximum number of entries in the cache.
+     */
+    utils::UInt cache_size;
+
+    /**
+     * Cache of previous synthesis results, indexed by Matrix::get_key(). The
+     * flag is false for unitaries that could not be synthesized.
+     */
+    utils::Map<utils::Str, utils::Pair<utils::Bool, Sequence>> cache;
+
+    /**
+     * The cheapest known product of non-parameterized native gates for each
+     * unitary, indexed by Matrix::get_key().
+     */
+    utils::Map<utils::Str, Sequence> products;
+
+    /**
+     * Index of the parameterized native gate for each axis, or MAX if there
+     * is none.
+     */
+    utils::UInt rotations[3];
+
+    /**
+     * Index of the non-parameterized native gate implementing a rotation by
+     * +pi/2 and -pi/2 about each axis, or MAX if there is none.
+     */
+    utils::UInt quarter_turns[3][2];
+
+    /**
+     * Appends a rotation about the given axis to the given sequence, unless
+     * the angle is a multiple of 2pi.
+     */
+    void add_rotation(Sequence &seq, Axis axis, utils::Real angle) const;
+
+    /**
+     * Considers the given candidate sequence for implementing u, replacing
+     * best if it is valid and cheaper.
+     */
+    void consider(
+        const Matrix &u,
+        const Sequence &candidate,
+        utils::Bool &found,
+        Sequence &best
+    ) const;
+
+public:
+
+    /**
+     * Constructs a synthesizer for the given native gates.
+     */
+    Synthesizer(const utils::Vec<NativeGate> &native_gates, utils::UInt cache_size);
+
+    /**
+     * Returns the native gates.
+     */
+    const utils::Vec<NativeGate> &get_natives() const;
+
+    /**
+     * Returns the unitary implemented by the given sequence.
+     */
+    Matrix get_matrix(const Sequence &seq) const;
+
+    /**
+     * Returns the total duration of the given sequence.
+     */
+    utils::UInt get_duration(const Sequence &seq) const;
+
+    /**
+     * Returns whether sequence a is cheaper than sequence b, i.e. whether it
+     * has a shorter duration, or the same duration and fewer gates.
+     */
+    utils::Bool is_cheaper(const Sequence &a, const Sequence &b) const;
+
+    /**
+     * Synthesizes the cheapest sequence of native gates implementing u up to
+     * global phase. Returns false if no implementation was found.
+     */
+    utils::Bool synthesize(const Matrix &u, Sequence &result);
+
+};
+
+} // namespace detail
+} // namespace fuse_single_qubit
+} // namespace opt
+} // namespace pass
+} // namespace ql
@@ -0,0 +1,71 @@
+/** \file
+ * Single-qubit gate fusion pass.
+ */
+
+#pragma once
+
+#include "ql/pmgr/pass_types/specializations.h"
+
+namespace ql {
+namespace pass {
+namespace opt {
+namespace fuse_single_qubit {
+
+/**
+ * Single-qubit gate fusion pass.
+ */
+class FuseSingleQubitGatesPass : public pmgr::pass_types::BlockTransformation {
+    static bool is_pass_registered;
+
+public:
+
+    /**
+     * Constructs a single-qubit gate fusion pass.
+     */
+    FuseSingleQubitGatesPass(
+        const utils::Ptr<const pmgr::Factory> &pass_factory,
+        const utils::Str &instance_name,
+        const utils::Str &type_name
+    );
+
+    /**
+     * Returns a user-friendly type name for this pass.
+     */
+    utils::Str get_friendly_type() const override;
+
+protected:
+
+    /**
+     * Returns that fusing gates in a block does not affect any other block.
+     */
+    utils::Bool is_block_local() const override;
+
+    /**
+     * Runs the single-qubit gate fusion pass on the given top-level block.
+     */
+    utils::Int run_on_block(
+        const ir::Ref &ir,
+        const ir::BlockBaseRef &block,
+        const utils::Str &block_name,
+        const pmgr::pass_types::Context &context
+    ) const override;
+
+    /**
+     * Dumps docs for the single-qubit gate fusion pass.
+     */
+    void dump_docs(
+        std::ostream &os,
+        const utils::Str &line_prefix
+    ) const override;
+
+};
+
+/**
+ * Shorthand for referring to the pass using namespace notation.
+ */
+using Pass = FuseSingleQubitGatesPass;
+
+} // namespace fuse_single_qubit
+} // namespace opt
+} // namespace pass
+} // namespace ql
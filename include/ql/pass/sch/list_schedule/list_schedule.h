@@ -14,7 +14,7 @@ namespace list_schedule {
 /**
  * Scheduler pass.
  */
-class ListSchedulePass : public pmgr::pass_types::Transformation {
+class ListSchedulePass : public pmgr::pass_types::BlockTransformation {
     static bool is_pass_registered;
 
 protected:
@@ -46,23 +46,60 @@ public:
 private:
 
     /**
-     * Runs the scheduler on the given block.
+     * Names the structured control-flow sub-blocks of the given block
+     * recursively, uniquified with respect to used_names.
      */
-    static void run_on_block(
+    static void name_sub_blocks(
+        const ir::BlockBaseRef &block,
+        const utils::Str &name,
+        utils::Set<utils::Str> &used_names
+    );
+
+    /**
+     * Schedules the given block and recursively its sub-blocks.
+     */
+    static void schedule_block(
         const ir::Ref &ir,
         const ir::BlockBaseRef &block,
-        const utils::Str &name_path,
-        utils::Set<utils::Str> &used_names,
+        const utils::Str &name,
         const pmgr::pass_types::Context &context
     );
 
-public:
+protected:
+
+    /**
+     * Returns that the scheduler uses the data dependency graph.
+     */
+    pmgr::analysis::Types get_required_analyses() const override;
 
     /**
-     * Runs the scheduler.
+     * Returns that the data dependency graph remains valid after scheduling,
+     * and that the control-flow graph is not affected.
      */
-    utils::Int run(
+    pmgr::analysis::Types get_preserved_analyses() const override;
+
+    /**
+     * Returns that scheduling a block does not affect any other block.
+     */
+    utils::Bool is_block_local() const override;
+
+    /**
+     * Names the structured control-flow sub-blocks of all blocks, such that
+     * the names are unique across the program.
+     */
+    void prepare_blocks(
         const ir::Ref &ir,
+        const utils::Vec<utils::Str> &block_names,
+        const pmgr::pass_types::Context &context
+    ) const override;
+
+    /**
+     * Runs the scheduler on the given top-level block.
+     */
+    utils::Int run_on_block(
+        const ir::Ref &ir,
+        const ir::BlockBaseRef &block,
+        const utils::Str &block_name,
         const pmgr::pass_types::Context &context
     ) const override;
 
@@ -0,0 +1,58 @@
+/** \file
+ * Defines the analyses that the pass manager keeps track of, allowing the
+ * results of expensive analyses to be reused between passes.
+ */
+
+#pragma once
+
+#include "ql/utils/str.h"
+#include "ql/utils/set.h"
+#include "ql/ir/ir.h"
+
+namespace ql {
+namespace pmgr {
+namespace analysis {
+
+/**
+ * The analyses that passes can attach to the IR as annotations, and that the
+ * pass manager can therefore reuse or invalidate.
+ */
+enum class Type {
+
+    /**
+     * The data dependency graphs of the blocks in the program, built using
+     * com::ddg::build() or com::ddg::build_or_reuse().
+     */
+    DDG,
+
+    /**
+     * The control-flow graph of the program, built using com::cfg::build().
+     */
+    CFG
+
+};
+
+/**
+ * A set of analysis types.
+ */
+using Types = utils::Set<Type>;
+
+/**
+ * Returns the set of all analysis types.
+ */
+Types all();
+
+/**
+ * Returns a user-friendly name for the given analysis type.
+ */
+utils::Str to_string(Type type);
+
+/**
+ * Removes the annotations for all analyses that are not in preserved from the
+ * given IR.
+ */
+void invalidate(const ir::Ref &ir, const Types &preserved = {});
+
+} // namespace analysis
+} // namespace pmgr
+} // namespace ql
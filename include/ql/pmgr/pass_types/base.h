@@ -14,6 +14,7 @@
 #include "ql/ir/ir.h"
 #include "ql/pmgr/declarations.h"
 #include "ql/pmgr/condition.h"
+#include "ql/pmgr/analysis.h"
 
 namespace ql {
 namespace pmgr {
@@ -257,6 +258,23 @@ protected:
      */
     virtual utils::Bool is_legacy() const;
 
+    /**
+     * Returns the analyses that this pass uses, and thus should not be
+     * invalidated before the pass is run if they are still valid. The pass
+     * itself is responsible for (re)building them when needed, for example
+     * using com::ddg::build_or_reuse(). Returns an empty set unless
+     * overridden.
+     */
+    virtual analysis::Types get_required_analyses() const;
+
+    /**
+     * Returns the analyses that remain valid after this pass is run, such that
+     * subsequent passes may reuse them. All other analyses are invalidated by
+     * the pass manager after the pass completes. Returns an empty set unless
+     * overridden, so passes that do not declare anything are safe by default.
+     */
+    virtual analysis::Types get_preserved_analyses() const;
+
     /**
      * Returns `pass "<name>"` for normal passes and `root` for the root pass.
      * Used for error messages.
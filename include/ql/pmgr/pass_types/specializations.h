@@ -131,6 +131,81 @@ protected:
 
 };
 
+/**
+ * A pass type for passes that transform the IR one top-level block at a time.
+ * Passes that do not touch anything outside of the block they are given
+ * (including its sub-blocks) may additionally declare themselves block-local
+ * by overriding is_block_local(), in which case the blocks are processed in
+ * parallel on a work-stealing thread pool, as controlled by the `num_threads`
+ * option. Block names are uniquified before any block is processed, and the
+ * return values are accumulated in program order, so the result does not
+ * depend on the number of threads.
+ */
+class BlockTransformation : public Normal {
+protected:
+
+    /**
+     * Constructs the pass. No error checking here; this is up to the parent
+     * pass group.
+     */
+    BlockTransformation(
+        const utils::Ptr<const Factory> &pass_factory,
+        const utils::Str &instance_name,
+        const utils::Str &type_name
+    );
+
+    /**
+     * Implementation for on_compile() that calls run_on_block() appropriately.
+     */
+    utils::Int run_internal(
+        const ir::Ref &ir,
+        const Context &context
+    ) const final;
+
+    /**
+     * Returns whether run_on_block() only accesses the block it is given,
+     * such that multiple blocks can be processed concurrently. Returns false
+     * unless overridden.
+     */
+    virtual utils::Bool is_block_local() const;
+
+    /**
+     * Called from the calling thread before any block is processed, with the
+     * uniquified names of all top-level blocks in program order. Passes can
+     * override this for work that must see the whole program, such as naming
+     * things uniquely across blocks that are processed concurrently. Does
+     * nothing unless overridden.
+     */
+    virtual void prepare_blocks(
+        const ir::Ref &ir,
+        const utils::Vec<utils::Str> &block_names,
+        const Context &context
+    ) const;
+
+    /**
+     * Initial accumulator value for the return value. Defaults to zero.
+     */
+    virtual utils::Int retval_initialize() const;
+
+    /**
+     * Return value reduction operator. Defaults to addition.
+     */
+    virtual utils::Int retval_accumulate(utils::Int state, utils::Int block) const;
+
+    /**
+     * The virtual implementation for this pass. block_name is the name of the
+     * block, uniquified with respect to the other top-level blocks of the
+     * program, for use in output filenames and such.
+     */
+    virtual utils::Int run_on_block(
+        const ir::Ref &ir,
+        const ir::BlockBaseRef &block,
+        const utils::Str &block_name,
+        const Context &context
+    ) const = 0;
+
+};
+
 /**
  * A pass type for passes that apply a program-wide transformation using the
  * old IR.
@@ -254,6 +329,12 @@ protected:
         const Context &context
     ) const = 0;
 
+    /**
+     * Returns that analysis passes preserve all analyses, since they don't
+     * modify the IR.
+     */
+    analysis::Types get_preserved_analyses() const override;
+
 };
 
 /**
@@ -0,0 +1,135 @@
+/** \file
+ * Provides a monotonic memory arena for bulk-allocating tree nodes.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include "ql/utils/num.h"
+
+namespace ql {
+namespace utils {
+
+/**
+ * Monotonic memory arena. Memory is handed out from large chunks, and is only
+ * released when the arena itself is destroyed; deallocating individual objects
+ * is a no-op. This makes allocation nearly free and improves locality for
+ * large numbers of small objects that tend to live equally long, such as the
+ * nodes of a program that is constructed in one go.
+ *
+ * Arenas are not thread-safe for allocation. Deallocation, being a no-op, can
+ * be done from any thread.
+ */
+class Arena {
+public:
+
+    /**
+     * Constructs an arena, of which the first chunk will have the given size
+     * in bytes. Subsequent chunks grow geometrically.
+     */
+    explicit Arena(UInt initial_size = 64 * 1024);
+
+    /**
+     * Allocates the given number of bytes with the given alignment.
+     */
+    void *allocate(UInt size, UInt alignment);
+
+    /**
+     * Returns the number of bytes that were allocated from this arena.
+     */
+    UInt get_bytes_allocated() const;
+
+private:
+
+    /**
+     * The underlying memory resource.
+     */
+    std::pmr::monotonic_buffer_resource resource;
+
+    /**
+     * The number of bytes allocated so far.
+     */
+    UInt bytes_allocated = 0;
+
+};
+
+/**
+ * Shared reference to an arena, used by the owner of the arena (such as the
+ * IR root node it is attached to) and by ArenaScope to keep it alive. Objects
+ * allocated from an arena do not keep it alive, so they must not outlive
+ * their owner.
+ */
+using ArenaRef = std::shared_ptr<Arena>;
+
+/**
+ * Standard allocator that allocates from an arena, usable with
+ * std::allocate_shared(). Only a plain pointer to the arena is stored, so
+ * the control block of each object allocated through it is no larger than
+ * usual, and allocation does not touch a reference count.
+ */
+template <class T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena *arena) : arena(arena) {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(std::size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, std::size_t) noexcept {
+    }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U> &other) const {
+        return arena == other.arena;
+    }
+
+    template <class U>
+    bool operator!=(const ArenaAllocator<U> &other) const {
+        return arena != other.arena;
+    }
+
+private:
+    template <class U>
+    friend class ArenaAllocator;
+
+    Arena *arena;
+};
+
+/**
+ * Returns the arena that make() should currently allocate from for this
+ * thread, or null if objects should be allocated normally.
+ */
+Arena *get_current_arena();
+
+/**
+ * RAII object that makes the given arena the current arena for this thread
+ * for as long as it exists, keeping it alive in the meantime. Constructing a
+ * scope with an empty reference disables arena allocation within the scope.
+ * Scopes can be nested.
+ */
+class ArenaScope {
+public:
+    explicit ArenaScope(ArenaRef arena);
+    ~ArenaScope();
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope &operator=(const ArenaScope&) = delete;
+
+private:
+
+    /**
+     * The arena that was current when the scope was entered.
+     */
+    ArenaRef previous;
+
+};
+
+} // namespace utils
+} // namespace ql
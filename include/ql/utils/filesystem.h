@@ -5,10 +5,14 @@
 #pragma once
 
 #include <fstream>
+#include <sstream>
+#include <mutex>
 #include "ql/utils/str.h"
 #include "ql/utils/exception.h"
 #include "ql/utils/compat.h"
 #include "ql/utils/list.h"
+#include "ql/utils/map.h"
+#include "ql/utils/ptr.h"
 
 namespace ql {
 namespace utils {
@@ -92,6 +96,85 @@ Str dir_name(const Str &path);
  */
 void make_dirs(const Str &path);
 
+/**
+ * Destination for the files written through OutFile, when they should not be
+ * written to the filesystem.
+ */
+class OutputSink {
+public:
+
+    /**
+     * Virtual destructor.
+     */
+    virtual ~OutputSink() = default;
+
+    /**
+     * Stores the complete contents of the file with the given path, as it was
+     * passed to OutFile. If a file with the same path was stored before, it is
+     * overwritten, just like a real file would be. May be called concurrently
+     * from multiple threads.
+     */
+    virtual void store(const Str &path, const Str &contents) = 0;
+
+};
+
+/**
+ * Output sink that keeps the files in memory.
+ */
+class MemoryOutputSink : public OutputSink {
+private:
+
+    /**
+     * Mutex protecting files.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * The files stored thus far, by path.
+     */
+    Map<Str, Str> files;
+
+public:
+
+    /**
+     * Stores the given file in memory.
+     */
+    void store(const Str &path, const Str &contents) override;
+
+    /**
+     * Returns a copy of the files stored thus far, by path.
+     */
+    Map<Str, Str> get_files() const;
+
+};
+
+/**
+ * Makes OutFile write to the given sink instead of the filesystem, until the
+ * matching pop_output_sink() call. Pushing an empty pointer reverts to the
+ * filesystem.
+ */
+void push_output_sink(const Ptr<OutputSink> &sink);
+
+/**
+ * Reverts the change made by the previous push_output_sink() call.
+ */
+void pop_output_sink();
+
+/**
+ * Context management class that pushes the given output sink on construction
+ * and pops it on destruction.
+ */
+struct WithOutputSink {
+    WithOutputSink(const Ptr<OutputSink> &sink) { push_output_sink(sink); }
+    ~WithOutputSink() { pop_output_sink(); }
+};
+
+/**
+ * Returns the output sink that OutFile currently writes to, or an empty
+ * pointer if files are written to the filesystem.
+ */
+Ptr<OutputSink> get_output_sink();
+
 /**
  * Wrapper for std::ofstream that:
  *  - takes care of the insane error handling magic of C++ streams;
@@ -103,20 +186,27 @@ void make_dirs(const Str &path);
  * happens while another exception is being handled, abort() will be called.
  * Relative paths are treated as relative to the current OpenQL working
  * directory.
+ *
+ * When an output sink is active (see push_output_sink()), the contents are
+ * buffered in memory instead, and handed to the sink under the path as
+ * given (without applying the working directory) when the file is closed.
  */
 class OutFile {
 private:
     std::ofstream ofs;
+    std::ostringstream buffer;
+    Ptr<OutputSink> sink;
     Str path;
 public:
     explicit OutFile(const Str &path);
+    ~OutFile();
     void write(const Str &content);
     void close();
     void check();
-    std::ofstream &unwrap();
+    std::ostream &unwrap();
     template <typename T>
     OutFile &operator<<(T &&rhs) {
-        ofs << std::forward<T>(rhs);
+        unwrap() << std::forward<T>(rhs);
         check();
         return *this;
     }
@@ -1,54 +1,96 @@
 /** \file
  * Provides macros for logging and the global loglevel variable.
+ *
+ * Log lines are formatted at the call site, but are written to std::cout or
+ * std::cerr asynchronously: they are pushed into a lock-free ring buffer that
+ * is drained by a background thread, which only flushes the streams when it
+ * runs out of work. Errors are flushed synchronously, so they are never lost
+ * when the error is followed by an exception.
+ *
+ * Whether a log statement is enabled is determined in two stages. Statements
+ * for levels more verbose than QL_COMPILED_LOG_LEVEL (configured through the
+ * OPENQL_COMPILED_LOG_LEVEL CMake option) are removed at compile-time. The
+ * remaining statements check the runtime log level of the module they are in,
+ * which is cached per call site; see set_module_log_level().
  */
 
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include "ql/utils/exception.h"
 #include "ql/utils/compat.h"
+#include "ql/utils/num.h"
 #include "ql/utils/str.h"
 
+// The most verbose log level that is compiled in. Normally set by config.h.
+#ifndef QL_COMPILED_LOG_LEVEL
+#define QL_COMPILED_LOG_LEVEL LOG_DEBUG
+#endif
+
 // helper macro: stringstream to string
 // based on https://stackoverflow.com/questions/21924156/how-to-initialize-a-stdstringstream
 #define QL_SS2S(values) ::ql::utils::Str(dynamic_cast<::ql::utils::StrStrm&&>(::ql::utils::StrStrm() << values).str())
 
+// helper macro: whether log statements of the given level are enabled at the
+// call site. Every expansion has its own cache for the log level of the
+// module it appears in.
+#define QL_LOG_ENABLED(level)                                                                               \
+    (                                                                                                       \
+        ::ql::utils::logger::LogLevel::level <= ::ql::utils::logger::LogLevel::QL_COMPILED_LOG_LEVEL        \
+        && []() -> ::ql::utils::logger::LogLevel {                                                          \
+            static ::ql::utils::logger::Site site{__FILE__};                                                \
+            return site.get_level();                                                                        \
+        }() >= ::ql::utils::logger::LogLevel::level                                                         \
+    )
+
 #define QL_PRINTLN(x) \
     do {                                                                                                    \
-        std::cout << "[OPENQL] " << x << std::endl;                                                         \
+        ::ql::utils::logger::write_line(QL_SS2S("[OPENQL] " << x));                                         \
     } while (false)
 
 #define QL_EOUT(content) \
     do {                                                                                                    \
-        if (::ql::utils::logger::log_level >= ::ql::utils::logger::LogLevel::LOG_ERROR) {                   \
-            ::std::cerr << "[OPENQL] " __FILE__ ":" << __LINE__ << " Error: " << content << ::std::endl;    \
+        if (QL_LOG_ENABLED(LOG_ERROR)) {                                                                    \
+            ::ql::utils::logger::write_line(                                                                \
+                QL_SS2S("[OPENQL] " __FILE__ ":" << __LINE__ << " Error: " << content), true                \
+            );                                                                                              \
+            ::ql::utils::logger::flush();                                                                   \
         }                                                                                                   \
     } while (false)
 
 #define QL_WOUT(content) \
     do {                                                                                                    \
-        if (::ql::utils::logger::log_level >= ::ql::utils::logger::LogLevel::LOG_WARNING) {                 \
-            ::std::cerr << "[OPENQL] " __FILE__ ":" << __LINE__ << " Warning: " << content << ::std::endl;  \
+        if (QL_LOG_ENABLED(LOG_WARNING)) {                                                                  \
+            ::ql::utils::logger::write_line(                                                                \
+                QL_SS2S("[OPENQL] " __FILE__ ":" << __LINE__ << " Warning: " << content), true              \
+            );                                                                                              \
         }                                                                                                   \
     } while (false)
 
 #define QL_IOUT(content) \
     do {                                                                                                    \
-        if (::ql::utils::logger::log_level >= ::ql::utils::logger::LogLevel::LOG_INFO) {                    \
-            ::std::cout << "[OPENQL] " __FILE__ ":" << __LINE__ << " Info: "<< content << ::std::endl;      \
+        if (QL_LOG_ENABLED(LOG_INFO)) {                                                                     \
+            ::ql::utils::logger::write_line(                                                                \
+                QL_SS2S("[OPENQL] " __FILE__ ":" << __LINE__ << " Info: " << content)                       \
+            );                                                                                              \
         }                                                                                                   \
     } while (false)
 
 #define QL_DOUT(content) \
     do {                                                                                                    \
-        if (::ql::utils::logger::log_level >= ::ql::utils::logger::LogLevel::LOG_DEBUG) {                   \
-            ::std::cout << "[OPENQL] " __FILE__ ":" << __LINE__ << " " << content << ::std::endl;           \
+        if (QL_LOG_ENABLED(LOG_DEBUG)) {                                                                    \
+            ::ql::utils::logger::write_line(                                                                \
+                QL_SS2S("[OPENQL] " __FILE__ ":" << __LINE__ << " " << content)                             \
+            );                                                                                              \
         }                                                                                                   \
     } while (false)
 
 #define QL_COUT(content) \
     do {                                                                                                    \
-        ::std::cout << "[OPENQL] " __FILE__ ":" << __LINE__ << " " << content << ::std::endl;               \
+        ::ql::utils::logger::write_line(                                                                    \
+            QL_SS2S("[OPENQL] " __FILE__ ":" << __LINE__ << " " << content)                                 \
+        );                                                                                                  \
     } while (false)
 
 #define QL_FATAL(content) \
@@ -61,7 +103,7 @@
     } while (false)
 
 #define QL_IS_LOG_DEBUG \
-    (::ql::utils::logger::log_level >= ::ql::utils::logger::LogLevel::LOG_DEBUG)
+    QL_LOG_ENABLED(LOG_DEBUG)
 
 #define QL_IF_LOG_DEBUG \
     if QL_IS_LOG_DEBUG
@@ -79,11 +121,108 @@ enum LogLevel {
     LOG_DEBUG
 };
 
+/**
+ * The log level for modules that don't have their own log level.
+ */
 QL_GLOBAL extern LogLevel log_level;
 
+/**
+ * Counter that is incremented whenever the global or a module log level
+ * changes, invalidating the levels cached by the call sites.
+ */
+QL_GLOBAL extern std::atomic<UInt> log_generation;
+
+/**
+ * Log level cache for a single log statement call site. These are constructed
+ * as function-local statics by the logging macros; the constructor is
+ * constexpr, so they are constant-initialized and don't need a guard.
+ */
+class Site {
+private:
+
+    /**
+     * The source file that the call site is in, used to determine its module.
+     */
+    const char *file;
+
+    /**
+     * The value of log_generation for which level is valid.
+     */
+    std::atomic<UInt> generation;
+
+    /**
+     * The cached log level.
+     */
+    std::atomic<LogLevel> level;
+
+    /**
+     * Recomputes the cached log level.
+     */
+    LogLevel update();
+
+public:
+
+    /**
+     * Constructs a call site for the given source file.
+     */
+    constexpr explicit Site(const char *file) : file(file), generation(0), level(LOG_NOTHING) {}
+
+    /**
+     * Returns the log level for this call site.
+     */
+    LogLevel get_level() {
+        if (generation.load(std::memory_order_acquire) == log_generation.load(std::memory_order_relaxed)) {
+            return level.load(std::memory_order_relaxed);
+        }
+        return update();
+    }
+
+};
+
 LogLevel log_level_from_string(const Str &level);
 void set_log_level(const Str &level);
 
+/**
+ * Returns the module name for the given source file, being its path relative
+ * to the ql source or include directory without the file extension, for
+ * example pass/map/qubits/map/detail/mapper.
+ */
+Str get_module(const Str &file);
+
+/**
+ * Sets the log level for the given module, overriding the global log level.
+ * A module is a path relative to the ql source directory, such as pass/map or
+ * com/sch/scheduler, and includes everything below it. When multiple modules
+ * match a source file, the most specific one is used.
+ */
+void set_module_log_level(const Str &module, const Str &level);
+
+/**
+ * Replaces all module log levels with the given comma-separated list of
+ * <module>=<level> pairs. An empty string clears all module log levels.
+ */
+void set_module_log_levels(const Str &spec);
+
+/**
+ * Sets whether log lines are written asynchronously by a background thread
+ * (the default) or synchronously by the thread that logs them, flushing after
+ * every line. The latter is slower, but keeps the log in sync with output
+ * written to std::cout or std::cerr by other means.
+ */
+void set_log_async(Bool async);
+
+/**
+ * Writes a line to the log, either to std::cout or to std::cerr. The line
+ * should not include the line terminator.
+ */
+void write_line(Str &&line, Bool error = false);
+
+/**
+ * Blocks until all lines written to the log so far have been written to and
+ * flushed from their streams.
+ */
+void flush();
+
 } // namespace logger
 } // namespace utils
 } // namespace ql
@@ -0,0 +1,45 @@
+/** \file
+ * Provides a minimal work-stealing thread pool for running independent tasks
+ * in parallel.
+ */
+
+#pragma once
+
+#include <functional>
+#include "ql/utils/num.h"
+
+namespace ql {
+namespace utils {
+
+/**
+ * Returns the number of threads that "auto" thread count options should
+ * resolve to, i.e. the amount of hardware concurrency, or 1 if this cannot be
+ * determined.
+ */
+UInt get_default_num_threads();
+
+/**
+ * Runs task(i) for all i in [0, num_tasks) using at most num_threads threads.
+ * The calling thread participates in the work, so num_threads = 1 (or
+ * num_tasks <= 1) runs everything sequentially in index order, without
+ * spawning any threads.
+ *
+ * Each worker starts out with a contiguous range of task indices, which it
+ * processes front to back. When a worker runs out of work, it steals tasks
+ * from the back of the range of another worker. This keeps the overhead low
+ * when tasks are roughly equal in size, while still balancing the load when
+ * they are not.
+ *
+ * Tasks must be independent of each other. If one or more tasks throw an
+ * exception, the remaining tasks are still run to completion, after which the
+ * exception thrown by the task with the lowest index is rethrown. This keeps
+ * error reporting deterministic regardless of scheduling.
+ */
+void parallel_for(
+    UInt num_tasks,
+    UInt num_threads,
+    const std::function<void(UInt)> &task
+);
+
+} // namespace utils
+} // namespace ql
@@ -8,6 +8,7 @@
 // Include the snippets from tree-gen.
 #include "ql/utils/tree-config.inc"
 #include "tree-all.hpp.inc"
+#include "ql/utils/arena.h"
 
 namespace ql {
 namespace utils {
@@ -90,10 +91,14 @@ template <class T>
 using Link = tree::base::Link<T>;
 
 /**
- * Constructs a One or Maybe object, analogous to std::make_shared.
+ * Constructs a One or Maybe object, analogous to std::make_shared. If an arena
+ * is active for this thread (see ArenaScope), the node is allocated from it.
  */
 template <class T, typename... Args>
 One<T> make(Args&&... args) {
+    if (auto arena = get_current_arena()) {
+        return One<T>(std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args>(args)...));
+    }
     return One<T>(std::make_shared<T>(std::forward<Args>(args)...));
 }
 
@@ -27,6 +27,7 @@ namespace std {
    %template(vectorf) vector<float>;
    %template(vectord) vector<double>;
    %template(vectorc) vector<std::complex<double>>;
+   %template(vectors) vector<std::string>;
    %template(mapss) map<std::string, std::string>;
 };
 
@@ -60,6 +61,7 @@ namespace std {
 %include "ql/api/operation.i"
 %include "ql/api/unitary.i"
 %include "ql/api/kernel.i"
+%include "ql/api/schedule.i"
 %include "ql/api/program.i"
 %include "ql/api/cqasm_reader.i"
 
@@ -52,6 +52,7 @@ __all__ = [
     'dump_compiler_docs',
     'Platform',
     'Program',
+    'Schedule',
     'Kernel',
     'CReg',
     'Operation',
@@ -77,6 +78,7 @@ def _fixup_swig_autodoc_type(typ):
         'mapss': 'Dict[str, str]',
         'vectorp': 'List[Pass]',
         'vectorui': 'List[int]',
+        'vectors': 'List[str]',
         'vectord': 'List[float]'
     }.get(typ, typ)
     return typ
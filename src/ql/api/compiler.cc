@@ -4,7 +4,9 @@
 
 #include "ql/api/compiler.h"
 
+#include "ql/utils/filesystem.h"
 #include "ql/ir/old_to_new.h"
+#include "ql/com/options.h"
 #include "ql/api/misc.h"
 #include "ql/api/platform.h"
 #include "ql/api/program.h"
@@ -396,13 +398,43 @@ void Compiler::construct() {
 }
 #endif
 
+/**
+ * Runs the given compilation function. If the `output_to_memory` global
+ * option is set, the files written in the process are collected in memory
+ * and returned; otherwise they are written to disk, and the result is empty.
+ */
+OutputFiles Compiler::run_with_output_sink(const std::function<void()> &compile) {
+    if (!ql::com::options::global["output_to_memory"].as_bool()) {
+        compile();
+        return {};
+    }
+    utils::Ptr<utils::MemoryOutputSink> memory;
+    memory.emplace();
+    utils::Ptr<utils::OutputSink> sink;
+    sink = memory;
+    {
+        utils::WithOutputSink with_sink{sink};
+        compile();
+    }
+    OutputFiles files;
+    for (const auto &file : memory->get_files()) {
+        files.emplace(file.first, file.second);
+    }
+    return files;
+}
+
 /**
  * Ensures that all passes have been constructed, and then runs the passes
  * on the given program. This is the same as Program.compile() when the
- * program is referencing the same compiler.
- */
-void Compiler::compile(const Program &program) {
-    pass_manager->compile(ir::convert_old_to_new(program.program));
+ * program is referencing the same compiler. If the `output_to_memory` global
+ * option is set, the output files are returned instead of written.
+ */
+OutputFiles Compiler::compile(const Program &program) {
+    return run_with_output_sink([&]() {
+        auto ir = ir::convert_old_to_new(program.program);
+        pass_manager->compile(ir);
+        program.compiled = ir;
+    });
 }
 
 /**
@@ -414,9 +446,14 @@ void Compiler::compile(const Program &program) {
  * If no platform is specified, it will default to the `"none"` architecture,
  * but the intended use case is to have the first pass load the platform. Again,
  * the cQASM reader can do this.
+ *
+ * If the `output_to_memory` global option is set, the output files are
+ * returned instead of written.
  */
-void Compiler::compile_with_frontend(const Platform &platform = Platform()) {
-    pass_manager->compile(ir::convert_old_to_new(platform.platform));
+OutputFiles Compiler::compile_with_frontend(const Platform &platform = Platform()) {
+    return run_with_output_sink([&]() {
+        pass_manager->compile(ir::convert_old_to_new(platform.platform));
+    });
 }
 
 } // namespace api
@@ -670,7 +670,10 @@ program : Program
 
 Returns
 -------
-None
+Dict[str, bytes]
+    When the `output_to_memory` global option is set, the files that would
+    have been written during compilation, mapping file names to contents.
+    Otherwise, the files are written to disk and this is empty.
 """
 
 
@@ -691,8 +694,23 @@ platform : Platform
 
 Returns
 -------
-None
+Dict[str, bytes]
+    When the `output_to_memory` global option is set, the files that would
+    have been written during compilation, mapping file names to contents.
+    Otherwise, the files are written to disk and this is empty.
 """
 
 
+// Output files are returned to Python as a dict of bytes, since they are not
+// necessarily valid UTF-8.
+%typemap(out) ql::api::OutputFiles {
+    $result = PyDict_New();
+    for (const auto &file : $1) {
+        PyObject *contents = PyBytes_FromStringAndSize(file.second.data(), file.second.size());
+        PyDict_SetItemString($result, file.first.c_str(), contents);
+        Py_DECREF(contents);
+    }
+}
+
+
 %include "ql/api/compiler.h"
@@ -4,6 +4,8 @@
 
 #include "ql/api/kernel.h"
 
+#include <limits>
+
 #include "ql/api/creg.h"
 #include "ql/api/operation.h"
 #include "ql/api/unitary.h"
@@ -190,6 +192,95 @@ void Kernel::condgate(
     );
 }
 
+/**
+ * Appends a sequence of quantum gates specified as parallel arrays, in a
+ * single call. This is equivalent to calling gate() for each element, but
+ * avoids the per-gate overhead of crossing the language boundary when
+ * large programs are constructed from Python.
+ *
+ * names is a table of gate names, and gate_ids specifies the gates to
+ * append as indices into that table. qubit_operands is a row-major matrix
+ * with one row per gate; its width is derived from its size. Rows of gates
+ * with fewer qubit operands than the matrix is wide must be padded at the
+ * end with SIZE_MAX (-1 from Python).
+ *
+ * durations and angles must either be empty or specify one value per
+ * gate. The same goes for condition_bits; for each gate, it specifies
+ * the bit register that the gate is conditional on (COND_UNARY), or
+ * SIZE_MAX (-1 from Python) for unconditional gates.
+ */
+void Kernel::gates(
+    const std::vector<std::string> &names,
+    const std::vector<size_t> &gate_ids,
+    const std::vector<size_t> &qubit_operands,
+    const std::vector<size_t> &durations,
+    const std::vector<double> &angles,
+    const std::vector<size_t> &condition_bits
+) {
+    static const size_t NONE = std::numeric_limits<size_t>::max();
+    size_t num_gates = gate_ids.size();
+    QL_DOUT("Python k.gates(<" << num_gates << " gates>)");
+
+    // Check the shapes of the arrays before appending anything, such that a
+    // mistake on the Python side does not leave a partially-built kernel.
+    if (num_gates == 0) {
+        if (!qubit_operands.empty()) {
+            QL_USER_ERROR("qubit operand matrix must be empty when no gates are specified");
+        }
+        return;
+    }
+    if (qubit_operands.size() % num_gates) {
+        QL_USER_ERROR(
+            "qubit operand matrix size (" << qubit_operands.size() << ") "
+            "is not a multiple of the number of gates (" << num_gates << ")"
+        );
+    }
+    size_t width = qubit_operands.size() / num_gates;
+    auto check_size = [num_gates](const char *what, size_t size) {
+        if (size != 0 && size != num_gates) {
+            QL_USER_ERROR(
+                what << " must be empty or specify one value per gate, "
+                "but " << size << " values were given for " << num_gates << " gates"
+            );
+        }
+    };
+    check_size("durations", durations.size());
+    check_size("angles", angles.size());
+    check_size("condition_bits", condition_bits.size());
+    for (size_t i = 0; i < num_gates; i++) {
+        if (gate_ids[i] >= names.size()) {
+            QL_USER_ERROR(
+                "gate ID " << gate_ids[i] << " of gate " << i << " is out of "
+                "range for a name table of size " << names.size()
+            );
+        }
+    }
+
+    ql::utils::Vec<ql::utils::UInt> qubits;
+    qubits.reserve(width);
+    for (size_t i = 0; i < num_gates; i++) {
+        qubits.clear();
+        for (size_t j = 0; j < width; j++) {
+            auto qubit = qubit_operands[i * width + j];
+            if (qubit == NONE) break;
+            qubits.push_back(qubit);
+        }
+        auto duration = durations.empty() ? 0 : durations[i];
+        auto angle = angles.empty() ? 0.0 : angles[i];
+        if (condition_bits.empty() || condition_bits[i] == NONE) {
+            kernel->gate(
+                names[gate_ids[i]], qubits, {}, duration, angle, {},
+                ir::compat::ConditionType::ALWAYS, {}
+            );
+        } else {
+            kernel->gate(
+                names[gate_ids[i]], qubits, {}, duration, angle, {},
+                ir::compat::ConditionType::UNARY, {condition_bits[i]}
+            );
+        }
+    }
+}
+
 /**
  * Appends a classical assignment gate to the circuit. The classical integer
  * register is assigned to the result of the given operation.
@@ -297,6 +297,51 @@ None
 """
 
 
+%feature("docstring") ql::api::Kernel::gates
+"""
+Appends a sequence of quantum gates specified as parallel arrays, in a single
+call. This is equivalent to calling gate() for each element, but avoids the
+per-gate overhead of crossing the language boundary when large programs are
+constructed from Python.
+
+The array arguments accept anything that supports the buffer protocol, such
+as numpy arrays, in which case the data is converted without constructing a
+Python object per element. Multidimensional arrays must be C-contiguous.
+Plain lists of numbers are also accepted.
+
+Parameters
+----------
+names : List[str]
+    Table of gate names. These are interpreted the same way as the name
+    argument of gate().
+
+gate_ids : array of int
+    The gates to append, as indices into names.
+
+qubit_operands : array of int
+    Row-major matrix with one row of qubit indices per gate, usually a
+    two-dimensional numpy array with shape (len(gate_ids), max_qubits). The
+    width is derived from the size. Rows of gates with fewer qubit operands
+    than the matrix is wide must be padded at the end with -1.
+
+durations : array of int
+    Optional gate durations, one per gate, with the same meaning as the
+    duration argument of gate().
+
+angles : array of float
+    Optional angles, one per gate, with the same meaning as the angle
+    argument of gate().
+
+condition_bits : array of int
+    Optional bit register indices, one per gate, that the gates are
+    conditional on (as for gate() with condstring \"COND_UNARY\"). Use -1
+    for gates that should always be executed.
+
+Returns
+-------
+None
+"""
+
 %feature("docstring") ql::api::Kernel::classical
 """
 Appends a classical assignment gate to the circuit. The classical integer
@@ -993,4 +1038,156 @@ None
 """
 
 
+// The array arguments of gates() are converted directly from objects that
+// support the buffer protocol, such as numpy arrays, to avoid constructing a
+// Python object per element for very large programs. Negative integers map
+// to SIZE_MAX, which gates() uses to mark padding and unconditional gates.
+%{
+#include <limits>
+#include <type_traits>
+
+template <typename T, typename S>
+static T ql_bulk_cast(S value) {
+    if (std::is_integral<T>::value && std::is_signed<S>::value && value < S(0)) {
+        return std::numeric_limits<T>::max();
+    }
+    return static_cast<T>(value);
+}
+
+template <typename S, typename T>
+static void ql_bulk_copy(const Py_buffer &view, std::vector<T> &result) {
+    const S *data = static_cast<const S*>(view.buf);
+    result.resize(view.len / view.itemsize);
+    for (size_t i = 0; i < result.size(); i++) {
+        result[i] = ql_bulk_cast<T>(data[i]);
+    }
+}
+
+template <typename T>
+static bool ql_bulk_from_buffer(PyObject *obj, std::vector<T> &result) {
+    Py_buffer view;
+    if (PyObject_GetBuffer(obj, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+        return false;
+    }
+
+    // Skip the byte order character, if any. Only native byte order is
+    // supported.
+    const char *format = view.format ? view.format : "B";
+    if (*format == '@') {
+        format++;
+    } else if (*format == '=' || *format == '<' || *format == '>' || *format == '!') {
+        const uint16_t probe = 1;
+        bool little = *reinterpret_cast<const uint8_t*>(&probe) == 1;
+        if ((*format == '<' && !little) || ((*format == '>' || *format == '!') && little)) {
+            PyBuffer_Release(&view);
+            PyErr_SetString(PyExc_ValueError, "array must be in native byte order");
+            return false;
+        }
+        format++;
+    }
+
+    bool ok = true;
+    if (format[0] != 0 && format[1] == 0) {
+        switch (format[0]) {
+            case 'b': case 'h': case 'i': case 'l': case 'q': case 'n':
+                switch (view.itemsize) {
+                    case 1: ql_bulk_copy<int8_t>(view, result); break;
+                    case 2: ql_bulk_copy<int16_t>(view, result); break;
+                    case 4: ql_bulk_copy<int32_t>(view, result); break;
+                    case 8: ql_bulk_copy<int64_t>(view, result); break;
+                    default: ok = false;
+                }
+                break;
+            case 'B': case 'H': case 'I': case 'L': case 'Q': case 'N': case '?':
+                switch (view.itemsize) {
+                    case 1: ql_bulk_copy<uint8_t>(view, result); break;
+                    case 2: ql_bulk_copy<uint16_t>(view, result); break;
+                    case 4: ql_bulk_copy<uint32_t>(view, result); break;
+                    case 8: ql_bulk_copy<uint64_t>(view, result); break;
+                    default: ok = false;
+                }
+                break;
+            case 'f': case 'd':
+                if (!std::is_floating_point<T>::value) {
+                    ok = false;
+                } else if (view.itemsize == sizeof(float)) {
+                    ql_bulk_copy<float>(view, result);
+                } else if (view.itemsize == sizeof(double)) {
+                    ql_bulk_copy<double>(view, result);
+                } else {
+                    ok = false;
+                }
+                break;
+            default:
+                ok = false;
+        }
+    } else {
+        ok = false;
+    }
+    if (!ok) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "unsupported array element type '%s'; expected %s",
+            view.format ? view.format : "B",
+            std::is_floating_point<T>::value ? "integers or floats" : "integers"
+        );
+    }
+    PyBuffer_Release(&view);
+    return ok;
+}
+
+template <typename T>
+static bool ql_bulk_to_vector(PyObject *obj, std::vector<T> &result) {
+    result.clear();
+    if (obj == Py_None) {
+        return true;
+    }
+    if (PyObject_CheckBuffer(obj)) {
+        return ql_bulk_from_buffer(obj, result);
+    }
+    PyObject *seq = PySequence_Fast(obj, "expected an array or a sequence of numbers");
+    if (!seq) {
+        return false;
+    }
+    Py_ssize_t size = PySequence_Fast_GET_SIZE(seq);
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+    result.resize(size);
+    for (Py_ssize_t i = 0; i < size; i++) {
+        if (std::is_floating_point<T>::value) {
+            result[i] = static_cast<T>(PyFloat_AsDouble(items[i]));
+        } else {
+            result[i] = ql_bulk_cast<T>(PyLong_AsLongLong(items[i]));
+        }
+        if (PyErr_Occurred()) {
+            Py_DECREF(seq);
+            return false;
+        }
+    }
+    Py_DECREF(seq);
+    return true;
+}
+%}
+
+%typemap(in)
+    const std::vector<size_t> &gate_ids (std::vector<size_t> temp),
+    const std::vector<size_t> &qubit_operands (std::vector<size_t> temp),
+    const std::vector<size_t> &durations (std::vector<size_t> temp),
+    const std::vector<size_t> &condition_bits (std::vector<size_t> temp),
+    const std::vector<double> &angles (std::vector<double> temp)
+{
+    if (!ql_bulk_to_vector($input, temp)) SWIG_fail;
+    $1 = &temp;
+}
+
+%typemap(typecheck, precedence=SWIG_TYPECHECK_POINTER)
+    const std::vector<size_t> &gate_ids,
+    const std::vector<size_t> &qubit_operands,
+    const std::vector<size_t> &durations,
+    const std::vector<size_t> &condition_bits,
+    const std::vector<double> &angles
+{
+    $1 = ($input == Py_None || PyObject_CheckBuffer($input) || PySequence_Check($input)) ? 1 : 0;
+}
+
+
 %include "ql/api/kernel.h"
@@ -161,16 +161,20 @@ void Program::set_compiler(const Compiler &compiler) {
 }
 
 /**
- * Compiles the program.
+ * Compiles the program. If the `output_to_memory` global option is set, the
+ * output files are returned instead of written.
  */
-void Program::compile() {
+OutputFiles Program::compile() {
     QL_IOUT("compiling " << name << " ...");
-    auto ir = ir::convert_old_to_new(program);
-    if (pass_manager.has_value()) {
-        pass_manager->compile(ir);
-    } else {
-        ql::pmgr::Manager::from_defaults(program->platform).compile(ir);
-    }
+    return Compiler::run_with_output_sink([&]() {
+        auto ir = ir::convert_old_to_new(program);
+        if (pass_manager.has_value()) {
+            pass_manager->compile(ir);
+        } else {
+            ql::pmgr::Manager::from_defaults(program->platform).compile(ir);
+        }
+        compiled = ir;
+    });
 }
 
 /**
@@ -194,5 +198,40 @@ void Program::write_interaction_matrix() const {
     );
 }
 
+/**
+ * Returns the names of the blocks of the program as compiled by the most
+ * recent call to compile() or Compiler::compile(), for use with
+ * get_schedule().
+ */
+std::vector<std::string> Program::get_schedule_names() const {
+    std::vector<std::string> names;
+    if (!compiled.empty() && !compiled->program.empty()) {
+        for (const auto &block : compiled->program->blocks) {
+            names.push_back(block->name);
+        }
+    }
+    return names;
+}
+
+/**
+ * Returns the scheduled instructions of the block with the given name of
+ * the program as compiled by the most recent call to compile() or
+ * Compiler::compile(), in columnar form. Structured control-flow statements
+ * within the block are not included.
+ */
+Schedule Program::get_schedule(const std::string &name) const {
+    if (compiled.empty() || compiled->program.empty()) {
+        QL_USER_ERROR("program " << this->name << " has not been compiled yet");
+    }
+    for (const auto &block : compiled->program->blocks) {
+        if (block->name == name) {
+            ql::utils::Ptr<ql::ir::ColumnarBlock> schedule;
+            schedule.emplace(ql::ir::export_columnar(compiled, block));
+            return Schedule(schedule);
+        }
+    }
+    QL_USER_ERROR("compiled program has no block named " << name);
+}
+
 } // namespace api
 } // namespace ql
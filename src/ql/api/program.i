@@ -233,7 +233,10 @@ None
 
 Returns
 -------
-None
+Dict[str, bytes]
+    When the `output_to_memory` global option is set, the files that would
+    have been written during compilation, mapping file names to contents.
+    Otherwise, the files are written to disk and this is empty.
 """
 
 
@@ -267,4 +270,40 @@ None
 """
 
 
+%feature("docstring") ql::api::Program::get_schedule_names
+"""
+Returns the names of the blocks of the program as compiled by the most
+recent call to compile() or Compiler.compile(), for use with get_schedule().
+
+Parameters
+----------
+None
+
+Returns
+-------
+List[str]
+    The names of the compiled blocks, or an empty list if the program has not
+    been compiled yet.
+"""
+
+
+%feature("docstring") ql::api::Program::get_schedule
+"""
+Returns the scheduled instructions of the block with the given name of the
+program as compiled by the most recent call to compile() or
+Compiler.compile(), in columnar form. Structured control-flow statements
+within the block are not included.
+
+Parameters
+----------
+name : str
+    The name of the block, as returned by get_schedule_names().
+
+Returns
+-------
+Schedule
+    The instructions of the block in columnar form.
+"""
+
+
 %include "ql/api/program.h"
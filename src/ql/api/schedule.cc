@@ -0,0 +1,72 @@
+/** \file
+ * API header for inspecting the schedule of a compiled program.
+ */
+
+#include "ql/api/schedule.h"
+
+//============================================================================//
+//                               W A R N I N G                                //
+//----------------------------------------------------------------------------//
+//         Docstrings in this file must manually be kept in sync with         //
+//     schedule.i! This should be automated at some point, but isn't yet.     //
+//============================================================================//
+
+namespace ql {
+namespace api {
+
+/**
+ * Returns the names of all columns, in buffer order.
+ */
+static std::vector<std::string> get_all_column_names() {
+    std::vector<std::string> names;
+    for (ql::utils::UInt i = 0; i < ql::ir::NUM_COLUMNS; i++) {
+        names.push_back(ql::utils::to_string(static_cast<ql::ir::Column>(i)));
+    }
+    return names;
+}
+
+/**
+ * Wraps the given columnar block.
+ */
+Schedule::Schedule(const ql::utils::Ptr<ql::ir::ColumnarBlock> &schedule) :
+    schedule(schedule),
+    name(schedule->name),
+    num_instructions(schedule->num_instructions),
+    num_qubit_operands(schedule->num_qubit_operands),
+    num_bit_operands(schedule->num_bit_operands),
+    instruction_names(schedule->instruction_names.begin(), schedule->instruction_names.end()),
+    column_names(get_all_column_names())
+{
+}
+
+/**
+ * Returns the number of values per instruction for the given column.
+ */
+size_t Schedule::get_column_width(const std::string &column) const {
+    return schedule->get_width(ql::ir::parse_column(column));
+}
+
+/**
+ * Returns the offset of the given column in the buffer, in elements.
+ */
+size_t Schedule::get_column_offset(const std::string &column) const {
+    return schedule->get_offset(ql::ir::parse_column(column));
+}
+
+/**
+ * Returns the total number of elements in the buffer.
+ */
+size_t Schedule::get_size() const {
+    return schedule->data.size();
+}
+
+/**
+ * Returns a pointer to the buffer. It remains valid for as long as any
+ * copy of this object exists.
+ */
+const int64_t *Schedule::get_data() const {
+    return schedule->data.data();
+}
+
+} // namespace api
+} // namespace ql
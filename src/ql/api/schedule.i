@@ -0,0 +1,274 @@
+
+%feature("docstring") ql::api::Schedule
+"""
+The instructions of a block of a compiled program in columnar form, as
+returned by Program.get_schedule(). All columns are stored in a single
+contiguous buffer of 64-bit signed integers, one column after the other. The
+available columns are:
+
+ - \"instruction\": index into instruction_names.
+ - \"cycle\": start cycle of the instruction.
+ - \"duration\": duration of the instruction in cycles.
+ - \"qubits\": qubit operands, num_qubit_operands per instruction, padded
+   with -1.
+ - \"bits\": bit operands, num_bit_operands per instruction, padded with -1.
+   The implicit bit of qubit i is bit i; explicit bit register i is bit
+   qubit_count + i.
+ - \"condition\": the condition type, using the ordering of the condition
+   strings accepted by Kernel.gate() (0 = always, 1 = never, 2 = unary,
+   3 = not, 4 = and, 5 = nand, 6 = or, 7 = nor, 8 = xor, 9 = nxor), or -1
+   if the condition cannot be represented that way.
+ - \"condition_bits\": the bit operands of the condition, two per
+   instruction, padded with -1.
+
+The columns can be accessed without copying through get_column() and
+get_buffer(), which return read-only memoryviews that can be passed to
+numpy.asarray() directly. The views keep the data alive.
+"""
+
+
+%feature("docstring") ql::api::Schedule::name
+"""
+The name of the block.
+"""
+
+
+%feature("docstring") ql::api::Schedule::num_instructions
+"""
+The number of instructions in the block.
+"""
+
+
+%feature("docstring") ql::api::Schedule::num_qubit_operands
+"""
+The maximum number of qubit operands of any instruction, i.e. the width of
+the \"qubits\" column.
+"""
+
+
+%feature("docstring") ql::api::Schedule::num_bit_operands
+"""
+The maximum number of bit operands of any instruction, i.e. the width of the
+\"bits\" column.
+"""
+
+
+%feature("docstring") ql::api::Schedule::instruction_names
+"""
+The table of instruction names indexed by the \"instruction\" column.
+"""
+
+
+%feature("docstring") ql::api::Schedule::column_names
+"""
+The names of the columns, in the order in which they are stored in the
+buffer.
+"""
+
+
+%feature("docstring") ql::api::Schedule::get_column_width
+"""
+Returns the number of values per instruction for the given column.
+
+Parameters
+----------
+column : str
+    The name of the column.
+
+Returns
+-------
+int
+    The number of values per instruction.
+"""
+
+
+%feature("docstring") ql::api::Schedule::get_column_offset
+"""
+Returns the offset of the given column in the buffer, in elements.
+
+Parameters
+----------
+column : str
+    The name of the column.
+
+Returns
+-------
+int
+    The offset of the column in elements.
+"""
+
+
+%feature("docstring") ql::api::Schedule::get_size
+"""
+Returns the total number of elements in the buffer.
+
+Parameters
+----------
+None
+
+Returns
+-------
+int
+    The total number of elements in the buffer.
+"""
+
+
+%feature("docstring") ql::api::Schedule::get_column
+"""
+Returns a read-only view of the given column without copying. Columns with
+one value per instruction are one-dimensional; the others are
+two-dimensional, with one row per instruction.
+
+Parameters
+----------
+column : str
+    The name of the column.
+
+Returns
+-------
+memoryview
+    A view of the column with format \"q\" (int64).
+"""
+
+
+%feature("docstring") ql::api::Schedule::get_buffer
+"""
+Returns a read-only, one-dimensional view of the complete buffer without
+copying.
+
+Parameters
+----------
+None
+
+Returns
+-------
+memoryview
+    A view of the buffer with format \"q\" (int64).
+"""
+
+
+// The buffer is exposed to Python through a minimal type implementing the
+// buffer protocol, which holds a copy of the Schedule object to keep the
+// data alive for as long as any view of it exists.
+%{
+struct QlScheduleArray {
+    PyObject_HEAD
+    ql::api::Schedule *schedule;
+    const int64_t *data;
+    int ndim;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+};
+
+static void ql_schedule_array_dealloc(PyObject *self) {
+    delete reinterpret_cast<QlScheduleArray*>(self)->schedule;
+    PyTypeObject *type = Py_TYPE(self);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static int ql_schedule_array_getbuffer(PyObject *self, Py_buffer *view, int flags) {
+    auto array = reinterpret_cast<QlScheduleArray*>(self);
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "schedule buffers are read-only");
+        return -1;
+    }
+    view->obj = self;
+    Py_INCREF(self);
+    view->buf = const_cast<int64_t*>(array->data);
+    view->len = sizeof(int64_t);
+    for (int i = 0; i < array->ndim; i++) {
+        view->len *= array->shape[i];
+    }
+    view->readonly = 1;
+    view->itemsize = sizeof(int64_t);
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>("q") : nullptr;
+    view->ndim = array->ndim;
+    view->shape = (flags & PyBUF_ND) ? array->shape : nullptr;
+    view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? array->strides : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+static PyObject *ql_schedule_array_type() {
+    static PyObject *type = nullptr;
+    if (!type) {
+        static PyType_Slot slots[] = {
+            {Py_tp_dealloc, reinterpret_cast<void*>(ql_schedule_array_dealloc)},
+#if PY_VERSION_HEX >= 0x03090000
+            {Py_bf_getbuffer, reinterpret_cast<void*>(ql_schedule_array_getbuffer)},
+#endif
+            {0, nullptr}
+        };
+        static PyType_Spec spec = {
+            "openql.ScheduleArray",
+            sizeof(QlScheduleArray),
+            0,
+            Py_TPFLAGS_DEFAULT,
+            slots
+        };
+        type = PyType_FromSpec(&spec);
+#if PY_VERSION_HEX < 0x03090000
+        // The buffer slots can only be passed to PyType_FromSpec() as of
+        // Python 3.9, so set the buffer procedures on the new type directly.
+        if (type) {
+            static PyBufferProcs buffer_procs = {ql_schedule_array_getbuffer, nullptr};
+            reinterpret_cast<PyTypeObject*>(type)->tp_as_buffer = &buffer_procs;
+        }
+#endif
+    }
+    return type;
+}
+
+static PyObject *ql_schedule_view(
+    const ql::api::Schedule &schedule,
+    size_t offset,
+    size_t rows,
+    size_t cols,
+    int ndim
+) {
+    auto type = reinterpret_cast<PyTypeObject*>(ql_schedule_array_type());
+    if (!type) {
+        return nullptr;
+    }
+    auto array = PyObject_New(QlScheduleArray, type);
+    if (!array) {
+        return nullptr;
+    }
+    array->schedule = new ql::api::Schedule(schedule);
+    array->data = schedule.get_data() + offset;
+    array->ndim = ndim;
+    array->shape[0] = rows;
+    array->shape[1] = cols;
+    array->strides[0] = cols * sizeof(int64_t);
+    array->strides[1] = sizeof(int64_t);
+    if (ndim == 1) {
+        array->strides[0] = sizeof(int64_t);
+    }
+    PyObject *view = PyMemoryView_FromObject(reinterpret_cast<PyObject*>(array));
+    Py_DECREF(array);
+    return view;
+}
+%}
+
+%ignore ql::api::Schedule::get_data;
+
+%extend ql::api::Schedule {
+    PyObject *get_column(const std::string &column) const {
+        size_t width = $self->get_column_width(column);
+        size_t offset = $self->get_column_offset(column);
+        if (column == "qubits" || column == "bits" || column == "condition_bits") {
+            return ql_schedule_view(*$self, offset, $self->num_instructions, width, 2);
+        } else {
+            return ql_schedule_view(*$self, offset, $self->num_instructions, 1, 1);
+        }
+    }
+
+    PyObject *get_buffer() const {
+        return ql_schedule_view(*$self, 0, $self->get_size(), 1, 1);
+    }
+}
+
+
+%include "ql/api/schedule.h"
@@ -5,8 +5,11 @@
 #include "ql/com/ana/interaction_matrix.h"
 
 #include <iomanip>
+#include <algorithm>
 #include "ql/utils/filesystem.h"
+#include "ql/utils/thread_pool.h"
 #include "ql/com/options.h"
+#include "ql/ir/ops.h"
 
 namespace ql {
 namespace com {
@@ -106,6 +109,224 @@ void InteractionMatrix::write_for_program(
     }
 }
 
+/**
+ * Constructs an empty interaction matrix for the given number of qubits.
+ */
+SparseInteractionMatrix::SparseInteractionMatrix(
+    UInt num_qubits
+) : num_qubits(num_qubits) {
+}
+
+/**
+ * Returns the index of the qubit referred to by the given operand, or
+ * utils::MAX if the operand is not a reference to a single qubit.
+ */
+static UInt get_qubit_operand(const ir::Ref &ir, const ir::ExpressionRef &op) {
+    auto ref = op->as_reference();
+    if (
+        !ref ||
+        ref->target != ir->platform->qubits ||
+        ref->data_type != ir->platform->qubits->data_type ||
+        ref->indices.size() != 1
+    ) {
+        return MAX;
+    }
+    auto lit = ref->indices[0]->as_int_literal();
+    if (!lit || lit->value < 0) {
+        return MAX;
+    }
+    return (UInt)lit->value;
+}
+
+/**
+ * Calls the given callback for each instruction in the given block and its
+ * structured control-flow sub-blocks that operates on exactly two different
+ * qubits, in program order.
+ */
+void SparseInteractionMatrix::for_each_interaction(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block,
+    const InteractionCallback &callback
+) {
+    for (const auto &statement : block->statements) {
+        if (auto custom = statement->as_custom_instruction()) {
+
+            // Gather the qubit operands, giving up as soon as we find more
+            // than two.
+            UInt qubits[2];
+            UInt num_qubit_operands = 0;
+            auto gather = [&](const Any<ir::Expression> &operands) {
+                for (const auto &op : operands) {
+                    auto qubit = get_qubit_operand(ir, op);
+                    if (qubit == MAX) {
+                        continue;
+                    }
+                    if (num_qubit_operands == 2) {
+                        num_qubit_operands++;
+                        return;
+                    }
+                    qubits[num_qubit_operands++] = qubit;
+                }
+            };
+            gather(custom->instruction_type->template_operands);
+            if (num_qubit_operands <= 2) {
+                gather(custom->operands);
+            }
+            if (num_qubit_operands == 2 && qubits[0] != qubits[1]) {
+                callback(qubits[0], qubits[1]);
+            }
+
+        } else if (auto if_else = statement->as_if_else()) {
+            for (const auto &branch : if_else->branches) {
+                for_each_interaction(ir, branch->body, callback);
+            }
+            if (!if_else->otherwise.empty()) {
+                for_each_interaction(ir, if_else->otherwise, callback);
+            }
+        } else if (auto loop = statement->as_loop()) {
+            for_each_interaction(ir, loop->body, callback);
+        }
+    }
+}
+
+/**
+ * Adds the two-qubit instructions in the given block and its sub-blocks
+ * to the matrix.
+ */
+void SparseInteractionMatrix::add_block(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block
+) {
+    for_each_interaction(ir, block, [this](UInt first, UInt second) {
+        add(first, second);
+    });
+}
+
+/**
+ * Computes the interaction matrix for the given block, including its
+ * structured control-flow sub-blocks.
+ */
+SparseInteractionMatrix SparseInteractionMatrix::from_block(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block
+) {
+    SparseInteractionMatrix matrix{ir::get_num_qubits(ir->platform)};
+    matrix.add_block(ir, block);
+    return matrix;
+}
+
+/**
+ * Computes the interaction matrix for all blocks of the program. The
+ * top-level blocks are processed in parallel using up to the given number
+ * of threads.
+ */
+SparseInteractionMatrix SparseInteractionMatrix::from_program(
+    const ir::Ref &ir,
+    UInt num_threads
+) {
+    SparseInteractionMatrix matrix{ir::get_num_qubits(ir->platform)};
+    if (ir->program.empty()) {
+        return matrix;
+    }
+    const auto &blocks = ir->program->blocks;
+    Vec<SparseInteractionMatrix> partial(blocks.size(), matrix);
+    parallel_for(blocks.size(), num_threads, [&](UInt i) {
+        partial[i].add_block(ir, blocks[i]);
+    });
+    for (const auto &block_matrix : partial) {
+        matrix.merge(block_matrix);
+    }
+    return matrix;
+}
+
+/**
+ * Adds the given count to the entry for the given pair of qubits.
+ */
+void SparseInteractionMatrix::add(UInt first, UInt second, UInt count) {
+    QL_ASSERT(first < num_qubits && second < num_qubits);
+    counts[first * num_qubits + second] += count;
+}
+
+/**
+ * Adds all entries of the given matrix to this matrix. The matrices must
+ * have the same size.
+ */
+void SparseInteractionMatrix::merge(const SparseInteractionMatrix &other) {
+    QL_ASSERT(num_qubits == other.num_qubits);
+    for (const auto &it : other.counts) {
+        counts[it.first] += it.second;
+    }
+}
+
+/**
+ * Returns the number of qubits, i.e. the size of the matrix.
+ */
+UInt SparseInteractionMatrix::get_num_qubits() const {
+    return num_qubits;
+}
+
+/**
+ * Returns the number of two-qubit instructions with the given operands, in
+ * the given order.
+ */
+UInt SparseInteractionMatrix::get_directed(UInt first, UInt second) const {
+    if (first >= num_qubits || second >= num_qubits) {
+        return 0;
+    }
+    auto it = counts.find(first * num_qubits + second);
+    if (it == counts.end()) {
+        return 0;
+    }
+    return it->second;
+}
+
+/**
+ * Returns the number of two-qubit instructions between the given qubits,
+ * regardless of operand order. This corresponds to the entries of the
+ * symmetric matrix computed by InteractionMatrix.
+ */
+UInt SparseInteractionMatrix::get(UInt a, UInt b) const {
+    if (a == b) {
+        return get_directed(a, b);
+    }
+    return get_directed(a, b) + get_directed(b, a);
+}
+
+/**
+ * Returns the number of nonzero (directed) entries.
+ */
+UInt SparseInteractionMatrix::get_num_nonzero() const {
+    return counts.size();
+}
+
+/**
+ * Returns the nonzero (directed) entries, sorted by first and then second
+ * qubit, i.e. in compressed-sparse-row order.
+ */
+Vec<SparseInteractionMatrix::Entry> SparseInteractionMatrix::get_entries() const {
+    Vec<Entry> entries;
+    entries.reserve(counts.size());
+    for (const auto &it : counts) {
+        entries.push_back({it.first / num_qubits, it.first % num_qubits, it.second});
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs) {
+        return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+    });
+    return entries;
+}
+
+/**
+ * Returns the nonzero entries of the matrix as a string, one
+ * `<first> <second> <count>` line per entry.
+ */
+Str SparseInteractionMatrix::get_string() const {
+    StrStrm ss;
+    for (const auto &entry : get_entries()) {
+        ss << "q" << entry.first << " q" << entry.second << " " << entry.count << "\n";
+    }
+    return ss.str();
+}
+
 } // namespace ana
 } // namespace com
 } // namespace ql
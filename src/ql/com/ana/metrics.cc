@@ -100,6 +100,126 @@ void Latency::process_block(const ir::Ref &, const ir::BlockBaseRef &block) {
     value = ir::get_duration_of_block(block);
 }
 
+/**
+ * Returns the number of qubits that are used at least once.
+ */
+utils::UInt Statistics::get_num_qubits_used() const {
+    utils::UInt count = 0;
+    for (auto usage : qubit_usage_count) {
+        if (usage) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * Adds the given per-qubit counters to the given per-qubit counters.
+ */
+static void merge_counters(
+    utils::Vec<utils::UInt> &into,
+    const utils::Vec<utils::UInt> &from
+) {
+    if (into.size() < from.size()) {
+        into.resize(from.size(), 0);
+    }
+    for (utils::UInt i = 0; i < from.size(); i++) {
+        into[i] += from[i];
+    }
+}
+
+/**
+ * Accumulates the statistics of a subsequent block or program into these
+ * statistics. The result is the same as when both had been processed by
+ * the same StatisticsMetric; in particular, the latency is replaced.
+ */
+void Statistics::merge(const Statistics &other) {
+    latency = other.latency;
+    quantum_gate_count += other.quantum_gate_count;
+    multi_qubit_gate_count += other.multi_qubit_gate_count;
+    classical_operation_count += other.classical_operation_count;
+    merge_counters(qubit_usage_count, other.qubit_usage_count);
+    merge_counters(qubit_used_cycle_count, other.qubit_used_cycle_count);
+}
+
+/**
+ * Fused statistics metric, instruction part. Equivalent to the individual
+ * counting metrics.
+ */
+void StatisticsMetric::process_instruction(
+    const ir::Ref &ir,
+    const ir::InstructionRef &instruction
+) {
+    auto num_qubits = ir::get_number_of_qubits_involved(instruction);
+    if (num_qubits) {
+        value.quantum_gate_count++;
+        if (num_qubits > 1) {
+            value.multi_qubit_gate_count++;
+        }
+    }
+
+    // Iterate over the operands in the same way get_operands() would return
+    // them, without copying them into a new list first.
+    auto duration = ir::get_duration_of_instruction(instruction);
+    auto process_operand = [this, &ir, duration](const ir::ExpressionRef &op) {
+        if (auto ref = op->as_reference()) {
+            if (
+                ref->target == ir->platform->qubits &&
+                ref->data_type == ir->platform->qubits->data_type &&
+                ref->indices.size() == 1 &&
+                ref->indices[0]->as_int_literal() &&
+                ref->indices[0]->as_int_literal()->value >= 0
+            ) {
+                auto index = (utils::UInt)ref->indices[0]->as_int_literal()->value;
+                if (index >= value.qubit_usage_count.size()) {
+                    value.qubit_usage_count.resize(index + 1, 0);
+                    value.qubit_used_cycle_count.resize(index + 1, 0);
+                }
+                value.qubit_usage_count[index]++;
+                value.qubit_used_cycle_count[index] += duration;
+            }
+        }
+    };
+    if (auto custom = instruction->as_custom_instruction()) {
+        for (const auto &op : custom->instruction_type->template_operands) {
+            process_operand(op);
+        }
+        for (const auto &op : custom->operands) {
+            process_operand(op);
+        }
+    } else if (auto set = instruction->as_set_instruction()) {
+        value.classical_operation_count++;
+        process_operand(set->lhs);
+        process_operand(set->rhs);
+    } else if (instruction->as_goto_instruction()) {
+        value.classical_operation_count++;
+    }
+}
+
+/**
+ * Fused statistics metric, block part. Computes the latency of top-level
+ * blocks in the same traversal as the instruction-based metrics.
+ */
+void StatisticsMetric::process_block(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block
+) {
+    auto top_level = depth++ == 0;
+    if (top_level) {
+        value.latency = 0;
+    }
+    for (const auto &statement : block->statements) {
+        process_statement(ir, statement);
+        if (top_level) {
+            value.latency = utils::max(
+                value.latency,
+                statement->cycle + ir::get_duration_of_statement(statement)
+            );
+        }
+    }
+    depth--;
+}
+
 } // namespace ana
 } // namespace com
 } // namespace ql
@@ -310,6 +310,13 @@ private:
      */
     utils::Int order_accumulator;
 
+    /**
+     * The commutation flags that the graph is built with, stored in the Graph
+     * annotation.
+     */
+    utils::Bool commute_multi_qubit;
+    utils::Bool commute_single_qubit;
+
     /**
      * Adds a data dependency edge between the nodes of the given two event-node
      * pairs, using the duration of the "from" statement as weight.
@@ -494,7 +501,9 @@ public:
     ) :
         block(block),
         gatherer(platform),
-        order_accumulator(0)
+        order_accumulator(0),
+        commute_multi_qubit(commute_multi_qubit),
+        commute_single_qubit(commute_single_qubit)
     {
         gatherer.disable_multi_qubit_commutation = !commute_multi_qubit;
         gatherer.disable_single_qubit_commutation = !commute_single_qubit;
@@ -512,7 +521,7 @@ public:
         // Graph annotation.
         source.emplace();
         sink.emplace();
-        block->set_annotation<Graph>({source, sink, 1});
+        block->set_annotation<Graph>({source, sink, 1, commute_multi_qubit, commute_single_qubit});
 
         // Process the statements.
         process_statement(source);
@@ -546,6 +555,25 @@ void build(
     Builder(platform, block, commute_multi_qubit, commute_single_qubit).build();
 }
 
+/**
+ * Same as build(), but if the block already has a data dependency graph
+ * attached to it that was built with the same commutation flags and is still
+ * valid according to is_valid(), that graph is reused instead. Returns whether
+ * the graph was (re)built.
+ */
+utils::Bool build_or_reuse(
+    const ir::PlatformRef &platform,
+    const ir::BlockBaseRef &block,
+    utils::Bool commute_multi_qubit,
+    utils::Bool commute_single_qubit
+) {
+    if (is_valid(block, commute_multi_qubit, commute_single_qubit)) {
+        return false;
+    }
+    build(platform, block, commute_multi_qubit, commute_single_qubit);
+    return true;
+}
+
 } // namespace ddg
 } // namespace com
 } // namespace ql
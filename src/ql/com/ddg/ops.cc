@@ -85,13 +85,60 @@ utils::Int get_direction(const ir::BlockBaseRef &block) {
     }
 }
 
+/**
+ * Returns whether the given block has a data dependency graph attached to it
+ * that is still usable, i.e. one that was built with the given commutation
+ * flags, has not been reversed, and still covers exactly the statements of the
+ * block in their original order. Note that this cannot detect in-place
+ * modifications of the statements themselves; passes that do that must clear
+ * the graph.
+ */
+utils::Bool is_valid(
+    const ir::BlockBaseRef &block,
+    utils::Bool commute_multi_qubit,
+    utils::Bool commute_single_qubit
+) {
+    auto graph = block->get_annotation_ptr<Graph>();
+    if (!graph) {
+        return false;
+    }
+    if (
+        graph->direction != 1 ||
+        graph->commute_multi_qubit != commute_multi_qubit ||
+        graph->commute_single_qubit != commute_single_qubit
+    ) {
+        return false;
+    }
+
+    // The builder numbers the nodes in statement order, starting from 1 after
+    // the source, so statements that were inserted, removed, or reordered
+    // since the graph was built break the sequence.
+    utils::Int order = 1;
+    for (const auto &statement : block->statements) {
+        auto node = statement->get_annotation_ptr<NodeRef>();
+        if (!node || (*node)->order != order) {
+            return false;
+        }
+        order++;
+    }
+    auto sink = get_sink_node(block);
+    return !sink.empty() && sink->order == order;
+}
+
 /**
  * Removes the data dependency graph annotations from the given block.
  */
 void clear(const ir::BlockBaseRef &block) {
-    block->erase_annotation<Graph>();
+    if (auto graph = block->get_annotation_ptr<Graph>()) {
+        graph->source->erase_annotation<NodeRef>();
+        graph->source->erase_annotation<Remaining>();
+        graph->sink->erase_annotation<NodeRef>();
+        graph->sink->erase_annotation<Remaining>();
+        block->erase_annotation<Graph>();
+    }
     for (const auto &statement : block->statements) {
         statement->erase_annotation<NodeRef>();
+        statement->erase_annotation<Remaining>();
     }
 }
 
@@ -135,7 +182,38 @@ void reverse(const ir::BlockBaseRef &block) {
     reverse_statement(graph.sink);
 }
 
+/**
+ * Updates the instruction order of the nodes of the (forward) data dependency
+ * graph associated with the given block to match the current order of the
+ * statements in the block. This must be called after a pass reorders the
+ * statements in a way that respects the dependencies, such as a scheduler, to
+ * keep the graph valid for reuse by subsequent passes. The resulting orders
+ * are the same as those a rebuild of the graph would produce.
+ */
+void renumber(const ir::BlockBaseRef &block) {
+    QL_ASSERT(get_direction(block) == 1);
+    utils::Int order = 0;
+    get_source(block)->get_annotation<NodeRef>()->order = order++;
+    for (const auto &statement : block->statements) {
+        statement->get_annotation<NodeRef>()->order = order++;
+    }
+    get_sink(block)->get_annotation<NodeRef>()->order = order;
+}
+
+/**
+ * Add the Remaining annotation to nodes in the graph.
+ * Remaining gives the remaining length of the critical path.
+ * Can be used to e.g. compare which gate is most critical.
+ */
 void add_remaining(const ir::BlockBaseRef &block) {
+
+    // Values computed for an earlier graph (the graph may be reused between
+    // passes) must not leak into the maximum below.
+    get_source(block)->erase_annotation<Remaining>();
+    for (const auto &statement : block->statements) {
+        statement->erase_annotation<Remaining>();
+    }
+
     get_sink(block)->set_annotation<Remaining>({ 0 });
 
     std::set<ir::StatementRef> toVisit;
@@ -83,6 +83,186 @@ public:
 
 };
 
+/**
+ * Precompiled form of a decomposition rule, for rules of which the expansion
+ * consists solely of custom instructions with operands that are either
+ * parameters of the rule, or constants. Applying such a rule does not require
+ * cloning the expansion and traversing it with the expression mapper; the
+ * instructions can be built directly by substituting operands by index. The
+ * compiled form is attached to the decomposition rule as an annotation.
+ */
+struct CompiledRule {
+
+    /**
+     * An operand of an instruction in the expansion.
+     */
+    struct Operand {
+
+        /**
+         * Index of the rule parameter that this operand is replaced with, or
+         * utils::MAX if the operand is a constant.
+         */
+        utils::UInt parameter;
+
+        /**
+         * The constant operand expression, if parameter is utils::MAX.
+         */
+        ir::ExpressionRef constant;
+
+    };
+
+    /**
+     * An instruction in the expansion.
+     */
+    struct Instruction {
+
+        /**
+         * The instruction type.
+         */
+        ir::InstructionTypeLink instruction_type;
+
+        /**
+         * The operands.
+         */
+        utils::Vec<Operand> operands;
+
+        /**
+         * The cycle relative to the start of the expansion.
+         */
+        utils::Int cycle;
+
+    };
+
+    /**
+     * The rule that this was compiled from. Annotations may be copied along
+     * when nodes are cloned, so this is needed to detect such copies.
+     */
+    const ir::InstructionDecomposition *owner = nullptr;
+
+    /**
+     * The number of statements in the expansion when this was compiled.
+     */
+    utils::UInt expansion_size = 0;
+
+    /**
+     * Whether the rule could be compiled. If not, the generic method must be
+     * used.
+     */
+    utils::Bool valid = false;
+
+    /**
+     * The instructions that the rule expands to.
+     */
+    utils::Vec<Instruction> instructions;
+
+};
+
+/**
+ * Compiles the given decomposition rule.
+ */
+static CompiledRule compile_rule(const ir::InstructionDecomposition &rule) {
+    CompiledRule compiled;
+    compiled.owner = &rule;
+    compiled.expansion_size = rule.expansion.size();
+    if (!rule.objects.empty()) {
+        return compiled;
+    }
+
+    // Returns the index of the parameter that the given expression refers to,
+    // or utils::MAX if it does not refer to a parameter.
+    auto get_parameter = [&rule](const ir::Reference &ref) -> utils::UInt {
+        const ir::Object *target = ref.target.get_ptr().get();
+        for (utils::UInt i = 0; i < rule.parameters.size(); i++) {
+            if (target == rule.parameters[i].get_ptr().get()) {
+                return i;
+            }
+        }
+        return utils::MAX;
+    };
+
+    for (const auto &stmt : rule.expansion) {
+        auto insn = stmt->as_custom_instruction();
+        if (!insn) {
+            return compiled;
+        }
+        CompiledRule::Instruction compiled_insn;
+        compiled_insn.instruction_type = insn->instruction_type;
+        compiled_insn.cycle = insn->cycle;
+        for (const auto &op : insn->operands) {
+            CompiledRule::Operand compiled_op;
+            compiled_op.parameter = utils::MAX;
+            if (auto ref = op->as_reference()) {
+                compiled_op.parameter = get_parameter(*ref);
+                if (compiled_op.parameter == utils::MAX) {
+
+                    // References to other objects are fine, as long as they
+                    // don't refer to parameters through their indices.
+                    for (const auto &index : ref->indices) {
+                        if (!index->as_literal()) {
+                            return compiled;
+                        }
+                    }
+                    compiled_op.constant = op;
+
+                }
+            } else if (op->as_literal()) {
+                compiled_op.constant = op;
+            } else {
+                return compiled;
+            }
+            compiled_insn.operands.push_back(std::move(compiled_op));
+        }
+        compiled.instructions.push_back(std::move(compiled_insn));
+    }
+
+    compiled.valid = true;
+    return compiled;
+}
+
+/**
+ * Returns the compiled form of the given decomposition rule, or null if the
+ * rule was not compiled using compile_decomposition_rules() or changed since.
+ * Rules are applied to multiple blocks in parallel while being shared via the
+ * platform, so this must not modify the rule; the caller falls back to the
+ * generic method when null is returned.
+ */
+static const CompiledRule *get_compiled_rule(const ir::DecompositionRef &rule) {
+    auto compiled = rule->get_annotation_ptr<CompiledRule>();
+    if (
+        !compiled ||
+        compiled->owner != rule.get_ptr().get() ||
+        compiled->expansion_size != rule->expansion.size()
+    ) {
+        return nullptr;
+    }
+    return compiled;
+}
+
+/**
+ * Compiles the decomposition rules of the given instruction types and their
+ * specializations.
+ */
+static void compile_decomposition_rules(
+    const utils::Any<ir::InstructionType> &instruction_types
+) {
+    for (const auto &instruction_type : instruction_types) {
+        for (const auto &rule : instruction_type->decompositions) {
+            rule->set_annotation<CompiledRule>(compile_rule(*rule));
+        }
+        compile_decomposition_rules(instruction_type->specializations);
+    }
+}
+
+/**
+ * Compiles the decomposition rules of all instruction types in the given
+ * platform to a form that can be applied more quickly. This must be called
+ * again when rules are added or changed; stale compiled rules are detected
+ * and ignored, but then the slower generic method is used to apply them.
+ */
+void compile_decomposition_rules(const ir::PlatformRef &platform) {
+    compile_decomposition_rules(platform->instructions);
+}
+
 /**
  * Recursively applies all available decomposition rules (that match the
  * predicate, if given) to the given block. Sub-blocks are not considered; in
@@ -102,19 +282,23 @@ utils::UInt apply_decomposition_rules(
 ) {
     DEBUG("decomposing block");
 
-    // Make a list of the statements we haven't processed yet, and clear the
-    // block. We'll add the statements back to the block as we process them.
-    utils::List<ir::StatementRef> remaining;
-    for (const auto &statement : block->statements) {
-        remaining.push_back(statement);
-    }
-    block->statements.reset();
+    // Make a stack of the statements we haven't processed yet, with the next
+    // statement at the back, and clear the block. We'll add the statements
+    // back to the block as we process them. Expansions are pushed onto the
+    // stack, so they are recursively decomposed before we continue with the
+    // next original statement.
+    auto &statements = block->statements.get_vec();
+    utils::Vec<ir::StatementRef> remaining(statements.rbegin(), statements.rend());
+    std::vector<utils::One<ir::Statement>> output;
+    output.reserve(statements.size());
+    statements.clear();
 
     // Process the statements.
     utils::UInt number_of_applications = 0;
+    utils::Vec<ir::StatementRef> expansion;
     while (!remaining.empty()) {
-        auto stmt = remaining.front();
-        remaining.pop_front();
+        auto stmt = std::move(remaining.back());
+        remaining.pop_back();
         utils::Bool rule_applied = false;
         if (auto insn = stmt->as_custom_instruction()) {
             DEBUG("expanding '" << ir::describe(stmt) << "'");
@@ -128,42 +312,70 @@ utils::UInt apply_decomposition_rules(
 
                 DEBUG("   applying rule '" << rule->name << "'");
 
-                DecompositionRuleExpressionMapper mapper;
-
                 QL_ASSERT(rule->objects.empty() && "Currently using variables in decomposition rules is not supported");
-
-                // Figure out how to map the operand placeholders.
                 QL_ASSERT(rule->parameters.size() == insn->operands.size());
-                for (utils::UInt i = 0; i < rule->parameters.size(); i++) {
-                    mapper.operand_map.insert({
-                        rule->parameters[i],
-                        insn->operands[i]
-                    });
-                }
 
-                // Perform the expansion.
-                auto it = remaining.begin();  // the insertion point for expanded instructions
-                for (const auto &orig_exp_stmt : rule->expansion) {
-                    auto exp_stmt = orig_exp_stmt.clone();
-                    DEBUG("   at insertion point: " << (it!=remaining.end() ? ir::describe(*it) : "<end>"));
-                    DEBUG("   from: '" << ir::describe(exp_stmt) << "'");
-                    mapper.process_statement(exp_stmt);
-                    if (ignore_schedule) {
-                        exp_stmt->cycle = stmt->cycle;
-                    } else {
-                        exp_stmt->cycle += stmt->cycle;
+                expansion.clear();
+                auto compiled = get_compiled_rule(rule);
+                if (compiled && compiled->valid) {
+
+                    // Fast path: build the instructions directly.
+                    for (const auto &compiled_insn : compiled->instructions) {
+                        auto exp_insn = utils::make<ir::CustomInstruction>();
+                        exp_insn->instruction_type = compiled_insn.instruction_type;
+                        for (const auto &op : compiled_insn.operands) {
+                            if (op.parameter == utils::MAX) {
+                                exp_insn->operands.add(op.constant.clone());
+                            } else {
+                                exp_insn->operands.add(insn->operands[op.parameter].clone());
+                            }
+                        }
+                        exp_insn->condition = insn->condition;
+                        if (ignore_schedule) {
+                            exp_insn->cycle = stmt->cycle;
+                        } else {
+                            exp_insn->cycle = compiled_insn.cycle + stmt->cycle;
+                        }
+                        DEBUG("   into: '" << ir::describe(exp_insn) << "'");
+                        expansion.push_back(exp_insn);
                     }
-#if 1   // FIXME: copy condition
-                    // copy condition to all suitable expanded instructions
-                    if (auto ci = exp_stmt->as_conditional_instruction()) {
-                        ci->condition = insn->condition;
+
+                } else {
+
+                    // Generic path: clone the expansion and map the
+                    // parameters.
+                    DecompositionRuleExpressionMapper mapper;
+                    for (utils::UInt i = 0; i < rule->parameters.size(); i++) {
+                        mapper.operand_map.insert({
+                            rule->parameters[i],
+                            insn->operands[i]
+                        });
                     }
+                    for (const auto &orig_exp_stmt : rule->expansion) {
+                        auto exp_stmt = orig_exp_stmt.clone();
+                        DEBUG("   from: '" << ir::describe(exp_stmt) << "'");
+                        mapper.process_statement(exp_stmt);
+                        if (ignore_schedule) {
+                            exp_stmt->cycle = stmt->cycle;
+                        } else {
+                            exp_stmt->cycle += stmt->cycle;
+                        }
+#if 1   // FIXME: copy condition
+                        // copy condition to all suitable expanded instructions
+                        if (auto ci = exp_stmt->as_conditional_instruction()) {
+                            ci->condition = insn->condition;
+                        }
 #endif
-                    DEBUG("   into: '" << ir::describe(exp_stmt) << "'");
-                    // insert exp_stmt, any subsequent expansions go *after* this one (i.e. before the next)
-                    it = std::next(remaining.insert(it, exp_stmt));
+                        DEBUG("   into: '" << ir::describe(exp_stmt) << "'");
+                        expansion.push_back(exp_stmt);
+                    }
+
                 }
 
+                // Push the expansion such that its first statement is
+                // processed next.
+                remaining.insert(remaining.end(), expansion.rbegin(), expansion.rend());
+
                 rule_applied = true;
                 break;
             }
@@ -172,9 +384,10 @@ utils::UInt apply_decomposition_rules(
         if (rule_applied) {
             number_of_applications++;
         } else {
-            block->statements.add(stmt);
+            output.push_back(std::move(stmt));
         }
     }
+    statements = std::move(output);
 
     // Make sure that the statements are ordered by cycle. This is only
     // necessary if we respected the schedule of the decomposition rules.
@@ -695,8 +695,9 @@ ir::ProgramRef StructureDecomposer::run(const ir::Ref &ir) {
 ir::ProgramRef decompose_structure(const ir::Ref &ir, utils::Bool check) {
     auto program = StructureDecomposer::run(ir);
 
-    // If we're in debug mode, check postconditions.
-    if (QL_IS_LOG_DEBUG || check) {
+    // If we're in debug mode, check postconditions, unless consistency
+    // checking was disabled.
+    if ((QL_IS_LOG_DEBUG || check) && ir::get_consistency_check_level() != ir::ConsistencyCheckLevel::NONE) {
         auto new_ir = ir.copy();
         new_ir->program = program;
         ir::check_consistency(new_ir);
@@ -4,6 +4,7 @@
 
 #include "ql/com/map/qubit_mapping.h"
 
+#include <algorithm>
 #include "ql/utils/logger.h"
 
 namespace ql {
@@ -39,6 +40,28 @@ QubitMapping::QubitMapping(
     resize(num_qubits, one_to_one, initial_state);
 }
 
+/**
+ * Marks the given real qubit as free, i.e. adds it to free_reals.
+ */
+void QubitMapping::mark_free(UInt real) {
+    QL_ASSERT(free_index[real] == UNDEFINED_QUBIT);
+    free_index[real] = free_reals.size();
+    free_reals.push_back(real);
+}
+
+/**
+ * Marks the given real qubit as used, i.e. removes it from free_reals.
+ */
+void QubitMapping::mark_used(UInt real) {
+    UInt index = free_index[real];
+    QL_ASSERT(index != UNDEFINED_QUBIT);
+    UInt last = free_reals.back();
+    free_reals[index] = last;
+    free_index[last] = index;
+    free_reals.pop_back();
+    free_index[real] = UNDEFINED_QUBIT;
+}
+
 /**
  * Resizes/reinitializes the map.
  *
@@ -51,27 +74,48 @@ void QubitMapping::resize(
     utils::Bool one_to_one,
     QubitState initial_state
 ) {
+
+    // Unmap any virtual qubits that are removed, and forget about any real
+    // qubits that are removed.
+    for (UInt virt = num_qubits; virt < nq; virt++) {
+        UInt real = virt_to_real[virt];
+        if (real != UNDEFINED_QUBIT && real < num_qubits) {
+            real_to_virt[real] = UNDEFINED_QUBIT;
+            mark_free(real);
+        }
+    }
+    for (UInt real = num_qubits; real < nq; real++) {
+        UInt virt = real_to_virt[real];
+        if (virt != UNDEFINED_QUBIT && virt < num_qubits) {
+            virt_to_real[virt] = UNDEFINED_QUBIT;
+        }
+        if (free_index[real] != UNDEFINED_QUBIT) {
+            mark_used(real);
+        }
+    }
+
     virt_to_real.resize(num_qubits);
+    real_to_virt.resize(num_qubits);
     real_state.resize(num_qubits);
+    free_index.resize(num_qubits);
     for (UInt i = nq; i < num_qubits; i++) {
-        if (one_to_one) {
+        virt_to_real[i] = UNDEFINED_QUBIT;
+        real_to_virt[i] = UNDEFINED_QUBIT;
+        free_index[i] = UNDEFINED_QUBIT;
+        real_state[i] = initial_state;
+        if (!one_to_one) {
+            mark_free(i);
+        }
+    }
+    if (one_to_one) {
+        for (UInt i = nq; i < num_qubits; i++) {
             virt_to_real[i] = i;
-        } else {
-            virt_to_real[i] = UNDEFINED_QUBIT;
+            real_to_virt[i] = i;
         }
-        real_state[i] = initial_state;
     }
     nq = num_qubits;
 }
 
-/**
- * Map virtual qubit index to real qubit index.
- */
-UInt &QubitMapping::operator[](UInt v) {
-    QL_ASSERT(v < nq);   // implies v != UNDEFINED_QUBIT
-    return virt_to_real[v];
-}
-
 /**
  * Map virtual qubit index to real qubit index.
  */
@@ -89,17 +133,18 @@ const utils::Vec<utils::UInt> &QubitMapping::get_virt_to_real() const {
 
 /**
  * Map real qubit to the virtual qubit index that is mapped to it (i.e.
- * backward map). When none, return UNDEFINED_QUBIT. This currently loops
- * over all qubits, so it isn't particularly fast.
+ * backward map). When none, return UNDEFINED_QUBIT.
  */
 UInt QubitMapping::get_virtual(UInt real) const {
     QL_ASSERT(real != UNDEFINED_QUBIT);
-    for (UInt virt = 0; virt < nq; virt++) {
-        if (virt_to_real[virt] == real) {
-            return virt;
-        }
-    }
-    return UNDEFINED_QUBIT;
+    return real_to_virt[real];
+}
+
+/**
+ * Returns the underlying real to virtual qubit vector.
+ */
+const utils::Vec<utils::UInt> &QubitMapping::get_real_to_virt() const {
+    return real_to_virt;
 }
 
 /**
@@ -124,24 +169,19 @@ const utils::Vec<QubitState> &QubitMapping::get_state() const {
 }
 
 /**
- * Allocate a real qubit for the given unmapped virtual qubit.
+ * Allocate a real qubit for the given unmapped virtual qubit. Any real qubit
+ * that has no virtual qubit mapped to it may be chosen.
  */
 UInt QubitMapping::allocate(UInt virt) {
     QL_ASSERT(virt_to_real[virt] == UNDEFINED_QUBIT);
-    // check all real indices for being in v2rMap
-    // first one that isn't, is free and is returned
-    for (UInt real = 0; real < nq; real++) {
-        if (get_virtual(real) == UNDEFINED_QUBIT) {
-            // real qubit r was not found in v2rMap
-            // use it to map v
-            virt_to_real[virt] = real;
-            QL_ASSERT(real_state[real] == QubitState::INITIALIZED || real_state[real] == QubitState::NONE);
-            QL_DOUT("allocate(v=" << virt << ") in r=" << real);
-            return real;
-        }
-    }
-    QL_ASSERT(0);    // number of virt qubits <= number of real qubits
-    return UNDEFINED_QUBIT;
+    QL_ASSERT(!free_reals.empty());    // number of virt qubits <= number of real qubits
+    UInt real = free_reals.back();
+    mark_used(real);
+    virt_to_real[virt] = real;
+    real_to_virt[real] = virt;
+    QL_ASSERT(real_state[real] == QubitState::INITIALIZED || real_state[real] == QubitState::NONE);
+    QL_DOUT("allocate(v=" << virt << ") in r=" << real);
+    return real;
 }
 
 /**
@@ -151,10 +191,8 @@ UInt QubitMapping::allocate(UInt virt) {
  */
 void QubitMapping::swap(UInt r0, UInt r1) {
     QL_ASSERT(r0 != r1);
-    UInt v0 = get_virtual(r0);
-    UInt v1 = get_virtual(r1);
-    // QL_DOUT("... swap between ("<< v0<<"<->"<<r0<<","<<v1<<"<->"<<r1<<") and ("<<v0<<"<->"<<r1<<","<<v1<<"<->"<<r0<<" )");
-    // DPRINT("... before swap");
+    UInt v0 = real_to_virt[r0];
+    UInt v1 = real_to_virt[r1];
     QL_ASSERT(v0 != v1);         // also holds when vi == UNDEFINED_QUBIT
 
     if (v0 == UNDEFINED_QUBIT) {
@@ -171,10 +209,36 @@ void QubitMapping::swap(UInt r0, UInt r1) {
         virt_to_real[v1] = r0;
     }
 
-    QubitState ts = real_state[r0];
-    real_state[r0] = real_state[r1];
-    real_state[r1] = ts;
-    // DPRINT("... after swap");
+    real_to_virt[r0] = v1;
+    real_to_virt[r1] = v0;
+
+    // The set of free real qubits only changes when exactly one of the two
+    // was free; in that case the free slot simply moves to the other qubit.
+    if ((v0 == UNDEFINED_QUBIT) != (v1 == UNDEFINED_QUBIT)) {
+        UInt now_free = (v0 == UNDEFINED_QUBIT) ? r1 : r0;
+        UInt now_used = (v0 == UNDEFINED_QUBIT) ? r0 : r1;
+        UInt index = free_index[now_used];
+        free_reals[index] = now_free;
+        free_index[now_free] = index;
+        free_index[now_used] = UNDEFINED_QUBIT;
+    }
+
+    std::swap(real_state[r0], real_state[r1]);
+}
+
+/**
+ * Overwrites this mapping with the given snapshot of a mapping of the same
+ * size. Unlike assignment, this never reallocates; it only copies the
+ * contents of the arrays.
+ */
+void QubitMapping::restore(const QubitMapping &snapshot) {
+    QL_ASSERT(snapshot.nq == nq);
+    std::copy(snapshot.virt_to_real.begin(), snapshot.virt_to_real.end(), virt_to_real.begin());
+    std::copy(snapshot.real_to_virt.begin(), snapshot.real_to_virt.end(), real_to_virt.begin());
+    std::copy(snapshot.real_state.begin(), snapshot.real_state.end(), real_state.begin());
+    std::copy(snapshot.free_index.begin(), snapshot.free_index.end(), free_index.begin());
+    free_reals.resize(snapshot.free_reals.size());
+    std::copy(snapshot.free_reals.begin(), snapshot.free_reals.end(), free_reals.begin());
 }
 
 /**
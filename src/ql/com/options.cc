@@ -36,6 +36,25 @@ Options make_ql_options() {
         }
     ).with_callback([](Option &x){logger::set_log_level(x.as_str());});
 
+    options.add_str(
+        "log_modules",
+        "Log levels for specific modules, overriding log_level, as a "
+        "comma-separated list of `<module>=<level>` pairs. A module is a path "
+        "relative to OpenQL's source directory, such as `pass/map` or "
+        "`com/sch/scheduler`, and includes everything below it. The most "
+        "specific matching module determines the log level of a statement.",
+        ""
+    ).with_callback([](Option &x){logger::set_module_log_levels(x.as_str());});
+
+    options.add_bool(
+        "log_async",
+        "Whether log messages are written to stdout/stderr asynchronously by a "
+        "background thread, without flushing after every line. Errors are "
+        "always flushed immediately. Disable this to keep the log in sync with "
+        "output written by other means, at the cost of performance.",
+        true
+    ).with_callback([](Option &x){logger::set_log_async(x.as_bool());});
+
     //========================================================================//
     // Kernel/gate and other global behavior not related to passes            //
     //========================================================================//
@@ -78,6 +97,61 @@ Options make_ql_options() {
         "only used when %N is used in the `output_prefix` common pass option."
     );
 
+    options.add_str(
+        "platform_cache_dir",
+        "When set to a directory, the result of converting a platform to the "
+        "new IR (including the parsed decomposition rules) is cached in that "
+        "directory, keyed by a hash of the processed platform JSON, the "
+        "architecture, and the OpenQL version. Subsequent runs with the same "
+        "platform then load the converted platform from the cache instead of "
+        "converting it again. The directory is created if it does not exist. "
+        "Caching is disabled when this is empty.",
+        ""
+    );
+
+    options.add_bool(
+        "ir_arena_allocation",
+        "When set, the nodes of programs that are constructed in bulk (when "
+        "converting a program from the API to the new IR and when reading "
+        "cQASM) are allocated from a monotonic memory arena associated with "
+        "the IR, rather than individually on the heap. This makes construction "
+        "and destruction of large programs faster, at the cost of memory for "
+        "nodes that are removed later not being reused until the whole program "
+        "is destroyed."
+    );
+
+    options.add_bool(
+        "output_to_memory",
+        "When set, the files that passes would write during compilation "
+        "(generated code, reports, dot graphs, and so on) are collected in "
+        "memory instead of being written to disk. Compiler.compile() and "
+        "Program.compile() then return them as a dictionary from file name "
+        "(as it would have been written, including the output prefix) to "
+        "file contents."
+    );
+
+    options.add_enum(
+        "ir_consistency_check",
+        "Controls how thoroughly the IR is checked for consistency after it "
+        "is constructed from the API or read from cQASM, and after structure "
+        "decomposition. `full` checks all constraints, `structural` only "
+        "checks that the tree is well-formed and that the program's entry "
+        "point and block names are valid, and `none` disables the checks. "
+        "Only reduce this for trusted inputs: an inconsistent IR may lead to "
+        "undefined behavior in later passes.",
+        "full",
+        {"none", "structural", "full"}
+    );
+
+    options.add_int(
+        "ir_consistency_check_threads",
+        "The maximum number of threads used to check the blocks of the "
+        "program concurrently during a full IR consistency check. `auto` uses "
+        "the amount of hardware concurrency of the machine.",
+        "1",
+        1, utils::MAX, {"auto"}
+    );
+
     //========================================================================//
     // Default pass order                                                     //
     //========================================================================//
@@ -0,0 +1,134 @@
+/** \file
+ * Defines a uniform (bundle-size balancing) list scheduler.
+ */
+
+#include "ql/com/sch/uniform.h"
+
+#include "ql/utils/map.h"
+#include "ql/com/ddg/ops.h"
+#include "ql/com/sch/scheduler.h"
+
+namespace ql {
+namespace com {
+namespace sch {
+
+/**
+ * Schedules the given block such that the number of statements per cycle is
+ * as uniform as possible, without making the schedule longer than the critical
+ * path requires. See the header file for details.
+ */
+void schedule_uniform(
+    const ir::BlockBaseRef &block,
+    const rmgr::CRef &resources,
+    utils::UInt max_resource_block_cycles
+) {
+    QL_DOUT("starting uniform scheduler...");
+
+    // Determine the deadline of each statement from the prescheduled cycle
+    // numbers. The prescheduler started at our sink node, so the absolute
+    // cycle number of our source node is the critical path length, and that
+    // of each statement is the critical path length from that statement to
+    // the sink. Bucket the statements by deadline as well; the number of
+    // buckets is the number of non-empty bundles in a schedule where each
+    // statement is scheduled as late as possible.
+    auto sink = com::ddg::get_sink(block);
+    auto length = utils::abs(com::ddg::get_source(block)->cycle);
+    utils::Map<ir::StatementRef, utils::Int> deadlines;
+    utils::Map<utils::Int, utils::UInt> buckets;
+    for (const auto &statement : block->statements) {
+        auto deadline = length - utils::abs(statement->cycle);
+        deadlines.set(statement) = deadline;
+        buckets.set(deadline)++;
+    }
+    utils::UInt remaining = block->statements.size();
+
+    // The scheduler orders the available statements by critical path length,
+    // which (for statements available in the same cycle) is the same as
+    // ordering them by increasing slack.
+    Scheduler<CriticalPathHeuristic> scheduler(block, resources);
+
+    utils::Int bundle_cycle = -1;
+    utils::UInt bundle_size = 0;
+    utils::Real target_size = 0.0;
+    utils::UInt advanced = 0;
+    while (!scheduler.is_done()) {
+        auto cycle = utils::abs(scheduler.get_cycle());
+
+        // Recompute the target bundle size when we start a new bundle.
+        if (cycle != bundle_cycle) {
+            bundle_cycle = cycle;
+            bundle_size = 0;
+
+            // Statements can only miss their deadline due to resource
+            // constraints. Move them to the bucket for the current cycle, so
+            // all buckets remain in the future.
+            utils::UInt overdue = 0;
+            auto it = buckets.begin();
+            while (it != buckets.end() && it->first < cycle) {
+                overdue += it->second;
+                it = buckets.erase(it);
+            }
+            if (overdue) {
+                buckets.set(cycle) += overdue;
+            }
+
+            if (!buckets.empty()) {
+                target_size = (utils::Real)remaining / (utils::Real)buckets.size();
+            }
+            QL_DOUT(
+                "cycle " << cycle << ": " << remaining << " statements in " <<
+                buckets.size() << " bundles to go, targeting " <<
+                target_size << " statements per bundle"
+            );
+
+        }
+
+        // Schedule the most critical available statement if it has reached
+        // its deadline or the bundle is not yet full.
+        auto statement = scheduler.get_most_critical();
+        if (!statement.empty()) {
+            if (statement == sink) {
+                QL_ASSERT(scheduler.try_schedule(statement));
+                continue;
+            }
+            auto deadline = deadlines.at(statement);
+            if (deadline <= cycle || (utils::Real)bundle_size < target_size) {
+                QL_ASSERT(scheduler.try_schedule(statement));
+                advanced = 0;
+                bundle_size++;
+                remaining--;
+                auto it = buckets.find(utils::max(deadline, cycle));
+                QL_ASSERT(it != buckets.end());
+                if (!--it->second) {
+                    buckets.erase(it);
+                }
+                continue;
+            }
+        }
+
+        // Nothing (more) is to be scheduled in this cycle, so advance to the
+        // next one.
+        if (statement.empty()) {
+            advanced++;
+            if (max_resource_block_cycles && advanced > max_resource_block_cycles) {
+                QL_USER_ERROR(
+                    "scheduling resources seem to be deadlocked! " <<
+                    "The current cycle is " << scheduler.get_cycle()
+                );
+            }
+        }
+        scheduler.advance();
+
+    }
+
+    QL_DOUT(
+        "uniform scheduler done; schedule takes " <<
+        utils::abs(sink->cycle) << " cycles"
+    );
+    scheduler.convert_cycles();
+
+}
+
+} // namespace sch
+} // namespace com
+} // namespace ql
@@ -150,15 +150,25 @@ void Topology::dump_docs(std::ostream &os, const utils::Str &line_prefix) {
 void Topology::generate_neighbors_list(utils::UInt qs, Neighbors &qubits) const {
     QL_ASSERT(connectivity == GridConnectivity::FULL);
 
-    // Generate neighbors for qubit qs for full connectivity per core.
-    for (utils::UInt qd = 0; qd < num_qubits; qd++) {
-        if (qs == qd) {
-            continue;
+    // Generate neighbors for qubit qs for full connectivity per core. All
+    // qubits in the same core are neighbors, and communication qubits are
+    // also connected to the communication qubits of all other cores. Only
+    // visit those ranges rather than all qubits.
+    auto src_core = get_core_index(qs);
+    auto src_comm = is_comm_qubit(qs);
+    for (utils::UInt core = 0; core < num_cores; core++) {
+        auto first = core * num_qubits_per_core;
+        auto last = first;
+        if (core == src_core) {
+            last += num_qubits_per_core;
+        } else if (src_comm) {
+            last += num_comm_qubits;
         }
-        if (!are_comm_qubits(qs, qd) && is_inter_core_hop(qs, qd)) {
-            continue;
+        for (utils::UInt qd = first; qd < last; qd++) {
+            if (qd != qs) {
+                qubits.push_back(qd);
+            }
         }
-        qubits.push_back(qd);
     }
 }
 
@@ -670,6 +680,13 @@ utils::UInt Topology::get_core_index(Qubit qubit) const {
     return qubit / num_qubits_per_core;
 }
 
+/**
+ * Returns the number of communication qubits per core.
+ */
+utils::UInt Topology::get_num_comm_qubits() const {
+    return num_comm_qubits;
+}
+
 /**
  * Returns whether communication between the given two qubits involves
  * inter-core communication.
@@ -756,6 +773,84 @@ utils::UInt Topology::get_min_hops(Qubit source, Qubit target) const {
     return min_hops;
 }
 
+/**
+ * Returns the neighbors n of src from which tgt can be reached in fewer than
+ * budget hops, i.e. get_distance(n, tgt) < budget, in the same order as
+ * get_neighbors(src). For multi-core topologies, detours via cores other than
+ * those of src and tgt are not returned, and the candidates are generated per
+ * class of qubits rather than by scanning all qubits; see the header.
+ */
+Topology::Neighbors Topology::get_path_neighbors(Qubit src, Qubit tgt, utils::UInt budget) const {
+    Neighbors result;
+    if (budget == 0) {
+        return result;
+    }
+
+    // Single-core topologies have no structure to exploit, so just filter
+    // the neighbor list.
+    if (num_cores == 1) {
+        result = get_neighbors(src);
+        result.remove_if([this, tgt, budget](Qubit n) {
+            return get_distance(n, tgt) >= budget;
+        });
+        return result;
+    }
+
+    auto src_core = get_core_index(src);
+    auto tgt_core = get_core_index(tgt);
+
+    // When qubits have coordinates, the neighbor lists are pregenerated and
+    // sorted by angle, so we have to filter those to retain that order.
+    if (has_coordinates()) {
+        result = neighbors.get(src);
+        result.remove_if([this, tgt, budget, src_core, tgt_core](Qubit n) {
+            auto core = get_core_index(n);
+            if (core != src_core && core != tgt_core) {
+                return true;
+            }
+            return get_distance(n, tgt) >= budget;
+        });
+        return result;
+    }
+
+    // Adds the qubits in [first, last) except src when their distance to tgt
+    // is within budget. Within a core, this distance is the same for all
+    // qubits of the same kind (communication or not), except for tgt itself.
+    auto add_range = [&result, src, tgt, budget](Qubit first, Qubit last, utils::UInt dist) {
+        if (dist < budget) {
+            for (auto n = first; n < last; n++) {
+                if (n != src) {
+                    result.push_back(n);
+                }
+            }
+        } else if (tgt >= first && tgt < last && tgt != src) {
+            result.push_back(tgt);
+        }
+    };
+    utils::UInt tgt_penalty = is_comm_qubit(tgt) ? 0 : 1;
+    for (utils::UInt core = 0; core < num_cores; core++) {
+        if (core != src_core && core != tgt_core) {
+            continue;
+        }
+        if (core != src_core && !is_comm_qubit(src)) {
+            continue;
+        }
+        auto first = core * num_qubits_per_core;
+        auto first_normal = first + num_comm_qubits;
+        auto last = first + num_qubits_per_core;
+        if (core == tgt_core) {
+            add_range(first, first_normal, 1);
+            if (core == src_core) {
+                add_range(first_normal, last, 1);
+            }
+        } else {
+            add_range(first, first_normal, 1 + tgt_penalty);
+            add_range(first_normal, last, 2 + tgt_penalty);
+        }
+    }
+    return result;
+}
+
 /**
  * Returns whether qubits have coordinates associated with them.
  */
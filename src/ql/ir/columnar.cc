@@ -0,0 +1,357 @@
+/** \file
+ * Columnar export of the instructions of a (scheduled) block, for consumption
+ * by external analysis tools without going through cQASM.
+ */
+
+#include "ql/ir/columnar.h"
+
+#include <algorithm>
+#include <functional>
+#include "ql/utils/exception.h"
+#include "ql/utils/map.h"
+#include "ql/ir/compat/gate.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/ops.h"
+
+namespace ql {
+namespace ir {
+
+/**
+ * String conversion for Column.
+ */
+std::ostream &operator<<(std::ostream &os, Column column) {
+    switch (column) {
+        case Column::INSTRUCTION:    os << "instruction";    break;
+        case Column::CYCLE:          os << "cycle";          break;
+        case Column::DURATION:       os << "duration";       break;
+        case Column::QUBITS:         os << "qubits";         break;
+        case Column::BITS:           os << "bits";           break;
+        case Column::CONDITION:      os << "condition";      break;
+        case Column::CONDITION_BITS: os << "condition_bits"; break;
+    }
+    return os;
+}
+
+/**
+ * Parses a column name as printed by operator<<. Throws a user error if the
+ * name is not recognized.
+ */
+Column parse_column(const utils::Str &name) {
+    for (utils::UInt i = 0; i < NUM_COLUMNS; i++) {
+        auto column = static_cast<Column>(i);
+        if (utils::to_string(column) == name) {
+            return column;
+        }
+    }
+    QL_USER_ERROR("unknown schedule column \"" << name << "\"");
+}
+
+/**
+ * Returns the number of values per instruction for the given column.
+ */
+utils::UInt ColumnarBlock::get_width(Column column) const {
+    switch (column) {
+        case Column::QUBITS:         return num_qubit_operands;
+        case Column::BITS:           return num_bit_operands;
+        case Column::CONDITION_BITS: return 2;
+        default:                     return 1;
+    }
+}
+
+/**
+ * Returns the offset of the given column in data, in elements.
+ */
+utils::UInt ColumnarBlock::get_offset(Column column) const {
+    utils::UInt offset = 0;
+    for (utils::UInt i = 0; i < static_cast<utils::UInt>(column); i++) {
+        offset += get_width(static_cast<Column>(i)) * num_instructions;
+    }
+    return offset;
+}
+
+/**
+ * Returns a pointer to the start of the given column.
+ */
+const utils::Int *ColumnarBlock::get_column(Column column) const {
+    return data.data() + get_offset(column);
+}
+
+namespace {
+
+/**
+ * The operands and condition of a single instruction, gathered before the
+ * widths of the operand columns are known.
+ */
+struct Row {
+    utils::Int instruction;
+    utils::Int cycle;
+    utils::Int duration;
+    utils::Vec<utils::Int> qubits;
+    utils::Vec<utils::Int> bits;
+    utils::Int condition = -1;
+    utils::Int condition_bits[2] = {-1, -1};
+};
+
+/**
+ * Helper class for export_columnar().
+ */
+class Exporter {
+private:
+
+    /**
+     * The IR that the block belongs to.
+     */
+    const Ref &ir;
+
+    /**
+     * The number of qubits, used as the offset for explicit bit registers.
+     */
+    utils::UInt num_qubits;
+
+    /**
+     * The explicit bit register object, if any.
+     */
+    ObjectLink breg_ob;
+
+public:
+
+    /**
+     * Constructs an exporter for the given IR.
+     */
+    explicit Exporter(const Ref &ir) : ir(ir) {
+        if (!ir->program.empty() && ir->program->has_annotation<ObjectUsage>()) {
+            num_qubits = ir->program->get_annotation<ObjectUsage>().num_qubits;
+        } else {
+            num_qubits = get_num_qubits(ir->platform);
+        }
+        breg_ob = find_physical_object(ir, "breg");
+    }
+
+    /**
+     * Returns the old-style bit index for the given expression if it is a
+     * reference to a single bit, or -1 if it is not.
+     */
+    utils::Int get_bit(const ExpressionRef &expr) const {
+        auto ref = expr->as_reference();
+        if (!ref || ref->indices.size() != 1 || !ref->indices[0]->as_int_literal()) {
+            return -1;
+        }
+        auto index = ref->indices[0]->as_int_literal()->value;
+        if (
+            ref->target == ir->platform->qubits &&
+            ref->data_type == ir->platform->default_bit_type
+        ) {
+            return index;
+        } else if (
+            !breg_ob.empty() &&
+            ref->target == breg_ob &&
+            ref->data_type == breg_ob->data_type
+        ) {
+            return index + (utils::Int)num_qubits;
+        }
+        return -1;
+    }
+
+    /**
+     * Appends the qubit and bit operands referred to by the given expression
+     * to the given row. Operands of any other kind are ignored.
+     */
+    void add_operand(const ExpressionRef &expr, Row &row) const {
+        auto ref = expr->as_reference();
+        if (!ref || ref->indices.size() != 1 || !ref->indices[0]->as_int_literal()) {
+            return;
+        }
+        if (
+            ref->target == ir->platform->qubits &&
+            ref->data_type == ir->platform->qubits->data_type
+        ) {
+            row.qubits.push_back(ref->indices[0]->as_int_literal()->value);
+        } else {
+            auto bit = get_bit(expr);
+            if (bit >= 0) {
+                row.bits.push_back(bit);
+            }
+        }
+    }
+
+    /**
+     * Converts the given instruction condition to the corresponding
+     * compat::ConditionType and operands, using the same interpretation as
+     * the new-to-old IR conversion. Leaves the condition at -1 if this is not
+     * possible.
+     */
+    void set_condition(const ExpressionRef &condition, Row &row) const {
+        using compat::ConditionType;
+        auto set = [&row](ConditionType type, utils::Int a = -1, utils::Int b = -1) {
+            row.condition = static_cast<utils::Int>(type);
+            row.condition_bits[0] = a;
+            row.condition_bits[1] = b;
+        };
+        if (auto blit = condition->as_bit_literal()) {
+            set(blit->value ? ConditionType::ALWAYS : ConditionType::NEVER);
+            return;
+        }
+        auto bit = get_bit(condition);
+        if (bit >= 0) {
+            set(ConditionType::UNARY, bit);
+            return;
+        }
+        auto fn = condition->as_function_call();
+        if (!fn) {
+            return;
+        }
+        const auto &name = fn->function_type->name;
+        if (name == "operator!" || name == "operator~") {
+            if (fn->operands.size() != 1) {
+                return;
+            }
+            bit = get_bit(fn->operands[0]);
+            if (bit >= 0) {
+                set(ConditionType::NOT, bit);
+                return;
+            }
+            auto fn2 = fn->operands[0]->as_function_call();
+            if (!fn2 || fn2->operands.size() != 2) {
+                return;
+            }
+            auto a = get_bit(fn2->operands[0]);
+            auto b = get_bit(fn2->operands[1]);
+            if (a < 0 || b < 0) {
+                return;
+            }
+            const auto &name2 = fn2->function_type->name;
+            if (name2 == "operator&" || name2 == "operator&&") {
+                set(ConditionType::NAND, a, b);
+            } else if (name2 == "operator|" || name2 == "operator||") {
+                set(ConditionType::NOR, a, b);
+            } else if (name2 == "operator^" || name2 == "operator^^" || name2 == "operator!=") {
+                set(ConditionType::NXOR, a, b);
+            } else if (name2 == "operator==") {
+                set(ConditionType::XOR, a, b);
+            }
+            return;
+        }
+        if (fn->operands.size() != 2) {
+            return;
+        }
+        auto a = get_bit(fn->operands[0]);
+        auto b = get_bit(fn->operands[1]);
+        if (a < 0 || b < 0) {
+            return;
+        }
+        if (name == "operator&" || name == "operator&&") {
+            set(ConditionType::AND, a, b);
+        } else if (name == "operator|" || name == "operator||") {
+            set(ConditionType::OR, a, b);
+        } else if (name == "operator^" || name == "operator^^" || name == "operator!=") {
+            set(ConditionType::XOR, a, b);
+        } else if (name == "operator==") {
+            set(ConditionType::NXOR, a, b);
+        }
+    }
+
+};
+
+} // anonymous namespace
+
+/**
+ * Exports the instructions of the given block to columnar form. Structured
+ * control-flow statements are not exported, as their bodies are scheduled
+ * separately. The block is expected to belong to the given IR, which should
+ * be compatible with the old IR (i.e. have been constructed via
+ * convert_old_to_new()).
+ */
+ColumnarBlock export_columnar(const Ref &ir, const BlockBaseRef &block) {
+    ColumnarBlock result;
+    if (auto named = block->as_block()) {
+        result.name = named->name;
+    }
+
+    // Build the instruction name table, and a map from instruction type to
+    // index in it.
+    utils::Map<const InstructionType*, utils::Int> instruction_ids;
+    for (const auto &insn_type : ir->platform->instructions) {
+        instruction_ids.set(insn_type.get_ptr().get()) = (utils::Int)result.instruction_names.size();
+        result.instruction_names.push_back(insn_type->name);
+    }
+    auto set_id = (utils::Int)result.instruction_names.size();
+    result.instruction_names.push_back("set");
+    auto wait_id = (utils::Int)result.instruction_names.size();
+    result.instruction_names.push_back("wait");
+    auto goto_id = (utils::Int)result.instruction_names.size();
+    result.instruction_names.push_back("goto");
+
+    // Gather the rows.
+    Exporter exporter(ir);
+    utils::Vec<Row> rows;
+    for (const auto &stmt : block->statements) {
+        auto insn = stmt.as<Instruction>();
+        if (insn.empty()) {
+            continue;
+        }
+        Row row;
+        row.cycle = stmt->cycle;
+        row.duration = (utils::Int)get_duration_of_instruction(insn);
+        if (auto custom = insn->as_custom_instruction()) {
+            row.instruction = instruction_ids.at(get_generalization(custom->instruction_type).get_ptr().get());
+            for (const auto &operand : get_operands(insn)) {
+                exporter.add_operand(operand, row);
+            }
+        } else if (auto set = insn->as_set_instruction()) {
+            row.instruction = set_id;
+            exporter.add_operand(set->lhs, row);
+        } else if (auto wait = insn->as_wait_instruction()) {
+            row.instruction = wait_id;
+            for (const auto &object : wait->objects) {
+                exporter.add_operand(object, row);
+            }
+        } else if (insn->as_goto_instruction()) {
+            row.instruction = goto_id;
+        } else {
+            QL_ICE("unknown instruction kind in columnar export");
+        }
+        if (auto cond = insn->as_conditional_instruction()) {
+            exporter.set_condition(cond->condition, row);
+        } else {
+            row.condition = static_cast<utils::Int>(compat::ConditionType::ALWAYS);
+        }
+        result.num_qubit_operands = utils::max<utils::UInt>(result.num_qubit_operands, row.qubits.size());
+        result.num_bit_operands = utils::max<utils::UInt>(result.num_bit_operands, row.bits.size());
+        rows.push_back(std::move(row));
+    }
+    result.num_instructions = rows.size();
+
+    // Fill the buffer, column by column.
+    result.data.resize(
+        result.get_offset(Column::CONDITION_BITS) +
+        result.get_width(Column::CONDITION_BITS) * rows.size(),
+        -1
+    );
+    auto fill = [&](Column column, const std::function<void(const Row&, utils::Int*)> &fn) {
+        auto width = result.get_width(column);
+        auto ptr = result.data.data() + result.get_offset(column);
+        for (const auto &row : rows) {
+            fn(row, ptr);
+            ptr += width;
+        }
+    };
+    fill(Column::INSTRUCTION, [](const Row &row, utils::Int *ptr) { *ptr = row.instruction; });
+    fill(Column::CYCLE, [](const Row &row, utils::Int *ptr) { *ptr = row.cycle; });
+    fill(Column::DURATION, [](const Row &row, utils::Int *ptr) { *ptr = row.duration; });
+    fill(Column::QUBITS, [](const Row &row, utils::Int *ptr) {
+        std::copy(row.qubits.begin(), row.qubits.end(), ptr);
+    });
+    fill(Column::BITS, [](const Row &row, utils::Int *ptr) {
+        std::copy(row.bits.begin(), row.bits.end(), ptr);
+    });
+    fill(Column::CONDITION, [](const Row &row, utils::Int *ptr) { *ptr = row.condition; });
+    fill(Column::CONDITION_BITS, [](const Row &row, utils::Int *ptr) {
+        ptr[0] = row.condition_bits[0];
+        ptr[1] = row.condition_bits[1];
+    });
+
+    return result;
+}
+
+} // namespace ir
+} // namespace ql
@@ -4,9 +4,10 @@
 
 #include "ql/ir/consistency.h"
 
-#include <regex>
+#include <unordered_set>
 #include "ql/utils/exception.h"
-#include "ql/utils/set.h"
+#include "ql/utils/thread_pool.h"
+#include "ql/com/options.h"
 #include "ql/ir/ops.h"
 
 namespace ql {
@@ -19,9 +20,10 @@ class ConsistencyChecker : public RecursiveVisitor {
 private:
 
     /**
-     * The set of all block names encountered.
+     * Whether to recurse into the blocks of the program. When false, the
+     * blocks must be checked separately, each with its own checker.
      */
-    utils::Set<utils::Str> block_names;
+    utils::Bool visit_blocks;
 
     /**
      * Whether we're currently traversing the tree inside a loop.
@@ -37,7 +39,7 @@ private:
      * Checks that the given string is a valid identifier.
      */
     static void check_identifier(const utils::Str &what, const utils::Str &s) {
-        if (!std::regex_match(s, IDENTIFIER_RE)) {
+        if (!is_identifier(s)) {
             QL_ICE(what << " \"" << s << "\" is not a valid identifier");
         }
     }
@@ -132,8 +134,66 @@ private:
         }
     }
 
+    /**
+     * Checks the program-level constraints: validity of the entry point, and
+     * validity and uniqueness of the block names.
+     */
+    static void check_program(Program &node) {
+
+        // Check validity of the entry point.
+        utils::Bool ok = false;
+        for (const auto &block : node.blocks) {
+            if (node.entry_point.links_to(block)) {
+                ok = true;
+                break;
+            }
+        }
+        if (!ok) {
+            QL_ICE(
+                "program entry point does not link to block in program root"
+            );
+        }
+
+        // Check block names.
+        std::unordered_set<utils::Str> block_names;
+        block_names.reserve(node.blocks.size());
+        for (const auto &block : node.blocks) {
+            if (!block->name.empty()) {
+                check_identifier("object name", block->name);
+                if (!block_names.insert(block->name).second) {
+                    QL_ICE("duplicate block name " << block->name);
+                }
+            }
+        }
+
+    }
+
 public:
 
+    /**
+     * Constructs a consistency checker. If visit_blocks is false, the blocks
+     * of the program are not checked, and the checker must be given the
+     * implicit bit type of the platform if it is used to check blocks
+     * directly.
+     */
+    explicit ConsistencyChecker(
+        utils::Bool visit_blocks = true,
+        const utils::OptLink<DataType> &implicit_bit_type = {}
+    ) :
+        visit_blocks(visit_blocks),
+        implicit_bit_type(implicit_bit_type)
+    {}
+
+    /**
+     * Performs only the structural checks of the program, i.e. the
+     * program-level constraints. This does not descend into the blocks.
+     */
+    static void check_structure(const Ref &ir) {
+        if (!ir->program.empty()) {
+            check_program(*ir->program);
+        }
+    }
+
     /**
      * Behavior for unknown node types. Assume that means that no check is
      * needed.
@@ -558,21 +618,16 @@ public:
      * Checks the program node.
      */
     void visit_program(Program &node) override {
-        RecursiveVisitor::visit_program(node);
-
-        // Check validity of the entry point.
-        utils::Bool ok = false;
-        for (const auto &block : node.blocks) {
-            if (node.entry_point.links_to(block)) {
-                ok = true;
-                break;
+        if (visit_blocks) {
+            RecursiveVisitor::visit_program(node);
+        } else {
+            for (auto &object : node.objects) {
+                object.visit(*this);
             }
         }
-        if (!ok) {
-            QL_ICE(
-                "program entry point does not link to block in program root"
-            );
-        }
+
+        // Check the entry point and the block names.
+        check_program(node);
 
     }
 
@@ -587,22 +642,6 @@ public:
 
     }
 
-    /**
-     * Checks a block.
-     */
-    void visit_block(Block &node) override {
-        RecursiveVisitor::visit_block(node);
-
-        // Check name.
-        if (!node.name.empty()) {
-            check_identifier("object name", node.name);
-            if (!block_names.insert(node.name).second) {
-                QL_ICE("duplicate block name " << node.name);
-            }
-        }
-
-    }
-
     /**
      * Checks the condition expression of a conditional instruction.
      */
@@ -931,23 +970,86 @@ public:
 };
 
 /**
- * Performs a consistency check of the IR. An exception is thrown if a problem
+ * String representation for ConsistencyCheckLevel.
+ */
+std::ostream &operator<<(std::ostream &os, ConsistencyCheckLevel level) {
+    switch (level) {
+        case ConsistencyCheckLevel::NONE:       os << "none";       break;
+        case ConsistencyCheckLevel::STRUCTURAL: os << "structural"; break;
+        case ConsistencyCheckLevel::FULL:       os << "full";       break;
+    }
+    return os;
+}
+
+/**
+ * Returns the consistency check level selected using the ir_consistency_check
+ * global option.
+ */
+ConsistencyCheckLevel get_consistency_check_level() {
+    const auto &level = com::options::global["ir_consistency_check"].as_str();
+    if (level == "none") {
+        return ConsistencyCheckLevel::NONE;
+    } else if (level == "structural") {
+        return ConsistencyCheckLevel::STRUCTURAL;
+    } else {
+        return ConsistencyCheckLevel::FULL;
+    }
+}
+
+/**
+ * Performs a consistency check of the IR at the level selected using the
+ * ir_consistency_check global option. An exception is thrown if a problem
  * is found. The constraints checked by this must be met on any interface that
  * passes an IR reference, although actually checking it on every interface
  * might be detrimental for performance.
  */
 void check_consistency(const Ref &ir) {
+    const auto &threads = com::options::global["ir_consistency_check_threads"];
+    utils::UInt num_threads;
+    if (threads.as_str() == "auto") {
+        num_threads = utils::get_default_num_threads();
+    } else {
+        num_threads = threads.as_uint();
+    }
+    check_consistency(ir, get_consistency_check_level(), num_threads);
+}
+
+/**
+ * Performs a consistency check of the IR at the given level. For the full
+ * check, the blocks of the program are checked in parallel using up to the
+ * given number of threads.
+ */
+void check_consistency(const Ref &ir, ConsistencyCheckLevel level, utils::UInt num_threads) {
+    if (level == ConsistencyCheckLevel::NONE) {
+        return;
+    }
     try {
 
         // First, check whether the tree itself is well-formed according to
         // tree-gen.
         ir.check_well_formed();
 
-        // The well-formedness check doesn't check any of the additional constraints
-        // that the IR imposes. The visitor pattern is great for doing checks like
-        // this, because it recursively walks through the entire tree by default.
-        ConsistencyChecker consistency_checker;
+        // The well-formedness check doesn't check any of the additional
+        // constraints that the IR imposes. For a structural check, only check
+        // the constraints on the program and its blocks.
+        if (level == ConsistencyCheckLevel::STRUCTURAL) {
+            ConsistencyChecker::check_structure(ir);
+            return;
+        }
+
+        // The visitor pattern is great for doing the full check, because it
+        // recursively walks through the entire tree by default. The blocks
+        // of the program are independent of each other, so we check those
+        // separately, and in parallel when requested.
+        ConsistencyChecker consistency_checker{false};
         ir->visit(consistency_checker);
+        if (!ir->program.empty()) {
+            const auto &blocks = ir->program->blocks;
+            utils::parallel_for(blocks.size(), num_threads, [&](utils::UInt i) {
+                ConsistencyChecker block_checker{true, ir->platform->implicit_bit_type};
+                blocks[i]->visit(block_checker);
+            });
+        }
 
     } catch (utils::Exception &e) {
 
@@ -1543,6 +1543,10 @@ void read(
 ) {
     auto pres = cqver::parse_string(data, fname);
     auto version = cqver::parse_string(data, fname);
+
+    // Allocate the program nodes from the arena for this IR, if enabled.
+    utils::ArenaScope arena_scope(get_program_arena(ir));
+
     if (version <= cqver::Version("1.2")) {
         read_v1(ir, data, fname, options);
     } else if (version == cqver::Version("3.0")) {
@@ -7,6 +7,9 @@
 
 #include "ql/ir/ops.h"
 #include "ql/ir/consistency.h"
+#include "ql/ir/platform_cache.h"
+#include "ql/com/options.h"
+#include "ql/com/dec/rules.h"
 #include "ql/ir/cqasm/read.h"
 #include "ql/arch/architecture.h"
 #include "ql/rmgr/manager.h"
@@ -254,7 +257,7 @@ static void parse_decomposition_rule(
  *
  * See convert_old_to_new(const compat::ProgramRef&) for details.
  */
-Ref convert_old_to_new(const compat::PlatformRef &old) {
+static Ref convert_platform(const compat::PlatformRef &old) {
     QL_DOUT("converting old platform");
 
     Ref ir;
@@ -349,7 +352,7 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
             auto name = template_params.front();
             template_params.pop_front();
             insn->name = name;
-            if (!std::regex_match(insn->name, IDENTIFIER_RE)) {
+            if (!is_identifier(insn->name)) {
                 QL_USER_ERROR("instruction name is not a valid identifier");
             }
 
@@ -359,7 +362,7 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
                 insn->cqasm_name = insn->name;
             } else if (it2->is_string()) {
                 insn->cqasm_name = it2->get<utils::Str>();
-                if (!std::regex_match(insn->cqasm_name, IDENTIFIER_RE)) {
+                if (!is_identifier(insn->cqasm_name)) {
                     QL_USER_ERROR("cQASM name is not a valid identifier");
                 }
             } else {
@@ -737,7 +740,7 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
                 insn->name = template_params.front();
                 insn->cqasm_name = insn->name;
                 template_params.pop_front();
-                if (!std::regex_match(insn->name, IDENTIFIER_RE)) {
+                if (!is_identifier(insn->name)) {
                     throw utils::Exception( // FIXME: QL_USER_ERROR??, also see below
                         "instruction name is not a valid identifier"
                     );
@@ -957,6 +960,15 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
         fn();
     }
 
+    // The specialization indices are maintained while instruction types are
+    // added, but rebuild them once more to be sure they are complete; after
+    // this, the platform is only read, possibly from multiple threads.
+    index_specializations(ir->platform);
+
+    // Likewise, compile the decomposition rules now, such that applying them
+    // doesn't need to modify the platform.
+    com::dec::compile_decomposition_rules(ir->platform);
+
     // Populate platform JSON data.
     ir->platform->data = old->platform_config;
 
@@ -979,6 +991,24 @@ Ref convert_old_to_new(const compat::PlatformRef &old) {
     return ir;
 }
 
+/**
+ * Converts the old platform to the new IR structure, using the on-disk
+ * platform cache if it is enabled.
+ */
+Ref convert_old_to_new(const compat::PlatformRef &old) {
+    if (com::options::global["platform_cache_dir"].as_str().empty()) {
+        return convert_platform(old);
+    }
+    auto cache_key = get_platform_cache_key(old);
+    auto cache_file = get_platform_cache_file(cache_key);
+    auto ir = load_platform_cache(cache_file, cache_key, old);
+    if (ir.empty()) {
+        ir = convert_platform(old);
+        store_platform_cache(cache_file, cache_key, ir);
+    }
+    return ir;
+}
+
 /**
  * Converts a classical operand to an expression.
  */
@@ -1691,6 +1721,9 @@ Ref convert_old_to_new(const compat::ProgramRef &old) {
     QL_DOUT("Convert_old_to_new");
     auto ir = convert_old_to_new(old->platform);
 
+    // Allocate the program nodes from the arena for this IR, if enabled.
+    utils::ArenaScope arena_scope(get_program_arena(ir));
+
     // If there are no kernels in the old program, don't create a program node
     // at all.
     if (old->kernels.empty()) {
@@ -1720,13 +1753,13 @@ Ref convert_old_to_new(const compat::ProgramRef &old) {
 
         // Sanitize and uniquify the kernel name.
         name = std::regex_replace(name, std::regex("[^a-zA-Z0-9_]"), "_");
-        if (!std::regex_match(name, IDENTIFIER_RE)) name = "_" + name;
+        if (!is_identifier(name)) name = "_" + name;
         auto unique_name = name;
         utils::UInt unique_idx = 1;
         while (!names.insert(unique_name).second) {
             unique_name = name + "_" + utils::to_string(unique_idx++);
         }
-        QL_ASSERT(std::regex_match(unique_name, IDENTIFIER_RE));
+        QL_ASSERT(is_identifier(unique_name));
         block->name = unique_name;
 
         // Link the previous block to this one.
@@ -4,6 +4,8 @@
 
 #include "ql/ir/ops.h"
 
+#include <unordered_map>
+#include "ql/com/options.h"
 #include "ql/ir/describe.h"
 #include "ql/ir/old_to_new.h"
 
@@ -67,7 +69,7 @@ utils::Int get_min_int_for(const IntType &ityp) {
 ObjectLink add_physical_object(const Ref &ir, const utils::One<PhysicalObject> &obj) {
 
     // Check its name.
-    if (!std::regex_match(obj->name, IDENTIFIER_RE)) {
+    if (!is_identifier(obj->name)) {
         QL_USER_ERROR(
             "invalid name for new register: \"" <<
             obj->name << "\" is not a valid identifier"
@@ -109,6 +111,181 @@ ObjectLink find_physical_object(const Ref &ir, const utils::Str &name) {
     }
 }
 
+/**
+ * Computes a hash for the given template operand that is consistent with
+ * equals(), i.e. template operands that compare equal have the same hash. Only
+ * the expression types that are commonly used as template operands (qubit
+ * references and integer and bit literals) are hashed by value; all other
+ * expressions just hash by node type, which is correct, but slow.
+ */
+static utils::UInt hash_template_operand(const Expression &expr) {
+    utils::UInt hash = 0;
+    auto combine = [&hash](utils::UInt value) {
+        hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    };
+    combine(static_cast<utils::UInt>(expr.type()));
+    if (auto ref = expr.as_reference()) {
+        combine(reinterpret_cast<utils::UInt>(ref->target.get_ptr().get()));
+        combine(reinterpret_cast<utils::UInt>(ref->data_type.get_ptr().get()));
+        for (const auto &index : ref->indices) {
+            combine(hash_template_operand(*index));
+        }
+    } else if (auto ilit = expr.as_int_literal()) {
+        combine(reinterpret_cast<utils::UInt>(ilit->data_type.get_ptr().get()));
+        combine(static_cast<utils::UInt>(ilit->value));
+    } else if (auto blit = expr.as_bit_literal()) {
+        combine(reinterpret_cast<utils::UInt>(blit->data_type.get_ptr().get()));
+        combine(blit->value);
+    }
+    return hash;
+}
+
+/**
+ * Annotation placed on instruction types to index their specializations by
+ * (the hash of) their last template operand. Platforms with many
+ * specializations of a single instruction (for example one per qubit pair) would
+ * otherwise require a linear scan with deep comparisons for every lookup. The
+ * index is maintained by add_or_find_instruction_type() when specializations
+ * are added, and can be (re)built for a whole platform using
+ * index_specializations(). Lookups never modify it, so they are safe to do
+ * concurrently; when the index is missing or stale, find_specialization()
+ * falls back to a linear scan.
+ */
+struct SpecializationIndex {
+
+    /**
+     * The instruction type that this index was built for. Annotations are
+     * copied along when instruction types are cloned, so this is needed to
+     * detect such copies.
+     */
+    const InstructionType *owner = nullptr;
+
+    /**
+     * The number of specializations when the index was last updated.
+     */
+    utils::UInt num_specializations = 0;
+
+    /**
+     * Map from template operand hash to indices into the specializations list.
+     */
+    std::unordered_map<utils::UInt, utils::Vec<utils::UInt>> buckets;
+
+};
+
+/**
+ * Returns the specialization index of the given instruction type if it exists
+ * and is up-to-date, or null otherwise.
+ */
+static const SpecializationIndex *get_specialization_index(
+    const InstructionType &instruction_type
+) {
+    auto idx = instruction_type.get_annotation_ptr<SpecializationIndex>();
+    if (
+        !idx ||
+        idx->owner != &instruction_type ||
+        idx->num_specializations != instruction_type.specializations.size()
+    ) {
+        return nullptr;
+    }
+    return idx;
+}
+
+/**
+ * Rebuilds the specialization index of the given instruction type.
+ */
+static void build_specialization_index(InstructionType &instruction_type) {
+    const auto &specs = instruction_type.specializations;
+    SpecializationIndex idx;
+    idx.owner = &instruction_type;
+    idx.num_specializations = specs.size();
+    for (utils::UInt i = 0; i < specs.size(); i++) {
+        idx.buckets[hash_template_operand(*specs[i]->template_operands.back())].push_back(i);
+    }
+    instruction_type.set_annotation<SpecializationIndex>(std::move(idx));
+}
+
+/**
+ * Updates the specialization index of the given instruction type after a
+ * specialization was appended to its specializations list.
+ */
+static void index_new_specialization(InstructionType &instruction_type) {
+    const auto &specs = instruction_type.specializations;
+    auto idx = instruction_type.get_annotation_ptr<SpecializationIndex>();
+    if (!idx || idx->owner != &instruction_type || idx->num_specializations + 1 != specs.size()) {
+        build_specialization_index(instruction_type);
+        return;
+    }
+    idx->buckets[hash_template_operand(*specs.back()->template_operands.back())].push_back(specs.size() - 1);
+    idx->num_specializations++;
+}
+
+/**
+ * (Re)builds the specialization indices of the given instruction types and,
+ * recursively, of their specializations.
+ */
+static void index_specializations(const utils::Any<InstructionType> &instruction_types) {
+    for (const auto &instruction_type : instruction_types) {
+        if (!instruction_type->specializations.empty()) {
+            build_specialization_index(*instruction_type);
+            index_specializations(instruction_type->specializations);
+        }
+    }
+}
+
+/**
+ * (Re)builds the indices used to quickly find instruction specializations by
+ * template operand for all instruction types in the given platform. Indices
+ * are maintained automatically when instruction types are added, so this only
+ * needs to be called for platforms that were constructed in another way, such
+ * as by cloning or deserialization. Platforms without up-to-date indices
+ * still work, but specialization lookups are slower.
+ */
+void index_specializations(const PlatformRef &platform) {
+    index_specializations(platform->instructions);
+}
+
+/**
+ * Looks for the direct specialization of the given instruction type with the
+ * given (last) template operand. If found, index is set to its index in the
+ * specializations list and true is returned. This never modifies the
+ * instruction type, so it is safe to use concurrently.
+ */
+static utils::Bool find_specialization(
+    const InstructionType &instruction_type,
+    const Expression &template_operand,
+    utils::UInt &index
+) {
+    const auto &specs = instruction_type.specializations;
+    if (specs.empty()) {
+        return false;
+    }
+
+    // Without an up-to-date index, fall back to a linear scan.
+    auto idx = get_specialization_index(instruction_type);
+    if (!idx) {
+        for (utils::UInt i = 0; i < specs.size(); i++) {
+            if (specs[i]->template_operands.back()->equals(template_operand)) {
+                index = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Look for the operand, confirming hash matches with a full comparison.
+    auto it = idx->buckets.find(hash_template_operand(template_operand));
+    if (it == idx->buckets.end()) {
+        return false;
+    }
+    for (auto i : it->second) {
+        if (specs[i]->template_operands.back()->equals(template_operand)) {
+            index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * Adds an instruction type to the platform, or return the matching instruction
  * type specialization without changing anything in the IR if one already
@@ -128,7 +305,7 @@ static utils::Pair<InstructionTypeLink, utils::Bool> add_or_find_instruction_typ
     QL_ASSERT(instruction_type->generalization.empty());
 
     // Check its name.
-    if (!std::regex_match(instruction_type->name, IDENTIFIER_RE)) {
+    if (!is_identifier(instruction_type->name)) {
         QL_USER_ERROR(
             "invalid name for new instruction type: \"" <<
             instruction_type->name << "\" is not a valid identifier"
@@ -193,15 +370,9 @@ static utils::Pair<InstructionTypeLink, utils::Bool> add_or_find_instruction_typ
 
         // See if the specialization already exists, and if so, recurse into
         // it.
-        auto already_exists = false;
-        for (const auto &spec : ityp->specializations) {
-            if (spec->template_operands.back().equals(op)) {
-                already_exists = true;
-                ityp = spec;
-                break;
-            }
-        }
-        if (already_exists) {
+        utils::UInt spec_index;
+        if (find_specialization(*ityp, *op, spec_index)) {
+            ityp = ityp->specializations[spec_index];
             continue;
         }
 
@@ -231,6 +402,7 @@ static utils::Pair<InstructionTypeLink, utils::Bool> add_or_find_instruction_typ
         // Link the specialization up.
         ityp->specializations.add(spec);
         spec->generalization = ityp;
+        index_new_specialization(*ityp);
         added_anything = true;
 
         // Advance to next.
@@ -570,18 +742,26 @@ void specialize_instruction(
     const InstructionRef &instruction
 ) {
     if (auto custom_insn = instruction->as_custom_instruction()) {
-        utils::Bool specialization_found;
-        do {
-            specialization_found = false;
-            for (const auto &spec : custom_insn->instruction_type->specializations) {
-                if (spec->template_operands.back().equals(custom_insn->operands.front())) {
-                    custom_insn->operands.remove(0);
-                    custom_insn->instruction_type = spec;
-                    specialization_found = true;
-                    break;
-                }
-            }
-        } while (specialization_found);
+        utils::UInt num_template_operands = 0;
+        utils::UInt spec_index;
+        while (
+            num_template_operands < custom_insn->operands.size() &&
+            find_specialization(
+                *custom_insn->instruction_type,
+                *custom_insn->operands[num_template_operands],
+                spec_index
+            )
+        ) {
+            custom_insn->instruction_type = custom_insn->instruction_type->specializations[spec_index];
+            num_template_operands++;
+        }
+
+        // Remove the operands that became template operands in one go, rather
+        // than shifting the operand list for each specialization level.
+        if (num_template_operands) {
+            auto &vec = custom_insn->operands.get_vec();
+            vec.erase(vec.begin(), vec.begin() + num_template_operands);
+        }
     }
 }
 
@@ -674,7 +854,7 @@ FunctionTypeLink add_function_type(
 
     // Check its name.
     if (
-        !std::regex_match(function_type->name, IDENTIFIER_RE) &&
+        !is_identifier(function_type->name) &&
         !utils::starts_with(function_type->name, "operator")
     ) {
         QL_USER_ERROR(
@@ -994,5 +1174,26 @@ utils::UInt get_number_of_qubits_involved(const InstructionRef &insn) {
     return num_qubits;
 }
 
+/**
+ * Returns the memory arena that nodes should be allocated from when
+ * bulk-constructing the program for the given IR, or an empty reference if
+ * arena allocation is disabled through the `ir_arena_allocation` global
+ * option. The arena is created on first use and attached to the root node, so
+ * all bulk construction for one IR shares the same arena. The root node owns
+ * the arena, so nodes allocated from it must not outlive the IR. Use it with
+ * utils::ArenaScope.
+ */
+utils::ArenaRef get_program_arena(const Ref &ir) {
+    if (auto arena = ir->get_annotation_ptr<utils::ArenaRef>()) {
+        return *arena;
+    }
+    if (!com::options::global["ir_arena_allocation"].as_bool()) {
+        return {};
+    }
+    auto arena = std::make_shared<utils::Arena>();
+    ir->set_annotation<utils::ArenaRef>(arena);
+    return arena;
+}
+
 } // namespace ir
 } // namespace ql
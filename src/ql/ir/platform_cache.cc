@@ -0,0 +1,258 @@
+/** \file
+ * Provides an on-disk cache for platforms converted to the new IR.
+ */
+
+#include "ql/ir/platform_cache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include "ql/version.h"
+#include "ql/utils/filesystem.h"
+#include "ql/utils/logger.h"
+#include "ql/com/options.h"
+#include "ql/com/dec/rules.h"
+#include "ql/arch/architecture.h"
+#include "ql/rmgr/manager.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/ops.h"
+
+namespace ql {
+namespace ir {
+
+/**
+ * Magic string at the start of each cache file. Should be changed whenever the
+ * format of the file changes.
+ */
+static const char CACHE_MAGIC[] = "OpenQL platform cache v1\n";
+
+/**
+ * Computes the 64-bit FNV-1a hash of the given data, continuing from the given
+ * hash value. Unlike std::hash, this is stable between runs and builds.
+ */
+static utils::UInt fnv1a(const utils::Str &data, utils::UInt hash = 0xCBF29CE484222325ull) {
+    for (auto c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+/**
+ * Returns the data that the cache key is derived from, i.e. everything that
+ * affects the result of convert_old_to_new() for the given platform.
+ */
+utils::Str get_platform_cache_key(const compat::PlatformRef &old) {
+    utils::StrStrm ss;
+    ss << OPENQL_VERSION_STRING << '\n';
+    ss << old->architecture->family->get_namespace_name() << '.';
+    ss << old->architecture->variant << '\n';
+    ss << old->qubit_count << ' ' << old->creg_count << ' ' << old->breg_count << ' ';
+    ss << old->cycle_time << '\n';
+    ss << old->platform_config.dump() << '\n';
+    ss << old->get_instructions().dump() << '\n';
+    return ss.str();
+}
+
+/**
+ * Calls the given function for each instruction type in the platform, in a
+ * deterministic order, including specializations.
+ */
+static void for_each_instruction_type(
+    const Ref &ir,
+    const std::function<void(const utils::One<InstructionType>&)> &fn
+) {
+    std::function<void(const utils::Any<InstructionType>&)> visit;
+    visit = [&fn, &visit](const utils::Any<InstructionType> &types) {
+        for (const auto &type : types) {
+            fn(type);
+            visit(type->specializations);
+        }
+    };
+    visit(ir->platform->instructions);
+}
+
+/**
+ * Returns the filename of the cache file for the given cache key, based on the
+ * `platform_cache_dir` global option. Returns an empty string if caching is
+ * disabled.
+ */
+utils::Str get_platform_cache_file(const utils::Str &key) {
+    auto dir = com::options::global["platform_cache_dir"].as_str();
+    if (dir.empty()) {
+        return "";
+    }
+    utils::StrStrm ss;
+    ss << dir << "/platform-" << std::hex << std::setw(16) << std::setfill('0');
+    ss << fnv1a(key) << ".cache";
+    return ss.str();
+}
+
+/**
+ * Tries to load the converted platform for the given old platform from the
+ * given cache file, which must have been stored for the given cache key. The
+ * topology, architecture, and resources are taken from the old platform, as
+ * they are in convert_old_to_new(). Returns an empty reference if the file
+ * does not exist or is not a valid cache file for this key; the latter also
+ * results in a warning.
+ */
+Ref load_platform_cache(
+    const utils::Str &filename,
+    const utils::Str &key,
+    const compat::PlatformRef &old
+) {
+    if (!utils::is_file(filename)) {
+        QL_DOUT("platform cache miss: " << filename);
+        return {};
+    }
+    QL_DOUT("loading platform from cache: " << filename);
+
+    try {
+
+        // Read the file in one go; the CBOR reader needs it in memory anyway.
+        std::ifstream ifs(filename, std::ios::in | std::ios::binary);
+        utils::StrStrm buf;
+        buf << ifs.rdbuf();
+        if (!ifs) {
+            throw utils::Exception("failed to read file");
+        }
+        auto data = buf.str();
+
+        // Check the header. We store the full key rather than just the hash,
+        // so hash collisions cannot result in loading the wrong platform.
+        utils::Str magic = CACHE_MAGIC;
+        if (data.compare(0, magic.size(), magic) != 0) {
+            throw utils::Exception("unrecognized file format");
+        }
+        utils::UInt pos = magic.size();
+        auto read_section = [&data, &pos]() {
+            auto eol = data.find('\n', pos);
+            if (eol == utils::Str::npos) {
+                throw utils::Exception("file is truncated");
+            }
+            auto size = std::stoull(data.substr(pos, eol - pos));
+            pos = eol + 1;
+            if (pos + size > data.size()) {
+                throw utils::Exception("file is truncated");
+            }
+            auto section = data.substr(pos, size);
+            pos += size;
+            return section;
+        };
+        if (read_section() != key) {
+            throw utils::Exception("cache key mismatch");
+        }
+        auto inferred = read_section();
+        auto ir = utils::tree::base::deserialize<Root>(read_section());
+
+        // Restore the PrototypeInferred annotations, which are not serialized.
+        utils::UInt index = 0;
+        for_each_instruction_type(ir, [&inferred, &index](const utils::One<InstructionType> &type) {
+            if (index >= inferred.size()) {
+                throw utils::Exception("instruction type count mismatch");
+            }
+            if (inferred[index++] == '1') {
+                type->set_annotation<PrototypeInferred>({});
+            }
+        });
+        if (index != inferred.size()) {
+            throw utils::Exception("instruction type count mismatch");
+        }
+
+        // Annotations are not serialized, so the specialization indices and
+        // compiled decomposition rules have to be rebuilt.
+        index_specializations(ir->platform);
+        com::dec::compile_decomposition_rules(ir->platform);
+
+        // Populate the things that are not serialized (the topology and
+        // architecture are stored as placeholders, see store_platform_cache())
+        // in the same way convert_old_to_new() does, sharing the instances
+        // with the old platform.
+        ir->platform->name = old->name;
+        utils::Ptr<com::Topology> top;
+        top.unwrap() = old->topology.unwrap();
+        ir->platform->topology.populate(top.as_const());
+        ir->platform->architecture.populate(old->architecture);
+        rmgr::CRef resources;
+        resources.emplace(rmgr::Manager::from_defaults(old, {}, ir));
+        ir->platform->resources.populate(resources);
+        ir->platform->set_annotation<compat::PlatformRef>(old);
+
+        return ir;
+
+    } catch (std::exception &e) {
+        QL_WOUT(
+            "ignoring invalid platform cache file " << filename << ": " << e.what()
+        );
+        return {};
+    }
+}
+
+/**
+ * Stores the given freshly converted platform in the given cache file, along
+ * with the given cache key. The file is written atomically, so concurrent
+ * compilations using the same cache directory are safe. Failure to write the
+ * cache only results in a warning.
+ */
+void store_platform_cache(
+    const utils::Str &filename,
+    const utils::Str &key,
+    const Ref &ir
+) {
+    QL_DOUT("storing platform in cache: " << filename);
+    try {
+        utils::Str inferred;
+        for_each_instruction_type(ir, [&inferred](const utils::One<InstructionType> &type) {
+            inferred += type->has_annotation<PrototypeInferred>() ? '1' : '0';
+        });
+
+        // The topology and architecture are taken from the old platform when
+        // the cache is loaded, so serialize them as placeholders; otherwise
+        // deserialization would construct them from scratch, which is part of
+        // the work the cache is supposed to avoid.
+        utils::Str tree;
+        auto topology = ir->platform->topology;
+        auto architecture = ir->platform->architecture;
+        ir->platform->topology = {};
+        ir->platform->architecture = {};
+        try {
+            tree = utils::tree::base::serialize(ir);
+        } catch (...) {
+            ir->platform->topology = topology;
+            ir->platform->architecture = architecture;
+            throw;
+        }
+        ir->platform->topology = topology;
+        ir->platform->architecture = architecture;
+
+        // Write to a temporary file first and then rename it, such that other
+        // processes never see a partially-written file.
+        utils::make_dirs(utils::dir_name(filename));
+        auto temp = filename + ".tmp" + utils::to_string(std::random_device()());
+        {
+            std::ofstream ofs(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+            auto write_section = [&ofs](const utils::Str &section) {
+                ofs << section.size() << '\n' << section;
+            };
+            ofs << CACHE_MAGIC;
+            write_section(key);
+            write_section(inferred);
+            write_section(tree);
+            if (!ofs) {
+                throw utils::Exception("failed to write " + temp);
+            }
+        }
+        if (std::rename(temp.c_str(), filename.c_str()) != 0) {
+            std::remove(temp.c_str());
+            throw utils::Exception("failed to rename " + temp + " to " + filename);
+        }
+
+    } catch (std::exception &e) {
+        QL_WOUT("failed to write platform cache file " << filename << ": " << e.what());
+    }
+}
+
+} // namespace ir
+} // namespace ql
@@ -297,12 +297,19 @@ std::ostream &operator<<(std::ostream &os, const OperandMode &am) {
 
 template <>
 void serialize(const Topology &obj, utils::tree::cbor::MapWriter &map) {
+    if (!obj.is_populated()) {
+        map.append_int("n", -1);
+        return;
+    }
     map.append_int("n", obj->get_num_qubits());
     map.append_binary("j", obj->get_json().dump());
 }
 
 template <>
 Topology deserialize(const utils::tree::cbor::MapReader &map) {
+    if (map.at("n").as_int() < 0) {
+        return Topology();
+    }
     com::CTopologyRef top;
     top.emplace(
         map.at("n").as_int(),
@@ -328,6 +335,11 @@ std::ostream &operator<<(std::ostream &os, const Topology &top) {
 
 template <>
 void serialize(const Architecture &obj, utils::tree::cbor::MapWriter &map) {
+    if (!obj.is_populated()) {
+        map.append_string("n", "");
+        map.append_string("v", "");
+        return;
+    }
     map.append_string("n", obj->family->get_namespace_name());
     map.append_string("v", obj->variant);
 }
@@ -335,6 +347,9 @@ void serialize(const Architecture &obj, utils::tree::cbor::MapWriter &map) {
 template <>
 Architecture deserialize(const utils::tree::cbor::MapReader &map) {
     Architecture wrap;
+    if (map.at("n").as_string().empty()) {
+        return wrap;
+    }
     wrap.populate(arch::Factory().build_from_namespace(
         map.at("n").as_string() + "." + map.at("v").as_string())
     );
@@ -0,0 +1,581 @@
+/** \file
+ * Deterministic generators for large synthetic programs, used for stress
+ * testing and benchmarking.
+ */
+
+#include "ql/ir/synthetic.h"
+
+#include <cmath>
+#include <iomanip>
+#include "ql/utils/exception.h"
+#include "ql/utils/set.h"
+#include "ql/utils/pair.h"
+#include "ql/ir/ops.h"
+
+namespace ql {
+namespace ir {
+namespace synthetic {
+
+/**
+ * Constructs a generator from the given seed.
+ */
+Random::Random(utils::UInt seed) : state(seed ^ 0x9E3779B97F4A7C15ull) {
+    if (!state) {
+        state = 1;
+    }
+}
+
+/**
+ * Returns the next 64-bit pseudo-random number.
+ */
+utils::UInt Random::next() {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * Returns a pseudo-random number in the range [0, n). n must be nonzero.
+ */
+utils::UInt Random::below(utils::UInt n) {
+    return next() % n;
+}
+
+/**
+ * Returns a pseudo-random number in the range [0, 1).
+ */
+utils::Real Random::uniform() {
+    return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * String conversion for Family.
+ */
+std::ostream &operator<<(std::ostream &os, Family family) {
+    switch (family) {
+        case Family::RANDOM:       os << "random";       break;
+        case Family::QFT:          os << "qft";          break;
+        case Family::QAOA:         os << "qaoa";         break;
+        case Family::SURFACE_CODE: os << "surface_code"; break;
+        case Family::NESTED_LOOPS: os << "nested_loops"; break;
+    }
+    return os;
+}
+
+/**
+ * Parses a family name as printed by operator<<. Throws a user error if the
+ * name is not recognized.
+ */
+Family parse_family(const utils::Str &name) {
+    for (auto family : {
+        Family::RANDOM, Family::QFT, Family::QAOA,
+        Family::SURFACE_CODE, Family::NESTED_LOOPS
+    }) {
+        if (utils::to_string(family) == name) {
+            return family;
+        }
+    }
+    QL_USER_ERROR("unknown synthetic program family \"" << name << "\"");
+}
+
+/**
+ * Returns the number of qubits of the generated program.
+ */
+utils::UInt Parameters::get_num_qubits() const {
+    if (family == Family::SURFACE_CODE) {
+        return 2 * distance * distance - 1;
+    }
+    return num_qubits;
+}
+
+/**
+ * Constructs a sink that writes to the given stream.
+ */
+CQasmSink::CQasmSink(std::ostream &os) : os(os) {
+}
+
+/**
+ * Writes the indentation for the current nesting depth.
+ */
+void CQasmSink::indent() {
+    for (utils::UInt i = 0; i < depth; i++) {
+        os << "    ";
+    }
+}
+
+void CQasmSink::begin(utils::UInt num_qubits, utils::UInt max_loop_depth) {
+
+    // Angles are written with full precision and always with a decimal point,
+    // such that they are not mistaken for integers.
+    saved_flags = os.flags();
+    saved_precision = os.precision(17);
+    os << std::showpoint;
+
+    os << "version " << (max_loop_depth ? "1.2" : "1.0") << "\n";
+    os << "qubits " << num_qubits << "\n";
+    if (max_loop_depth) {
+        os << "\n";
+        for (utils::UInt i = 0; i < max_loop_depth; i++) {
+            os << "var i" << i << ": int\n";
+        }
+    }
+    os << "\n";
+}
+
+void CQasmSink::operation(const Operation &op) {
+    indent();
+    if (op.conditional) {
+        os << "cond (b[" << op.condition_bit << "]) ";
+    }
+    os << op.name;
+    auto first = true;
+    for (auto qubit : op.qubits) {
+        os << (first ? " " : ", ") << "q[" << qubit << "]";
+        first = false;
+    }
+    for (auto angle : op.angles) {
+        os << (first ? " " : ", ") << angle;
+        first = false;
+    }
+    os << "\n";
+}
+
+void CQasmSink::begin_loop(utils::UInt iterations) {
+    QL_ASSERT(iterations > 0);
+    indent();
+    os << "foreach (i" << depth << " = 0.." << iterations - 1 << ") {\n";
+    depth++;
+}
+
+void CQasmSink::end_loop() {
+    QL_ASSERT(depth > 0);
+    depth--;
+    indent();
+    os << "}\n";
+}
+
+void CQasmSink::end() {
+    os.flags(saved_flags);
+    os.precision(saved_precision);
+    os.flush();
+}
+
+/**
+ * Constructs a sink that builds a program named name in the given IR.
+ */
+IrSink::IrSink(const Ref &ir, const utils::Str &name) : ir(ir), name(name) {
+}
+
+void IrSink::begin(utils::UInt num_qubits, utils::UInt max_loop_depth) {
+    if (num_qubits > get_num_qubits(ir->platform)) {
+        QL_USER_ERROR(
+            "synthetic program needs " << num_qubits << " qubits, but the " <<
+            "platform only has " << get_num_qubits(ir->platform)
+        );
+    }
+    real_type = find_type(ir, "real");
+
+    ir->program.emplace();
+    ir->program->name = name;
+    ir->program->unique_name = name;
+    auto block = utils::make<Block>();
+    block->name = "main";
+    ir->program->blocks.add(block);
+    ir->program->entry_point = block;
+    blocks = {block.as<BlockBase>()};
+
+    loop_variables.clear();
+    for (utils::UInt i = 0; i < max_loop_depth; i++) {
+        loop_variables.push_back(make_temporary(ir, ir->platform->default_int_type));
+    }
+}
+
+void IrSink::operation(const Operation &op) {
+    utils::Any<Expression> operands;
+    for (auto qubit : op.qubits) {
+        operands.add(make_qubit_ref(ir->platform, qubit));
+    }
+    for (auto angle : op.angles) {
+        if (real_type.empty()) {
+            QL_USER_ERROR("platform has no real type for angle operands");
+        }
+        operands.emplace<RealLiteral>(angle, real_type);
+    }
+    ExpressionRef condition;
+    if (op.conditional) {
+        condition = make_bit_ref(ir, op.condition_bit);
+    }
+    blocks.back()->statements.add(
+        make_instruction(ir->platform, op.name, operands, condition)
+    );
+}
+
+void IrSink::begin_loop(utils::UInt iterations) {
+    QL_ASSERT(iterations > 0);
+    QL_ASSERT(blocks.size() <= loop_variables.size());
+    auto body = utils::make<SubBlock>();
+    blocks.back()->statements.emplace<StaticLoop>(
+        make_reference(ir->platform, loop_variables[blocks.size() - 1]),
+        make_uint_lit(ir->platform, 0),
+        make_uint_lit(ir->platform, iterations - 1),
+        body,
+        0
+    );
+    blocks.push_back(body.as<BlockBase>());
+}
+
+void IrSink::end_loop() {
+    QL_ASSERT(blocks.size() > 1);
+    blocks.pop_back();
+}
+
+void IrSink::end() {
+    QL_ASSERT(blocks.size() == 1);
+    blocks.clear();
+}
+
+namespace {
+
+/**
+ * Generator state shared by the families.
+ */
+class Generator {
+private:
+
+    /**
+     * The generator parameters.
+     */
+    const Parameters &parameters;
+
+    /**
+     * The sink to emit to.
+     */
+    Sink &sink;
+
+    /**
+     * The pseudo-random number generator.
+     */
+    Random rng;
+
+    /**
+     * Operation object reused for all emitted gates, to avoid allocating
+     * memory for each gate.
+     */
+    Operation op;
+
+    /**
+     * Emits a gate without angle operands.
+     */
+    void gate(const char *name, std::initializer_list<utils::UInt> qubits) {
+        op.name = name;
+        op.qubits.assign(qubits.begin(), qubits.end());
+        op.angles.clear();
+        op.conditional = false;
+        sink.operation(op);
+    }
+
+    /**
+     * Emits a single-qubit rotation gate.
+     */
+    void rotation(const char *name, utils::UInt qubit, utils::Real angle) {
+        op.name = name;
+        op.qubits.assign(1, qubit);
+        op.angles.assign(1, angle);
+        op.conditional = false;
+        sink.operation(op);
+    }
+
+    /**
+     * Emits a gate that is conditional on the measurement bit of the given
+     * qubit.
+     */
+    void conditional_gate(utils::UInt bit, const char *name, std::initializer_list<utils::UInt> qubits) {
+        op.name = name;
+        op.qubits.assign(qubits.begin(), qubits.end());
+        op.angles.clear();
+        op.conditional = true;
+        op.condition_bit = bit;
+        sink.operation(op);
+    }
+
+    /**
+     * Emits a controlled phase rotation, decomposed into CNOTs and Z
+     * rotations.
+     */
+    void controlled_phase(utils::UInt control, utils::UInt target, utils::Real angle) {
+        rotation("rz", control, angle / 2);
+        gate("cnot", {control, target});
+        rotation("rz", target, -angle / 2);
+        gate("cnot", {control, target});
+        rotation("rz", target, angle / 2);
+    }
+
+    /**
+     * Emits the given number of random single-qubit gates and CNOTs.
+     */
+    void random_gates(utils::UInt num_gates) {
+        static const char *SINGLE_QUBIT_GATES[] = {"x", "y", "z", "h", "s", "t", "tdag"};
+        auto num_qubits = parameters.num_qubits;
+        for (utils::UInt i = 0; i < num_gates; i++) {
+            if (num_qubits > 1 && rng.uniform() < parameters.two_qubit_density) {
+                auto a = rng.below(num_qubits);
+                auto b = rng.below(num_qubits - 1);
+                if (b >= a) {
+                    b++;
+                }
+                gate("cnot", {a, b});
+            } else {
+                gate(SINGLE_QUBIT_GATES[rng.below(7)], {rng.below(num_qubits)});
+            }
+        }
+    }
+
+    /**
+     * Random circuit family.
+     */
+    void random() {
+        random_gates(parameters.num_gates);
+    }
+
+    /**
+     * Quantum Fourier transform family.
+     */
+    void qft() {
+        auto n = parameters.num_qubits;
+        for (utils::UInt i = 0; i < n; i++) {
+            gate("h", {i});
+            for (utils::UInt j = i + 1; j < n; j++) {
+                controlled_phase(j, i, std::ldexp(M_PI, -(int)(j - i)));
+            }
+        }
+        for (utils::UInt i = 0; i < n / 2; i++) {
+            gate("swap", {i, n - i - 1});
+        }
+    }
+
+    /**
+     * QAOA family, for MaxCut on a random graph.
+     */
+    void qaoa() {
+        auto n = parameters.num_qubits;
+        if (n < 2) {
+            QL_USER_ERROR("QAOA programs need at least two qubits");
+        }
+
+        // Generate the problem graph.
+        auto num_edges = utils::min(n * parameters.degree / 2, n * (n - 1) / 2);
+        utils::Vec<utils::Pair<utils::UInt, utils::UInt>> edges;
+        utils::Set<utils::Pair<utils::UInt, utils::UInt>> edge_set;
+        while (edges.size() < num_edges) {
+            auto a = rng.below(n);
+            auto b = rng.below(n - 1);
+            if (b >= a) {
+                b++;
+            }
+            if (edge_set.insert({utils::min(a, b), utils::max(a, b)}).second) {
+                edges.emplace_back(a, b);
+            }
+        }
+
+        // Emit the layers.
+        for (utils::UInt q = 0; q < n; q++) {
+            gate("h", {q});
+        }
+        for (utils::UInt layer = 0; layer < parameters.num_layers; layer++) {
+            auto gamma = rng.uniform() * M_PI;
+            auto beta = rng.uniform() * M_PI;
+            for (const auto &edge : edges) {
+                gate("cnot", {edge.first, edge.second});
+                rotation("rz", edge.second, 2 * gamma);
+                gate("cnot", {edge.first, edge.second});
+            }
+            for (utils::UInt q = 0; q < n; q++) {
+                rotation("rx", q, 2 * beta);
+            }
+        }
+        for (utils::UInt q = 0; q < n; q++) {
+            gate("measure", {q});
+        }
+    }
+
+    /**
+     * Rotated surface code family. Data qubits come first in row-major order,
+     * followed by the ancillas.
+     */
+    void surface_code() {
+        auto d = parameters.distance;
+        if (d < 2) {
+            QL_USER_ERROR("surface code distance must be at least 2");
+        }
+
+        // Build the stabilizers. The plaquette at corner (i, j) touches data
+        // qubits (i-1, j-1), (i-1, j), (i, j-1), and (i, j), in that order.
+        // Bulk plaquettes alternate between X and Z type, the top and bottom
+        // boundaries host weight-2 X stabilizers, and the left and right
+        // boundaries host weight-2 Z stabilizers.
+        struct Stabilizer {
+            utils::UInt ancilla;
+            utils::Bool is_x;
+            utils::Int data[4];
+        };
+        utils::Vec<Stabilizer> stabilizers;
+        for (utils::UInt i = 0; i <= d; i++) {
+            for (utils::UInt j = 0; j <= d; j++) {
+                auto even = (i + j) % 2 == 0;
+                auto row_boundary = i == 0 || i == d;
+                auto col_boundary = j == 0 || j == d;
+                if (row_boundary && col_boundary) continue;
+                if (row_boundary && !even) continue;
+                if (col_boundary && even) continue;
+                Stabilizer stab;
+                stab.ancilla = d * d + stabilizers.size();
+                stab.is_x = even;
+                utils::UInt k = 0;
+                for (utils::Int r : {(utils::Int)i - 1, (utils::Int)i}) {
+                    for (utils::Int c : {(utils::Int)j - 1, (utils::Int)j}) {
+                        auto valid = r >= 0 && r < (utils::Int)d && c >= 0 && c < (utils::Int)d;
+                        stab.data[k++] = valid ? r * d + c : -1;
+                    }
+                }
+                stabilizers.push_back(stab);
+            }
+        }
+        QL_ASSERT(stabilizers.size() == d * d - 1);
+
+        // X stabilizers visit their data qubits in Z order and Z stabilizers
+        // in N order, which avoids hook errors.
+        static const utils::UInt X_ORDER[] = {0, 1, 2, 3};
+        static const utils::UInt Z_ORDER[] = {0, 2, 1, 3};
+
+        auto num_qubits = parameters.get_num_qubits();
+        for (utils::UInt q = 0; q < num_qubits; q++) {
+            gate("prepz", {q});
+        }
+        for (utils::UInt round = 0; round < parameters.num_rounds; round++) {
+            for (const auto &stab : stabilizers) {
+                if (stab.is_x) gate("h", {stab.ancilla});
+            }
+            for (utils::UInt step = 0; step < 4; step++) {
+                for (const auto &stab : stabilizers) {
+                    auto data = stab.data[stab.is_x ? X_ORDER[step] : Z_ORDER[step]];
+                    if (data < 0) continue;
+                    if (stab.is_x) {
+                        gate("cnot", {stab.ancilla, (utils::UInt)data});
+                    } else {
+                        gate("cnot", {(utils::UInt)data, stab.ancilla});
+                    }
+                }
+            }
+            for (const auto &stab : stabilizers) {
+                if (stab.is_x) gate("h", {stab.ancilla});
+            }
+            for (const auto &stab : stabilizers) {
+                gate("measure", {stab.ancilla});
+            }
+
+            // Reset the ancillas for the next round through feedback.
+            for (const auto &stab : stabilizers) {
+                conditional_gate(stab.ancilla, "x", {stab.ancilla});
+            }
+        }
+        for (utils::UInt q = 0; q < d * d; q++) {
+            gate("measure", {q});
+        }
+    }
+
+    /**
+     * Emits a loop body for the nested loop family, with the given number of
+     * loop levels remaining below it.
+     */
+    void nested_loop_body(utils::UInt remaining_depth) {
+        auto before = parameters.num_gates / 2;
+        random_gates(before);
+        if (remaining_depth) {
+            sink.begin_loop(parameters.loop_iterations);
+            nested_loop_body(remaining_depth - 1);
+            sink.end_loop();
+        }
+        random_gates(parameters.num_gates - before);
+    }
+
+    /**
+     * Nested loop family.
+     */
+    void nested_loops() {
+        if (!parameters.loop_iterations) {
+            QL_USER_ERROR("loops must have at least one iteration");
+        }
+        nested_loop_body(parameters.loop_depth);
+    }
+
+public:
+
+    /**
+     * Constructs a generator.
+     */
+    Generator(const Parameters &parameters, Sink &sink) :
+        parameters(parameters), sink(sink), rng(parameters.seed)
+    {}
+
+    /**
+     * Generates the program.
+     */
+    void run() {
+        auto num_qubits = parameters.get_num_qubits();
+        if (!num_qubits) {
+            QL_USER_ERROR("synthetic programs need at least one qubit");
+        }
+        auto uses_loops = parameters.family == Family::NESTED_LOOPS;
+        sink.begin(num_qubits, uses_loops ? parameters.loop_depth : 0);
+        switch (parameters.family) {
+            case Family::RANDOM:       random();       break;
+            case Family::QFT:          qft();          break;
+            case Family::QAOA:         qaoa();         break;
+            case Family::SURFACE_CODE: surface_code(); break;
+            case Family::NESTED_LOOPS: nested_loops(); break;
+        }
+        sink.end();
+    }
+
+};
+
+} // anonymous namespace
+
+/**
+ * Generates a program with the given parameters into the given sink.
+ */
+void generate(const Parameters &parameters, Sink &sink) {
+    Generator(parameters, sink).run();
+}
+
+/**
+ * Generates a program with the given parameters and writes it as cQASM to the
+ * given stream.
+ */
+void generate_cqasm(const Parameters &parameters, std::ostream &os) {
+    CQasmSink sink(os);
+    generate(parameters, sink);
+}
+
+/**
+ * Generates a program with the given parameters and returns it as cQASM.
+ */
+utils::Str generate_cqasm(const Parameters &parameters) {
+    utils::StrStrm ss;
+    generate_cqasm(parameters, ss);
+    return ss.str();
+}
+
+/**
+ * Generates a program with the given parameters into the given IR, replacing
+ * its program, if any.
+ */
+void generate_ir(const Parameters &parameters, const Ref &ir) {
+    IrSink sink(ir);
+    generate(parameters, sink);
+}
+
+} // namespace synthetic
+} // namespace ir
+} // namespace ql
@@ -5,6 +5,7 @@
 #include "ql/pass/ana/statistics/report.h"
 
 #include "ql/utils/filesystem.h"
+#include "ql/utils/json.h"
 #include "ql/com/ana/metrics.h"
 #include "ql/pmgr/factory.h"
 
@@ -14,6 +15,114 @@ namespace ana {
 namespace statistics {
 namespace report {
 
+/**
+ * Dumps per-qubit counters in the same format as utils::SparseMap does, i.e.
+ * only listing qubits with a nonzero value.
+ */
+static void dump_qubit_counters(
+    const utils::Vec<utils::UInt> &counters,
+    std::ostream &os
+) {
+    os << "{";
+    utils::Bool first = true;
+    for (utils::UInt qubit = 0; qubit < counters.size(); qubit++) {
+        if (!counters[qubit]) {
+            continue;
+        }
+        if (first) {
+            first = false;
+        } else {
+            os << ", ";
+        }
+        os << qubit << ": " << counters[qubit];
+    }
+    os << "}";
+}
+
+/**
+ * Converts per-qubit counters to a JSON object mapping qubit indices to their
+ * nonzero values.
+ */
+static utils::Json qubit_counters_to_json(const utils::Vec<utils::UInt> &counters) {
+    auto json = utils::Json::object();
+    for (utils::UInt qubit = 0; qubit < counters.size(); qubit++) {
+        if (counters[qubit]) {
+            json[utils::to_string(qubit)] = counters[qubit];
+        }
+    }
+    return json;
+}
+
+/**
+ * Converts the given statistics and additional statistics lines to JSON.
+ */
+static utils::Json statistics_to_json(
+    const com::ana::Statistics &stats,
+    const utils::List<utils::Str> &additional
+) {
+    auto json = utils::Json::object();
+    json["duration"] = stats.latency;
+    json["quantum_gates"] = stats.quantum_gate_count;
+    json["multi_qubit_gates"] = stats.multi_qubit_gate_count;
+    json["classical_operations"] = stats.classical_operation_count;
+    json["qubits_used"] = stats.get_num_qubits_used();
+    json["qubit_usage"] = qubit_counters_to_json(stats.qubit_usage_count);
+    json["qubit_cycles"] = qubit_counters_to_json(stats.qubit_used_cycle_count);
+    auto lines = utils::Json::array();
+    for (const auto &line : additional) {
+        lines.push_back(line);
+    }
+    json["additional"] = lines;
+    return json;
+}
+
+/**
+ * Dumps precomputed statistics for a block to the given output stream.
+ */
+static void dump_block_statistics(
+    const com::ana::Statistics &stats,
+    const utils::List<utils::Str> &additional,
+    std::ostream &os,
+    const utils::Str &line_prefix
+) {
+    os << line_prefix << "Duration (assuming no control-flow): " << stats.latency << "\n";
+    os << line_prefix << "Number of quantum gates: " << stats.quantum_gate_count << "\n";
+    os << line_prefix << "Number of multi-qubit gates: " << stats.multi_qubit_gate_count << "\n";
+    os << line_prefix << "Number of classical operations: " << stats.classical_operation_count << "\n";
+    os << line_prefix << "Number of qubits used: " << stats.get_num_qubits_used() << "\n";
+    os << line_prefix << "Qubit cycles use (assuming no control-flow): ";
+    dump_qubit_counters(stats.qubit_used_cycle_count, os);
+    os << "\n";
+    for (const auto &line : additional) {
+        os << line_prefix << "----- " << line << "\n";
+    }
+    os.flush();
+}
+
+/**
+ * Dumps precomputed global statistics for a program to the given output
+ * stream.
+ */
+static void dump_program_statistics(
+    const com::ana::Statistics &stats,
+    const utils::List<utils::Str> &additional,
+    std::ostream &os,
+    const utils::Str &line_prefix
+) {
+    os << line_prefix << "Total duration (assuming no control-flow): " << stats.latency << "\n";
+    os << line_prefix << "Total number of quantum gates: " << stats.quantum_gate_count << "\n";
+    os << line_prefix << "Total number of multi-qubit gates: " << stats.multi_qubit_gate_count << "\n";
+    os << line_prefix << "Total number of classical operations: " << stats.classical_operation_count << "\n";
+    os << line_prefix << "Number of qubits used: " << stats.get_num_qubits_used() << "\n";
+    os << line_prefix << "Qubit cycles use (assuming no control-flow): ";
+    dump_qubit_counters(stats.qubit_used_cycle_count, os);
+    os << "\n";
+    for (const auto &line : additional) {
+        os << line_prefix << line << "\n";
+    }
+    os.flush();
+}
+
 /**
  * Dumps basic statistics for the given kernel to the given output stream.
  */
@@ -23,18 +132,10 @@ void dump(
     std::ostream &os,
     const utils::Str &line_prefix
 ) {
-    using namespace com::ana;
-
-    os << line_prefix << "Duration (assuming no control-flow): " << compute_block<Latency>(ir, block) << "\n";
-    os << line_prefix << "Number of quantum gates: " << compute_block<QuantumGateCount>(ir, block) << "\n";
-    os << line_prefix << "Number of multi-qubit gates: " << compute_block<MultiQubitGateCount>(ir, block) << "\n";
-    os << line_prefix << "Number of classical operations: " << compute_block<ClassicalOperationCount>(ir, block) << "\n";
-    os << line_prefix << "Number of qubits used: " << compute_block<QubitUsageCount>(ir, block).sparse_size() << "\n";
-    os << line_prefix << "Qubit cycles use (assuming no control-flow): " << compute_block<QubitUsedCycleCount>(ir, block) << "\n";
-    for (const auto &line : AdditionalStats::pop(block)) {
-        os << line_prefix << "----- " << line << "\n";
-    }
-    os.flush();
+    dump_block_statistics(
+        com::ana::compute_block<com::ana::StatisticsMetric>(ir, block),
+        AdditionalStats::pop(block), os, line_prefix
+    );
 }
 
 /**
@@ -48,18 +149,53 @@ void dump(
     std::ostream &os,
     const utils::Str &line_prefix
 ) {
-    using namespace com::ana;
-
-    os << line_prefix << "Total duration (assuming no control-flow): " << compute_program<Latency>(ir) << "\n";
-    os << line_prefix << "Total number of quantum gates: " << compute_program<QuantumGateCount>(ir) << "\n";
-    os << line_prefix << "Total number of multi-qubit gates: " << compute_program<MultiQubitGateCount>(ir) << "\n";
-    os << line_prefix << "Total number of classical operations: " << compute_program<ClassicalOperationCount>(ir) << "\n";
-    os << line_prefix << "Number of qubits used: " << compute_program<QubitUsageCount>(ir).sparse_size() << "\n";
-    os << line_prefix << "Qubit cycles use (assuming no control-flow): " << compute_program<QubitUsedCycleCount>(ir) << "\n";
-    for (const auto &line : AdditionalStats::pop(program)) {
-        os << line_prefix << line << "\n";
+    dump_program_statistics(
+        com::ana::compute_program<com::ana::StatisticsMetric>(ir),
+        AdditionalStats::pop(program), os, line_prefix
+    );
+}
+
+/**
+ * Implementation of dump_all(). If json is non-null, the statistics are also
+ * written to it in machine-readable form. The IR is only traversed once: the
+ * global statistics are derived from the statistics of the blocks.
+ */
+static void dump_all(
+    const ir::Ref &ir,
+    std::ostream &os,
+    const utils::Str &line_prefix,
+    utils::Json *json
+) {
+    if (ir->program.empty()) {
+        os << line_prefix << "no program node to dump statistics for" << std::endl;
+        if (json) {
+            *json = utils::Json::object();
+        }
+        return;
+    }
+    com::ana::Statistics global;
+    auto blocks_json = utils::Json::array();
+    for (const auto &block : ir->program->blocks) {
+        auto stats = com::ana::compute_block<com::ana::StatisticsMetric>(ir, block);
+        auto additional = AdditionalStats::pop(block);
+        os << line_prefix << "For block with name \"" << block->name << "\":\n";
+        dump_block_statistics(stats, additional, os, line_prefix + "    ");
+        os << "\n";
+        if (json) {
+            auto block_json = statistics_to_json(stats, additional);
+            block_json["name"] = block->name;
+            blocks_json.push_back(std::move(block_json));
+        }
+        global.merge(stats);
+    }
+    auto additional = AdditionalStats::pop(ir->program);
+    os << line_prefix << "Global statistics:\n";
+    dump_program_statistics(global, additional, os, line_prefix);
+    if (json) {
+        *json = utils::Json::object();
+        (*json)["blocks"] = std::move(blocks_json);
+        (*json)["global"] = statistics_to_json(global, additional);
     }
-    os.flush();
 }
 
 /**
@@ -71,17 +207,7 @@ void dump_all(
     std::ostream &os,
     const utils::Str &line_prefix
 ) {
-    if (ir->program.empty()) {
-        os << line_prefix << "no program node to dump statistics for" << std::endl;
-    } else {
-        for (const auto &block : ir->program->blocks) {
-            os << line_prefix << "For block with name \"" << block->name << "\":\n";
-            dump(ir, block, os, line_prefix + "    ");
-            os << "\n";
-        }
-        os << line_prefix << "Global statistics:\n";
-        dump(ir, ir->program, os, line_prefix);
-    }
+    dump_all(ir, os, line_prefix, nullptr);
 }
 
 bool ReportStatisticsPass::is_pass_registered = pmgr::Factory::register_pass<ReportStatisticsPass>("ana.statistics.Report");
@@ -127,6 +253,13 @@ ReportStatisticsPass::ReportStatisticsPass(
         "use this option to emulate that behavior.",
         ""
     );
+    options.add_str(
+        "json_output_suffix",
+        "Suffix to use for the filename of a machine-readable JSON version of "
+        "the report, written alongside the text report. If empty, no JSON "
+        "report is written.",
+        ""
+    );
 }
 
 /**
@@ -138,7 +271,14 @@ utils::Int ReportStatisticsPass::run(
 ) const {
     auto line_prefix = options["line_prefix"].as_str();
     auto filename = context.output_prefix + options["output_suffix"].as_str();
-    dump_all(ir, utils::OutFile(filename).unwrap(), line_prefix);
+    auto json_suffix = options["json_output_suffix"].as_str();
+    if (json_suffix.empty()) {
+        dump_all(ir, utils::OutFile(filename).unwrap(), line_prefix);
+    } else {
+        utils::Json json;
+        dump_all(ir, utils::OutFile(filename).unwrap(), line_prefix, &json);
+        utils::OutFile(context.output_prefix + json_suffix).write(json.dump(4));
+    }
     return 0;
 }
 
@@ -6,8 +6,8 @@
 
 #include "interaction.h"
 
-#include <fstream>
 #include "ql/utils/json.h"
+#include "ql/utils/filesystem.h"
 #include "common.h"
 #include "image.h"
 
@@ -132,7 +132,7 @@ void generateAndSaveDOTFile(const Str &output_prefix, const Vec<Qubit> &qubits)
     {
         QL_IOUT("Generating DOT file for qubit interaction graph...");
 
-        std::ofstream output(output_prefix + ".dot");
+        OutFile output(output_prefix + ".dot");
         output << "graph qubit_interaction_graph {\n";
         output << "    node [shape=circle];\n";
 
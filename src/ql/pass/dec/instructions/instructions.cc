@@ -149,7 +149,7 @@ DecomposeInstructionsPass::DecomposeInstructionsPass(
     const utils::Ptr<const pmgr::Factory> &pass_factory,
     const utils::Str &instance_name,
     const utils::Str &type_name
-) : pmgr::pass_types::Transformation(pass_factory, instance_name, type_name) {
+) : pmgr::pass_types::BlockTransformation(pass_factory, instance_name, type_name) {
 
     options.add_str(
         "predicate_key",
@@ -184,9 +184,10 @@ DecomposeInstructionsPass::DecomposeInstructionsPass(
 }
 
 /**
- * Runs the instruction decomposer on the given block.
+ * Runs the instruction decomposer on the given block and recursively its
+ * sub-blocks.
  */
-utils::UInt DecomposeInstructionsPass::run_on_block(
+utils::UInt DecomposeInstructionsPass::decompose_block(
     const ir::Ref &ir,
     const ir::BlockBaseRef &block,
     utils::Bool ignore_schedule,
@@ -208,13 +209,13 @@ utils::UInt DecomposeInstructionsPass::run_on_block(
     for (const auto &statement : block->statements) {
         if (auto if_else = statement->as_if_else()) {
             for (const auto &branch : if_else->branches) {
-                number_of_applications += run_on_block(ir, branch->body, ignore_schedule, predicate);
+                number_of_applications += decompose_block(ir, branch->body, ignore_schedule, predicate);
             }
             if (!if_else->otherwise.empty()) {
-                number_of_applications += run_on_block(ir, if_else->otherwise, ignore_schedule, predicate);
+                number_of_applications += decompose_block(ir, if_else->otherwise, ignore_schedule, predicate);
             }
         } else if (auto loop = statement->as_loop()) {
-            number_of_applications += run_on_block(ir, loop->body, ignore_schedule, predicate);
+            number_of_applications += decompose_block(ir, loop->body, ignore_schedule, predicate);
         }
     }
 
@@ -222,17 +223,27 @@ utils::UInt DecomposeInstructionsPass::run_on_block(
 }
 
 /**
- * Runs the instruction decomposer.
+ * Returns that decomposing the instructions in a block does not affect any
+ * other block.
  */
-utils::Int DecomposeInstructionsPass::run(
+utils::Bool DecomposeInstructionsPass::is_block_local() const {
+    return true;
+}
+
+/**
+ * Runs the instruction decomposer on the given top-level block.
+ */
+utils::Int DecomposeInstructionsPass::run_on_block(
     const ir::Ref &ir,
-    const pmgr::pass_types::Context &/* context */
+    const ir::BlockBaseRef &block,
+    const utils::Str &/* block_name */,
+    const pmgr::pass_types::Context &context
 ) const {
 
     // Parse options.
-    auto ignore_schedule = options["ignore_schedule"].as_bool();
-    auto predicate_key = options["predicate_key"].as_str();
-    auto predicate_value = options["predicate_value"].as_str();
+    auto ignore_schedule = context.options["ignore_schedule"].as_bool();
+    auto predicate_key = context.options["predicate_key"].as_str();
+    auto predicate_value = context.options["predicate_value"].as_str();
 
     // Construct the predicate function.
     auto predicate = [predicate_key, predicate_value](const ir::DecompositionRef &rule) {
@@ -248,19 +259,9 @@ utils::Int DecomposeInstructionsPass::run(
         return utils::pattern_match(predicate_value, value);
     };
 
-    // Process the decomposition rules for the whole program.
-    utils::UInt number_of_applications = 0;
-    if (!ir->program.empty()) {
-        for (const auto &block : ir->program->blocks) {
-            try {
-                number_of_applications += run_on_block(ir, block, ignore_schedule, predicate);
-            } catch (utils::Exception &e) {
-                e.add_context("in block " + block->name);
-                throw;
-            }
-        }
-    }
-    return (utils::Int)number_of_applications;
+    // Process the decomposition rules for this block. The number of
+    // applications is summed over all blocks by the pass type.
+    return (utils::Int)decompose_block(ir, block, ignore_schedule, predicate);
 }
 
 } // namespace instructions
@@ -8,6 +8,7 @@
 #include "ql/com/dec/structure.h"
 #include "ql/com/cfg/build.h"
 #include "ql/com/cfg/consistency.h"
+#include "ql/ir/consistency.h"
 #include "ql/com/cfg/dot.h"
 #include "ql/pmgr/pass_types/base.h"
 #include "ql/pmgr/factory.h"
@@ -97,7 +98,9 @@ utils::Int DecomposeStructurePass::run(
     // If requested, write a control-flow graph of the result.
     if (options["write_dot_graph"].as_bool()) {
         com::cfg::build(ir->program);
-        com::cfg::check_consistency(ir->program);
+        if (ir::get_consistency_check_level() != ir::ConsistencyCheckLevel::NONE) {
+            com::cfg::check_consistency(ir->program);
+        }
         com::cfg::dump_dot(ir, utils::OutFile(context.output_prefix + ".dot").unwrap());
         com::cfg::clear(ir->program);
     }
@@ -17,7 +17,8 @@ Alter::Alter(ir::PlatformRef pl, const ir::BlockBaseRef &b, const OptionsRef &op
         path(std::move(pa)),
         leftOpIt(l), rightOpIt(r) {}
 
-void Alter::add_swaps(Past &past, utils::Any<ir::Statement> *output_circuit) const {
+template <class PastType, class AddSwap>
+void Alter::for_each_swap(const PastType &past, AddSwap &&add_swap) const {
     const auto& mode = options->swap_selection_mode;
     if (mode == SwapSelectionMode::ONE || mode == SwapSelectionMode::ALL) {
         utils::UInt max_num_to_add = (mode == SwapSelectionMode::ONE ? 1 : utils::MAX);
@@ -29,14 +30,14 @@ void Alter::add_swaps(Past &past, utils::Any<ir::Statement> *output_circuit) con
         for (auto it = path->begin();
                 swaps_added < max_num_to_add && it != leftOpIt;
                 ++swaps_added, it = std::next(it)) {
-            past.add_swap(*it, *std::next(it), output_circuit);
+            add_swap(*it, *std::next(it));
         }
 
         swaps_added = 0;
         for (auto it = path->rbegin();
                 swaps_added < max_num_to_add && it != rightOpIt;
                 ++swaps_added, it = std::next(it)) {
-            past.add_swap(*it, *std::next(it), output_circuit);
+            add_swap(*it, *std::next(it));
         }
     } else {
         QL_ASSERT(mode == SwapSelectionMode::EARLIEST);
@@ -45,26 +46,54 @@ void Alter::add_swaps(Past &past, utils::Any<ir::Statement> *output_circuit) con
             // Both left and right operands of the 2q gate need to get closer.
             if (past.is_first_swap_earliest(*path->begin(), *std::next(path->begin()),
                                             *path->rbegin(), *std::next(path->rbegin()))) {
-                past.add_swap(*path->begin(), *std::next(path->begin()), output_circuit);
+                add_swap(*path->begin(), *std::next(path->begin()));
             } else {
-                past.add_swap(*path->rbegin(), *std::next(path->rbegin()), output_circuit);
+                add_swap(*path->rbegin(), *std::next(path->rbegin()));
             }
         } else if (leftOpIt != path->begin()) {
             // Right operand of the 2q gate does not move, only left does.
-            past.add_swap(*path->begin(), *std::next(path->begin()), output_circuit);
+            add_swap(*path->begin(), *std::next(path->begin()));
         } else if (rightOpIt != path->rbegin()) {
             // Left operand of the 2q gate does not move, only right does.
-            past.add_swap(*path->rbegin(), *std::next(path->rbegin()), output_circuit);
+            add_swap(*path->rbegin(), *std::next(path->rbegin()));
         }
     }
 }
 
+void Alter::add_swaps(Past &past, utils::Any<ir::Statement> *output_circuit) const {
+    for_each_swap(past, [&past, output_circuit](utils::UInt r0, utils::UInt r1) {
+        past.add_swap(r0, r1, output_circuit);
+    });
+}
+
 void Alter::extend(Past curr_past, const Past &base_past) {
     QL_ASSERT(!score_valid && "Alter::extend() can only be called once!");
     add_swaps(curr_past);
     set_score(curr_past.get_max_free_cycle() - base_past.get_max_free_cycle());
 }
 
+void Alter::extend_all(utils::List<Alter> &alters, const Past &curr_past, const Past &base_past) {
+    if (alters.empty()) {
+        return;
+    }
+
+    // The buffers of the virtual past are allocated once, and reused for
+    // every alternative.
+    VirtualPast virtual_past(curr_past);
+    for (auto &a : alters) {
+        QL_ASSERT(!a.score_valid && "Alter::extend() can only be called once!");
+        virtual_past.reset(curr_past);
+        a.for_each_swap(virtual_past, [&virtual_past](utils::UInt r0, utils::UInt r1) {
+            virtual_past.add_swap(r0, r1);
+        });
+        if (virtual_past.is_valid()) {
+            a.set_score(virtual_past.get_max_free_cycle() - base_past.get_max_free_cycle());
+        } else {
+            a.extend(curr_past, base_past);
+        }
+    }
+}
+
 utils::List<Alter> Alter::create_from_path(const ir::PlatformRef &platform, const ir::BlockBaseRef &block, const OptionsRef &options, ir::CustomInstructionRef gate, std::list<utils::UInt> path) {
     utils::List<Alter> result;
 
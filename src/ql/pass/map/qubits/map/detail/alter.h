@@ -2,6 +2,7 @@
 
 #include "options.h"
 #include "past.h"
+#include "virtual_past.h"
 
 namespace ql {
 namespace pass {
@@ -34,6 +35,15 @@ public:
      */
     void extend(Past curr_past, const Past &base_past);
 
+    /**
+     * Equivalent to calling extend() for each of the given alternatives, but
+     * without copying curr_past or constructing any IR gates. Instead, the
+     * swaps are modelled using a single VirtualPast that is reset for each
+     * alternative. Only when an alternative involves a gate that cannot be
+     * modelled this way is extend() used for it.
+     */
+    static void extend_all(utils::List<Alter> &alters, const Past &curr_past, const Past &base_past);
+
     /**
      * Split the given routing path into alters where the target gate is executed at every possible hop along the path.
      *
@@ -58,6 +68,14 @@ public:
     }
 
 private:
+    /**
+     * Calls add_swap(r0, r1) for each swap that add_swaps() would add to the
+     * given past. PastType is either Past or VirtualPast; it is only used to
+     * determine the earliest swap.
+     */
+    template <class PastType, class AddSwap>
+    void for_each_swap(const PastType &past, AddSwap &&add_swap) const;
+
     Alter(ir::PlatformRef pl, const ir::BlockBaseRef &b, const OptionsRef &opt, ir::CustomInstructionRef g, std::shared_ptr<std::list<utils::UInt>> pa,
         std::list<utils::UInt>::iterator l, std::list<utils::UInt>::reverse_iterator r);
 
@@ -19,7 +19,9 @@ void FreeCycle::initialize(const ir::PlatformRef &p, const OptionsRef &opt) {
     options = opt;
     platform = p;
 
+    qubit_fc.assign(ir::get_num_qubits(platform), 0);
     fcv.clear();
+    max_fc = 0;
 }
 
 /**
@@ -27,13 +29,7 @@ void FreeCycle::initialize(const ir::PlatformRef &p, const OptionsRef &opt) {
  * entries.
  */
 utils::UInt FreeCycle::get_max() const {
-    utils::UInt max_free_cycle = 0;
-    for (const auto &p : fcv) {
-        if (max_free_cycle < p.second) {
-            max_free_cycle = p.second;
-        }
-    }
-    return max_free_cycle;
+    return max_fc;
 }
 
 /**
@@ -105,6 +101,7 @@ void FreeCycle::add(const ir::CustomInstructionRef &g, utils::UInt startCycle) {
         if (!ref.empty()) { 
             QL_ASSERT(get_for_reference(*ref) <= startCycle && "Something went wrong with heuristic scheduling in mapper");
             get_for_reference(*ref) = freeCycle;
+            max_fc = utils::max(max_fc, freeCycle);
         }
     }
 }
@@ -65,6 +65,13 @@ public:
      */
     utils::UInt cycle_extension(const ir::CustomInstructionRef &g) const;
 
+    /**
+     * Returns the first free cycle for each qubit of the main qubit register.
+     */
+    const utils::Vec<utils::UInt> &get_qubit_cycles() const {
+        return qubit_fc;
+    }
+
 private:
     static std::array<utils::UInt, 5> get_indices(const ir::Reference &ref) {
         std::array<utils::UInt, 5> result;
@@ -86,16 +93,39 @@ private:
         return result;
     }
 
+    /**
+     * If ref refers to an element of the main qubit register, sets index to
+     * the qubit index and returns true. Otherwise returns false.
+     */
+    utils::Bool get_qubit_index(const ir::Reference &ref, utils::UInt &index) const {
+        if (
+            ref.target == platform->qubits &&
+            ref.data_type == platform->qubits->data_type &&
+            ref.indices.size() == 1
+        ) {
+            if (auto int_lit = ref.indices[0]->as_int_literal()) {
+                index = int_lit->value;
+                return index < qubit_fc.size();
+            }
+        }
+        return false;
+    }
+
     utils::UInt& get_for_qubit(utils::UInt i) {
-        return get_for_reference(*make_qubit_ref(platform, i));
+        return qubit_fc[i];
     }
 
     utils::UInt get_for_qubit(utils::UInt i) const {
-        return get_for_reference(*make_qubit_ref(platform, i));
+        return qubit_fc[i];
     }
 
     utils::UInt& get_for_reference(const ir::Reference &ref) {
-        auto it = std::find_if(fcv.begin(), fcv.end(), [&ref](std::pair<ir::Reference, utils::UInt> p) {
+        utils::UInt index;
+        if (get_qubit_index(ref, index)) {
+            return qubit_fc[index];
+        }
+
+        auto it = std::find_if(fcv.begin(), fcv.end(), [&ref](const std::pair<ir::Reference, utils::UInt> &p) {
             return p.first.equals(ref);
         });
 
@@ -109,7 +139,12 @@ private:
     }
 
     utils::UInt get_for_reference(const ir::Reference &ref) const {
-        auto it = std::find_if(fcv.begin(), fcv.end(), [&ref](std::pair<ir::Reference, utils::UInt> p) {
+        utils::UInt index;
+        if (get_qubit_index(ref, index)) {
+            return qubit_fc[index];
+        }
+
+        auto it = std::find_if(fcv.begin(), fcv.end(), [&ref](const std::pair<ir::Reference, utils::UInt> &p) {
             return p.first.equals(ref);
         });
 
@@ -124,10 +159,24 @@ private:
     OptionsRef options;
 
     /**
-     * The map from qubit references to the first cycle index where the given qubit is available.
+     * The first cycle index where each qubit of the main qubit register is
+     * available, indexed by qubit. These are by far the most common
+     * references, so they are kept in a flat array.
+     */
+    utils::Vec<utils::UInt> qubit_fc;
+
+    /**
+     * The map from all other references to the first cycle index where the given object is available.
      * This is encoded as an association list, which avoids the burden of defining a hash or an ordering.
      */
     std::list<std::pair<ir::Reference, utils::UInt>> fcv;
+
+    /**
+     * The maximum over all of the above, i.e. the cycle where all scheduled
+     * operations are completed. Free cycles only ever increase, so this can
+     * be maintained incrementally.
+     */
+    utils::UInt max_fc = 0;
 };
 
 } // namespace detail
@@ -82,8 +82,9 @@ class TopologicalOrderGateIterator : public GateIterator {
 public:
     TopologicalOrderGateIterator(const ir::PlatformRef& platform, const ir::BlockBaseRef &b, const OptionsRef &options) :
         block(b) { 
-        // Build DDG and add it as annotation to IR.
-        com::ddg::build(platform, block, options->commute_multi_qubit, options->commute_single_qubit);
+        // Build DDG and add it as annotation to IR, unless a previous pass
+        // left a valid one behind.
+        com::ddg::build_or_reuse(platform, block, options->commute_multi_qubit, options->commute_single_qubit);
         com::ddg::add_remaining(block);
 
         if (options->write_dot_graphs) {
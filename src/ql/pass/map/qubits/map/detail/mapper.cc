@@ -1,9 +1,14 @@
 #include "mapper.h"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <set>
 #include "ql/utils/filesystem.h"
+#include "ql/utils/thread_pool.h"
 #include "ql/pass/ana/statistics/annotations.h"
 #include "ql/com/ddg/dot.h"
+#include "ql/com/ddg/ops.h"
 #include "ql/ir/ops.h"
 
 namespace ql {
@@ -63,13 +68,13 @@ List<Alter> Mapper::gen_shortest_paths(
     QL_DOUT("gen_shortest_paths: distance(src=" << src << ", tgt=" << tgt << ") = " << d);
     QL_ASSERT(d >= 1);
 
-    // Reduce neighbors nbs to those n continuing a path within budget.
+    // Get the neighbors n continuing a path within budget.
     // src=>tgt is distance d, budget>=d is allowed, attempt src->n=>tgt
     // src->n is one hop, budget from n is one less so distance(n,tgt) <= budget-1 (i.e. distance < budget)
     // when budget==d, this defaults to distance(n,tgt) <= d-1
-    auto neighbors = platform->topology->get_neighbors(src);
-
-    neighbors.remove_if([this,budget,tgt](const UInt& n) { return platform->topology->get_distance(n, tgt) >= budget; });
+    // For multi-core, the topology composes these from the core structure,
+    // so this does not scale with the total number of qubits.
+    auto neighbors = platform->topology->get_path_neighbors(src, tgt, budget);
 
     // Update the neighbor list according to the path strategy.
     if (strategy == PathStrategy::RANDOM) {
@@ -252,7 +257,7 @@ List<ir::CustomInstructionRef> Mapper::map_mappable_gates(
 ) {
     utils::List<ir::CustomInstructionRef> available_gates;
     while (!(available_gates = future.get_schedulable_gates()).empty()) {
-        routing_progress.feed(future.get_progress());
+        feed_progress(future);
 
         bool hasMappedGate = false;
         for (const auto &gate : available_gates) {
@@ -298,9 +303,7 @@ Alter Mapper::select_alter(
 
     QL_ASSERT(options->heuristic == Heuristic::MIN_EXTEND);
 
-    for (auto &a : alters) {
-        a.extend(past, base_past); // This fills a.score.
-    }
+    Alter::extend_all(alters, past, base_past); // This fills a.score for each alter.
     alters.sort([](const Alter &a1, const Alter &a2) { return a1.get_score() < a2.get_score(); });
 
     auto factor = options->recursion_width_factor * utils::pow(options->recursion_width_exponent, recursion_depth);
@@ -358,16 +361,18 @@ Alter Mapper::select_alter(
     return tie_break_alter(alters, future);
 }
 
-utils::Any<ir::Statement> Mapper::route_gates(Future &future, Past &past) {
+void Mapper::route_gates(Future &future, Past &past, utils::Any<ir::Statement> &output_circuit) {
+    if (options->heuristic == Heuristic::SABRE) {
+        route_gates_sabre(future, past, output_circuit);
+        return;
+    }
+
     Bool also_nn_two_qubit_gates = (
         options->lookahead_mode == LookaheadMode::NO_ROUTING_FIRST
         || options->lookahead_mode == LookaheadMode::ALL
     );
 
-    routing_progress = Progress("router", 1000);
-
     List<ir::CustomInstructionRef> gates;
-    utils::Any<ir::Statement> output_circuit;
     while (!(gates = map_mappable_gates(future, past, also_nn_two_qubit_gates, &output_circuit)).empty()) {
         auto alters = gen_alters(gates, past);
         QL_ASSERT(!alters.empty() && "No suitable routing path");
@@ -376,23 +381,303 @@ utils::Any<ir::Statement> Mapper::route_gates(Future &future, Past &past) {
 
         commit_alter(selected_alter, future, past, &output_circuit);
 
-        routing_progress.feed(future.get_progress());
+        feed_progress(future);
+    }
+}
+
+Vec<Pair<UInt, UInt>> Mapper::get_sabre_extended_set(const List<ir::CustomInstructionRef> &front) {
+    Vec<Pair<UInt, UInt>> result;
+    UInt limit = options->sabre_extended_set_size;
+    if (!limit || options->lookahead_mode == LookaheadMode::DISABLED) {
+        return result;
+    }
+    if (front.empty() || !front.front()->has_annotation<com::ddg::NodeRef>()) {
+        return result;
+    }
+
+    // Breadth-first search through the successors of the front layer. The
+    // number of visited nodes is bounded as well, so long chains of
+    // single-qubit gates cannot make this expensive.
+    std::set<ir::StatementRef> seen;
+    List<ir::StatementRef> queue;
+    for (const auto &gate : front) {
+        seen.insert(gate.as<ir::Statement>());
+        queue.push_back(gate.as<ir::Statement>());
+    }
+    UInt budget = front.size() + 8 * limit;
+    while (!queue.empty() && budget-- > 0) {
+        auto statement = queue.front();
+        queue.pop_front();
+        for (const auto &succ : com::ddg::get_node(statement)->successors) {
+            if (succ.first->as_sentinel_statement() || !seen.insert(succ.first).second) {
+                continue;
+            }
+            queue.push_back(succ.first);
+            auto gate = succ.first.as<ir::CustomInstruction>();
+            if (gate.empty()) {
+                continue;
+            }
+            ir::OperandsHelper ops(platform, *gate);
+            if (ops.numberOfQubitOperands() == 2) {
+                result.push_back(ops.get2QGateOperands());
+                if (result.size() >= limit) {
+                    return result;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+void Mapper::route_gates_sabre(Future &future, Past &past, utils::Any<ir::Statement> &output_circuit) {
+    const auto &topology = platform->topology;
+    UInt num_qubits = get_num_qubits(platform);
+
+    // Decay factor per real qubit, reset whenever a gate is mapped and every
+    // few swaps.
+    static constexpr UInt DECAY_RESET_INTERVAL = 5;
+    Vec<Real> decay(num_qubits, 1.0);
+    UInt swaps_since_decay_reset = 0;
+
+    // Number of swaps the heuristic may insert without mapping a gate before
+    // falling back to shortest-path routing. Set whenever a gate is mapped,
+    // based on the distances in the front layer at that point.
+    UInt stall_limit = 0;
+    UInt swaps_since_progress = 0;
+    Real last_progress = -1.0;
+
+    List<ir::CustomInstructionRef> front;
+    while (!(front = map_mappable_gates(future, past, true, &output_circuit)).empty()) {
+
+        // Get the virtual operands of the front layer gates, and their
+        // current distance.
+        Vec<Pair<UInt, UInt>> front_qubits;
+        UInt max_distance = 0;
+        for (const auto &gate : front) {
+            auto qubits = ir::OperandsHelper(platform, *gate).get2QGateOperands();
+            front_qubits.push_back(qubits);
+            max_distance = utils::max(max_distance, topology->get_min_hops(
+                past.get_real_qubit(qubits.first),
+                past.get_real_qubit(qubits.second)
+            ));
+        }
+
+        // Reset the decay factors and stall counter when gates were mapped
+        // since the previous iteration.
+        auto progress = future.get_progress();
+        if (progress != last_progress) {
+            last_progress = progress;
+            std::fill(decay.begin(), decay.end(), 1.0);
+            swaps_since_decay_reset = 0;
+            swaps_since_progress = 0;
+            stall_limit = 10 + 2 * max_distance * front.size();
+        }
+
+        // If the heuristic got stuck, route the first gate of the front layer
+        // along a shortest path to guarantee progress.
+        if (swaps_since_progress >= stall_limit) {
+            QL_DOUT("SABRE heuristic made no progress for " << swaps_since_progress << " swaps; routing shortest path");
+            auto alters = gen_alters_gate(front.front(), past);
+            QL_ASSERT(!alters.empty() && "No suitable routing path");
+            auto alter = tie_break_alter(alters, future);
+            commit_alter(alter, future, past, &output_circuit);
+            feed_progress(future);
+            continue;
+        }
+
+        // Gather the candidate swaps: all edges touching a qubit used by the
+        // front layer.
+        std::set<Pair<UInt, UInt>> candidates;
+        for (const auto &qubits : front_qubits) {
+            for (auto virt : {qubits.first, qubits.second}) {
+                auto real = past.get_real_qubit(virt);
+                for (auto neighbor : topology->get_neighbors(real)) {
+                    candidates.insert({utils::min(real, neighbor), utils::max(real, neighbor)});
+                }
+            }
+        }
+        QL_ASSERT(!candidates.empty() && "No suitable routing path");
+
+        // Score the candidates.
+        auto extended_qubits = get_sabre_extended_set(front);
+        auto sum_distance = [&](const Vec<Pair<UInt, UInt>> &gates, UInt r0, UInt r1) {
+            auto moved = [r0, r1](UInt r) { return r == r0 ? r1 : r == r1 ? r0 : r; };
+            Real sum = 0.0;
+            for (const auto &qubits : gates) {
+                sum += topology->get_min_hops(
+                    moved(past.get_real_qubit(qubits.first)),
+                    moved(past.get_real_qubit(qubits.second))
+                );
+            }
+            return sum;
+        };
+        Real best_score = std::numeric_limits<Real>::infinity();
+        List<Pair<UInt, UInt>> best;
+        for (const auto &candidate : candidates) {
+            auto r0 = candidate.first;
+            auto r1 = candidate.second;
+            Real score = sum_distance(front_qubits, r0, r1) / front_qubits.size();
+            if (!extended_qubits.empty()) {
+                score += options->sabre_extended_set_weight
+                    * sum_distance(extended_qubits, r0, r1) / extended_qubits.size();
+            }
+            score *= utils::max(decay[r0], decay[r1]);
+            if (score < best_score) {
+                best_score = score;
+                best.clear();
+            }
+            if (score <= best_score) {
+                best.push_back(candidate);
+            }
+        }
+
+        // Tie-break and apply the best swap.
+        Pair<UInt, UInt> swap;
+        switch (options->tie_break_method) {
+            case TieBreakMethod::RANDOM: {
+                std::uniform_int_distribution<> dis(0, best.size() - 1);
+                swap = *std::next(best.begin(), dis(rng));
+                break;
+            }
+            case TieBreakMethod::LAST:
+                swap = best.back();
+                break;
+            default:
+                swap = best.front();
+                break;
+        }
+        QL_DOUT("SABRE swap " << swap.first << " <-> " << swap.second << " with score " << best_score);
+        past.add_swap(swap.first, swap.second, &output_circuit);
+        swaps_since_progress++;
+
+        decay[swap.first] += options->sabre_decay_delta;
+        decay[swap.second] += options->sabre_decay_delta;
+        if (++swaps_since_decay_reset >= DECAY_RESET_INTERVAL) {
+            std::fill(decay.begin(), decay.end(), 1.0);
+            swaps_since_decay_reset = 0;
+        }
+    }
+}
+
+void Mapper::refine_sabre_layout(const ir::BlockBaseRef &block, com::map::QubitMapping &v2r) {
+    auto initial_state = options->assume_initialized ? com::map::QubitState::INITIALIZED : com::map::QubitState::NONE;
+
+    // The backward pass routes the statements in reverse order. The statement
+    // nodes are shared with the original block; since the router only emits
+    // clones, they are not modified other than by the dependency graph
+    // annotations, which are cleared at the end.
+    auto reversed = utils::make<ir::Block>();
+    for (UInt i = block->statements.size(); i-- > 0; ) {
+        reversed->statements.add(block->statements[i]);
     }
 
+    // Routes the given block starting from v2r, and updates v2r with the
+    // final mapping. Only the permutation carries over to the next pass; the
+    // qubit states are reset to those at the start of the block.
+    auto layout_pass = [&](const ir::BlockBaseRef &pass_block) {
+        Past past(platform, options);
+        past.import_mapping(v2r);
+        {
+            Future future(platform, options, pass_block);
+            utils::Any<ir::Statement> discarded;
+            route_gates(future, past, discarded);
+        }
+        past.export_mapping(v2r);
+        for (UInt real = 0; real < v2r.get_state().size(); real++) {
+            v2r.set_state(real, initial_state);
+        }
+    };
+
+    routing_progress = Progress("router layout", 1000);
+    for (UInt iteration = 0; iteration < options->sabre_layout_iterations; iteration++) {
+        layout_pass(block);
+        layout_pass(reversed);
+        QL_DOUT("SABRE layout after iteration " << iteration << ": " << v2r.mapping_to_string());
+    }
     routing_progress.complete();
 
-    assign_increasing_cycle_numbers_to_routed_circuit(platform, output_circuit);
+    com::ddg::clear(reversed);
+    com::ddg::clear(block);
+    reversed->statements.reset();
+}
+
+void Mapper::route_windowed(const ir::BlockBaseRef &block, Past &past, utils::Any<ir::Statement> &output_circuit) {
+    UInt window_size = options->routing_window_size;
+    QL_ASSERT(window_size > 0);
+
+    // Take the input statements out of the block, such that the only
+    // remaining references to them are ours. Each window then pops its
+    // statements from the front of this list, so they are freed as soon as
+    // the window has been routed (the router only emits clones).
+    List<ir::StatementRef> input;
+    for (const auto &statement : block->statements) {
+        input.push_back(statement);
+    }
+    block->statements.reset();
+
+    UInt num_statements = input.size();
+    UInt num_done = 0;
+    auto window = utils::make<ir::Block>();
+    while (!input.empty()) {
+        window->statements.reset();
+        while (!input.empty() && window->statements.size() < window_size) {
+            window->statements.add(input.front());
+            input.pop_front();
+        }
+
+        QL_DOUT(
+            "routing window of " << window->statements.size() << " statements, "
+            << num_done << " of " << num_statements << " statements done"
+        );
+
+        window_progress_offset = (Real)num_done / (Real)num_statements;
+        window_progress_scale = (Real)window->statements.size() / (Real)num_statements;
+
+        {
+            Future future(platform, options, window);
+            route_gates(future, past, output_circuit);
+        }
 
-    return output_circuit;
+        num_done += window->statements.size();
+
+        // Release the dependency graph annotations along with the statements.
+        if (window->has_annotation<com::ddg::Graph>()) {
+            com::ddg::clear(window);
+        }
+    }
+    window->statements.reset();
+
+    window_progress_offset = 0.0;
+    window_progress_scale = 1.0;
 }
 
-Mapper::RoutingStatistics Mapper::route(ir::BlockBaseRef block, com::map::QubitMapping &v2r) {
-    Future future(platform, options, block);
+void Mapper::feed_progress(Future &future) {
+    routing_progress.feed(window_progress_offset + window_progress_scale * future.get_progress());
+}
 
+Mapper::RoutingStatistics Mapper::route(ir::BlockBaseRef block, com::map::QubitMapping &v2r) {
     Past past(platform, options);
     past.import_mapping(v2r);
 
-    block->statements = route_gates(future, past);
+    routing_progress = Progress("router", 1000);
+
+    utils::Any<ir::Statement> output_circuit;
+    if (options->routing_window_size > 0 && block->statements.size() > options->routing_window_size) {
+        com::ddg::clear(block);
+        route_windowed(block, past, output_circuit);
+    } else {
+        Future future(platform, options, block);
+        route_gates(future, past, output_circuit);
+    }
+
+    routing_progress.complete();
+
+    assign_increasing_cycle_numbers_to_routed_circuit(platform, output_circuit);
+
+    // The dependency graph describes the unrouted statements, so it must be
+    // removed before they are replaced.
+    com::ddg::clear(block);
+    block->statements = output_circuit;
 
     past.export_mapping(v2r_out);
 
@@ -400,21 +685,130 @@ Mapper::RoutingStatistics Mapper::route(ir::BlockBaseRef block, com::map::QubitM
 
     stats.num_swaps_added = past.get_num_swaps_added();
     stats.num_moves_added = past.get_num_moves_added();
+    stats.num_cycles = past.get_max_free_cycle();
 
     return stats;
 }
 
 Mapper::RoutingStatistics Mapper::map_block(ir::BlockBaseRef block) {
+    if (!options->portfolio.empty()) {
+        return map_block_portfolio(block);
+    }
+
     com::map::QubitMapping v2r{
         get_num_qubits(platform),
         true,
         options->assume_initialized ? com::map::QubitState::INITIALIZED : com::map::QubitState::NONE
     };
 
+    // The layout refinement routes the whole block at once, so it is skipped
+    // when the block is routed in windows to bound memory usage.
+    auto windowed = options->routing_window_size > 0 && block->statements.size() > options->routing_window_size;
+    if (options->heuristic == Heuristic::SABRE && options->sabre_layout_iterations > 0 && !windowed) {
+        refine_sabre_layout(block, v2r);
+    }
+
     v2r_in = v2r;
     return route(block, v2r);
 }
 
+Mapper::RoutingStatistics Mapper::map_block_portfolio(const ir::BlockBaseRef &block) {
+
+    // The candidate configurations and their results. Candidate 0 is our own
+    // configuration, without the portfolio to avoid recursion.
+    struct Candidate {
+        Str name;
+        OptionsRef options;
+        ir::BlockBaseRef block;
+        RoutingStatistics stats;
+        com::map::QubitMapping v2r_in;
+        com::map::QubitMapping v2r_out;
+    };
+    utils::Ptr<Options> own_options;
+    own_options.emplace(*options);
+    own_options->portfolio.clear();
+    std::vector<Candidate> candidates(options->portfolio.size() + 1);
+    candidates[0].name = "default";
+    candidates[0].options = own_options.as_const();
+    for (UInt i = 0; i < options->portfolio.size(); i++) {
+        candidates[i + 1].name = options->portfolio[i].first;
+        candidates[i + 1].options = options->portfolio[i].second.as_const();
+    }
+
+    // Route each candidate on its own clone of the block, such that the
+    // dependency graph annotations of the candidates don't interfere. Cloning
+    // doesn't copy annotations, so the clones start out without a graph. Each
+    // task only writes to its own candidate. The platform is shared, but
+    // routing only reads it: the specialization indices used when new gates
+    // are made and the compiled decomposition rules are built along with the
+    // platform, so make_instruction() and apply_decomposition_rules() don't
+    // modify it. Anything added to the router that does write to the platform
+    // must happen before this point.
+    for (auto &candidate : candidates) {
+        candidate.block = block->clone();
+    }
+    QL_DOUT(
+        "routing " << candidates.size() << " portfolio candidates using up to "
+        << options->portfolio_threads << " threads"
+    );
+    utils::parallel_for(candidates.size(), options->portfolio_threads, [&](UInt i) {
+        auto &candidate = candidates[i];
+        try {
+            Mapper mapper(platform, candidate.options);
+            candidate.stats = mapper.map_block(candidate.block);
+            candidate.v2r_in = mapper.v2r_in;
+            candidate.v2r_out = mapper.v2r_out;
+        } catch (utils::Exception &e) {
+            e.add_context("in portfolio candidate \"" + candidate.name + "\"");
+            throw;
+        }
+    });
+
+    // Select the best candidate. The objective is compared first, then the
+    // other metrics; remaining ties go to the earliest candidate.
+    auto key = [this](const RoutingStatistics &stats) -> std::array<UInt, 3> {
+        auto swaps = stats.num_swaps_added;
+        auto full_swaps = stats.num_swaps_added - stats.num_moves_added;
+        auto cycles = stats.num_cycles;
+        switch (options->portfolio_objective) {
+            case PortfolioObjective::MOVES: return {full_swaps, swaps, cycles};
+            case PortfolioObjective::DEPTH: return {cycles, swaps, full_swaps};
+            default:                        return {swaps, full_swaps, cycles};
+        }
+    };
+    UInt best = 0;
+    for (UInt i = 1; i < candidates.size(); i++) {
+        if (key(candidates[i].stats) < key(candidates[best].stats)) {
+            best = i;
+        }
+    }
+
+    using pass::ana::statistics::AdditionalStats;
+    for (UInt i = 0; i < candidates.size(); i++) {
+        const auto &candidate = candidates[i];
+        AdditionalStats::push(
+            block,
+            "portfolio candidate " + to_string(i) + " (" + candidate.name + "): "
+            + "swaps added: " + to_string(candidate.stats.num_swaps_added)
+            + ", of which moves added: " + to_string(candidate.stats.num_moves_added)
+            + ", cycles: " + to_string(candidate.stats.num_cycles)
+            + (i == best ? " (selected)" : "")
+        );
+    }
+    AdditionalStats::push(
+        block,
+        "portfolio objective: " + to_string(options->portfolio_objective)
+        + ", selected candidate: " + to_string(best)
+    );
+
+    // Take over the result of the best candidate.
+    com::ddg::clear(block);
+    block->statements = candidates[best].block->statements;
+    v2r_in = candidates[best].v2r_in;
+    v2r_out = candidates[best].v2r_out;
+    return candidates[best].stats;
+}
+
 void Mapper::map(ir::ProgramRef program) {
     if (program->blocks.size() >= 2) {
         QL_FATAL("Inter-block mapping is not implemented. The mapper/router will only work for programs which consist of a single block.");
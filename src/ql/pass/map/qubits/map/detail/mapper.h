@@ -1,6 +1,7 @@
 #pragma once
 
 #include <random>
+#include "ql/utils/pair.h"
 #include "ql/utils/progress.h"
 #include "ql/ir/ir.h"
 #include "ql/com/map/qubit_mapping.h"
@@ -132,8 +133,7 @@ class Mapper {
 public:
     Mapper(const ir::PlatformRef &p, const OptionsRef &o) :
             platform(p), options(o) {
-        static constexpr utils::UInt seed = 123;
-        rng.seed(seed);
+        rng.seed(options->random_seed);
     }
 
     /**
@@ -146,6 +146,7 @@ private:
     struct RoutingStatistics {
         utils::UInt num_swaps_added = 0;
         utils::UInt num_moves_added = 0;
+        utils::UInt num_cycles = 0;
     };
 
     ir::PlatformRef platform;
@@ -153,8 +154,9 @@ private:
     OptionsRef options;
 
     /**
-     * Random-number generator for the "random" tie-breaking option.
-     * The seed is constant so that the output of OpenQL is deterministic.
+     * Random-number generator for the "random" tie-breaking option. The seed
+     * comes from the options, and is constant by default so that the output
+     * of OpenQL is deterministic.
      */
     std::mt19937 rng;
 
@@ -163,6 +165,14 @@ private:
      */
     utils::Progress routing_progress;
 
+    /**
+     * Overall progress at the start of the current routing window, and the
+     * fraction of the overall progress that the current window represents.
+     * These are 0 and 1 when routing is not windowed.
+     */
+    utils::Real window_progress_offset = 0.0;
+    utils::Real window_progress_scale = 1.0;
+
     /**
      * Qubit mapping before mapping, set by map_block().
      */
@@ -296,10 +306,56 @@ private:
     );
 
     /**
-     * Process all gates in future and update past with routing result.
+     * Process all gates in future and update past with routing result. The
+     * routed gates are appended to output_circuit.
+     */
+    void route_gates(Future &future, Past &past, utils::Any<ir::Statement> &output_circuit);
+
+    /**
+     * Returns the virtual qubit operands of up to
+     * options->sabre_extended_set_size two-qubit gates that follow the given
+     * front layer in the dependency graph, in breadth-first order. Returns
+     * nothing if lookahead is disabled (lookahead_mode is `no`) or if no
+     * dependency graph is available.
+     */
+    utils::Vec<utils::Pair<utils::UInt, utils::UInt>> get_sabre_extended_set(
+        const utils::List<ir::CustomInstructionRef> &front
+    );
+
+    /**
+     * Implementation of route_gates() for the SABRE heuristic. Swaps are
+     * inserted one at a time, each time choosing the swap adjacent to the
+     * front layer that minimizes the SABRE cost function. If the heuristic
+     * fails to make progress for too long, the first gate of the front layer
+     * (in the order returned by map_mappable_gates()) is routed along a
+     * shortest path instead, which guarantees termination.
      */
-    utils::Any<ir::Statement> route_gates(Future &future, Past &past);
-    
+    void route_gates_sabre(Future &future, Past &past, utils::Any<ir::Statement> &output_circuit);
+
+    /**
+     * Refines the initial mapping v2r for the SABRE heuristic, by routing the
+     * block forward and then backward options->sabre_layout_iterations times,
+     * each time starting from the final mapping of the previous pass. The
+     * routed circuits are discarded.
+     */
+    void refine_sabre_layout(const ir::BlockBaseRef &block, com::map::QubitMapping &v2r);
+
+    /**
+     * Routes the statements of the given block in consecutive windows of
+     * options->routing_window_size gates. Each window gets its own Future
+     * (and thus dependency graph), while past is carried over from window to
+     * window, such that the mapping and free cycle map remain continuous. The
+     * input statements of a window are released as soon as it has been
+     * routed. The routed gates are appended to output_circuit.
+     */
+    void route_windowed(const ir::BlockBaseRef &block, Past &past, utils::Any<ir::Statement> &output_circuit);
+
+    /**
+     * Feeds the routing progress tracker based on the progress of the given
+     * future, taking the current routing window into account.
+     */
+    void feed_progress(Future &future);
+
     /**
      * Map/route the block wrt the virtual-to-real v2r qubit mapping.
      */
@@ -309,6 +365,16 @@ private:
      * Runs routing for the given block.
      */
     RoutingStatistics map_block(ir::BlockBaseRef block);
+
+    /**
+     * Runs routing for the given block in portfolio mode. A clone of the block
+     * is routed with our configuration and with each of the configurations in
+     * options->portfolio, using up to options->portfolio_threads threads. The
+     * routed statements and qubit mappings of the best candidate according to
+     * options->portfolio_objective are then taken over. The statistics of all
+     * candidates are reported via AdditionalStats.
+     */
+    RoutingStatistics map_block_portfolio(const ir::BlockBaseRef &block);
 };
 
 } // namespace detail
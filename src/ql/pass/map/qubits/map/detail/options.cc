@@ -11,6 +11,7 @@ std::ostream &operator<<(std::ostream &os, Heuristic h) {
     switch (h) {
         case Heuristic::BASE:               os << "base";          break;
         case Heuristic::MIN_EXTEND:         os << "min_extend";    break;
+        case Heuristic::SABRE:              os << "sabre";         break;
     }
     return os;
 }
@@ -53,6 +54,15 @@ std::ostream &operator<<(std::ostream &os, TieBreakMethod tbm) {
     return os;
 }
 
+std::ostream &operator<<(std::ostream &os, PortfolioObjective po) {
+    switch (po) {
+        case PortfolioObjective::SWAPS: os << "swaps"; break;
+        case PortfolioObjective::MOVES: os << "moves"; break;
+        case PortfolioObjective::DEPTH: os << "depth"; break;
+    }
+    return os;
+}
+
 } // namespace detail
 } // namespace map
 } // namespace qubits
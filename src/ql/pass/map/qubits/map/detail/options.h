@@ -3,6 +3,8 @@
 #include "ql/utils/num.h"
 #include "ql/utils/str.h"
 #include "ql/utils/ptr.h"
+#include "ql/utils/pair.h"
+#include "ql/utils/vec.h"
 
 namespace ql {
 namespace pass {
@@ -34,7 +36,21 @@ enum class Heuristic {
      * recursion_width_limit. When the limit is reached, the tie-breaking method
      * is applied to the best-scoring alternatives.
      */
-    MIN_EXTEND
+    MIN_EXTEND,
+
+    /**
+     * SABRE-style routing (Li et al., 2019). Rather than generating complete
+     * routing paths for a single gate, swaps are inserted one at a time,
+     * choosing the swap adjacent to the front layer of unroutable gates that
+     * minimizes the distance between the operands of the front layer gates
+     * and (with a lower weight) of a bounded extended set of upcoming
+     * two-qubit gates. A per-qubit decay factor discourages swapping the same
+     * qubits over and over, so parallel swaps are favored. The initial
+     * placement can furthermore be refined by routing the circuit forward
+     * and backward, and using the final mapping of the backward pass as the
+     * initial mapping.
+     */
+    SABRE
 
 };
 
@@ -138,6 +154,40 @@ enum class TieBreakMethod {
 
 std::ostream &operator<<(std::ostream &os, TieBreakMethod tbm);
 
+/**
+ * Objectives for selecting the best result in portfolio mode. Ties are
+ * broken by the other metrics, and finally by the order of the candidates.
+ */
+enum class PortfolioObjective {
+
+    /**
+     * Minimize the total number of swap and move gates added.
+     */
+    SWAPS,
+
+    /**
+     * Minimize the number of swap gates added that could not be replaced by
+     * a move gate, i.e. make the best use of initialized qubits.
+     */
+    MOVES,
+
+    /**
+     * Minimize the number of cycles of the routed block, as determined by
+     * the embedded scheduler.
+     */
+    DEPTH
+
+};
+
+std::ostream &operator<<(std::ostream &os, PortfolioObjective po);
+
+struct Options;
+
+/**
+ * A named alternative mapper configuration for portfolio mode.
+ */
+using PortfolioCandidate = utils::Pair<utils::Str, utils::Ptr<Options>>;
+
 /**
  * Main options structure.
  */
@@ -253,6 +303,66 @@ struct Options {
 
     std::string decomposition_rule_name_pattern = "";
 
+    /**
+     * Maximum number of gates the router considers at once. When nonzero, the
+     * block is routed in consecutive windows of this many gates; the
+     * dependency graph is only built for the current window, and input gates
+     * are released as soon as their window has been routed. 0 means that the
+     * whole block is routed at once.
+     */
+    utils::UInt routing_window_size = 0;
+
+    /**
+     * Maximum number of upcoming two-qubit gates beyond the front layer that
+     * the SABRE heuristic takes into account.
+     */
+    utils::UInt sabre_extended_set_size = 20;
+
+    /**
+     * Weight of the extended set relative to the front layer in the SABRE
+     * cost function.
+     */
+    utils::Real sabre_extended_set_weight = 0.5;
+
+    /**
+     * Amount by which the SABRE decay factor of a qubit increases whenever
+     * it is swapped.
+     */
+    utils::Real sabre_decay_delta = 0.001;
+
+    /**
+     * Number of forward-backward routing passes that the SABRE heuristic
+     * uses to refine the initial mapping. 0 keeps the initial mapping as is.
+     */
+    utils::UInt sabre_layout_iterations = 1;
+
+    /**
+     * Seed for the random number generator used for random tie-breaking and
+     * path selection. The seed is constant unless overridden, so that the
+     * output of OpenQL is deterministic.
+     */
+    utils::UInt random_seed = 123;
+
+    /**
+     * Alternative configurations to route each block with in portfolio mode.
+     * When nonempty, the block is routed once with this configuration and
+     * once with each alternative, and the best result according to
+     * portfolio_objective is kept. The alternatives do not have portfolios
+     * of their own.
+     */
+    utils::Vec<PortfolioCandidate> portfolio;
+
+    /**
+     * The objective for selecting the best result in portfolio mode.
+     */
+    PortfolioObjective portfolio_objective = PortfolioObjective::SWAPS;
+
+    /**
+     * Maximum number of threads used to route the portfolio candidates
+     * concurrently. The result does not depend on this.
+     */
+    utils::UInt portfolio_threads = 1;
+
 };
 
 /**
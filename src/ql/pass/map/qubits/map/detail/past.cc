@@ -24,6 +24,7 @@ Past::Past(ir::PlatformRef p, const OptionsRef &opt) {
         options->assume_initialized ? com::map::QubitState::INITIALIZED : com::map::QubitState::NONE
     );
     fc.initialize(platform, options);
+    gate_profiles = std::make_shared<utils::Map<std::pair<utils::Str, utils::Vec<utils::UInt>>, GateProfile>>();
 }
 
 void Past::import_mapping(const com::map::QubitMapping &v2r_value) {
@@ -34,7 +35,7 @@ void Past::export_mapping(com::map::QubitMapping &v2r_destination) const {
     v2r_destination = v2r;
 }
 
-void Past::add(const ir::CustomInstructionRef &gate, utils::Any<ir::Statement> *output_gates) {
+utils::Any<ir::Statement> Past::decompose(const ir::CustomInstructionRef &gate) const {
     auto new_block_for_dec = utils::make<ir::Block>();
     new_block_for_dec->statements.add(gate);
 
@@ -45,7 +46,11 @@ void Past::add(const ir::CustomInstructionRef &gate, utils::Any<ir::Statement> *
         com::dec::apply_decomposition_rules(new_block_for_dec, true, predicate);
     }
 
-    for (const auto &st: new_block_for_dec->statements) {
+    return new_block_for_dec->statements;
+}
+
+void Past::add(const ir::CustomInstructionRef &gate, utils::Any<ir::Statement> *output_gates) {
+    for (const auto &st: decompose(gate)) {
         auto custom = st.as<ir::CustomInstruction>();
 
         QL_ASSERT(!custom.empty() && "Decomposition rules for router can only contain gates");
@@ -183,6 +188,52 @@ void Past::make_real(const ir::CustomInstructionRef &gate) {
 utils::UInt Past::get_max_free_cycle() const {
     return fc.get_max();
 }
+
+const GateProfile &Past::get_gate_profile(
+    const utils::Str &gname,
+    const utils::Vec<utils::UInt> &qubits
+) const {
+    auto key = std::make_pair(gname, qubits);
+    auto it = gate_profiles->find(key);
+    if (it != gate_profiles->end()) {
+        return it->second;
+    }
+
+    // Build the gate once in the same way add_swap() and add_move() would,
+    // and record what add() would do to the FreeCycle map.
+    auto gate = new_gate(gname, qubits);
+    GateProfile profile;
+    profile.duration = gate->instruction_type->duration;
+    for (const auto &st : decompose(gate)) {
+        auto custom = st.as<ir::CustomInstruction>();
+        QL_ASSERT(!custom.empty() && "Decomposition rules for router can only contain gates");
+
+        GateProfile::Step step;
+        step.duration = custom->instruction_type->duration;
+        for (const auto &op : custom->operands) {
+            const auto &ref = op.as<ir::Reference>();
+            if (ref.empty()) {
+                continue;
+            }
+            if (
+                ref->target == platform->qubits &&
+                ref->data_type == platform->qubits->data_type &&
+                ref->indices.size() == 1 &&
+                ref->indices[0]->as_int_literal()
+            ) {
+                step.qubits.push_back(ref->indices[0]->as_int_literal()->value);
+            } else {
+                profile.virtualizable = false;
+            }
+        }
+        if (!custom->condition.as<ir::Reference>().empty()) {
+            profile.virtualizable = false;
+        }
+        profile.steps.push_back(std::move(step));
+    }
+
+    return gate_profiles->set(key) = std::move(profile);
+}
 } // namespace detail
 } // namespace map
 } // namespace qubits
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "ql/utils/num.h"
 #include "ql/utils/str.h"
 #include "ql/utils/list.h"
@@ -36,6 +38,50 @@ namespace detail {
  *   as little as possible.
  */
 
+/**
+ * Summary of the effect that a routing gate (swap, move, prepz, ...) on a
+ * particular set of real qubits has on the FreeCycle map, after decomposition.
+ * This allows alternatives to be scored without constructing IR nodes; see
+ * VirtualPast.
+ */
+struct GateProfile {
+
+    /**
+     * A single gate resulting from decomposition.
+     */
+    struct Step {
+
+        /**
+         * The real qubits referred to by the gate.
+         */
+        utils::Vec<utils::UInt> qubits;
+
+        /**
+         * The duration of the gate in cycles.
+         */
+        utils::UInt duration;
+
+    };
+
+    /**
+     * Duration of the gate before decomposition.
+     */
+    utils::UInt duration = 0;
+
+    /**
+     * The gates resulting from decomposition, in order.
+     */
+    utils::Vec<Step> steps;
+
+    /**
+     * Whether the decomposed gates only refer to qubits of the main qubit
+     * register. If not, the gate can only be modelled using the full FreeCycle
+     * map.
+     */
+    utils::Bool virtualizable = true;
+
+};
+
 class Past {
 public:
     Past(ir::PlatformRef p, const OptionsRef &opt);
@@ -124,7 +170,25 @@ public:
      */
     utils::UInt get_max_free_cycle() const;
 
+    /**
+     * Returns the profile of the gate with the given name and qubits, computing
+     * and caching it if this is the first time it is requested. The cache is
+     * shared between copies of this Past.
+     */
+    const GateProfile &get_gate_profile(
+        const utils::Str &gname,
+        const utils::Vec<utils::UInt> &qubits
+    ) const;
+
 private:
+    friend class VirtualPast;
+
+    /**
+     * Applies the decomposition rules for the router to the given gate, and
+     * returns the resulting gates.
+     */
+    utils::Any<ir::Statement> decompose(const ir::CustomInstructionRef &gate) const;
+
     ir::PlatformRef platform;
     OptionsRef options;
 
@@ -140,6 +204,12 @@ private:
 
     utils::UInt num_swaps_added = 0;
     utils::UInt num_moves_added = 0;
+
+    /**
+     * Cache for get_gate_profile(). Profiles only depend on the platform and
+     * options, so copies of a Past share the same cache.
+     */
+    std::shared_ptr<utils::Map<std::pair<utils::Str, utils::Vec<utils::UInt>>, GateProfile>> gate_profiles;
 };
 
 } // namespace detail
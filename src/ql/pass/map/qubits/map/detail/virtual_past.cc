@@ -0,0 +1,130 @@
+#include "virtual_past.h"
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace map {
+namespace detail {
+
+VirtualPast::VirtualPast(const Past &past) :
+    past(&past),
+    v2r(past.v2r),
+    qubit_fc(past.fc.get_qubit_cycles()),
+    max_fc(past.fc.get_max()),
+    valid(true)
+{}
+
+void VirtualPast::reset(const Past &p) {
+    past = &p;
+    v2r.restore(p.v2r);
+    const auto &src = p.fc.get_qubit_cycles();
+    QL_ASSERT(src.size() == qubit_fc.size());
+    std::copy(src.begin(), src.end(), qubit_fc.begin());
+    max_fc = p.fc.get_max();
+    valid = true;
+}
+
+void VirtualPast::add(const GateProfile &profile) {
+    if (!profile.virtualizable) {
+        valid = false;
+        return;
+    }
+    for (const auto &step : profile.steps) {
+        utils::UInt start_cycle = 1;
+        for (auto q : step.qubits) {
+            start_cycle = utils::max(start_cycle, qubit_fc[q]);
+        }
+        utils::UInt free_cycle = start_cycle + step.duration;
+        for (auto q : step.qubits) {
+            qubit_fc[q] = free_cycle;
+        }
+        if (!step.qubits.empty()) {
+            max_fc = utils::max(max_fc, free_cycle);
+        }
+    }
+}
+
+utils::Bool VirtualPast::add_move(utils::UInt &r0, utils::UInt &r1) {
+    if (v2r.get_state(r0) != com::map::QubitState::LIVE) {
+        std::swap(r0, r1);
+    }
+
+    if (v2r.get_state(r1) == com::map::QubitState::NONE) {
+        const auto &prepz = past->get_gate_profile("prepz", {r1});
+
+        // Same computation as FreeCycle::cycle_extension(), including the
+        // unsigned arithmetic.
+        utils::UInt extension = qubit_fc[r1] + prepz.duration - max_fc;
+        if (extension <= past->options->max_move_penalty) {
+            add(prepz);
+        } else {
+            return false;
+        }
+    }
+
+    auto gname = past->platform->topology->is_inter_core_hop(r0, r1) ? "tmove" : "move";
+    add(past->get_gate_profile(gname, {r0, r1}));
+    return true;
+}
+
+void VirtualPast::add_swap(utils::UInt r0, utils::UInt r1) {
+    if (v2r.get_state(r0) != com::map::QubitState::LIVE &&
+        v2r.get_state(r1) != com::map::QubitState::LIVE) {
+        v2r.swap(r0, r1);
+        return;
+    }
+
+    if (past->options->use_move_gates &&
+            (v2r.get_state(r0) != com::map::QubitState::LIVE ||
+             v2r.get_state(r1) != com::map::QubitState::LIVE)) {
+        if (add_move(r0, r1)) {
+            v2r.swap(r0, r1);
+            return;
+        }
+    }
+
+    if (past->options->reverse_swap_if_better && qubit_fc[r0] < qubit_fc[r1]) {
+        std::swap(r0, r1);
+    }
+
+    auto gname = past->platform->topology->is_inter_core_hop(r0, r1) ? "tswap" : "swap";
+    add(past->get_gate_profile(gname, {r0, r1}));
+    v2r.swap(r0, r1);
+}
+
+utils::Bool VirtualPast::is_first_swap_earliest(
+    utils::UInt fr0,
+    utils::UInt fr1,
+    utils::UInt sr0,
+    utils::UInt sr1
+) const {
+    if (past->options->reverse_swap_if_better) {
+        if (qubit_fc[fr0] < qubit_fc[fr1]) {
+            std::swap(fr0, fr1);
+        }
+        if (qubit_fc[sr0] < qubit_fc[sr1]) {
+            std::swap(sr0, sr1);
+        }
+    }
+
+    auto start_cycle_first_swap = utils::max(qubit_fc[fr0] - 1, qubit_fc[fr1]);
+    auto start_cycle_second_swap = utils::max(qubit_fc[sr0] - 1, qubit_fc[sr1]);
+
+    return start_cycle_first_swap < start_cycle_second_swap;
+}
+
+utils::Bool VirtualPast::is_valid() const {
+    return valid;
+}
+
+utils::UInt VirtualPast::get_max_free_cycle() const {
+    return max_fc;
+}
+
+} // namespace detail
+} // namespace map
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "ql/utils/num.h"
+#include "ql/utils/str.h"
+#include "ql/utils/vec.h"
+#include "ql/com/map/qubit_mapping.h"
+#include "options.h"
+#include "past.h"
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace map {
+namespace detail {
+
+/**
+ * Scratch copy of the part of a Past that determines the cycle extension of a
+ * routing alternative: the qubit mapping and the free cycle of each qubit.
+ * Swaps and moves are modelled using the GateProfiles cached by the Past,
+ * rather than by constructing and decomposing IR gates, so no IR nodes are
+ * allocated while scoring. The buffers are reused by each reset(), so a single
+ * VirtualPast can score any number of alternatives.
+ *
+ * add_swap() and is_first_swap_earliest() mirror their counterparts in Past
+ * and FreeCycle exactly, such that get_max_free_cycle() returns the same value
+ * as it would for a copy of the Past that the swaps were added to. When a gate
+ * is needed that cannot be modelled (because its decomposition refers to
+ * something other than qubits), the VirtualPast is marked invalid, and the
+ * caller must fall back to using a real Past.
+ */
+class VirtualPast {
+public:
+
+    /**
+     * Constructs a VirtualPast as a copy of the given Past.
+     */
+    explicit VirtualPast(const Past &past);
+
+    /**
+     * Resets this VirtualPast to a copy of the given Past.
+     */
+    void reset(const Past &past);
+
+    /**
+     * Models Past::add_swap().
+     */
+    void add_swap(utils::UInt r0, utils::UInt r1);
+
+    /**
+     * Models Past::is_first_swap_earliest().
+     */
+    utils::Bool is_first_swap_earliest(
+        utils::UInt fr0,
+        utils::UInt fr1,
+        utils::UInt sr0,
+        utils::UInt sr1
+    ) const;
+
+    /**
+     * Returns whether all gates added since the last reset could be modelled.
+     */
+    utils::Bool is_valid() const;
+
+    /**
+     * Returns the first completely free cycle.
+     */
+    utils::UInt get_max_free_cycle() const;
+
+private:
+
+    /**
+     * Models Past::add_move().
+     */
+    utils::Bool add_move(utils::UInt &r0, utils::UInt &r1);
+
+    /**
+     * Models Past::add() for the gate with the given profile.
+     */
+    void add(const GateProfile &profile);
+
+    /**
+     * The Past we were last reset to.
+     */
+    const Past *past;
+
+    /**
+     * Copy of the virtual to real qubit map of the past.
+     */
+    com::map::QubitMapping v2r;
+
+    /**
+     * Copy of the free cycle of each qubit of the past.
+     */
+    utils::Vec<utils::UInt> qubit_fc;
+
+    /**
+     * The maximum free cycle.
+     */
+    utils::UInt max_fc = 0;
+
+    /**
+     * Whether all gates so far could be modelled.
+     */
+    utils::Bool valid = true;
+
+};
+
+} // namespace detail
+} // namespace map
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
@@ -1,6 +1,7 @@
 #include "ql/pass/map/qubits/map/map.h"
 
 #include "detail/mapper.h"
+#include "ql/utils/thread_pool.h"
 #include "ql/pmgr/factory.h"
 
 namespace ql {
@@ -101,9 +102,56 @@ MapQubitsPass::MapQubitsPass(
         "this option will speculate what each option will do in terms of "
         "extending the duration of the circuit, optionally recursively, to find "
         "the best alternatives in terms of circuit duration within some "
-        "lookahead window.",
+        "lookahead window. `sabre` ignores the alternative routes entirely, and "
+        "instead greedily inserts one swap at a time, chosen to minimize the "
+        "distance between the operands of the front layer of two-qubit gates "
+        "plus a weighted lookahead term for the gates behind it (SABRE); this "
+        "scales much better to large devices. With `sabre`, the initial "
+        "placement is also refined by routing the block forward and backward "
+        "before the actual routing pass; see the `sabre_*` options.",
         "base",
-        {"base", "minextend"}
+        {"base", "minextend", "sabre"}
+    );
+
+    options.add_int(
+        "sabre_extended_set_size",
+        "Maximum number of two-qubit gates following the front layer that the "
+        "`sabre` heuristic takes into account as lookahead. Set to 0 to only "
+        "consider the front layer. No lookahead is done when `lookahead_mode` "
+        "is `no`. "
+        "This option only has an effect when `route_heuristic` is `sabre`.",
+        "20",
+        0, utils::MAX
+    );
+
+    options.add_real(
+        "sabre_extended_set_weight",
+        "Weight of the lookahead term relative to the front layer term in the "
+        "cost function of the `sabre` heuristic. "
+        "This option only has an effect when `route_heuristic` is `sabre`.",
+        "0.5",
+        0.0, utils::INF
+    );
+
+    options.add_real(
+        "sabre_decay_delta",
+        "Amount by which the cost of swapping a qubit is increased each time "
+        "the `sabre` heuristic swaps it without making progress. This favors "
+        "swaps that can be done in parallel. "
+        "This option only has an effect when `route_heuristic` is `sabre`.",
+        "0.001",
+        0.0, utils::INF
+    );
+
+    options.add_int(
+        "sabre_layout_iterations",
+        "Number of forward-backward routing iterations used by the `sabre` "
+        "heuristic to refine the initial placement of each block before it is "
+        "routed. Set to 0 to use the incoming placement as is. Refinement is "
+        "skipped for blocks routed in windows (see `routing_window_size`). "
+        "This option only has an effect when `route_heuristic` is `sabre`.",
+        "1",
+        0, utils::MAX
     );
 
     options.add_int(
@@ -275,118 +323,304 @@ MapQubitsPass::MapQubitsPass(
         "to mapped instruction before scheduling them.",
         ""
     );
-}
 
-pmgr::pass_types::NodeType MapQubitsPass::on_construct(
-    const utils::Ptr<const pmgr::Factory> &factory,
-    utils::List<pmgr::PassRef> &passes,
-    pmgr::condition::Ref &condition
-) {
-    (void)factory;
-    (void)passes;
-    (void)condition;
+    options.add_int(
+        "routing_window_size",
+        "Controls the maximum number of gates that the router considers at "
+        "once. When nonzero, the block is routed in consecutive windows of "
+        "this many gates: the dependency graph is only built for the current "
+        "window, and the input gates of a window are released as soon as it "
+        "has been routed. This bounds memory usage for very long blocks, at "
+        "the expense of not being able to look ahead beyond the end of the "
+        "current window. 0 means that the whole block is routed at once.",
+        "0",
+        0, utils::MAX
+    );
 
-    parsed_options.emplace();
+    //========================================================================//
+    // Options controlling portfolio mode                                     //
+    //========================================================================//
+
+    options.add_str(
+        "portfolio",
+        "Enables portfolio mode when nonempty. The block is then routed "
+        "several times, once with the options of this pass and once for each "
+        "configuration listed here, and the result that scores best according "
+        "to `portfolio_objective` is kept. Configurations are separated by "
+        "semicolons, and each consists of comma-separated `option=value` "
+        "overrides for the options of this pass. The special key `seed` "
+        "changes the seed of the random number generator used by the "
+        "`random` tie-breaking and path selection modes. For example, "
+        "`lookahead_mode=all;route_heuristic=sabre;seed=1,tie_break_method=random` "
+        "tries four configurations in total. The results of all candidates "
+        "are reported in the statistics.",
+        ""
+    );
 
-    parsed_options->assume_initialized = options["assume_initialized"].as_bool();
-    parsed_options->assume_prep_only_initializes = options["assume_prep_only_initializes"].as_bool();
+    options.add_enum(
+        "portfolio_objective",
+        "The objective used to select the best result in portfolio mode. "
+        "`swaps` minimizes the total number of swap and move gates added, "
+        "`moves` minimizes the number of swap gates that could not be "
+        "replaced with a move gate, and `depth` minimizes the number of "
+        "cycles of the routed block. Ties are broken using the other metrics, "
+        "and then by the order of the configurations.",
+        "swaps",
+        {"swaps", "moves", "depth"}
+    );
+
+    options.add_int(
+        "portfolio_threads",
+        "The maximum number of threads used to route the candidates of a "
+        "portfolio concurrently. `auto` uses the amount of hardware "
+        "concurrency of the machine. The result does not depend on this "
+        "option.",
+        "1",
+        1, utils::MAX, {"auto"}
+    );
+}
+
+/**
+ * Parses the given pass options into the given mapper options structure. The
+ * portfolio options are not handled here.
+ */
+static void parse_options(const utils::Options &options, detail::Options &parsed) {
+    parsed.assume_initialized = options["assume_initialized"].as_bool();
+    parsed.assume_prep_only_initializes = options["assume_prep_only_initializes"].as_bool();
 
     auto route_heuristic = options["route_heuristic"].as_str();
     if (route_heuristic == "base") {
-        parsed_options->heuristic = detail::Heuristic::BASE;
+        parsed.heuristic = detail::Heuristic::BASE;
     } else if (route_heuristic == "minextend") {
-        parsed_options->heuristic = detail::Heuristic::MIN_EXTEND;
+        parsed.heuristic = detail::Heuristic::MIN_EXTEND;
+    } else if (route_heuristic == "sabre") {
+        parsed.heuristic = detail::Heuristic::SABRE;
     } else {
         QL_ASSERT(false);
     }
 
-    parsed_options->max_alters = options["max_alternative_routes"].as_uint();
+    parsed.sabre_extended_set_size = options["sabre_extended_set_size"].as_uint();
+    parsed.sabre_extended_set_weight = options["sabre_extended_set_weight"].as_real();
+    parsed.sabre_decay_delta = options["sabre_decay_delta"].as_real();
+    parsed.sabre_layout_iterations = options["sabre_layout_iterations"].as_uint();
+
+    parsed.max_alters = options["max_alternative_routes"].as_uint();
 
     auto tie_break_method = options["tie_break_method"].as_str();
     if (tie_break_method == "first") {
-        parsed_options->tie_break_method = detail::TieBreakMethod::FIRST;
+        parsed.tie_break_method = detail::TieBreakMethod::FIRST;
     } else if (tie_break_method == "last") {
-        parsed_options->tie_break_method = detail::TieBreakMethod::LAST;
+        parsed.tie_break_method = detail::TieBreakMethod::LAST;
     } else if (tie_break_method == "random") {
-        parsed_options->tie_break_method = detail::TieBreakMethod::RANDOM;
+        parsed.tie_break_method = detail::TieBreakMethod::RANDOM;
     } else if (tie_break_method == "critical") {
-        parsed_options->tie_break_method = detail::TieBreakMethod::CRITICAL;
+        parsed.tie_break_method = detail::TieBreakMethod::CRITICAL;
     } else {
         QL_ASSERT(false);
     }
 
     auto lookahead_mode = options["lookahead_mode"].as_str();
     if (lookahead_mode == "no") {
-        parsed_options->lookahead_mode = detail::LookaheadMode::DISABLED;
+        parsed.lookahead_mode = detail::LookaheadMode::DISABLED;
     } else if (lookahead_mode == "1qfirst") {
-        parsed_options->lookahead_mode = detail::LookaheadMode::ONE_QUBIT_GATE_FIRST;
+        parsed.lookahead_mode = detail::LookaheadMode::ONE_QUBIT_GATE_FIRST;
     } else if (lookahead_mode == "noroutingfirst") {
-        parsed_options->lookahead_mode = detail::LookaheadMode::NO_ROUTING_FIRST;
+        parsed.lookahead_mode = detail::LookaheadMode::NO_ROUTING_FIRST;
     } else if (lookahead_mode == "all") {
-        parsed_options->lookahead_mode = detail::LookaheadMode::ALL;
+        parsed.lookahead_mode = detail::LookaheadMode::ALL;
     } else {
         QL_ASSERT(false);
     }
 
     auto path_selection_mode = options["path_selection_mode"].as_str();
     if (path_selection_mode == "all") {
-        parsed_options->path_selection_mode = detail::PathSelectionMode::ALL;
+        parsed.path_selection_mode = detail::PathSelectionMode::ALL;
     } else if (path_selection_mode == "borders") {
-        parsed_options->path_selection_mode = detail::PathSelectionMode::BORDERS;
+        parsed.path_selection_mode = detail::PathSelectionMode::BORDERS;
     } else if (path_selection_mode == "random") {
-        parsed_options->path_selection_mode = detail::PathSelectionMode::RANDOM;
+        parsed.path_selection_mode = detail::PathSelectionMode::RANDOM;
     } else {
         QL_ASSERT(false);
     }
 
     auto swap_selection_mode = options["swap_selection_mode"].as_str();
     if (swap_selection_mode == "one") {
-        parsed_options->swap_selection_mode = detail::SwapSelectionMode::ONE;
+        parsed.swap_selection_mode = detail::SwapSelectionMode::ONE;
     } else if (swap_selection_mode == "all") {
-        parsed_options->swap_selection_mode = detail::SwapSelectionMode::ALL;
+        parsed.swap_selection_mode = detail::SwapSelectionMode::ALL;
     } else if (swap_selection_mode == "earliest") {
-        parsed_options->swap_selection_mode = detail::SwapSelectionMode::EARLIEST;
+        parsed.swap_selection_mode = detail::SwapSelectionMode::EARLIEST;
     } else {
         QL_ASSERT(false);
     }
 
-    parsed_options->recurse_on_nn_two_qubit = options["recurse_on_nn_two_qubit"].as_bool();
+    parsed.recurse_on_nn_two_qubit = options["recurse_on_nn_two_qubit"].as_bool();
 
     if (options["recursion_depth_limit"].as_str() == "inf") {
-        parsed_options->recursion_depth_limit = utils::MAX;
+        parsed.recursion_depth_limit = utils::MAX;
     } else {
-        parsed_options->recursion_depth_limit = options["recursion_depth_limit"].as_uint();
+        parsed.recursion_depth_limit = options["recursion_depth_limit"].as_uint();
     }
 
-    parsed_options->recursion_width_factor = options["recursion_width_factor"].as_real();
-    parsed_options->recursion_width_exponent = options["recursion_width_exponent"].as_real();
+    parsed.recursion_width_factor = options["recursion_width_factor"].as_real();
+    parsed.recursion_width_exponent = options["recursion_width_exponent"].as_real();
 
     auto use_moves = options["use_moves"].as_str();
     if (use_moves == "no") {
-        parsed_options->use_move_gates = false;
+        parsed.use_move_gates = false;
     } else if (use_moves == "yes") {
-        parsed_options->use_move_gates = true;
-        parsed_options->max_move_penalty = 0;
+        parsed.use_move_gates = true;
+        parsed.max_move_penalty = 0;
+    } else {
+        parsed.use_move_gates = true;
+        parsed.max_move_penalty = utils::parse_uint(use_moves);
+    }
+
+    parsed.reverse_swap_if_better = options["reverse_swap_if_better"].as_bool();
+    parsed.commute_multi_qubit = options["commute_multi_qubit"].as_bool();
+    parsed.commute_single_qubit = options["commute_single_qubit"].as_bool();
+    parsed.write_dot_graphs = options["write_dot_graphs"].as_bool();
+
+    parsed.decomposition_rule_name_pattern = options["decomposition_rule_name_pattern"].as_str();
+    parsed.routing_window_size = options["routing_window_size"].as_uint();
+}
+
+/**
+ * Returns the given string with leading and trailing whitespace removed.
+ */
+static utils::Str strip(const utils::Str &str) {
+    auto first = str.find_first_not_of(" \t\n");
+    if (first == utils::Str::npos) {
+        return "";
+    }
+    auto last = str.find_last_not_of(" \t\n");
+    return str.substr(first, last - first + 1);
+}
+
+/**
+ * Splits the given string at the given separator, and returns the nonempty
+ * elements with surrounding whitespace removed.
+ */
+static utils::List<utils::Str> split_list(const utils::Str &str, char separator) {
+    utils::List<utils::Str> result;
+    utils::UInt start = 0;
+    while (start <= str.size()) {
+        auto end = str.find(separator, start);
+        if (end == utils::Str::npos) {
+            end = str.size();
+        }
+        auto element = strip(str.substr(start, end - start));
+        if (!element.empty()) {
+            result.push_back(element);
+        }
+        start = end + 1;
+    }
+    return result;
+}
+
+/**
+ * Restores options that were temporarily overridden for a portfolio
+ * configuration to their previous values, in reverse order.
+ */
+static void restore_options(
+    utils::Options &options,
+    const utils::List<utils::Pair<utils::Str, utils::Pair<utils::Bool, utils::Str>>> &saved
+) {
+    for (auto it = saved.rbegin(); it != saved.rend(); ++it) {
+        if (it->second.first) {
+            options[it->first].set(it->second.second);
+        } else {
+            options[it->first].reset();
+        }
+    }
+}
+
+pmgr::pass_types::NodeType MapQubitsPass::on_construct(
+    const utils::Ptr<const pmgr::Factory> &factory,
+    utils::List<pmgr::PassRef> &passes,
+    pmgr::condition::Ref &condition
+) {
+    (void)factory;
+    (void)passes;
+    (void)condition;
+
+    parsed_options.emplace();
+    parse_options(options, *parsed_options);
+
+    auto portfolio_objective = options["portfolio_objective"].as_str();
+    if (portfolio_objective == "swaps") {
+        parsed_options->portfolio_objective = detail::PortfolioObjective::SWAPS;
+    } else if (portfolio_objective == "moves") {
+        parsed_options->portfolio_objective = detail::PortfolioObjective::MOVES;
+    } else if (portfolio_objective == "depth") {
+        parsed_options->portfolio_objective = detail::PortfolioObjective::DEPTH;
     } else {
-        parsed_options->use_move_gates = true;
-        parsed_options->max_move_penalty = utils::parse_uint(use_moves);
+        QL_ASSERT(false);
     }
 
-    parsed_options->reverse_swap_if_better = options["reverse_swap_if_better"].as_bool();
-    parsed_options->commute_multi_qubit = options["commute_multi_qubit"].as_bool();
-    parsed_options->commute_single_qubit = options["commute_single_qubit"].as_bool();
-    parsed_options->write_dot_graphs = options["write_dot_graphs"].as_bool();
+    if (options["portfolio_threads"].as_str() == "auto") {
+        parsed_options->portfolio_threads = utils::get_default_num_threads();
+    } else {
+        parsed_options->portfolio_threads = options["portfolio_threads"].as_uint();
+    }
 
-    parsed_options->decomposition_rule_name_pattern = options["decomposition_rule_name_pattern"].as_str();
+    // Parse the portfolio configurations. The overrides are applied to our
+    // own options temporarily, such that they are validated and parsed the
+    // same way as the pass options themselves.
+    for (const auto &entry : split_list(options["portfolio"].as_str(), ';')) {
+        utils::UInt seed = parsed_options->random_seed;
+        utils::List<utils::Pair<utils::Str, utils::Pair<utils::Bool, utils::Str>>> saved;
+        try {
+            for (const auto &assignment : split_list(entry, ',')) {
+                auto eq = assignment.find('=');
+                if (eq == utils::Str::npos) {
+                    QL_USER_ERROR("expected option=value but found \"" << assignment << "\"");
+                }
+                auto key = strip(assignment.substr(0, eq));
+                auto value = strip(assignment.substr(eq + 1));
+                if (key == "seed") {
+                    seed = utils::parse_uint(value);
+                    continue;
+                }
+                if (utils::starts_with(key, "portfolio") || key == "write_dot_graphs") {
+                    QL_USER_ERROR("option " << key << " cannot be varied within a portfolio");
+                }
+                auto &option = options[key];
+                saved.push_back({key, {option.is_set(), option.as_str()}});
+                option.set(value);
+            }
+        } catch (utils::Exception &e) {
+            e.add_context("in portfolio configuration \"" + entry + "\"");
+            restore_options(options, saved);
+            throw;
+        }
+        detail::PortfolioCandidate candidate{entry, {}};
+        candidate.second.emplace();
+        parse_options(options, *candidate.second);
+        candidate.second->random_seed = seed;
+        restore_options(options, saved);
+        parsed_options->portfolio.push_back(candidate);
+    }
 
     return pmgr::pass_types::NodeType::NORMAL;
 }
 
+pmgr::analysis::Types MapQubitsPass::get_required_analyses() const {
+    return {pmgr::analysis::Type::DDG};
+}
+
+pmgr::analysis::Types MapQubitsPass::get_preserved_analyses() const {
+    return {pmgr::analysis::Type::CFG};
+}
+
 utils::Int MapQubitsPass::run(
     const ir::Ref &ir,
     const pmgr::pass_types::Context &context
 ) const {
     parsed_options->output_prefix = context.output_prefix;
+    for (const auto &candidate : parsed_options->portfolio) {
+        candidate.second->output_prefix = context.output_prefix;
+    }
     detail::Mapper(ir->platform, parsed_options.as_const()).map(ir->program);
     return 0;
 }
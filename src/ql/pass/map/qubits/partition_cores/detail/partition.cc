@@ -0,0 +1,713 @@
+/** \file
+ * Multilevel k-way graph partitioner used to assign virtual qubits to the
+ * cores of a multi-core platform.
+ */
+
+#include "partition.h"
+
+#include <algorithm>
+#include <queue>
+#include "ql/utils/pair.h"
+#include "ql/utils/exception.h"
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace partition_cores {
+namespace detail {
+
+using namespace utils;
+
+namespace {
+
+/**
+ * Tolerance for comparing gains.
+ */
+const Real EPSILON = 1.0e-9;
+
+/**
+ * Coarsening stops when the graph has at most this many vertices per part.
+ */
+const UInt COARSEST_VERTICES_PER_PART = 16;
+
+/**
+ * Coarsening stops when a level does not reduce the number of vertices to
+ * at most this fraction of the previous level.
+ */
+const Real MIN_COARSENING_RATIO = 0.95;
+
+/**
+ * A refinement pass stops after this many consecutive moves that did not
+ * improve the best partitioning found in the pass.
+ */
+const UInt MAX_NON_IMPROVING_MOVES = 100;
+
+/**
+ * Max-heap of gains and vertices, used with lazy invalidation.
+ */
+using Heap = std::priority_queue<Pair<Real, UInt>>;
+
+/**
+ * A partitioning of a graph that is being refined.
+ */
+class Partitioning {
+private:
+
+    /**
+     * Scratch space for get_connectivity(), indexed by part.
+     */
+    Vec<Real> connectivity;
+
+    /**
+     * The parts for which connectivity is currently nonzero.
+     */
+    Vec<UInt> touched;
+
+public:
+
+    /**
+     * The graph being partitioned.
+     */
+    const Graph &graph;
+
+    /**
+     * The number of parts.
+     */
+    UInt num_parts;
+
+    /**
+     * The part of each vertex.
+     */
+    Vec<UInt> parts;
+
+    /**
+     * The total vertex weight of each part.
+     */
+    Vec<UInt> loads;
+
+    /**
+     * Wraps the given partitioning.
+     */
+    Partitioning(const Graph &graph, UInt num_parts, const Vec<UInt> &parts) :
+        connectivity(num_parts, 0.0),
+        graph(graph),
+        num_parts(num_parts),
+        parts(parts),
+        loads(num_parts, 0)
+    {
+        for (UInt v = 0; v < graph.size(); v++) {
+            loads[parts[v]] += graph.vertex_weights[v];
+        }
+    }
+
+    /**
+     * Returns the total weight of the edges from v to each part. The result
+     * is valid until the next call.
+     */
+    const Vec<Real> &get_connectivity(UInt v) {
+        for (auto part : touched) {
+            connectivity[part] = 0.0;
+        }
+        touched.clear();
+        for (const auto &edge : graph.edges[v]) {
+            auto part = parts[edge.first];
+            if (connectivity[part] == 0.0) {
+                touched.push_back(part);
+            }
+            connectivity[part] += edge.second;
+        }
+        return connectivity;
+    }
+
+    /**
+     * Returns the gain of moving v from its current part to the given part.
+     */
+    Real get_gain(UInt v, UInt part) {
+        const auto &conn = get_connectivity(v);
+        return conn[part] - conn[parts[v]];
+    }
+
+    /**
+     * Returns the total amount by which the parts exceed the given capacity.
+     */
+    UInt get_overload(UInt capacity) const {
+        UInt overload = 0;
+        for (auto load : loads) {
+            if (load > capacity) {
+                overload += load - capacity;
+            }
+        }
+        return overload;
+    }
+
+    /**
+     * Finds the best part to move v to without exceeding the given capacity.
+     * Only parts that v is connected to are considered, unless the current
+     * part of v exceeds the capacity. Returns MAX if there is no such part.
+     */
+    UInt get_best_move(UInt v, UInt capacity, Real &gain) {
+        const auto &conn = get_connectivity(v);
+        auto own = parts[v];
+        auto weight = graph.vertex_weights[v];
+        auto overloaded = loads[own] > capacity;
+        auto best = MAX;
+        gain = 0.0;
+        for (UInt part = 0; part < num_parts; part++) {
+            if (part == own || loads[part] + weight > capacity) {
+                continue;
+            }
+            if (conn[part] == 0.0 && !overloaded) {
+                continue;
+            }
+            auto part_gain = conn[part] - conn[own];
+            if (
+                best == MAX || part_gain > gain + EPSILON ||
+                (part_gain > gain - EPSILON && loads[part] < loads[best])
+            ) {
+                best = part;
+                gain = part_gain;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * Moves v to the given part.
+     */
+    void move(UInt v, UInt part) {
+        loads[parts[v]] -= graph.vertex_weights[v];
+        loads[part] += graph.vertex_weights[v];
+        parts[v] = part;
+    }
+
+};
+
+/**
+ * Coarsens the given graph by heavy-edge matching, without creating vertices
+ * heavier than max_weight. Unconnected vertices are matched with each other.
+ * Returns the coarse graph and the coarse vertex for each fine vertex.
+ */
+Pair<Graph, Vec<UInt>> coarsen(const Graph &graph, UInt max_weight) {
+    auto n = graph.size();
+
+    // Visit low-degree vertices first, as they have the fewest options.
+    Vec<UInt> order(n);
+    for (UInt v = 0; v < n; v++) {
+        order[v] = v;
+    }
+    std::stable_sort(order.begin(), order.end(), [&graph](UInt a, UInt b) {
+        return graph.edges[a].size() < graph.edges[b].size();
+    });
+
+    // Match vertices.
+    Vec<UInt> match(n, MAX);
+    auto unconnected = MAX;
+    for (auto v : order) {
+        if (match[v] != MAX) {
+            continue;
+        }
+        auto best = MAX;
+        Real best_weight = 0.0;
+        for (const auto &edge : graph.edges[v]) {
+            auto u = edge.first;
+            if (
+                match[u] == MAX &&
+                graph.vertex_weights[u] + graph.vertex_weights[v] <= max_weight &&
+                (best == MAX || edge.second > best_weight)
+            ) {
+                best = u;
+                best_weight = edge.second;
+            }
+        }
+        if (best == MAX && graph.edges[v].empty()) {
+            if (
+                unconnected != MAX &&
+                graph.vertex_weights[unconnected] + graph.vertex_weights[v] <= max_weight
+            ) {
+                best = unconnected;
+                unconnected = MAX;
+            } else {
+                unconnected = v;
+                continue;
+            }
+        }
+        if (best == MAX) {
+            match[v] = v;
+        } else {
+            match[v] = best;
+            match[best] = v;
+        }
+    }
+
+    // Number the coarse vertices.
+    Vec<UInt> coarse(n, MAX);
+    UInt num_coarse = 0;
+    for (UInt v = 0; v < n; v++) {
+        if (coarse[v] != MAX) {
+            continue;
+        }
+        coarse[v] = num_coarse;
+        if (match[v] != MAX) {
+            coarse[match[v]] = num_coarse;
+        }
+        num_coarse++;
+    }
+
+    // Build the coarse graph.
+    Graph result(num_coarse);
+    for (auto &weight : result.vertex_weights) {
+        weight = 0;
+    }
+    for (UInt v = 0; v < n; v++) {
+        result.vertex_weights[coarse[v]] += graph.vertex_weights[v];
+        for (const auto &edge : graph.edges[v]) {
+            if (coarse[edge.first] != coarse[v]) {
+                result.edges[coarse[v]].set(coarse[edge.first]) += edge.second;
+            }
+        }
+    }
+
+    return {std::move(result), std::move(coarse)};
+}
+
+/**
+ * Computes an initial partitioning by greedy graph growing: vertices are
+ * assigned in order of decreasing connectivity to the vertices assigned so
+ * far, to the part they are most connected to that still has room. Parts may
+ * exceed the capacity if a vertex fits nowhere; this is fixed by refinement
+ * and rebalancing.
+ */
+Vec<UInt> initial_partition(const Graph &graph, UInt num_parts, UInt capacity) {
+    auto n = graph.size();
+    Vec<UInt> parts(n, MAX);
+    Vec<UInt> loads(num_parts, 0);
+    Vec<Vec<Real>> connectivity(n, Vec<Real>(num_parts, 0.0));
+
+    // Priority is the connectivity to a part, then the vertex weight.
+    std::priority_queue<Pair<Pair<Real, UInt>, UInt>> queue;
+    for (UInt v = 0; v < n; v++) {
+        queue.push({{0.0, graph.vertex_weights[v]}, v});
+    }
+    while (!queue.empty()) {
+        auto v = queue.top().second;
+        queue.pop();
+        if (parts[v] != MAX) {
+            continue;
+        }
+        auto weight = graph.vertex_weights[v];
+        auto best = MAX;
+        for (UInt part = 0; part < num_parts; part++) {
+            if (loads[part] + weight > capacity) {
+                continue;
+            }
+            if (
+                best == MAX || connectivity[v][part] > connectivity[v][best] + EPSILON ||
+                (connectivity[v][part] > connectivity[v][best] - EPSILON && loads[part] < loads[best])
+            ) {
+                best = part;
+            }
+        }
+        if (best == MAX) {
+            best = (UInt)(std::min_element(loads.begin(), loads.end()) - loads.begin());
+        }
+        parts[v] = best;
+        loads[best] += weight;
+        for (const auto &edge : graph.edges[v]) {
+            auto u = edge.first;
+            if (parts[u] == MAX) {
+                connectivity[u][best] += edge.second;
+                queue.push({{connectivity[u][best], graph.vertex_weights[u]}, u});
+            }
+        }
+    }
+    return parts;
+}
+
+/**
+ * Refines the given partitioning with k-way Fiduccia-Mattheyses passes. Each
+ * pass tentatively moves every vertex at most once, best gain first, and then
+ * rolls back to the best partitioning seen. Moves never make a part exceed
+ * the capacity, and moves out of parts that exceed it are always allowed, so
+ * the total overload never increases.
+ */
+void refine_moves(Partitioning &pt, UInt capacity, UInt max_passes) {
+    auto n = pt.graph.size();
+    for (UInt pass = 0; pass < max_passes; pass++) {
+        Vec<Bool> locked(n, false);
+        Heap heap;
+        for (UInt v = 0; v < n; v++) {
+            Real gain;
+            if (pt.get_best_move(v, capacity, gain) != MAX) {
+                heap.push({gain, v});
+            }
+        }
+
+        Vec<Pair<UInt, UInt>> moves;
+        Real total_gain = 0.0;
+        Real best_gain = 0.0;
+        auto best_overload = pt.get_overload(capacity);
+        UInt best_num_moves = 0;
+        UInt non_improving = 0;
+        while (!heap.empty() && non_improving < MAX_NON_IMPROVING_MOVES) {
+            auto entry = heap.top();
+            heap.pop();
+            auto v = entry.second;
+            if (locked[v]) {
+                continue;
+            }
+            Real gain;
+            auto target = pt.get_best_move(v, capacity, gain);
+            if (target == MAX) {
+                continue;
+            }
+            if (std::abs(gain - entry.first) > EPSILON) {
+                heap.push({gain, v});
+                continue;
+            }
+
+            moves.push_back({v, pt.parts[v]});
+            pt.move(v, target);
+            locked[v] = true;
+            total_gain += gain;
+            auto overload = pt.get_overload(capacity);
+            if (
+                overload < best_overload ||
+                (overload == best_overload && total_gain > best_gain + EPSILON)
+            ) {
+                best_overload = overload;
+                best_gain = total_gain;
+                best_num_moves = moves.size();
+                non_improving = 0;
+            } else {
+                non_improving++;
+            }
+
+            for (const auto &edge : pt.graph.edges[v]) {
+                auto u = edge.first;
+                if (!locked[u] && pt.get_best_move(u, capacity, gain) != MAX) {
+                    heap.push({gain, u});
+                }
+            }
+        }
+
+        // Roll back to the best partitioning.
+        while (moves.size() > best_num_moves) {
+            pt.move(moves.back().first, moves.back().second);
+            moves.pop_back();
+        }
+        if (!best_num_moves) {
+            break;
+        }
+    }
+}
+
+/**
+ * Moves vertices out of parts that exceed the given capacity until none do,
+ * cheapest (i.e. highest gain) first, to the part that loses the least. This
+ * is needed because refine_moves() only reduces the overload as far as its
+ * passes get: a pass stops after MAX_NON_IMPROVING_MOVES moves, which is easily
+ * reached when there are many boundary vertices with negative gain, and when
+ * no pass improves anything, no further passes are made. Every part with room
+ * is considered as a target, so this always succeeds when the vertex weights
+ * are one and the total weight does not exceed num_parts * capacity.
+ */
+void rebalance(Partitioning &pt, UInt capacity) {
+    auto n = pt.graph.size();
+    Heap heap;
+    for (UInt v = 0; v < n; v++) {
+        Real gain;
+        if (pt.loads[pt.parts[v]] > capacity && pt.get_best_move(v, capacity, gain) != MAX) {
+            heap.push({gain, v});
+        }
+    }
+    while (!heap.empty()) {
+        auto entry = heap.top();
+        heap.pop();
+        auto v = entry.second;
+        if (pt.loads[pt.parts[v]] <= capacity) {
+            continue;
+        }
+        Real gain;
+        auto target = pt.get_best_move(v, capacity, gain);
+        if (target == MAX) {
+            continue;
+        }
+        if (std::abs(gain - entry.first) > EPSILON) {
+            heap.push({gain, v});
+            continue;
+        }
+        pt.move(v, target);
+
+        // The gains of the neighbors that are still in overloaded parts
+        // changed. Gains that changed because a target part filled up are
+        // caught when the vertex is popped.
+        for (const auto &edge : pt.graph.edges[v]) {
+            auto u = edge.first;
+            if (pt.loads[pt.parts[u]] > capacity && pt.get_best_move(u, capacity, gain) != MAX) {
+                heap.push({gain, u});
+            }
+        }
+    }
+}
+
+/**
+ * Pops the vertex with the best up-to-date gain for moving from part "from"
+ * to part "to" from the given heap. Returns MAX if there is none.
+ */
+UInt pop_best(Partitioning &pt, Heap &heap, const Vec<Bool> &locked, UInt from, UInt to, Real &gain) {
+    while (!heap.empty()) {
+        auto entry = heap.top();
+        heap.pop();
+        auto v = entry.second;
+        if (locked[v] || pt.parts[v] != from) {
+            continue;
+        }
+        gain = pt.get_gain(v, to);
+        if (std::abs(gain - entry.first) > EPSILON) {
+            heap.push({gain, v});
+            continue;
+        }
+        return v;
+    }
+    return MAX;
+}
+
+/**
+ * Refines the given partitioning with Kernighan-Lin style swaps of vertices
+ * between pairs of parts, which preserves the loads exactly. This is what
+ * improves the partitioning when all parts are full, in which case no single
+ * vertex can be moved. All vertices must have unit weight.
+ */
+void refine_swaps(Partitioning &pt, UInt max_passes) {
+    auto n = pt.graph.size();
+    for (UInt pass = 0; pass < max_passes; pass++) {
+        Bool improved = false;
+        for (UInt a = 0; a < pt.num_parts; a++) {
+            for (UInt b = a + 1; b < pt.num_parts; b++) {
+
+                // Gather the vertices on the boundary between a and b.
+                Vec<Bool> locked(n, false);
+                Heap heap_a, heap_b;
+                for (UInt v = 0; v < n; v++) {
+                    auto part = pt.parts[v];
+                    if (part != a && part != b) {
+                        continue;
+                    }
+                    auto other = part == a ? b : a;
+                    const auto &conn = pt.get_connectivity(v);
+                    if (conn[other] > 0.0) {
+                        (part == a ? heap_a : heap_b).push({conn[other] - conn[part], v});
+                    }
+                }
+
+                // Greedily swap the best pairs while this improves the cut.
+                while (true) {
+                    Real gain_u, gain_v;
+                    auto u = pop_best(pt, heap_a, locked, a, b, gain_u);
+                    if (u == MAX) {
+                        break;
+                    }
+                    auto v = pop_best(pt, heap_b, locked, b, a, gain_v);
+                    if (v == MAX) {
+                        break;
+                    }
+                    auto gain = gain_u + gain_v;
+                    auto it = pt.graph.edges[u].find(v);
+                    if (it != pt.graph.edges[u].end()) {
+                        gain -= 2 * it->second;
+                    }
+                    if (gain <= EPSILON) {
+                        break;
+                    }
+                    pt.move(u, b);
+                    pt.move(v, a);
+                    locked[u] = true;
+                    locked[v] = true;
+                    improved = true;
+                    for (auto w : {u, v}) {
+                        for (const auto &edge : pt.graph.edges[w]) {
+                            auto x = edge.first;
+                            if (locked[x]) {
+                                continue;
+                            }
+                            if (pt.parts[x] == a) {
+                                heap_a.push({pt.get_gain(x, b), x});
+                            } else if (pt.parts[x] == b) {
+                                heap_b.push({pt.get_gain(x, a), x});
+                            }
+                        }
+                    }
+                }
+
+            }
+        }
+        if (!improved) {
+            break;
+        }
+    }
+}
+
+} // anonymous namespace
+
+/**
+ * Constructs a graph with the given number of unit-weight vertices and no
+ * edges.
+ */
+Graph::Graph(UInt num_vertices) :
+    vertex_weights(num_vertices, 1),
+    edges(num_vertices)
+{
+}
+
+/**
+ * Returns the number of vertices.
+ */
+UInt Graph::size() const {
+    return vertex_weights.size();
+}
+
+/**
+ * Adds the given weight to the edge between a and b. Self-loops are ignored.
+ */
+void Graph::add_edge(UInt a, UInt b, Real weight) {
+    if (a == b) {
+        return;
+    }
+    edges[a].set(b) += weight;
+    edges[b].set(a) += weight;
+}
+
+/**
+ * Returns the total weight of the edges between vertices in different parts.
+ */
+Real get_cut(const Graph &graph, const Vec<UInt> &parts) {
+    Real cut = 0.0;
+    for (UInt v = 0; v < graph.size(); v++) {
+        for (const auto &edge : graph.edges[v]) {
+            if (edge.first > v && parts[edge.first] != parts[v]) {
+                cut += edge.second;
+            }
+        }
+    }
+    return cut;
+}
+
+/**
+ * Partitions the vertices of the given graph into num_parts parts, such that
+ * the total vertex weight of each part is at most capacity, while minimizing
+ * the total weight of the edges between parts. The graph is coarsened by
+ * heavy-edge matching, partitioned greedily at the coarsest level, and then
+ * projected back while being refined with Fiduccia-Mattheyses moves at each
+ * level, followed by forced rebalancing and Kernighan-Lin style swaps at
+ * the finest level. The vertex weights must be one, and the total number of
+ * vertices must not exceed num_parts * capacity. Returns the part index for
+ * each vertex.
+ */
+Vec<UInt> partition(
+    const Graph &graph,
+    UInt num_parts,
+    UInt capacity,
+    const Options &options
+) {
+    QL_ASSERT(num_parts > 0);
+    QL_ASSERT(graph.size() <= num_parts * capacity);
+    if (num_parts == 1) {
+        return Vec<UInt>(graph.size(), 0);
+    }
+
+    // Coarsen the graph. Coarse vertices are limited to half a part, so the
+    // initial partitioning is unlikely to need to overload parts.
+    Vec<Graph> levels;
+    Vec<Vec<UInt>> projections;
+    levels.push_back(graph);
+    auto max_weight = max<UInt>(1, capacity / 2);
+    while (levels.back().size() > num_parts * COARSEST_VERTICES_PER_PART) {
+        auto coarse = coarsen(levels.back(), max_weight);
+        if (coarse.first.size() > MIN_COARSENING_RATIO * levels.back().size()) {
+            break;
+        }
+        projections.push_back(std::move(coarse.second));
+        levels.push_back(std::move(coarse.first));
+    }
+
+    // Partition the coarsest graph, then project the partitioning back to the
+    // finer graphs, refining it along the way. At the coarse levels, parts may
+    // exceed the capacity by a bit less than the heaviest vertex, as the
+    // coarse vertices may not allow a better fit.
+    auto parts = initial_partition(levels.back(), num_parts, capacity);
+    for (auto level = levels.size(); level-- > 0;) {
+        const auto &level_graph = levels[level];
+        if (level + 1 < levels.size()) {
+            Vec<UInt> fine_parts(level_graph.size());
+            for (UInt v = 0; v < level_graph.size(); v++) {
+                fine_parts[v] = parts[projections[level][v]];
+            }
+            parts = std::move(fine_parts);
+        }
+        auto heaviest = *std::max_element(level_graph.vertex_weights.begin(), level_graph.vertex_weights.end());
+        Partitioning pt(level_graph, num_parts, parts);
+        refine_moves(pt, capacity + heaviest - 1, options.max_passes);
+        parts = pt.parts;
+    }
+
+    // Force any remaining overload out of the parts, then do the final
+    // refinement by swapping, which works even when all parts are full.
+    Partitioning pt(graph, num_parts, parts);
+    rebalance(pt, capacity);
+    refine_swaps(pt, options.max_passes);
+    QL_ASSERT(pt.get_overload(capacity) == 0);
+    return pt.parts;
+}
+
+/**
+ * Assigns the vertices of each part to the real qubits of the corresponding
+ * core, i.e. qubits part * capacity up to (part + 1) * capacity. Within a
+ * core, the vertices with the most weight to other parts are assigned to the
+ * first num_comm_qubits qubits, which are the communication qubits. Returns
+ * the real qubit index for each vertex.
+ */
+Vec<UInt> assign_qubits(
+    const Graph &graph,
+    const Vec<UInt> &parts,
+    UInt num_parts,
+    UInt capacity,
+    UInt num_comm_qubits
+) {
+    Vec<Vec<UInt>> members(num_parts);
+    Vec<Real> external(graph.size(), 0.0);
+    for (UInt v = 0; v < graph.size(); v++) {
+        members[parts[v]].push_back(v);
+        for (const auto &edge : graph.edges[v]) {
+            if (parts[edge.first] != parts[v]) {
+                external[v] += edge.second;
+            }
+        }
+    }
+
+    Vec<UInt> result(graph.size(), MAX);
+    for (UInt part = 0; part < num_parts; part++) {
+        auto &vertices = members[part];
+        QL_ASSERT(vertices.size() <= capacity);
+
+        // Move the vertices with the most inter-core interaction to the
+        // front, keeping the others in their original order.
+        auto num_comm = min<UInt>(num_comm_qubits, vertices.size());
+        std::stable_sort(vertices.begin(), vertices.end(), [&external](UInt a, UInt b) {
+            return external[a] > external[b];
+        });
+        std::sort(vertices.begin() + num_comm, vertices.end());
+
+        for (UInt slot = 0; slot < vertices.size(); slot++) {
+            result[vertices[slot]] = part * capacity + slot;
+        }
+    }
+    return result;
+}
+
+} // namespace detail
+} // namespace partition_cores
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
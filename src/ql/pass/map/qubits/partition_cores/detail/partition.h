@@ -0,0 +1,111 @@
+/** \file
+ * Multilevel k-way graph partitioner used to assign virtual qubits to the
+ * cores of a multi-core platform.
+ */
+
+#pragma once
+
+#include "ql/utils/num.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/map.h"
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace partition_cores {
+namespace detail {
+
+/**
+ * An undirected graph with weighted vertices and edges. For qubit
+ * partitioning, the vertices are virtual qubits and the edge weights count
+ * (weighted) two-qubit interactions.
+ */
+struct Graph {
+
+    /**
+     * The weight of each vertex.
+     */
+    utils::Vec<utils::UInt> vertex_weights;
+
+    /**
+     * The edges of each vertex, as a map from neighbor to edge weight. Always
+     * symmetric, and without self-loops.
+     */
+    utils::Vec<utils::Map<utils::UInt, utils::Real>> edges;
+
+    /**
+     * Constructs a graph with the given number of unit-weight vertices and
+     * no edges.
+     */
+    explicit Graph(utils::UInt num_vertices = 0);
+
+    /**
+     * Returns the number of vertices.
+     */
+    utils::UInt size() const;
+
+    /**
+     * Adds the given weight to the edge between a and b. Self-loops are
+     * ignored.
+     */
+    void add_edge(utils::UInt a, utils::UInt b, utils::Real weight);
+
+};
+
+/**
+ * Options for the partitioner.
+ */
+struct Options {
+
+    /**
+     * The maximum number of refinement passes per level.
+     */
+    utils::UInt max_passes = 8;
+
+};
+
+/**
+ * Returns the total weight of the edges between vertices in different parts.
+ */
+utils::Real get_cut(const Graph &graph, const utils::Vec<utils::UInt> &parts);
+
+/**
+ * Partitions the vertices of the given graph into num_parts parts, such that
+ * the total vertex weight of each part is at most capacity, while minimizing
+ * the total weight of the edges between parts. The graph is coarsened by
+ * heavy-edge matching, partitioned greedily at the coarsest level, and then
+ * projected back while being refined with Fiduccia-Mattheyses moves at each
+ * level, followed by forced rebalancing and Kernighan-Lin style swaps at
+ * the finest level. The vertex weights must be one, and the total number of
+ * vertices must not exceed num_parts * capacity. Returns the part index for
+ * each vertex.
+ */
+utils::Vec<utils::UInt> partition(
+    const Graph &graph,
+    utils::UInt num_parts,
+    utils::UInt capacity,
+    const Options &options = {}
+);
+
+/**
+ * Assigns the vertices of each part to the real qubits of the corresponding
+ * core, i.e. qubits part * capacity up to (part + 1) * capacity. Within a
+ * core, the vertices with the most weight to other parts are assigned to the
+ * first num_comm_qubits qubits, which are the communication qubits. Returns
+ * the real qubit index for each vertex.
+ */
+utils::Vec<utils::UInt> assign_qubits(
+    const Graph &graph,
+    const utils::Vec<utils::UInt> &parts,
+    utils::UInt num_parts,
+    utils::UInt capacity,
+    utils::UInt num_comm_qubits
+);
+
+} // namespace detail
+} // namespace partition_cores
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
@@ -0,0 +1,183 @@
+/** \file
+ * Defines the multi-core qubit partitioning pass.
+ */
+
+#include "ql/pass/map/qubits/partition_cores/partition_cores.h"
+
+#include <cmath>
+#include "detail/partition.h"
+#include "ql/com/ana/interaction_matrix.h"
+#include "ql/com/map/reference_updater.h"
+#include "ql/ir/ir.h"
+#include "ql/pass/ana/statistics/annotations.h"
+#include "ql/pmgr/factory.h"
+
+namespace ql {
+namespace pass {
+namespace map {
+namespace qubits {
+namespace partition_cores {
+
+bool PartitionCoresPass::is_pass_registered = pmgr::Factory::register_pass<PartitionCoresPass>("map.qubits.PartitionCores");
+
+/**
+ * Builds the qubit interaction graph of a program. Each two-qubit gate adds
+ * its weight to the edge between its operands. When window_size is nonzero,
+ * the weight of a gate is window_decay^w, where w is the index of the window
+ * of window_size two-qubit gates it falls in, such that the partitioning
+ * favors the interactions that occur first.
+ */
+static detail::Graph build_interaction_graph(
+    const ir::Ref &ir,
+    utils::UInt window_size,
+    utils::Real window_decay
+) {
+    using com::ana::SparseInteractionMatrix;
+    detail::Graph graph{ir->platform->qubits->shape[0]};
+
+    // Without windows, the weights are just the interaction counts.
+    if (!window_size) {
+        auto matrix = SparseInteractionMatrix::from_program(ir);
+        for (const auto &entry : matrix.get_entries()) {
+            graph.add_edge(entry.first, entry.second, (utils::Real)entry.count);
+        }
+        return graph;
+    }
+
+    // Otherwise, walk the interactions in program order.
+    utils::UInt num_gates = 0;
+    for (const auto &block : ir->program->blocks) {
+        SparseInteractionMatrix::for_each_interaction(
+            ir, block,
+            [&](utils::UInt first, utils::UInt second) {
+                auto window = (utils::Real)(num_gates++ / window_size);
+                graph.add_edge(first, second, std::pow(window_decay, window));
+            }
+        );
+    }
+    return graph;
+}
+
+/**
+ * Dumps docs for the multi-core qubit partitioner.
+ */
+void PartitionCoresPass::dump_docs(
+    std::ostream &os,
+    const utils::Str &line_prefix
+) const {
+    utils::dump_str(os, line_prefix, R"(
+    This pass computes an initial mapping of virtual to real qubits for
+    multi-core platforms, that minimizes the amount of interaction between
+    qubits on different cores. It builds the interaction graph of the program,
+    in which the weight of the edge between two qubits is the number of
+    two-qubit gates between them, and partitions it into one part per core
+    with at most num_qubits_per_core qubits each, using multilevel graph
+    partitioning: the graph is coarsened by heavy-edge matching, partitioned
+    greedily, and then projected back to the original graph while refining
+    the partitioning with Fiduccia-Mattheyses and Kernighan-Lin style moves.
+
+    Within each core, the qubits that interact most with other cores are
+    assigned to the communication qubits, the others keep their relative
+    order. The resulting mapping is applied to the program, such that the
+    router starts from it. Nothing is done for single-core platforms.
+
+    Because only a single mapping is produced, the interaction graph can
+    optionally be weighted by time: with window_size set, the two-qubit gates
+    are grouped into windows of that many gates in program order, and the
+    weight of the gates in each window is window_decay times that of the
+    previous window. This favors keeping the qubits that interact early in the
+    program together, leaving later interactions to the router.
+    )");
+}
+
+/**
+ * Returns a user-friendly type name for this pass.
+ */
+utils::Str PartitionCoresPass::get_friendly_type() const {
+    return "Multi-core qubit partitioner";
+}
+
+/**
+ * Constructs a multi-core qubit partitioner.
+ */
+PartitionCoresPass::PartitionCoresPass(
+    const utils::Ptr<const pmgr::Factory> &pass_factory,
+    const utils::Str &instance_name,
+    const utils::Str &type_name
+) : pmgr::pass_types::Transformation(pass_factory, instance_name, type_name) {
+    options.add_int(
+        "window_size",
+        "The number of two-qubit gates per time window. The interactions in "
+        "each window are weighted window_decay times as much as those of the "
+        "previous window. When zero, all interactions are weighted equally.",
+        "0", 0, utils::MAX
+    );
+    options.add_real(
+        "window_decay",
+        "The factor by which the weight of interactions decreases from one "
+        "time window to the next. Only used when window_size is nonzero.",
+        "0.5", 0.0, 1.0
+    );
+    options.add_int(
+        "max_passes",
+        "The maximum number of refinement passes per coarsening level.",
+        "8", 1, utils::MAX
+    );
+}
+
+/**
+ * Runs multi-core qubit partitioning.
+ */
+utils::Int PartitionCoresPass::run(
+    const ir::Ref &ir,
+    const pmgr::pass_types::Context &/* context */
+) const {
+    const auto &topology = ir->platform->topology;
+    auto num_cores = topology->get_num_cores();
+    if (num_cores <= 1 || ir->program.empty()) {
+        return 0;
+    }
+    auto num_qubits = ir->platform->qubits->shape[0];
+    auto qubits_per_core = topology->get_num_qubits_per_core();
+
+    auto graph = build_interaction_graph(
+        ir,
+        options["window_size"].as_uint(),
+        options["window_decay"].as_real()
+    );
+
+    detail::Options opts;
+    opts.max_passes = options["max_passes"].as_uint();
+    auto parts = detail::partition(graph, num_cores, qubits_per_core, opts);
+    auto mapping = detail::assign_qubits(graph, parts, num_cores, qubits_per_core, topology->get_num_comm_qubits());
+
+    // Report the inter-core interaction before and after.
+    utils::Vec<utils::UInt> old_parts(num_qubits);
+    utils::Bool identity = true;
+    for (utils::UInt q = 0; q < num_qubits; q++) {
+        old_parts[q] = topology->get_core_index(q);
+        identity &= mapping[q] == q;
+    }
+    ana::statistics::AdditionalStats::push(
+        ir->program,
+        "inter-core interaction before partitioning: " +
+        utils::to_string(detail::get_cut(graph, old_parts))
+    );
+    ana::statistics::AdditionalStats::push(
+        ir->program,
+        "inter-core interaction after partitioning: " +
+        utils::to_string(detail::get_cut(graph, parts))
+    );
+
+    if (!identity) {
+        com::map::mapProgram(ir->platform, mapping, ir->program);
+    }
+
+    return 0;
+}
+
+} // namespace partition_cores
+} // namespace qubits
+} // namespace map
+} // namespace pass
+} // namespace ql
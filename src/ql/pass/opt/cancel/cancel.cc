@@ -0,0 +1,659 @@
+/** \file
+ * Commutation-aware gate cancellation pass.
+ */
+
+#include "ql/pass/opt/cancel/cancel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include "ql/utils/set.h"
+#include "ql/ir/ops.h"
+#include "ql/ir/describe.h"
+#include "ql/com/ddg/build.h"
+#include "ql/com/ddg/ops.h"
+#include "ql/pmgr/pass_types/base.h"
+#include "ql/pmgr/factory.h"
+#include "ql/pass/ana/statistics/annotations.h"
+
+#define DEBUG(x) QL_DOUT(x)
+
+namespace ql {
+namespace pass {
+namespace opt {
+namespace cancel {
+
+namespace {
+
+/**
+ * Tolerance for merged rotation angles to be considered zero.
+ */
+const utils::Real EPSILON = 1.0e-9;
+
+/**
+ * The ways in which two gates of the same class can cancel.
+ */
+enum class Kind {
+
+    /**
+     * The gate is its own inverse.
+     */
+    SELF_INVERSE,
+
+    /**
+     * Gates of the same class with opposite sign are each other's inverse.
+     */
+    INVERSE_PAIR,
+
+    /**
+     * Rotations about the same axis, merged by adding their angles.
+     */
+    ROTATION
+
+};
+
+/**
+ * Cancellation behavior of a gate.
+ */
+struct GateClass {
+
+    /**
+     * Name of the class. Only gates of the same class can cancel.
+     */
+    utils::Str name;
+
+    /**
+     * How gates of this class cancel.
+     */
+    Kind kind;
+
+    /**
+     * For INVERSE_PAIR, the sign of the gate within the pair.
+     */
+    utils::Int sign;
+
+    /**
+     * Whether the order of the qubit operands is irrelevant.
+     */
+    utils::Bool symmetric;
+
+};
+
+/**
+ * Returns the cancellation behavior for the gate with the given name, based
+ * on the names of OpenQL's default gates. Returns false if the gate is not
+ * known to cancel with anything.
+ */
+utils::Bool get_gate_class(const utils::Str &name, GateClass &cls) {
+    static const utils::Map<utils::Str, GateClass> CLASSES = {
+        {"x",       {"x",    Kind::SELF_INVERSE, 0, false}},
+        {"x180",    {"x",    Kind::SELF_INVERSE, 0, false}},
+        {"rx180",   {"x",    Kind::SELF_INVERSE, 0, false}},
+        {"y",       {"y",    Kind::SELF_INVERSE, 0, false}},
+        {"y180",    {"y",    Kind::SELF_INVERSE, 0, false}},
+        {"ry180",   {"y",    Kind::SELF_INVERSE, 0, false}},
+        {"z",       {"z",    Kind::SELF_INVERSE, 0, false}},
+        {"h",       {"h",    Kind::SELF_INVERSE, 0, false}},
+        {"hadamard",{"h",    Kind::SELF_INVERSE, 0, false}},
+        {"cnot",    {"cnot", Kind::SELF_INVERSE, 0, false}},
+        {"cx",      {"cnot", Kind::SELF_INVERSE, 0, false}},
+        {"cz",      {"cz",   Kind::SELF_INVERSE, 0, true}},
+        {"swap",    {"swap", Kind::SELF_INVERSE, 0, true}},
+        {"toffoli", {"toffoli", Kind::SELF_INVERSE, 0, false}},
+        {"s",       {"s",    Kind::INVERSE_PAIR, 1, false}},
+        {"sdag",    {"s",    Kind::INVERSE_PAIR, -1, false}},
+        {"t",       {"t",    Kind::INVERSE_PAIR, 1, false}},
+        {"tdag",    {"t",    Kind::INVERSE_PAIR, -1, false}},
+        {"x90",     {"x90",  Kind::INVERSE_PAIR, 1, false}},
+        {"rx90",    {"x90",  Kind::INVERSE_PAIR, 1, false}},
+        {"xm90",    {"x90",  Kind::INVERSE_PAIR, -1, false}},
+        {"mx90",    {"x90",  Kind::INVERSE_PAIR, -1, false}},
+        {"rxm90",   {"x90",  Kind::INVERSE_PAIR, -1, false}},
+        {"y90",     {"y90",  Kind::INVERSE_PAIR, 1, false}},
+        {"ry90",    {"y90",  Kind::INVERSE_PAIR, 1, false}},
+        {"ym90",    {"y90",  Kind::INVERSE_PAIR, -1, false}},
+        {"my90",    {"y90",  Kind::INVERSE_PAIR, -1, false}},
+        {"rym90",   {"y90",  Kind::INVERSE_PAIR, -1, false}},
+        {"x45",     {"x45",  Kind::INVERSE_PAIR, 1, false}},
+        {"rx45",    {"x45",  Kind::INVERSE_PAIR, 1, false}},
+        {"xm45",    {"x45",  Kind::INVERSE_PAIR, -1, false}},
+        {"mx45",    {"x45",  Kind::INVERSE_PAIR, -1, false}},
+        {"rxm45",   {"x45",  Kind::INVERSE_PAIR, -1, false}},
+        {"rx",      {"rx",   Kind::ROTATION, 0, false}},
+        {"ry",      {"ry",   Kind::ROTATION, 0, false}},
+        {"rz",      {"rz",   Kind::ROTATION, 0, false}}
+    };
+    auto it = CLASSES.find(name);
+    if (it == CLASSES.end()) {
+        return false;
+    }
+    cls = it->second;
+    return true;
+}
+
+/**
+ * A gate that may cancel with or merge into another gate.
+ */
+struct Gate {
+
+    /**
+     * The cancellation behavior of the gate.
+     */
+    GateClass cls;
+
+    /**
+     * The name of the (generalized) instruction.
+     */
+    utils::Str name;
+
+    /**
+     * Key identifying the class and qubit operands. Only gates with the same
+     * key can cancel.
+     */
+    utils::Str key;
+
+    /**
+     * The qubit operands.
+     */
+    utils::Vec<utils::UInt> qubits;
+
+    /**
+     * The angle of rotations, updated when rotations are merged.
+     */
+    utils::Real angle = 0.0;
+
+};
+
+/**
+ * Helper class for the gate cancellation pass, operating on a single block.
+ * Nodes are identified by their order in the data dependency graph, so the
+ * statement with index i in the block is node i + 1, and the source and sink
+ * are nodes 0 and N + 1.
+ */
+class Canceller {
+private:
+
+    /**
+     * The IR that we're operating on.
+     */
+    const ir::Ref &ir;
+
+    /**
+     * The block that we're operating on.
+     */
+    const ir::BlockBaseRef &block;
+
+    /**
+     * The predecessors of each node. As nodes are removed, edges are added
+     * from their predecessors to their successors, so this remains
+     * conservative. May contain duplicates and removed nodes.
+     */
+    utils::Vec<utils::Vec<utils::UInt>> predecessors;
+
+    /**
+     * The successors of each node, with the same caveats as predecessors.
+     */
+    utils::Vec<utils::Vec<utils::UInt>> successors;
+
+    /**
+     * Whether each node has been removed.
+     */
+    utils::Vec<utils::Bool> removed;
+
+    /**
+     * The cancellable gates, indexed by node.
+     */
+    utils::Map<utils::UInt, Gate> gates;
+
+    /**
+     * The nodes that have not been removed for each gate key.
+     */
+    utils::Map<utils::Str, utils::Set<utils::UInt>> nodes_by_key;
+
+    /**
+     * Replacements for merged rotations, indexed by node.
+     */
+    utils::Map<utils::UInt, ir::InstructionRef> replacements;
+
+    /**
+     * The nodes that still need to be checked for a cancellation partner.
+     */
+    utils::Set<utils::UInt> worklist;
+
+    /**
+     * The number of gates removed so far.
+     */
+    utils::UInt num_removed = 0;
+
+    /**
+     * Returns the statement for the given node.
+     */
+    const ir::StatementRef &get_statement(utils::UInt node) const {
+        return block->statements[node - 1];
+    }
+
+    /**
+     * Returns the qubit index if the given expression is a reference to a
+     * single qubit, or MAX if it is not.
+     */
+    utils::UInt get_qubit(const ir::ExpressionRef &expr) const {
+        auto ref = expr->as_reference();
+        if (
+            !ref || ref->target != ir->platform->qubits ||
+            ref->data_type != ir->platform->qubits->data_type ||
+            ref->indices.size() != 1 || !ref->indices[0]->as_int_literal()
+        ) {
+            return utils::MAX;
+        }
+        return (utils::UInt)ref->indices[0]->as_int_literal()->value;
+    }
+
+    /**
+     * Returns whether the given statement is an unconditional gate that may
+     * cancel with another gate, and if so, describes it.
+     */
+    utils::Bool get_gate(const ir::StatementRef &stmt, Gate &gate) const {
+        auto custom = stmt->as_custom_instruction();
+        if (!custom) {
+            return false;
+        }
+        auto condition = custom->condition->as_bit_literal();
+        if (!condition || !condition->value) {
+            return false;
+        }
+        gate.name = get_generalization(custom->instruction_type)->name;
+        if (!get_gate_class(gate.name, gate.cls)) {
+            return false;
+        }
+        auto operands = get_operands(stmt.as<ir::Instruction>());
+        auto num_qubits = operands.size();
+        if (gate.cls.kind == Kind::ROTATION) {
+            if (operands.size() != 2) {
+                return false;
+            }
+            auto angle = operands[1]->as_real_literal();
+            if (!angle) {
+                return false;
+            }
+            gate.angle = angle->value;
+            num_qubits = 1;
+        } else if (num_qubits == 0) {
+            return false;
+        }
+        for (utils::UInt i = 0; i < num_qubits; i++) {
+            auto qubit = get_qubit(operands[i]);
+            if (qubit == utils::MAX) {
+                return false;
+            }
+            gate.qubits.push_back(qubit);
+        }
+        if (gate.cls.symmetric) {
+            std::sort(gate.qubits.begin(), gate.qubits.end());
+        }
+        gate.key = gate.cls.name;
+        for (auto qubit : gate.qubits) {
+            gate.key += "," + utils::to_string(qubit);
+        }
+        return true;
+    }
+
+    /**
+     * Adds an edge from node a to node b.
+     */
+    void add_edge(utils::UInt a, utils::UInt b) {
+        successors[a].push_back(b);
+        predecessors[b].push_back(a);
+    }
+
+    /**
+     * Returns whether gates a and b, with a before b, can be made adjacent by
+     * reordering commuting statements. This is the case when no statement in
+     * between depends on a or is depended on by b. Any such statement
+     * implies a direct successor of a or a direct predecessor of b in
+     * between them, so only the direct neighbors need to be checked.
+     */
+    utils::Bool can_be_made_adjacent(utils::UInt a, utils::UInt b) const {
+        for (auto succ : successors[a]) {
+            if (succ != b && succ < b && !removed[succ]) {
+                return false;
+            }
+        }
+        for (auto pred : predecessors[b]) {
+            if (pred != a && pred > a && !removed[pred]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Queues the next node after the given node with the given key, as its
+     * nearest potential partner may have changed.
+     */
+    void queue_next_with_key(const utils::Str &key, utils::UInt node) {
+        const auto &nodes = nodes_by_key.at(key);
+        auto it = nodes.upper_bound(node);
+        if (it != nodes.end()) {
+            worklist.insert(*it);
+        }
+    }
+
+    /**
+     * Marks the given node as removed.
+     */
+    void remove(utils::UInt node) {
+        removed[node] = true;
+        nodes_by_key.at(gates.at(node).key).erase(node);
+        num_removed++;
+    }
+
+    /**
+     * Removes gates a and b, which cancel out, connecting their predecessors
+     * to their successors.
+     */
+    void cancel(utils::UInt a, utils::UInt b) {
+        DEBUG(
+            "cancelling '" << ir::describe(get_statement(a)) << "' and '" <<
+            ir::describe(get_statement(b)) << "'"
+        );
+        utils::Set<utils::UInt> preds;
+        utils::Set<utils::UInt> succs;
+        for (auto node : {a, b}) {
+            for (auto pred : predecessors[node]) {
+                if (pred != a && pred != b && !removed[pred]) {
+                    preds.insert(pred);
+                }
+            }
+            for (auto succ : successors[node]) {
+                if (succ != a && succ != b && !removed[succ]) {
+                    succs.insert(succ);
+                }
+            }
+        }
+        const auto key = gates.at(a).key;
+        remove(a);
+        remove(b);
+        for (auto pred : preds) {
+            for (auto succ : succs) {
+                add_edge(pred, succ);
+            }
+        }
+
+        // Any pair involving a neighbor of the removed gates may have become
+        // possible.
+        for (auto pred : preds) {
+            auto it = gates.find(pred);
+            if (it != gates.end()) {
+                queue_next_with_key(it->second.key, pred);
+            }
+        }
+        for (auto succ : succs) {
+            worklist.insert(succ);
+        }
+        queue_next_with_key(key, b);
+    }
+
+    /**
+     * Merges rotation b into rotation a, which becomes a rotation by the given
+     * angle. Returns false if no instruction could be made for the merged
+     * rotation.
+     */
+    utils::Bool merge(utils::UInt a, utils::UInt b, utils::Real angle) {
+        auto &gate = gates.at(a);
+        utils::Any<ir::Expression> operands;
+        operands.add(make_qubit_ref(ir->platform, gate.qubits[0]));
+        operands.emplace<ir::RealLiteral>(angle, find_type(ir, "real"));
+        auto insn = make_instruction(ir->platform, gate.name, operands, {}, true);
+        if (insn.empty()) {
+            return false;
+        }
+        DEBUG(
+            "merging '" << ir::describe(get_statement(a)) << "' and '" <<
+            ir::describe(get_statement(b)) << "' into '" << ir::describe(insn) << "'"
+        );
+        insn->cycle = get_statement(a)->cycle;
+        replacements.set(a) = insn;
+        gate.angle = angle;
+
+        // The merged gate takes over the dependencies of b. The predecessors
+        // of b all precede a and the successors of a all follow b, so this
+        // keeps the graph ordered.
+        for (auto pred : predecessors[b]) {
+            if (pred != a && !removed[pred]) {
+                add_edge(pred, a);
+            }
+        }
+        for (auto succ : successors[b]) {
+            if (!removed[succ]) {
+                add_edge(a, succ);
+            }
+        }
+        remove(b);
+        worklist.insert(a);
+        queue_next_with_key(gate.key, a);
+        return true;
+    }
+
+    /**
+     * Tries to cancel or merge the given node with the nearest preceding gate
+     * that has the same key.
+     */
+    void process(utils::UInt b) {
+        if (removed[b]) {
+            return;
+        }
+        auto it_b = gates.find(b);
+        if (it_b == gates.end()) {
+            return;
+        }
+        const auto &gate_b = it_b->second;
+        const auto &nodes = nodes_by_key.at(gate_b.key);
+        auto it = nodes.lower_bound(b);
+        if (it == nodes.begin()) {
+            return;
+        }
+        auto a = *std::prev(it);
+        const auto &gate_a = gates.at(a);
+        if (!can_be_made_adjacent(a, b)) {
+            return;
+        }
+        switch (gate_b.cls.kind) {
+            case Kind::SELF_INVERSE:
+                cancel(a, b);
+                break;
+            case Kind::INVERSE_PAIR:
+                if (gate_a.cls.sign != gate_b.cls.sign) {
+                    cancel(a, b);
+                }
+                break;
+            case Kind::ROTATION: {
+                auto angle = std::remainder(gate_a.angle + gate_b.angle, 2 * utils::PI);
+                if (std::abs(angle) < EPSILON) {
+                    cancel(a, b);
+                } else {
+                    merge(a, b, angle);
+                }
+                break;
+            }
+        }
+    }
+
+public:
+
+    /**
+     * Builds the dependency graph for the given block.
+     */
+    Canceller(const ir::Ref &ir, const ir::BlockBaseRef &block) : ir(ir), block(block) {
+        auto num_nodes = block->statements.size() + 2;
+        predecessors.resize(num_nodes);
+        successors.resize(num_nodes);
+        removed.resize(num_nodes, false);
+
+        // Build the commutation-aware data dependency graph, and copy its
+        // edges into our own, mutable representation.
+        com::ddg::build(ir->platform, block, true, true);
+        for (utils::UInt index = 0; index < block->statements.size(); index++) {
+            const auto &stmt = block->statements[index];
+            auto node = com::ddg::get_node(stmt);
+            QL_ASSERT((utils::UInt)node->order == index + 1);
+            for (const auto &succ : node->successors) {
+                add_edge(index + 1, com::ddg::get_node(succ.first)->order);
+            }
+            Gate gate;
+            if (get_gate(stmt, gate)) {
+                nodes_by_key.set(gate.key).insert(index + 1);
+                gates.set(index + 1) = std::move(gate);
+            }
+        }
+        com::ddg::clear(block);
+    }
+
+    /**
+     * Cancels and merges gates until a fixpoint is reached, and updates the
+     * block accordingly. Returns the number of gates removed.
+     */
+    utils::UInt run() {
+        for (const auto &it : gates) {
+            worklist.insert(it.first);
+        }
+        while (!worklist.empty()) {
+            auto node = *worklist.begin();
+            worklist.erase(worklist.begin());
+            process(node);
+        }
+        if (!num_removed) {
+            return 0;
+        }
+
+        // Rebuild the statement list.
+        auto &statements = block->statements.get_vec();
+        std::vector<utils::One<ir::Statement>> output;
+        output.reserve(statements.size() - num_removed);
+        for (utils::UInt index = 0; index < statements.size(); index++) {
+            auto node = index + 1;
+            if (removed[node]) {
+                continue;
+            }
+            auto it = replacements.find(node);
+            if (it != replacements.end()) {
+                output.push_back(it->second);
+            } else {
+                output.push_back(std::move(statements[index]));
+            }
+        }
+        statements = std::move(output);
+        return num_removed;
+    }
+
+};
+
+/**
+ * Runs the gate cancellation pass on the given block and recursively its
+ * sub-blocks. Returns the number of gates removed.
+ */
+utils::UInt cancel_block(const ir::Ref &ir, const ir::BlockBaseRef &block) {
+    auto num_removed = Canceller(ir, block).run();
+    for (const auto &statement : block->statements) {
+        if (auto if_else = statement->as_if_else()) {
+            for (const auto &branch : if_else->branches) {
+                num_removed += cancel_block(ir, branch->body);
+            }
+            if (!if_else->otherwise.empty()) {
+                num_removed += cancel_block(ir, if_else->otherwise);
+            }
+        } else if (auto loop = statement->as_loop()) {
+            num_removed += cancel_block(ir, loop->body);
+        }
+    }
+    return num_removed;
+}
+
+} // anonymous namespace
+
+bool CancelGatesPass::is_pass_registered = pmgr::Factory::register_pass<CancelGatesPass>("opt.Cancel");
+
+/**
+ * Dumps docs for the gate cancellation pass.
+ */
+void CancelGatesPass::dump_docs(
+    std::ostream &os,
+    const utils::Str &line_prefix
+) const {
+    utils::dump_str(os, line_prefix, R"(
+    This pass removes pairs of gates that cancel out, and merges pairs of
+    rotations about the same axis into a single rotation. Two gates are
+    considered if they act on the same qubits and can be made adjacent by
+    reordering the statements in between them in a way that respects the
+    commutation rules of the data dependency graph, i.e. the `COMMUTE_X`,
+    `COMMUTE_Y`, and `COMMUTE_Z` operand modes of the instructions. For
+    example, the two CZ gates in `cz q[0], q[1]; rz q[0], 0.5; cz q[0], q[1]`
+    cancel, because the rotation commutes with them.
+
+    The following gates are recognized by name, and must be unconditional:
+
+     - `x`, `y`, `z`, `h`, `cnot`, `cz`, `swap`, and `toffoli` (and aliases such
+       as `x180` and `cx`) cancel with themselves;
+     - `s`/`sdag`, `t`/`tdag`, `x90`/`xm90`, `y90`/`ym90`, and `x45`/`xm45` (and
+       aliases such as `rx90` and `mx90`) cancel with each other; and
+     - `rx`, `ry`, and `rz` with a literal angle merge by adding their angles,
+       and are removed when the result is a multiple of 2pi.
+
+    Cancellations are repeated until a fixpoint is reached, so nested pairs
+    such as `h; x; x; h` are removed completely. This is done with a worklist
+    that only revisits the neighbors of changed gates, so the pass runs in
+    near-linear time. Gates never cancel across block boundaries. The pass
+    returns the number of gates that were removed.
+
+    Merged rotations take the place of the first rotation, and removing gates
+    does not invalidate a schedule, so the pass can be used both before and
+    after scheduling.
+    )");
+}
+
+/**
+ * Returns a user-friendly type name for this pass.
+ */
+utils::Str CancelGatesPass::get_friendly_type() const {
+    return "Gate canceller";
+}
+
+/**
+ * Constructs a gate cancellation pass.
+ */
+CancelGatesPass::CancelGatesPass(
+    const utils::Ptr<const pmgr::Factory> &pass_factory,
+    const utils::Str &instance_name,
+    const utils::Str &type_name
+) : pmgr::pass_types::BlockTransformation(pass_factory, instance_name, type_name) {
+}
+
+/**
+ * Returns that cancelling gates in a block does not affect any other block.
+ */
+utils::Bool CancelGatesPass::is_block_local() const {
+    return true;
+}
+
+/**
+ * Runs the gate cancellation pass on the given top-level block.
+ */
+utils::Int CancelGatesPass::run_on_block(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block,
+    const utils::Str &/* block_name */,
+    const pmgr::pass_types::Context &/* context */
+) const {
+    auto num_removed = cancel_block(ir, block);
+    auto named = block.as<ir::Block>();
+    if (!named.empty()) {
+        ana::statistics::AdditionalStats::push(
+            named, "gates removed by cancellation: " + utils::to_string(num_removed)
+        );
+    }
+    return (utils::Int)num_removed;
+}
+
+} // namespace cancel
+} // namespace opt
+} // namespace pass
+} // namespace ql
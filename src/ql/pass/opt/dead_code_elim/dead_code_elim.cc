@@ -22,7 +22,7 @@ DeadCodeEliminationPass::DeadCodeEliminationPass(
     const utils::Ptr<const pmgr::Factory> &pass_factory,
     const utils::Str &instance_name,
     const utils::Str &type_name
-) : pmgr::pass_types::Transformation(pass_factory, instance_name, type_name) {
+) : pmgr::pass_types::BlockTransformation(pass_factory, instance_name, type_name) {
 }
 
 /**
@@ -33,9 +33,10 @@ utils::Str DeadCodeEliminationPass::get_friendly_type() const {
 }
 
 /**
- * Runs the dead code elimination pass on the given block.
+ * Runs the dead code elimination pass on the given block and recursively its
+ * sub-blocks.
  */
-void DeadCodeEliminationPass::run_on_block(
+void DeadCodeEliminationPass::eliminate_in_block(
     const ir::BlockBaseRef &block,
     utils::UInt level
 ) {
@@ -68,7 +69,7 @@ void DeadCodeEliminationPass::run_on_block(
                 if (auto condition = branch->condition->as_bit_literal()) {
                     if (condition->value) {   // condition 'true'
                         // descend body
-                        run_on_block(branch->body, level+1);
+                        eliminate_in_block(branch->body, level+1);
 
                         // delete subsequent if_else branches and if_else->otherwise, since these are unreachable
                         DEBUG(block_name << ": found 'if_else(true)': removing unreachable if_else-branches and if_else->otherwise");
@@ -103,14 +104,14 @@ void DeadCodeEliminationPass::run_on_block(
                 // condition is not a bit_literal
                 } else {
                     // descend body
-                    run_on_block(branch->body, level+1);
+                    eliminate_in_block(branch->body, level+1);
                 }
                 branch_idx++;
             }
 
             // descend otherwise
             if (!if_else->otherwise.empty()) {
-                run_on_block(if_else->otherwise, level+1);
+                eliminate_in_block(if_else->otherwise, level+1);
             }
 
             // if we no longer have branches, but do have otherwise, promote its body into statements within this block
@@ -136,7 +137,7 @@ void DeadCodeEliminationPass::run_on_block(
         // handle loop
         } else if (auto loop = statement->as_loop()) {
             // descend loop body
-            run_on_block(loop->body, level+1);
+            eliminate_in_block(loop->body, level+1);
 
             // NB: we currently have no real use for optimizing static loops, note that we cannot fully
             // remove loop anyway if break or continue exists
@@ -146,18 +147,23 @@ void DeadCodeEliminationPass::run_on_block(
 }
 
 /**
- * Runs the dead code elimination pass.
+ * Returns that dead code elimination in a block does not affect any other
+ * block.
  */
-utils::Int DeadCodeEliminationPass::run(
-    const ir::Ref &ir,
+utils::Bool DeadCodeEliminationPass::is_block_local() const {
+    return true;
+}
+
+/**
+ * Runs the dead code elimination pass on the given top-level block.
+ */
+utils::Int DeadCodeEliminationPass::run_on_block(
+    const ir::Ref &/* ir */,
+    const ir::BlockBaseRef &block,
+    const utils::Str &/* block_name */,
     const pmgr::pass_types::Context &/* context */
 ) const {
-    // perform dead code elimination
-    if (!ir->program.empty()) {
-        for (const auto &block : ir->program->blocks) {
-            run_on_block(block);
-        }
-    }
+    eliminate_in_block(block);
     return 0;
 }
 
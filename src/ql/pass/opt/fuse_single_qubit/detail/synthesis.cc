@@ -0,0 +1,489 @@
+/** \file
+ * Single-qubit unitary arithmetic and resynthesis into native gates for the
+ * single-qubit gate fusion pass.
+ */
+
+#include "ql/pass/opt/fuse_single_qubit/detail/synthesis.h"
+
+#include <cmath>
+#include <sstream>
+
+namespace ql {
+namespace pass {
+namespace opt {
+namespace fuse_single_qubit {
+namespace detail {
+
+using namespace utils;
+
+/**
+ * Tolerance used for comparing unitaries and for dropping rotations by
+ * (multiples of 2pi) zero.
+ */
+static const Real EPSILON = 1.0e-9;
+
+/**
+ * The maximum number of non-parameterized native gates that are combined
+ * when searching for fixed products.
+ */
+static const UInt MAX_PRODUCT_LENGTH = 3;
+
+/**
+ * Returns the identity matrix.
+ */
+Matrix Matrix::identity() {
+    return {{1.0, 0.0, 0.0, 1.0}};
+}
+
+/**
+ * Returns exp(-i*angle/2*sigma), where sigma is the Pauli matrix for the
+ * given axis.
+ */
+Matrix Matrix::rotation(Axis axis, Real angle) {
+    switch (axis) {
+        case Axis::X: return rotation(1.0, 0.0, 0.0, angle);
+        case Axis::Y: return rotation(0.0, 1.0, 0.0, angle);
+        case Axis::Z: return rotation(0.0, 0.0, 1.0, angle);
+    }
+    return identity();
+}
+
+/**
+ * Returns the rotation by the given angle about the given unit vector.
+ */
+Matrix Matrix::rotation(Real nx, Real ny, Real nz, Real angle) {
+    Real c = std::cos(angle / 2.0);
+    Real s = std::sin(angle / 2.0);
+    return {{
+        Complex(c, -s * nz), Complex(-s * ny, -s * nx),
+        Complex(s * ny, -s * nx), Complex(c, s * nz)
+    }};
+}
+
+/**
+ * Returns the matrix product of this and rhs.
+ */
+Matrix Matrix::operator*(const Matrix &rhs) const {
+    return {{
+        m[0] * rhs.m[0] + m[1] * rhs.m[2], m[0] * rhs.m[1] + m[1] * rhs.m[3],
+        m[2] * rhs.m[0] + m[3] * rhs.m[2], m[2] * rhs.m[1] + m[3] * rhs.m[3]
+    }};
+}
+
+/**
+ * Returns the conjugate transpose of this matrix.
+ */
+Matrix Matrix::adjoint() const {
+    return {{std::conj(m[0]), std::conj(m[2]), std::conj(m[1]), std::conj(m[3])}};
+}
+
+/**
+ * Returns whether this matrix equals the given matrix up to global phase.
+ */
+Bool Matrix::equivalent(const Matrix &other) const {
+    Complex trace = 0.0;
+    for (UInt i = 0; i < 4; i++) {
+        trace += std::conj(m[i]) * other.m[i];
+    }
+    return std::abs(trace) > 2.0 * (1.0 - EPSILON);
+}
+
+/**
+ * Scales the given unitary to determinant one, and returns its first column.
+ * The result is unique up to sign.
+ */
+static void get_special_column(const Matrix &u, Complex &a, Complex &b) {
+    Complex s = std::sqrt(u.m[0] * u.m[3] - u.m[1] * u.m[2]);
+    a = u.m[0] / s;
+    b = u.m[2] / s;
+}
+
+/**
+ * Returns a string that is the same for matrices that are equal up to
+ * global phase (and rounding), for use as a cache key.
+ */
+Str Matrix::get_key() const {
+
+    // A special unitary is fully described by its first column, and is unique
+    // up to sign.
+    Complex a, b;
+    get_special_column(*this, a, b);
+    Real values[4] = {a.real(), a.imag(), b.real(), b.imag()};
+    for (auto value : values) {
+        if (std::abs(value) > 1.0e-6) {
+            if (value < 0.0) {
+                for (auto &v : values) {
+                    v = -v;
+                }
+            }
+            break;
+        }
+    }
+
+    std::ostringstream ss;
+    for (auto value : values) {
+        ss << std::llround(value * 1.0e6) << ",";
+    }
+    return ss.str();
+}
+
+/**
+ * Returns the semantics of the single-qubit gate with the given name, based
+ * on the names of OpenQL's default gates. Returns false if the name is not
+ * recognized. The duration is left untouched.
+ */
+Bool get_default_semantics(const Str &name, NativeGate &gate) {
+    gate.name = name;
+    gate.parameterized = false;
+    gate.matrix = Matrix::identity();
+    auto fixed = [&gate](Axis axis, Real angle) {
+        gate.axis = axis;
+        gate.matrix = Matrix::rotation(axis, angle);
+        return true;
+    };
+    if (name == "rx" || name == "ry" || name == "rz") {
+        gate.parameterized = true;
+        gate.axis = name == "rx" ? Axis::X : name == "ry" ? Axis::Y : Axis::Z;
+        return true;
+    } else if (name == "i" || name == "identity") {
+        return true;
+    } else if (name == "h" || name == "hadamard") {
+        Real r = 1.0 / std::sqrt(2.0);
+        gate.matrix = {{r, r, r, -r}};
+        return true;
+    } else if (name == "x" || name == "x180" || name == "rx180") {
+        return fixed(Axis::X, PI);
+    } else if (name == "y" || name == "y180" || name == "ry180") {
+        return fixed(Axis::Y, PI);
+    } else if (name == "z") {
+        return fixed(Axis::Z, PI);
+    } else if (name == "s") {
+        return fixed(Axis::Z, PI / 2);
+    } else if (name == "sdag") {
+        return fixed(Axis::Z, -PI / 2);
+    } else if (name == "t") {
+        return fixed(Axis::Z, PI / 4);
+    } else if (name == "tdag") {
+        return fixed(Axis::Z, -PI / 4);
+    } else if (name == "x90" || name == "rx90") {
+        return fixed(Axis::X, PI / 2);
+    } else if (name == "xm90" || name == "mx90" || name == "rxm90") {
+        return fixed(Axis::X, -PI / 2);
+    } else if (name == "y90" || name == "ry90") {
+        return fixed(Axis::Y, PI / 2);
+    } else if (name == "ym90" || name == "my90" || name == "rym90") {
+        return fixed(Axis::Y, -PI / 2);
+    } else if (name == "x45" || name == "rx45") {
+        return fixed(Axis::X, PI / 4);
+    } else if (name == "xm45" || name == "mx45" || name == "rxm45") {
+        return fixed(Axis::X, -PI / 4);
+    }
+    return false;
+}
+
+/**
+ * Returns a unitary W such that W*Rz(t)*W^dagger = Rp(t) and
+ * W*Ry(t)*W^dagger = Rq(t) for all t. p and q must differ.
+ */
+static Matrix get_frame(Axis p, Axis q) {
+    Real r = 1.0 / std::sqrt(3.0);
+    switch (p) {
+        case Axis::X:
+            if (q == Axis::Y) return Matrix::rotation(Axis::Y, PI / 2);
+            return Matrix::rotation(r, r, r, 2 * PI / 3);
+        case Axis::Y:
+            if (q == Axis::X) return Matrix::rotation(r, r, r, -2 * PI / 3);
+            return Matrix::rotation(0.0, 1.0 / std::sqrt(2.0), 1.0 / std::sqrt(2.0), PI);
+        case Axis::Z:
+            if (q == Axis::X) return Matrix::rotation(Axis::Z, -PI / 2);
+            return Matrix::identity();
+    }
+    return Matrix::identity();
+}
+
+/**
+ * Decomposes u into Rp(a)*Rq(b)*Rp(c) up to global phase. p and q must differ.
+ */
+static void decompose_euler(const Matrix &u, Axis p, Axis q, Real &a, Real &b, Real &c) {
+    auto w = get_frame(p, q);
+    Complex ca, cb;
+    get_special_column(w.adjoint() * u * w, ca, cb);
+
+    // For the ZYZ decomposition, ca = exp(-i(a+c)/2)*cos(b/2) and
+    // cb = exp(i(a-c)/2)*sin(b/2).
+    b = 2 * std::atan2(std::abs(cb), std::abs(ca));
+    if (std::abs(cb) < EPSILON) {
+        a = -2 * std::arg(ca);
+        c = 0.0;
+    } else if (std::abs(ca) < EPSILON) {
+        a = 2 * std::arg(cb);
+        c = 0.0;
+    } else {
+        a = std::arg(cb) - std::arg(ca);
+        c = -std::arg(ca) - std::arg(cb);
+    }
+}
+
+/**
+ * Returns the axis and sign of the cross product of p and q, which must
+ * differ.
+ */
+static Axis get_cross_product(Axis p, Axis q, Real &sign) {
+    auto pi = static_cast<UInt>(p);
+    auto qi = static_cast<UInt>(q);
+    sign = (qi + 3 - pi) % 3 == 1 ? 1.0 : -1.0;
+    return static_cast<Axis>(3 - pi - qi);
+}
+
+/**
+ * Constructs a synthesizer for the given native gates.
+ */
+Synthesizer::Synthesizer(
+    const Vec<NativeGate> &native_gates,
+    UInt cache_size
+) :
+    natives(native_gates),
+    cache_size(cache_size)
+{
+
+    // Find the cheapest rotation gates.
+    for (UInt axis = 0; axis < 3; axis++) {
+        rotations[axis] = MAX;
+        quarter_turns[axis][0] = MAX;
+        quarter_turns[axis][1] = MAX;
+    }
+    auto update = [this](UInt &current, UInt candidate) {
+        if (current == MAX || natives[candidate].duration < natives[current].duration) {
+            current = candidate;
+        }
+    };
+    for (UInt i = 0; i < natives.size(); i++) {
+        const auto &native = natives[i];
+        if (native.parameterized) {
+            update(rotations[static_cast<UInt>(native.axis)], i);
+            continue;
+        }
+        for (UInt axis = 0; axis < 3; axis++) {
+            if (native.matrix.equivalent(Matrix::rotation(static_cast<Axis>(axis), PI / 2))) {
+                update(quarter_turns[axis][0], i);
+            } else if (native.matrix.equivalent(Matrix::rotation(static_cast<Axis>(axis), -PI / 2))) {
+                update(quarter_turns[axis][1], i);
+            }
+        }
+    }
+
+    // Find the cheapest products of up to MAX_PRODUCT_LENGTH non-parameterized
+    // gates by breadth-first search, only extending the cheapest sequence for
+    // each unitary.
+    Map<Str, Pair<Matrix, Sequence>> frontier;
+    frontier.set(Matrix::identity().get_key()) = {Matrix::identity(), {}};
+    products.set(Matrix::identity().get_key()) = {};
+    for (UInt length = 0; length < MAX_PRODUCT_LENGTH; length++) {
+        Map<Str, Pair<Matrix, Sequence>> next;
+        for (const auto &it : frontier) {
+            for (UInt i = 0; i < natives.size(); i++) {
+                if (natives[i].parameterized) {
+                    continue;
+                }
+                auto matrix = natives[i].matrix * it.second.first;
+                auto seq = it.second.second;
+                seq.push_back({i, 0.0});
+                auto key = matrix.get_key();
+                auto existing = products.find(key);
+                if (existing == products.end() || is_cheaper(seq, existing->second)) {
+                    products.set(key) = seq;
+                    next.set(key) = {matrix, seq};
+                }
+            }
+        }
+        frontier = std::move(next);
+    }
+
+}
+
+/**
+ * Returns the native gates.
+ */
+const Vec<NativeGate> &Synthesizer::get_natives() const {
+    return natives;
+}
+
+/**
+ * Returns the unitary implemented by the given sequence.
+ */
+Matrix Synthesizer::get_matrix(const Sequence &seq) const {
+    auto result = Matrix::identity();
+    for (const auto &gate : seq) {
+        const auto &native = natives[gate.native];
+        if (native.parameterized) {
+            result = Matrix::rotation(native.axis, gate.angle) * result;
+        } else {
+            result = native.matrix * result;
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the total duration of the given sequence.
+ */
+UInt Synthesizer::get_duration(const Sequence &seq) const {
+    UInt duration = 0;
+    for (const auto &gate : seq) {
+        duration += natives[gate.native].duration;
+    }
+    return duration;
+}
+
+/**
+ * Returns whether sequence a is cheaper than sequence b, i.e. whether it
+ * has a shorter duration, or the same duration and fewer gates.
+ */
+Bool Synthesizer::is_cheaper(const Sequence &a, const Sequence &b) const {
+    auto da = get_duration(a);
+    auto db = get_duration(b);
+    if (da != db) {
+        return da < db;
+    }
+    return a.size() < b.size();
+}
+
+/**
+ * Appends a rotation about the given axis to the given sequence, unless
+ * the angle is a multiple of 2pi.
+ */
+void Synthesizer::add_rotation(Sequence &seq, Axis axis, Real angle) const {
+    angle = std::remainder(angle, 2 * PI);
+    if (std::abs(angle) < EPSILON) {
+        return;
+    }
+    seq.push_back({rotations[static_cast<UInt>(axis)], angle});
+}
+
+/**
+ * Considers the given candidate sequence for implementing u, replacing
+ * best if it is valid and cheaper.
+ */
+void Synthesizer::consider(
+    const Matrix &u,
+    const Sequence &candidate,
+    Bool &found,
+    Sequence &best
+) const {
+    if (found && !is_cheaper(candidate, best)) {
+        return;
+    }
+    if (!get_matrix(candidate).equivalent(u)) {
+        return;
+    }
+    found = true;
+    best = candidate;
+}
+
+/**
+ * Synthesizes the cheapest sequence of native gates implementing u up to
+ * global phase. Returns false if no implementation was found.
+ */
+Bool Synthesizer::synthesize(const Matrix &u, Sequence &result) {
+    auto key = u.get_key();
+    auto cached = cache.find(key);
+    if (cached != cache.end()) {
+        result = cached->second.second;
+        return cached->second.first;
+    }
+
+    Bool found = false;
+    Sequence best;
+
+    // Products of fixed gates, including the empty sequence.
+    auto product = products.find(key);
+    if (product != products.end()) {
+        consider(u, product->second, found, best);
+    }
+
+    for (UInt pi = 0; pi < 3; pi++) {
+        if (rotations[pi] == MAX) {
+            continue;
+        }
+        auto p = static_cast<Axis>(pi);
+        Real a, b, c;
+
+        // A single rotation.
+        decompose_euler(u, p, static_cast<Axis>((pi + 1) % 3), a, b, c);
+        if (std::abs(std::remainder(b, 2 * PI)) < EPSILON) {
+            Sequence seq;
+            add_rotation(seq, p, a + c);
+            consider(u, seq, found, best);
+        }
+
+        for (UInt qi = 0; qi < 3; qi++) {
+            if (qi == pi) {
+                continue;
+            }
+            auto q = static_cast<Axis>(qi);
+
+            // Euler decomposition using two parameterized rotations.
+            if (rotations[qi] != MAX) {
+                decompose_euler(u, p, q, a, b, c);
+                Sequence seq;
+                add_rotation(seq, p, c);
+                add_rotation(seq, q, b);
+                add_rotation(seq, p, a);
+                consider(u, seq, found, best);
+            }
+
+            // Euler decomposition about p and p x q, using
+            // Rq(-pi/2)*Rp(b)*Rq(pi/2) = R(p x q)(b), and
+            // Rq(-pi/2) = Rp(pi)*Rq(pi/2)*Rp(-pi) for when only one of the
+            // quarter turns is available.
+            auto plus = quarter_turns[qi][0];
+            auto minus = quarter_turns[qi][1];
+            if (plus == MAX && minus == MAX) {
+                continue;
+            }
+            Real sign;
+            auto m = get_cross_product(p, q, sign);
+            decompose_euler(u, p, m, a, b, c);
+            b *= sign;
+            if (plus != MAX && minus != MAX) {
+                Sequence seq;
+                add_rotation(seq, p, c);
+                seq.push_back({plus, 0.0});
+                add_rotation(seq, p, b);
+                seq.push_back({minus, 0.0});
+                add_rotation(seq, p, a);
+                consider(u, seq, found, best);
+            }
+            if (plus != MAX) {
+                Sequence seq;
+                add_rotation(seq, p, c);
+                seq.push_back({plus, 0.0});
+                add_rotation(seq, p, b - PI);
+                seq.push_back({plus, 0.0});
+                add_rotation(seq, p, a + PI);
+                consider(u, seq, found, best);
+            }
+            if (minus != MAX) {
+                Sequence seq;
+                add_rotation(seq, p, c - PI);
+                seq.push_back({minus, 0.0});
+                add_rotation(seq, p, b + PI);
+                seq.push_back({minus, 0.0});
+                add_rotation(seq, p, a);
+                consider(u, seq, found, best);
+            }
+        }
+    }
+
+    if (cache.size() < cache_size) {
+        cache.set(key) = {found, best};
+    }
+    result = best;
+    return found;
+}
+
+} // namespace detail
+} // namespace fuse_single_qubit
+} // namespace opt
+} // namespace pass
+} // namespace ql
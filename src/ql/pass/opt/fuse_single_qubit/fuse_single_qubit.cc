@@ -0,0 +1,550 @@
+/** \file
+ * Single-qubit gate fusion pass.
+ */
+
+#include "ql/pass/opt/fuse_single_qubit/fuse_single_qubit.h"
+
+#include "ql/utils/set.h"
+#include "ql/utils/json.h"
+#include "ql/ir/ops.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/describe.h"
+#include "ql/pmgr/pass_types/base.h"
+#include "ql/pmgr/factory.h"
+#include "ql/pass/ana/statistics/annotations.h"
+#include "ql/pass/opt/fuse_single_qubit/detail/synthesis.h"
+
+#define DEBUG(x) QL_DOUT(x)
+
+namespace ql {
+namespace pass {
+namespace opt {
+namespace fuse_single_qubit {
+
+using namespace detail;
+
+namespace {
+
+/**
+ * A gate that is part of a run of fusable gates on a single qubit.
+ */
+struct RunGate {
+
+    /**
+     * Index of the statement in the block.
+     */
+    utils::UInt index;
+
+    /**
+     * The unitary implemented by the gate.
+     */
+    Matrix matrix;
+
+};
+
+/**
+ * Helper class for the single-qubit gate fusion pass.
+ */
+class Fuser {
+private:
+
+    /**
+     * The IR that we're operating on.
+     */
+    const ir::Ref &ir;
+
+    /**
+     * The synthesizer, which also holds the semantics of the native
+     * single-qubit gates.
+     */
+    utils::Ptr<Synthesizer> synthesizer;
+
+    /**
+     * Map from top-level instruction type to native gate index.
+     */
+    utils::Map<const ir::InstructionType*, utils::UInt> type_indices;
+
+    /**
+     * The real number type used for rotation angles.
+     */
+    ir::DataTypeLink real_type;
+
+    /**
+     * The pending runs of fusable gates per qubit.
+     */
+    utils::Map<utils::UInt, utils::Vec<RunGate>> runs;
+
+    /**
+     * The replacements for the first statement of each fused run.
+     */
+    utils::Map<utils::UInt, utils::Vec<ir::InstructionRef>> replacements;
+
+    /**
+     * The indices of the other statements of each fused run, which are
+     * removed.
+     */
+    utils::Set<utils::UInt> removed;
+
+    /**
+     * The statements of the block currently being processed.
+     */
+    const std::vector<utils::One<ir::Statement>> *statements = nullptr;
+
+    /**
+     * Parses the value of the "unitary" key of the JSON data of an
+     * instruction type into the given native gate.
+     */
+    static void parse_unitary(const utils::Json &json, NativeGate &gate) {
+        auto error = [&gate]() {
+            QL_USER_ERROR(
+                "invalid unitary for instruction " << gate.name << ": " <<
+                "expected a 2x2 unitary matrix in row-major order, formatted " <<
+                "as [[re, im], [re, im], [re, im], [re, im]]"
+            );
+        };
+        if (!json.is_array() || json.size() != 4) {
+            error();
+        }
+        for (utils::UInt i = 0; i < 4; i++) {
+            const auto &element = json[i];
+            if (
+                !element.is_array() || element.size() != 2 ||
+                !element[0].is_number() || !element[1].is_number()
+            ) {
+                error();
+            }
+            gate.matrix.m[i] = utils::Complex(
+                element[0].get<utils::Real>(),
+                element[1].get<utils::Real>()
+            );
+        }
+        auto product = gate.matrix.adjoint() * gate.matrix;
+        auto identity = Matrix::identity();
+        for (utils::UInt i = 0; i < 4; i++) {
+            if (std::abs(product.m[i] - identity.m[i]) > 1.0e-6) {
+                error();
+            }
+        }
+    }
+
+    /**
+     * Returns whether the given operand type is a qubit.
+     */
+    utils::Bool is_qubit_type(const utils::One<ir::OperandType> &operand_type) const {
+        return operand_type->data_type == ir->platform->qubits->data_type;
+    }
+
+    /**
+     * Returns the qubit index if the given expression is a reference to a
+     * single qubit, or MAX if it is not.
+     */
+    utils::UInt get_qubit(const ir::ExpressionRef &expr) const {
+        auto ref = expr->as_reference();
+        if (
+            !ref || ref->target != ir->platform->qubits ||
+            ref->data_type != ir->platform->qubits->data_type ||
+            ref->indices.size() != 1 || !ref->indices[0]->as_int_literal()
+        ) {
+            return utils::MAX;
+        }
+        return (utils::UInt)ref->indices[0]->as_int_literal()->value;
+    }
+
+    /**
+     * Returns whether the given statement is a fusable single-qubit gate,
+     * i.e. an unconditional instruction with known semantics acting on a
+     * single qubit. If so, the qubit and unitary are returned.
+     */
+    utils::Bool get_fusable_gate(
+        const ir::StatementRef &stmt,
+        utils::UInt &qubit,
+        Matrix &matrix
+    ) const {
+        auto custom = stmt->as_custom_instruction();
+        if (!custom) {
+            return false;
+        }
+        auto condition = custom->condition->as_bit_literal();
+        if (!condition || !condition->value) {
+            return false;
+        }
+        auto it = type_indices.find(get_generalization(custom->instruction_type).get_ptr().get());
+        if (it == type_indices.end()) {
+            return false;
+        }
+        const auto &native = synthesizer->get_natives()[it->second];
+        auto operands = get_operands(stmt.as<ir::Instruction>());
+        if (operands.size() != (native.parameterized ? 2 : 1)) {
+            return false;
+        }
+        qubit = get_qubit(operands[0]);
+        if (qubit == utils::MAX) {
+            return false;
+        }
+        if (native.parameterized) {
+            auto angle = operands[1]->as_real_literal();
+            if (!angle) {
+                return false;
+            }
+            matrix = Matrix::rotation(native.axis, angle->value);
+        } else {
+            matrix = native.matrix;
+        }
+        return true;
+    }
+
+    /**
+     * Adds the qubits referred to by the given expression to qubits. Sets
+     * all if the expression refers to qubits that can't be determined
+     * statically.
+     */
+    void find_qubits(
+        const ir::ExpressionRef &expr,
+        utils::Vec<utils::UInt> &qubits,
+        utils::Bool &all
+    ) const {
+        if (auto ref = expr->as_reference()) {
+
+            // Note that this includes the implicit bits associated with
+            // qubits.
+            if (ref->target == ir->platform->qubits) {
+                if (ref->indices.size() == 1 && ref->indices[0]->as_int_literal()) {
+                    qubits.push_back((utils::UInt)ref->indices[0]->as_int_literal()->value);
+                } else {
+                    all = true;
+                }
+            }
+
+        } else if (auto fn = expr->as_function_call()) {
+            for (const auto &operand : fn->operands) {
+                find_qubits(operand, qubits, all);
+            }
+        }
+    }
+
+    /**
+     * Fuses the given run of gates on the given qubit, if this makes it
+     * cheaper.
+     */
+    void fuse_run(utils::UInt qubit, const utils::Vec<RunGate> &run) {
+        if (run.size() < 2) {
+            return;
+        }
+
+        // Compute the unitary of the run and synthesize it.
+        auto unitary = Matrix::identity();
+        for (const auto &gate : run) {
+            unitary = gate.matrix * unitary;
+        }
+        Sequence seq;
+        if (!synthesizer->synthesize(unitary, seq)) {
+            return;
+        }
+
+        // Build the replacement instructions.
+        const auto &first = (*statements)[run.front().index];
+        utils::Vec<ir::InstructionRef> instructions;
+        utils::UInt new_duration = 0;
+        for (const auto &gate : seq) {
+            const auto &native = synthesizer->get_natives()[gate.native];
+            utils::Any<ir::Expression> operands;
+            operands.add(make_qubit_ref(ir->platform, qubit));
+            if (native.parameterized) {
+                operands.emplace<ir::RealLiteral>(gate.angle, real_type);
+            }
+            auto insn = make_instruction(ir->platform, native.name, operands, {}, true);
+            if (insn.empty()) {
+                return;
+            }
+            insn->cycle = first->cycle;
+            new_duration += get_duration_of_instruction(insn);
+            instructions.push_back(insn);
+        }
+
+        // Only replace the run if this actually improves anything, taking the
+        // durations of specialized instructions into account.
+        utils::UInt old_duration = 0;
+        for (const auto &gate : run) {
+            old_duration += get_duration_of_statement((*statements)[gate.index]);
+        }
+        if (
+            new_duration > old_duration ||
+            (new_duration == old_duration && instructions.size() >= run.size())
+        ) {
+            return;
+        }
+
+        DEBUG(
+            "fusing " << run.size() << " gates starting at '" <<
+            ir::describe(first) << "' into " << instructions.size() << " gates"
+        );
+        replacements.set(run.front().index) = instructions;
+        for (utils::UInt i = 1; i < run.size(); i++) {
+            removed.insert(run[i].index);
+        }
+    }
+
+    /**
+     * Ends the pending run on the given qubit.
+     */
+    void flush(utils::UInt qubit) {
+        auto it = runs.find(qubit);
+        if (it == runs.end()) {
+            return;
+        }
+        fuse_run(qubit, it->second);
+        runs.erase(it);
+    }
+
+    /**
+     * Ends all pending runs.
+     */
+    void flush_all() {
+        for (const auto &it : runs) {
+            fuse_run(it.first, it.second);
+        }
+        runs.clear();
+    }
+
+    /**
+     * Ends the pending runs on all qubits that the given statement, which is
+     * not a fusable gate, may affect.
+     */
+    void flush_for(const ir::StatementRef &stmt) {
+        utils::Vec<utils::UInt> qubits;
+        utils::Bool all = false;
+        if (auto custom = stmt->as_custom_instruction()) {
+            for (const auto &operand : get_operands(stmt.as<ir::Instruction>())) {
+                find_qubits(operand, qubits, all);
+            }
+            find_qubits(custom->condition, qubits, all);
+        } else if (auto set = stmt->as_set_instruction()) {
+            find_qubits(set->lhs, qubits, all);
+            find_qubits(set->rhs, qubits, all);
+            find_qubits(set->condition, qubits, all);
+        } else if (auto wait = stmt->as_wait_instruction()) {
+            if (wait->objects.empty()) {
+                all = true;
+            }
+            for (const auto &object : wait->objects) {
+                find_qubits(object, qubits, all);
+            }
+        } else {
+
+            // Gotos and structured control-flow.
+            all = true;
+
+        }
+        if (all) {
+            flush_all();
+        } else {
+            for (auto qubit : qubits) {
+                flush(qubit);
+            }
+        }
+    }
+
+public:
+
+    /**
+     * Determines the native single-qubit gates of the platform.
+     */
+    Fuser(const ir::Ref &ir, utils::UInt cache_size) : ir(ir) {
+        real_type = find_type(ir, "real");
+        utils::Vec<NativeGate> natives;
+        for (const auto &insn_type : ir->platform->instructions) {
+
+            // Determine the semantics, either from the "unitary" key in the
+            // instruction data or from the name.
+            NativeGate gate;
+            auto it = insn_type->data->find("unitary");
+            if (it != insn_type->data->end()) {
+                gate.name = insn_type->name;
+                parse_unitary(*it, gate);
+            } else if (!get_default_semantics(insn_type->name, gate)) {
+                continue;
+            }
+
+            // The instruction must have exactly one qubit operand, followed
+            // by a real-valued angle operand for rotations.
+            const auto &operand_types = insn_type->operand_types;
+            if (operand_types.size() != (gate.parameterized ? 2 : 1) || !is_qubit_type(operand_types[0])) {
+                continue;
+            }
+            if (gate.parameterized) {
+                if (real_type.empty() || operand_types[1]->data_type != real_type) {
+                    continue;
+                }
+            }
+
+            gate.duration = insn_type->duration;
+            DEBUG("native single-qubit gate: " << gate.name << " (" << gate.duration << " cycles)");
+            type_indices.set(insn_type.get_ptr().get()) = natives.size();
+            natives.push_back(gate);
+        }
+        synthesizer.emplace(natives, cache_size);
+    }
+
+    /**
+     * Fuses runs of single-qubit gates in the given block and recursively in
+     * its sub-blocks. Returns the number of gates removed.
+     */
+    utils::UInt fuse_block(const ir::BlockBaseRef &block) {
+        utils::UInt num_removed = 0;
+
+        // Find the runs of fusable gates.
+        auto &stmts = block->statements.get_vec();
+        statements = &stmts;
+        runs.clear();
+        replacements.clear();
+        removed.clear();
+        for (utils::UInt index = 0; index < stmts.size(); index++) {
+            const auto &stmt = stmts[index];
+            utils::UInt qubit;
+            Matrix matrix;
+            if (get_fusable_gate(stmt, qubit, matrix)) {
+                runs.set(qubit).push_back({index, matrix});
+            } else {
+                flush_for(stmt);
+            }
+        }
+        flush_all();
+
+        // Rebuild the statement list.
+        if (!replacements.empty()) {
+            std::vector<utils::One<ir::Statement>> output;
+            output.reserve(stmts.size());
+            for (utils::UInt index = 0; index < stmts.size(); index++) {
+                auto it = replacements.find(index);
+                if (it != replacements.end()) {
+                    output.insert(output.end(), it->second.begin(), it->second.end());
+                } else if (!removed.count(index)) {
+                    output.push_back(std::move(stmts[index]));
+                }
+            }
+            num_removed = stmts.size() - output.size();
+            stmts = std::move(output);
+
+            // The fused gates were all placed in the cycle of the first gate
+            // of each run, so the schedule is no longer valid.
+            block->erase_annotation<ir::KernelCyclesValid>();
+        }
+        statements = nullptr;
+
+        // Recurse into structured control-flow sub-blocks.
+        for (const auto &statement : block->statements) {
+            if (auto if_else = statement->as_if_else()) {
+                for (const auto &branch : if_else->branches) {
+                    num_removed += fuse_block(branch->body);
+                }
+                if (!if_else->otherwise.empty()) {
+                    num_removed += fuse_block(if_else->otherwise);
+                }
+            } else if (auto loop = statement->as_loop()) {
+                num_removed += fuse_block(loop->body);
+            }
+        }
+
+        return num_removed;
+    }
+
+};
+
+} // anonymous namespace
+
+bool FuseSingleQubitGatesPass::is_pass_registered = pmgr::Factory::register_pass<FuseSingleQubitGatesPass>("opt.FuseSingleQubitGates");
+
+/**
+ * Dumps docs for the single-qubit gate fusion pass.
+ */
+void FuseSingleQubitGatesPass::dump_docs(
+    std::ostream &os,
+    const utils::Str &line_prefix
+) const {
+    utils::dump_str(os, line_prefix, R"(
+    This pass fuses runs of consecutive single-qubit gates acting on the same
+    qubit into a single unitary, and resynthesizes that unitary into the
+    cheapest sequence of the platform's native single-qubit gates that it can
+    find. A run is only replaced if the result has a shorter total duration, or
+    the same duration and fewer gates. The pass returns the number of gates
+    that were removed.
+
+    The semantics of the platform's instructions are determined as follows:
+
+     - instructions with a `"unitary"` key in their JSON data are treated as
+       fixed single-qubit gates with the given unitary, specified as
+       `[[re, im], [re, im], [re, im], [re, im]]` in row-major order;
+     - `rx`, `ry`, and `rz` instructions with a qubit and a real-valued
+       operand are treated as rotations by the given angle in radians; and
+     - OpenQL's default single-qubit gate names (`i`, `h`, `x`, `y`, `z`, `s`,
+       `sdag`, `t`, `tdag`, `x90`, `xm90`, `y90`, `ym90`, `x45`, `xm45`, and
+       their aliases such as `rx180` and `mx90`) are treated as the
+       corresponding gates.
+
+    The `"matrix"` key of legacy platform configurations is not used, as it is
+    not reliably filled in. Unitaries are compared up to global phase. Only
+    unconditional instructions with exactly one qubit operand and literal
+    operands are fused; any other statement ends the runs on the qubits that it
+    refers to, and gotos, structured control-flow, and wait instructions
+    without operands end all runs. Runs do not cross block boundaries.
+
+    The synthesized gates are placed in the cycle of the first gate of the run
+    they replace, so the program has to be (re)scheduled after this pass.
+    )");
+}
+
+/**
+ * Returns a user-friendly type name for this pass.
+ */
+utils::Str FuseSingleQubitGatesPass::get_friendly_type() const {
+    return "Single-qubit gate fuser";
+}
+
+/**
+ * Constructs a single-qubit gate fusion pass.
+ */
+FuseSingleQubitGatesPass::FuseSingleQubitGatesPass(
+    const utils::Ptr<const pmgr::Factory> &pass_factory,
+    const utils::Str &instance_name,
+    const utils::Str &type_name
+) : pmgr::pass_types::BlockTransformation(pass_factory, instance_name, type_name) {
+    options.add_int(
+        "cache_size",
+        "The maximum number of synthesized unitaries that are cached per "
+        "block.",
+        "1024",
+        0, utils::MAX
+    );
+}
+
+/**
+ * Returns that fusing gates in a block does not affect any other block.
+ */
+utils::Bool FuseSingleQubitGatesPass::is_block_local() const {
+    return true;
+}
+
+/**
+ * Runs the single-qubit gate fusion pass on the given top-level block.
+ */
+utils::Int FuseSingleQubitGatesPass::run_on_block(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block,
+    const utils::Str &/* block_name */,
+    const pmgr::pass_types::Context &context
+) const {
+    Fuser fuser(ir, context.options["cache_size"].as_uint());
+    auto num_removed = fuser.fuse_block(block);
+    auto named = block.as<ir::Block>();
+    if (!named.empty()) {
+        ana::statistics::AdditionalStats::push(
+            named, "single-qubit gates removed by fusion: " + utils::to_string(num_removed)
+        );
+    }
+    return (utils::Int)num_removed;
+}
+
+} // namespace fuse_single_qubit
+} // namespace opt
+} // namespace pass
+} // namespace ql
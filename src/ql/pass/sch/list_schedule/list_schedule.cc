@@ -10,6 +10,7 @@
 #include "ql/com/ddg/ops.h"
 #include "ql/com/ddg/dot.h"
 #include "ql/com/sch/scheduler.h"
+#include "ql/com/sch/uniform.h"
 #include "ql/pmgr/pass_types/base.h"
 #include "ql/pmgr/factory.h"
 
@@ -21,6 +22,18 @@ namespace pass {
 namespace sch {
 namespace list_schedule {
 
+namespace {
+
+/**
+ * Annotation used to pass the names of structured control-flow sub-blocks,
+ * unique across the program, from prepare_blocks() to schedule_block().
+ */
+struct SubBlockName {
+    utils::Str name;
+};
+
+} // anonymous namespace
+
 bool ListSchedulePass::is_pass_registered = pmgr::Factory::register_pass<ListSchedulePass>("sch.ListSchedule");
 
 /**
@@ -51,7 +64,7 @@ ListSchedulePass::ListSchedulePass(
     const utils::Ptr<const pmgr::Factory> &pass_factory,
     const utils::Str &instance_name,
     const utils::Str &type_name
-) : pmgr::pass_types::Transformation(pass_factory, instance_name, type_name) {
+) : pmgr::pass_types::BlockTransformation(pass_factory, instance_name, type_name) {
 
     options.add_bool(
         "resource_constraints",
@@ -80,9 +93,12 @@ ListSchedulePass::ListSchedulePass(
         "the statement with the longest critical path first. `deep_criticality` "
         "is the same except for statements with equal critical path length; in "
         "this case, the deep-criticality of the most critical successor "
-        "is recursively checked instead.",
+        "is recursively checked instead. `uniform` also uses the critical "
+        "path length, but additionally tries to balance the number of "
+        "statements per cycle without extending the schedule, postponing "
+        "statements that are not yet critical when a cycle is already full.",
         "deep_criticality",
-        {"none", "critical_path", "deep_criticality"}
+        {"none", "critical_path", "deep_criticality", "uniform"}
     );
 
     options.add_bool(
@@ -120,27 +136,52 @@ ListSchedulePass::ListSchedulePass(
 }
 
 /**
- * Runs the scheduler on the given block.
+ * Names the structured control-flow sub-blocks of the given block
+ * recursively, uniquified with respect to used_names.
  */
-void ListSchedulePass::run_on_block(
+void ListSchedulePass::name_sub_blocks(
+    const ir::BlockBaseRef &block,
+    const utils::Str &name,
+    utils::Set<utils::Str> &used_names
+) {
+    auto name_sub_block = [&used_names](const ir::BlockBaseRef &sub_block, const utils::Str &name_path) {
+        utils::Str sub_name = name_path;
+        if (!used_names.insert(sub_name).second) {
+            utils::UInt i = 1;
+            do {
+                sub_name = name_path + "_" + utils::to_string(i++);
+            } while (!used_names.insert(sub_name).second);
+        }
+        sub_block->set_annotation<SubBlockName>({sub_name});
+        name_sub_blocks(sub_block, sub_name, used_names);
+    };
+    for (const auto &statement : block->statements) {
+        if (auto if_else = statement->as_if_else()) {
+            for (const auto &branch : if_else->branches) {
+                name_sub_block(branch->body, name + "_if");
+            }
+            if (!if_else->otherwise.empty()) {
+                name_sub_block(if_else->otherwise, name + "_else");
+            }
+        } else if (auto loop = statement->as_loop()) {
+            name_sub_block(loop->body, name + "_loop");
+        }
+    }
+}
+
+/**
+ * Schedules the given block and recursively its sub-blocks.
+ */
+void ListSchedulePass::schedule_block(
     const ir::Ref &ir,
     const ir::BlockBaseRef &block,
-    const utils::Str &name_path,
-    utils::Set<utils::Str> &used_names,
+    const utils::Str &name,
     const pmgr::pass_types::Context &context
 ) {
 
-    // Figure out a unique name for this block.
-    utils::Str name = name_path;
-    if (!used_names.insert(name).second) {
-        utils::UInt i = 1;
-        do {
-            name = name_path + "_" + utils::to_string(i++);
-        } while (!used_names.insert(name).second);
-    }
-
-    // Build a data dependency graph for the block.
-    com::ddg::build(
+    // Build a data dependency graph for the block, or reuse the one left
+    // behind by a previous pass if it is still valid.
+    com::ddg::build_or_reuse(
         ir->platform,
         block,
         context.options["commute_multi_qubit"].as_bool(),
@@ -158,7 +199,8 @@ void ListSchedulePass::run_on_block(
     auto heuristic = context.options["scheduler_heuristic"].as_str();
     if (
         heuristic == "critical_path" ||
-        heuristic == "deep_criticality"
+        heuristic == "deep_criticality" ||
+        heuristic == "uniform"
     ) {
 
         // Criticality for ASAP list scheduling is computed via ALAP
@@ -203,6 +245,12 @@ void ListSchedulePass::run_on_block(
         scheduler.run(context.options["max_resource_block_cycles"].as_int());
         scheduler.convert_cycles();
         com::sch::DeepCriticality::clear(block);
+    } else if (heuristic == "uniform") {
+        com::sch::schedule_uniform(
+            block,
+            manager,
+            context.options["max_resource_block_cycles"].as_int()
+        );
     } else {
         QL_ICE("unknown heuristic " << heuristic);
     }
@@ -232,42 +280,92 @@ void ListSchedulePass::run_on_block(
         com::ddg::dump_dot(block, utils::OutFile(filename).unwrap());
     }
 
-    // Clean up the DDG.
-    com::ddg::clear(block);
+    // Leave the DDG behind in forward direction for subsequent passes. The
+    // scheduler sorted the statements by cycle, which respects the
+    // dependencies, so only the instruction order needs to be updated.
+    if (reversed) {
+        com::ddg::reverse(block);
+    }
+    com::ddg::renumber(block);
 
     // Attach the KernelCyclesValid annotation to set the cycles_valid flag of
     // the corresponding kernel when new-to-old conversion is applied.
     block->set_annotation<ir::KernelCyclesValid>({true});
 
-    // Recurse into structured control-flow sub-blocks.
+    // Recurse into structured control-flow sub-blocks, using the names
+    // assigned to them by prepare_blocks().
+    auto schedule_sub_block = [&](const ir::BlockBaseRef &sub_block) {
+        auto sub_name = sub_block->get_annotation<SubBlockName>().name;
+        sub_block->erase_annotation<SubBlockName>();
+        schedule_block(ir, sub_block, sub_name, context);
+    };
     for (const auto &statement : block->statements) {
         if (auto if_else = statement->as_if_else()) {
             for (const auto &branch : if_else->branches) {
-                run_on_block(ir, branch->body, name + "_if", used_names, context);
+                schedule_sub_block(branch->body);
             }
             if (!if_else->otherwise.empty()) {
-                run_on_block(ir, if_else->otherwise, name + "_else", used_names, context);
+                schedule_sub_block(if_else->otherwise);
             }
         } else if (auto loop = statement->as_loop()) {
-            run_on_block(ir, loop->body, name + "_loop", used_names, context);
+            schedule_sub_block(loop->body);
         }
     }
 
 }
 
 /**
- * Runs the scheduler.
+ * Returns that the scheduler uses the data dependency graph.
+ */
+pmgr::analysis::Types ListSchedulePass::get_required_analyses() const {
+    return {pmgr::analysis::Type::DDG};
+}
+
+/**
+ * Returns that the data dependency graph remains valid after scheduling,
+ * and that the control-flow graph is not affected.
+ */
+pmgr::analysis::Types ListSchedulePass::get_preserved_analyses() const {
+    return {pmgr::analysis::Type::DDG, pmgr::analysis::Type::CFG};
+}
+
+/**
+ * Returns that scheduling a block does not affect any other block.
+ */
+utils::Bool ListSchedulePass::is_block_local() const {
+    return true;
+}
+
+/**
+ * Names the structured control-flow sub-blocks of all blocks, such that the
+ * names are unique across the program. This is done serially up front, as the
+ * blocks themselves may be scheduled concurrently.
  */
-utils::Int ListSchedulePass::run(
+void ListSchedulePass::prepare_blocks(
     const ir::Ref &ir,
-    const pmgr::pass_types::Context &context
+    const utils::Vec<utils::Str> &block_names,
+    const pmgr::pass_types::Context &/* context */
 ) const {
     utils::Set<utils::Str> used_names;
-    if (!ir->program.empty()) {
-        for (const auto &block : ir->program->blocks) {
-            run_on_block(ir, block, block->name, used_names, context);
-        }
+    for (const auto &name : block_names) {
+        used_names.insert(name);
     }
+    const auto &blocks = ir->program->blocks;
+    for (utils::UInt i = 0; i < blocks.size(); i++) {
+        name_sub_blocks(blocks[i], block_names[i], used_names);
+    }
+}
+
+/**
+ * Runs the scheduler on the given top-level block.
+ */
+utils::Int ListSchedulePass::run_on_block(
+    const ir::Ref &ir,
+    const ir::BlockBaseRef &block,
+    const utils::Str &block_name,
+    const pmgr::pass_types::Context &context
+) const {
+    schedule_block(ir, block, block_name, context);
     return 0;
 }
 
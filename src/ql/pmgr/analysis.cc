@@ -0,0 +1,72 @@
+/** \file
+ * Defines the analyses that the pass manager keeps track of, allowing the
+ * results of expensive analyses to be reused between passes.
+ */
+
+#include "ql/pmgr/analysis.h"
+
+#include "ql/com/ddg/ops.h"
+#include "ql/com/cfg/ops.h"
+
+namespace ql {
+namespace pmgr {
+namespace analysis {
+
+/**
+ * Returns the set of all analysis types.
+ */
+Types all() {
+    return {Type::DDG, Type::CFG};
+}
+
+/**
+ * Returns a user-friendly name for the given analysis type.
+ */
+utils::Str to_string(Type type) {
+    switch (type) {
+        case Type::DDG: return "DDG";
+        case Type::CFG: return "CFG";
+    }
+    return "unknown";
+}
+
+/**
+ * Removes the data dependency graphs from the given block and its sub-blocks.
+ */
+static void invalidate_ddg(const ir::BlockBaseRef &block) {
+    com::ddg::clear(block);
+    for (const auto &statement : block->statements) {
+        if (auto if_else = statement->as_if_else()) {
+            for (const auto &branch : if_else->branches) {
+                invalidate_ddg(branch->body);
+            }
+            if (!if_else->otherwise.empty()) {
+                invalidate_ddg(if_else->otherwise);
+            }
+        } else if (auto loop = statement->as_loop()) {
+            invalidate_ddg(loop->body);
+        }
+    }
+}
+
+/**
+ * Removes the annotations for all analyses that are not in preserved from the
+ * given IR.
+ */
+void invalidate(const ir::Ref &ir, const Types &preserved) {
+    if (ir.empty() || ir->program.empty()) {
+        return;
+    }
+    if (!preserved.count(Type::DDG)) {
+        for (const auto &block : ir->program->blocks) {
+            invalidate_ddg(block);
+        }
+    }
+    if (!preserved.count(Type::CFG)) {
+        com::cfg::clear(ir->program);
+    }
+}
+
+} // namespace analysis
+} // namespace pmgr
+} // namespace ql
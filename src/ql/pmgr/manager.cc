@@ -8,6 +8,7 @@
 #include "ql/com/options.h"
 #include "ql/arch/architecture.h"
 #include "ql/ir/cqasm/write.h"
+#include "ql/pmgr/analysis.h"
 
 namespace ql {
 namespace pmgr {
@@ -884,6 +885,12 @@ void Manager::compile(const ir::Ref &ir) {
     // Compile the program.
     root->compile(ir, "");
 
+    // Drop any analysis results that passes left behind for reuse; they are
+    // of no use after compilation, and the data dependency graphs in
+    // particular are cyclic structures that would otherwise keep the IR
+    // alive.
+    pmgr::analysis::invalidate(ir);
+
 }
 
 } // namespace pmgr
@@ -192,6 +192,27 @@ utils::Bool Base::is_legacy() const {
     return false;
 }
 
+/**
+ * Returns the analyses that this pass uses, and thus should not be
+ * invalidated before the pass is run if they are still valid. The pass
+ * itself is responsible for (re)building them when needed, for example
+ * using com::ddg::build_or_reuse(). Returns an empty set unless
+ * overridden.
+ */
+analysis::Types Base::get_required_analyses() const {
+    return {};
+}
+
+/**
+ * Returns the analyses that remain valid after this pass is run, such that
+ * subsequent passes may reuse them. All other analyses are invalidated by
+ * the pass manager after the pass completes. Returns an empty set unless
+ * overridden, so passes that do not declare anything are safe by default.
+ */
+analysis::Types Base::get_preserved_analyses() const {
+    return {};
+}
+
 /**
  * Returns `pass "<name>"` for normal passes and `root` for the root pass.
  * Used for error messages.
@@ -1034,7 +1055,29 @@ utils::Int Base::run_main_pass(
     const Context &context
 ) const {
     QL_IOUT("starting pass \"" << context.full_pass_name << "\" of type \"" << type_name << "\"...");
+
+    // Analyses that the pass neither uses nor preserves are dropped before the
+    // pass runs, such that passes that replace blocks wholesale cannot leave
+    // stale graph annotations dangling.
+    auto required = get_required_analyses();
+    auto preserved = get_preserved_analyses();
+    auto retained = required;
+    retained.insert(preserved.begin(), preserved.end());
+    analysis::invalidate(ir, retained);
+
     auto retval = run_internal(ir, context);
+
+    // Only the analyses that the pass promises not to have broken may be
+    // reused by subsequent passes.
+    analysis::invalidate(ir, preserved);
+    if (!preserved.empty()) {
+        utils::StrStrm ss;
+        for (auto type : preserved) {
+            ss << " " << analysis::to_string(type);
+        }
+        QL_DOUT("pass \"" << context.full_pass_name << "\" preserved analyses:" << ss.str());
+    }
+
     QL_IOUT("completed pass \"" << context.full_pass_name << "\"; return value is " << retval);
     return retval;
 }
@@ -5,6 +5,10 @@
 
 #include "ql/pmgr/pass_types/specializations.h"
 
+#include <vector>
+#include "ql/utils/set.h"
+#include "ql/utils/vec.h"
+#include "ql/utils/thread_pool.h"
 #include "ql/ir/new_to_old.h"
 #include "ql/ir/old_to_new.h"
 
@@ -93,6 +97,131 @@ utils::Int Transformation::run_internal(
     return run(ir, context);
 }
 
+/**
+ * Constructs the pass. No error checking here; this is up to the parent
+ * pass group.
+ */
+BlockTransformation::BlockTransformation(
+    const utils::Ptr<const Factory> &pass_factory,
+    const utils::Str &instance_name,
+    const utils::Str &type_name
+) : Normal(pass_factory, instance_name, type_name) {
+    options.add_int(
+        "num_threads",
+        "The maximum number of threads used to process the blocks of the "
+        "program concurrently. `auto` uses the amount of hardware concurrency "
+        "of the machine. Only passes that operate strictly within the block "
+        "they are given support this; for other passes, this option has no "
+        "effect. The result of the pass does not depend on this option.",
+        "1",
+        1, utils::MAX, {"auto"}
+    );
+}
+
+/**
+ * Implementation for on_compile() that calls run_on_block() appropriately.
+ */
+utils::Int BlockTransformation::run_internal(
+    const ir::Ref &ir,
+    const Context &context
+) const {
+    if (ir->program.empty()) {
+        return retval_initialize();
+    }
+    const auto &blocks = ir->program->blocks;
+
+    // Uniquify the block names up front, such that the names don't depend on
+    // the order in which the blocks are processed.
+    utils::Set<utils::Str> used_names;
+    utils::Vec<utils::Str> block_names;
+    for (const auto &block : blocks) {
+        utils::Str name = block->name;
+        if (!used_names.insert(name).second) {
+            utils::UInt i = 1;
+            do {
+                name = block->name + "_" + utils::to_string(i++);
+            } while (!used_names.insert(name).second);
+        }
+        block_names.push_back(name);
+    }
+
+    // Let the pass prepare for processing the blocks.
+    prepare_blocks(ir, block_names, context);
+
+    // Figure out how many threads we can use.
+    utils::UInt num_threads = 1;
+    if (is_block_local()) {
+        if (context.options["num_threads"].as_str() == "auto") {
+            num_threads = utils::get_default_num_threads();
+        } else {
+            num_threads = context.options["num_threads"].as_uint();
+        }
+    }
+    if (num_threads > 1 && blocks.size() > 1) {
+        QL_DOUT(
+            "processing " << blocks.size() << " blocks using up to "
+            << num_threads << " threads"
+        );
+    }
+
+    // Process the blocks. Each task only writes to its own return value slot.
+    std::vector<utils::Int> retvals(blocks.size(), 0);
+    utils::parallel_for(blocks.size(), num_threads, [&](utils::UInt i) {
+        const auto &block = blocks[i];
+        try {
+            retvals[i] = run_on_block(ir, block, block_names[i], context);
+        } catch (utils::Exception &e) {
+            e.add_context("in block " + block->name);
+            throw;
+        }
+    });
+
+    // Accumulate the return values in program order.
+    utils::Int accumulator = retval_initialize();
+    for (auto retval : retvals) {
+        accumulator = retval_accumulate(accumulator, retval);
+    }
+    return accumulator;
+}
+
+/**
+ * Returns whether run_on_block() only accesses the block it is given, such
+ * that multiple blocks can be processed concurrently. Returns false unless
+ * overridden.
+ */
+utils::Bool BlockTransformation::is_block_local() const {
+    return false;
+}
+
+/**
+ * Called from the calling thread before any block is processed, with the
+ * uniquified names of all top-level blocks in program order. Does nothing
+ * unless overridden.
+ */
+void BlockTransformation::prepare_blocks(
+    const ir::Ref &,
+    const utils::Vec<utils::Str> &,
+    const Context &
+) const {
+}
+
+/**
+ * Initial accumulator value for the return value. Defaults to zero.
+ */
+utils::Int BlockTransformation::retval_initialize() const {
+    return 0;
+}
+
+/**
+ * Return value reduction operator. Defaults to addition.
+ */
+utils::Int BlockTransformation::retval_accumulate(
+    utils::Int state,
+    utils::Int block
+) const {
+    return state + block;
+}
+
 /**
  * Constructs the pass. No error checking here; this is up to the parent
  * pass group.
@@ -202,6 +331,14 @@ utils::Int Analysis::run_internal(
     return run(ir, context);
 }
 
+/**
+ * Returns that analysis passes preserve all analyses, since they don't
+ * modify the IR.
+ */
+analysis::Types Analysis::get_preserved_analyses() const {
+    return analysis::all();
+}
+
 /**
  * Constructs the pass. No error checking here; this is up to the parent
  * pass group.
@@ -0,0 +1,54 @@
+/** \file
+ * Provides a monotonic memory arena for bulk-allocating tree nodes.
+ */
+
+#include "ql/utils/arena.h"
+
+namespace ql {
+namespace utils {
+
+/**
+ * Constructs an arena, of which the first chunk will have the given size
+ * in bytes. Subsequent chunks grow geometrically.
+ */
+Arena::Arena(UInt initial_size) : resource(initial_size) {
+}
+
+/**
+ * Allocates the given number of bytes with the given alignment.
+ */
+void *Arena::allocate(UInt size, UInt alignment) {
+    bytes_allocated += size;
+    return resource.allocate(size, alignment);
+}
+
+/**
+ * Returns the number of bytes that were allocated from this arena.
+ */
+UInt Arena::get_bytes_allocated() const {
+    return bytes_allocated;
+}
+
+/**
+ * The current arena for this thread.
+ */
+static thread_local ArenaRef current_arena;
+
+/**
+ * Returns the arena that make() should currently allocate from for this
+ * thread, or null if objects should be allocated normally.
+ */
+Arena *get_current_arena() {
+    return current_arena.get();
+}
+
+ArenaScope::ArenaScope(ArenaRef arena) : previous(std::move(current_arena)) {
+    current_arena = std::move(arena);
+}
+
+ArenaScope::~ArenaScope() {
+    current_arena = std::move(previous);
+}
+
+} // namespace utils
+} // namespace ql
@@ -204,12 +204,70 @@ void make_dirs(const Str &path) {
     make_dirs_raw(process_path(path));
 }
 
+/**
+ * Stores the given file in memory.
+ */
+void MemoryOutputSink::store(const Str &path, const Str &contents) {
+    std::lock_guard<std::mutex> lock(mutex);
+    files.set(path) = contents;
+}
+
+/**
+ * Returns a copy of the files stored thus far, by path.
+ */
+Map<Str, Str> MemoryOutputSink::get_files() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return files;
+}
+
+namespace {
+
+/**
+ * Stack of output sinks. Private; use push_output_sink(), pop_output_sink(),
+ * and get_output_sink() to access.
+ */
+List<Ptr<OutputSink>> output_sink_stack;
+
+} // anonymous namespace
+
+/**
+ * Makes OutFile write to the given sink instead of the filesystem, until the
+ * matching pop_output_sink() call. Pushing an empty pointer reverts to the
+ * filesystem.
+ */
+void push_output_sink(const Ptr<OutputSink> &sink) {
+    output_sink_stack.push_back(sink);
+}
+
+/**
+ * Reverts the change made by the previous push_output_sink() call.
+ */
+void pop_output_sink() {
+    output_sink_stack.pop_back();
+}
+
+/**
+ * Returns the output sink that OutFile currently writes to, or an empty
+ * pointer if files are written to the filesystem.
+ */
+Ptr<OutputSink> get_output_sink() {
+    if (output_sink_stack.empty()) {
+        return {};
+    } else {
+        return output_sink_stack.back();
+    }
+}
+
 /**
  * Tries to create a file (if it doesn't already exist) and opens it for
- * writing. If the directory that path is contained by does not exists, it is
- * first created.
+ * writing, or starts buffering it in memory if an output sink is active. If
+ * the directory that path is contained by does not exists, it is first
+ * created.
  */
-OutFile::OutFile(const Str &path) : ofs(), path(path) {
+OutFile::OutFile(const Str &path) : ofs(), buffer(), sink(get_output_sink()), path(path) {
+    if (sink.has_value()) {
+        return;
+    }
     auto processed_path = process_path(path);
 
     // If the parent path does not exist yet, recursively try to create a
@@ -225,20 +283,35 @@ OutFile::OutFile(const Str &path) : ofs(), path(path) {
 
 }
 
+/**
+ * Hands the buffered contents to the output sink if close() wasn't called.
+ */
+OutFile::~OutFile() {
+    if (sink.has_value()) {
+        sink->store(path, buffer.str());
+    }
+}
+
 /**
  * Writes to the file.
  */
 void OutFile::write(const Str &content) {
-    ofs << content;
+    unwrap() << content;
     check();
 }
 
 /**
  * Closes the file prior to destruction. This is not necessary for correct
  * filesystem behavior (the file is always closed on destruction), but allows
- * any exceptions from the close() syscall to be caught.
+ * any exceptions from the close() syscall to be caught. When writing to an
+ * output sink, the contents are handed to it here.
  */
 void OutFile::close() {
+    if (sink.has_value()) {
+        sink->store(path, buffer.str());
+        sink.reset();
+        return;
+    }
     ofs.close();
     check();
 }
@@ -247,15 +320,19 @@ void OutFile::close() {
  * Throws an exception if badbit or failbit are set.
  */
 void OutFile::check() {
-    if (ofs.fail()) {
+    if (unwrap().fail()) {
         QL_SYSTEM_ERROR("failed to write file \"" << path << "\"");
     }
 }
 
 /**
- * Provides unchecked access to the underlying std::ofstream object.
+ * Provides unchecked access to the underlying stream, which is either a
+ * std::ofstream or an in-memory buffer.
  */
-std::ofstream &OutFile::unwrap() {
+std::ostream &OutFile::unwrap() {
+    if (sink.has_value()) {
+        return buffer;
+    }
     return ofs;
 }
 
@@ -3,7 +3,14 @@
  */
 
 #include "ql/utils/logger.h"
+
+#include <condition_variable>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
 #include "ql/utils/exception.h"
+#include "ql/utils/map.h"
 
 namespace ql {
 namespace utils {
@@ -14,6 +21,336 @@ namespace logger {
  */
 LogLevel log_level;
 
+/**
+ * Counter that is incremented whenever the global or a module log level
+ * changes, invalidating the levels cached by the call sites. Starts at 1,
+ * because call sites start out at generation 0.
+ */
+std::atomic<UInt> log_generation{1};
+
+namespace {
+
+/**
+ * Mutex protecting module_log_levels.
+ */
+std::mutex module_mutex;
+
+/**
+ * Log levels for specific modules.
+ */
+Map<Str, LogLevel> module_log_levels;
+
+/**
+ * Returns the log level for the given module, being the level of the most
+ * specific matching entry in module_log_levels, or log_level if there is
+ * none. module_mutex must be locked by the caller.
+ */
+LogLevel get_module_log_level(const Str &module) {
+    Str prefix = module;
+    while (true) {
+        auto it = module_log_levels.find(prefix);
+        if (it != module_log_levels.end()) {
+            return it->second;
+        }
+        auto pos = prefix.rfind('/');
+        if (pos == Str::npos) {
+            return log_level;
+        }
+        prefix.resize(pos);
+    }
+}
+
+/**
+ * Returns the given string without leading and trailing whitespace.
+ */
+Str trim(const Str &str) {
+    auto first = str.find_first_not_of(" \t\r\n");
+    if (first == Str::npos) {
+        return "";
+    }
+    auto last = str.find_last_not_of(" \t\r\n");
+    return str.substr(first, last - first + 1);
+}
+
+/**
+ * A single line in the log.
+ */
+struct Line {
+
+    /**
+     * The contents of the line, without line terminator.
+     */
+    Str text;
+
+    /**
+     * Whether the line should be written to std::cerr rather than std::cout.
+     */
+    Bool error = false;
+
+};
+
+/**
+ * Bounded lock-free queue of log lines, using Dmitry Vyukov's ring buffer
+ * design: each slot has a sequence number that tells producers when the slot
+ * is free and the consumer when it has been filled. Any number of threads may
+ * push lines concurrently, but only one thread may pop lines at a time.
+ */
+class LineQueue {
+private:
+
+    /**
+     * The number of slots. Must be a power of two.
+     */
+    static constexpr UInt CAPACITY = 4096;
+
+    /**
+     * A slot in the ring buffer.
+     */
+    struct Slot {
+        std::atomic<UInt> sequence;
+        Line line;
+    };
+
+    /**
+     * The slots of the ring buffer.
+     */
+    Slot slots[CAPACITY];
+
+    /**
+     * The position at which the next line will be pushed.
+     */
+    std::atomic<UInt> push_position{0};
+
+    /**
+     * The position from which the next line will be popped.
+     */
+    UInt pop_position = 0;
+
+public:
+
+    /**
+     * Constructs an empty queue.
+     */
+    LineQueue() {
+        for (UInt i = 0; i < CAPACITY; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Tries to push a line into the queue. Returns false without moving from
+     * line if the queue is full.
+     */
+    Bool try_push(Line &line) {
+        auto position = push_position.load(std::memory_order_relaxed);
+        while (true) {
+            auto &slot = slots[position & (CAPACITY - 1)];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = (Int)sequence - (Int)position;
+            if (diff == 0) {
+                if (push_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.line = std::move(line);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = push_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Tries to pop a line from the queue. Returns false if the queue is empty.
+     */
+    Bool try_pop(Line &line) {
+        auto &slot = slots[pop_position & (CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != pop_position + 1) {
+            return false;
+        }
+        line = std::move(slot.line);
+        slot.sequence.store(pop_position + CAPACITY, std::memory_order_release);
+        pop_position++;
+        return true;
+    }
+
+};
+
+/**
+ * The logging backend. Lines are pushed into the queue by the logging threads
+ * and popped by a background thread. The background thread is the only
+ * consumer, except when a thread needs to wait for the log to be written; that
+ * thread then drains the queue itself, with drain_mutex ensuring that there is
+ * only one consumer at a time.
+ */
+class Backend {
+private:
+
+    /**
+     * The queue of lines waiting to be written.
+     */
+    LineQueue queue;
+
+    /**
+     * Mutex held while popping from the queue and writing to the streams.
+     */
+    std::mutex drain_mutex;
+
+    /**
+     * Whether lines are written asynchronously.
+     */
+    std::atomic<Bool> async{true};
+
+    /**
+     * Used to start the background thread when it's first needed.
+     */
+    std::once_flag started;
+
+    /**
+     * Set by the background thread when it is about to sleep, so producers
+     * know they need to wake it up.
+     */
+    std::atomic<Bool> sleeping{false};
+
+    /**
+     * Mutex and condition variable used to wake up the background thread.
+     */
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+
+    /**
+     * Writes all lines in the queue to their streams, without flushing. The
+     * drain mutex must be locked by the caller. Returns whether any lines
+     * were written.
+     */
+    Bool drain_locked() {
+        Bool any = false;
+        Line line;
+        while (queue.try_pop(line)) {
+            (line.error ? std::cerr : std::cout) << line.text << '\n';
+            any = true;
+        }
+        return any;
+    }
+
+    /**
+     * Body of the background thread.
+     */
+    void run() {
+        Bool dirty = false;
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(drain_mutex);
+                if (drain_locked()) {
+                    dirty = true;
+                    continue;
+                }
+                if (dirty) {
+                    std::cout.flush();
+                    std::cerr.flush();
+                    dirty = false;
+                }
+            }
+
+            // Out of work, so wait for producers to wake us. The timeout
+            // catches wakeups lost between the check above and the wait.
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            sleeping.store(true);
+            wake.wait_for(lock, std::chrono::milliseconds(100));
+            sleeping.store(false);
+        }
+    }
+
+public:
+
+    /**
+     * Returns the backend. It is deliberately leaked, because the detached
+     * background thread may still be using it during static destruction.
+     */
+    static Backend &get() {
+        static Backend *backend = [] {
+            auto b = new Backend();
+            std::atexit([] {
+                get().flush(std::chrono::milliseconds(100));
+            });
+            return b;
+        }();
+        return *backend;
+    }
+
+    /**
+     * Sets whether lines are written asynchronously.
+     */
+    void set_async(Bool value) {
+        flush();
+        async.store(value);
+    }
+
+    /**
+     * Writes a line to the log.
+     */
+    void write(Line &&line) {
+        if (!async.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(drain_mutex);
+            drain_locked();
+            (line.error ? std::cerr : std::cout) << line.text << std::endl;
+            return;
+        }
+        std::call_once(started, [this] {
+            std::thread([this] { run(); }).detach();
+        });
+        while (!queue.try_push(line)) {
+
+            // The queue is full, so help draining it rather than waiting.
+            std::lock_guard<std::mutex> lock(drain_mutex);
+            drain_locked();
+
+        }
+        if (sleeping.load(std::memory_order_relaxed)) {
+            wake.notify_one();
+        }
+    }
+
+    /**
+     * Writes and flushes all lines that were written to the log before the
+     * call, giving up if the drain mutex cannot be acquired within the given
+     * timeout.
+     */
+    void flush(std::chrono::milliseconds timeout = std::chrono::milliseconds::max()) {
+        std::unique_lock<std::mutex> lock(drain_mutex, std::defer_lock);
+        if (timeout == std::chrono::milliseconds::max()) {
+            lock.lock();
+        } else {
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            while (!lock.try_lock()) {
+                if (std::chrono::steady_clock::now() > deadline) {
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        drain_locked();
+        std::cout.flush();
+        std::cerr.flush();
+    }
+
+};
+
+} // anonymous namespace
+
+/**
+ * Recomputes the cached log level.
+ */
+LogLevel Site::update() {
+    std::lock_guard<std::mutex> lock(module_mutex);
+    auto current_generation = log_generation.load(std::memory_order_relaxed);
+    auto current_level = module_log_levels.empty() ? log_level : get_module_log_level(get_module(file));
+    level.store(current_level, std::memory_order_relaxed);
+    generation.store(current_generation, std::memory_order_release);
+    return current_level;
+}
+
 /**
  * Converts the string representation of a log level to a LogLevel enum variant.
  * Throws ql::exception if the string could not be converted.
@@ -40,7 +377,105 @@ LogLevel log_level_from_string(const Str &level) {
  * Sets the current log level using its string representation.
  */
 void set_log_level(const Str &level) {
-    log_level = log_level_from_string(level);
+    auto value = log_level_from_string(level);
+    std::lock_guard<std::mutex> lock(module_mutex);
+    log_level = value;
+    log_generation++;
+}
+
+/**
+ * Returns the module name for the given source file, being its path relative
+ * to the ql source or include directory without the file extension, for
+ * example pass/map/qubits/map/detail/mapper.
+ */
+Str get_module(const Str &file) {
+    Str module = replace_all(file, "\\", "/");
+    auto pos = module.rfind("/ql/");
+    if (pos != Str::npos) {
+        module = module.substr(pos + 4);
+    } else if (module.compare(0, 3, "ql/") == 0) {
+        module = module.substr(3);
+    }
+    auto dot = module.rfind('.');
+    if (dot != Str::npos && module.find('/', dot) == Str::npos) {
+        module.resize(dot);
+    }
+    return module;
+}
+
+/**
+ * Sets the log level for the given module, overriding the global log level.
+ * A module is a path relative to the ql source directory, such as pass/map or
+ * com/sch/scheduler, and includes everything below it. When multiple modules
+ * match a source file, the most specific one is used.
+ */
+void set_module_log_level(const Str &module, const Str &level) {
+    auto value = log_level_from_string(level);
+    auto name = module;
+    while (!name.empty() && name.back() == '/') {
+        name.pop_back();
+    }
+    std::lock_guard<std::mutex> lock(module_mutex);
+    module_log_levels.set(name) = value;
+    log_generation++;
+}
+
+/**
+ * Replaces all module log levels with the given comma-separated list of
+ * <module>=<level> pairs. An empty string clears all module log levels.
+ */
+void set_module_log_levels(const Str &spec) {
+    Map<Str, LogLevel> levels;
+    Str::size_type start = 0;
+    while (start < spec.size()) {
+        auto end = spec.find(',', start);
+        if (end == Str::npos) {
+            end = spec.size();
+        }
+        auto pair = trim(spec.substr(start, end - start));
+        start = end + 1;
+        if (pair.empty()) {
+            continue;
+        }
+        auto eq = pair.find('=');
+        if (eq == Str::npos) {
+            throw Exception("expected <module>=<level> in module log level list, but found \"" + pair + "\"");
+        }
+        auto module = trim(pair.substr(0, eq));
+        while (!module.empty() && module.back() == '/') {
+            module.pop_back();
+        }
+        levels.set(module) = log_level_from_string(trim(pair.substr(eq + 1)));
+    }
+    std::lock_guard<std::mutex> lock(module_mutex);
+    module_log_levels = std::move(levels);
+    log_generation++;
+}
+
+/**
+ * Sets whether log lines are written asynchronously by a background thread
+ * (the default) or synchronously by the thread that logs them, flushing after
+ * every line. The latter is slower, but keeps the log in sync with output
+ * written to std::cout or std::cerr by other means.
+ */
+void set_log_async(Bool async) {
+    Backend::get().set_async(async);
+}
+
+/**
+ * Writes a line to the log, either to std::cout or to std::cerr. The line
+ * should not include the line terminator.
+ */
+void write_line(Str &&line, Bool error) {
+    Backend::get().write({std::move(line), error});
+}
+
+/**
+ * Blocks until all lines written to the log so far have been written to and
+ * flushed from their streams.
+ */
+void flush() {
+    Backend::get().flush();
 }
 
 } // namespace logger
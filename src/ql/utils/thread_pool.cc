@@ -0,0 +1,144 @@
+/** \file
+ * Provides a minimal work-stealing thread pool for running independent tasks
+ * in parallel.
+ */
+
+#include "ql/utils/thread_pool.h"
+
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ql {
+namespace utils {
+
+/**
+ * Returns the number of threads that "auto" thread count options should
+ * resolve to, i.e. the amount of hardware concurrency, or 1 if this cannot be
+ * determined.
+ */
+UInt get_default_num_threads() {
+    auto num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) {
+        return 1;
+    }
+    return num_threads;
+}
+
+namespace {
+
+/**
+ * Per-worker task queue. The owning worker pops from the front, thieves pop
+ * from the back.
+ */
+struct WorkQueue {
+    std::mutex mutex;
+    std::deque<UInt> tasks;
+
+    /**
+     * Pops the next task for the owner of this queue. Returns false if the
+     * queue is empty.
+     */
+    Bool pop_front(UInt &task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) {
+            return false;
+        }
+        task = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+
+    /**
+     * Steals a task from the back of this queue. Returns false if the queue
+     * is empty.
+     */
+    Bool pop_back(UInt &task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) {
+            return false;
+        }
+        task = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+
+};
+
+} // anonymous namespace
+
+/**
+ * Runs task(i) for all i in [0, num_tasks) using at most num_threads threads.
+ * See header for details.
+ */
+void parallel_for(
+    UInt num_tasks,
+    UInt num_threads,
+    const std::function<void(UInt)> &task
+) {
+
+    // Run sequentially if parallelism can't help.
+    num_threads = min(num_threads, num_tasks);
+    if (num_threads <= 1) {
+        for (UInt i = 0; i < num_tasks; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    // Distribute the tasks over the workers in contiguous ranges.
+    std::deque<WorkQueue> queues(num_threads);
+    for (UInt w = 0; w < num_threads; w++) {
+        UInt first = num_tasks * w / num_threads;
+        UInt last = num_tasks * (w + 1) / num_threads;
+        for (UInt i = first; i < last; i++) {
+            queues[w].tasks.push_back(i);
+        }
+    }
+
+    // Exceptions are stored per task, so we can rethrow the one with the
+    // lowest index afterwards.
+    std::vector<std::exception_ptr> exceptions(num_tasks);
+
+    auto worker = [&queues, &exceptions, &task, num_threads](UInt self) {
+        while (true) {
+            UInt index;
+            Bool found = queues[self].pop_front(index);
+            for (UInt offset = 1; !found && offset < num_threads; offset++) {
+                found = queues[(self + offset) % num_threads].pop_back(index);
+            }
+            if (!found) {
+                return;
+            }
+            try {
+                task(index);
+            } catch (...) {
+                exceptions[index] = std::current_exception();
+            }
+        }
+    };
+
+    // Spawn the helper threads, and let the calling thread act as worker 0.
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (UInt w = 1; w < num_threads; w++) {
+        threads.emplace_back(worker, w);
+    }
+    worker(0);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // Rethrow the first exception, if any.
+    for (const auto &exception : exceptions) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+}
+
+} // namespace utils
+} // namespace ql
@@ -0,0 +1,137 @@
+#include "ql/com/ana/interaction_matrix.h"
+#include "ql/ir/compat/compat.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/ops.h"
+
+#include <gtest/gtest.h>
+
+using namespace ql;
+using com::ana::SparseInteractionMatrix;
+
+static void expect_entry(
+    const SparseInteractionMatrix::Entry &entry,
+    utils::UInt first,
+    utils::UInt second,
+    utils::UInt count
+) {
+    EXPECT_EQ(entry.first, first);
+    EXPECT_EQ(entry.second, second);
+    EXPECT_EQ(entry.count, count);
+}
+
+TEST(ql_com_ana_interaction_matrix, csr_contents) {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    auto program = utils::make<ir::compat::Program>("test_prog", plat, 7, 32, 10);
+    auto kernel = utils::make<ir::compat::Kernel>("kernel", plat, 7, 32, 10);
+    kernel->cz(2, 3);
+    kernel->cnot(0, 1);
+    kernel->x(0);
+    kernel->cnot(1, 0);
+    kernel->cnot(0, 1);
+    program->add(kernel);
+    auto ir = ir::convert_old_to_new(program);
+
+    auto matrix = SparseInteractionMatrix::from_block(ir, ir->program->blocks[0]);
+    EXPECT_EQ(matrix.get_num_qubits(), 7);
+    EXPECT_EQ(matrix.get_num_nonzero(), 3);
+
+    // The entries are in row-major order regardless of program order.
+    auto entries = matrix.get_entries();
+    ASSERT_EQ(entries.size(), 3);
+    expect_entry(entries[0], 0, 1, 2);
+    expect_entry(entries[1], 1, 0, 1);
+    expect_entry(entries[2], 2, 3, 1);
+
+    EXPECT_EQ(matrix.get_directed(0, 1), 2);
+    EXPECT_EQ(matrix.get_directed(3, 2), 0);
+    EXPECT_EQ(matrix.get(0, 1), 3);
+    EXPECT_EQ(matrix.get(1, 0), 3);
+    EXPECT_EQ(matrix.get(4, 5), 0);
+    EXPECT_EQ(matrix.get(0, 100), 0);
+    EXPECT_EQ(matrix.get_string(), "q0 q1 2\nq1 q0 1\nq2 q3 1\n");
+}
+
+TEST(ql_com_ana_interaction_matrix, parallel_equals_serial) {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    auto program = utils::make<ir::compat::Program>("test_prog", plat, 7, 32, 10);
+    for (utils::UInt k = 0; k < 16; k++) {
+        auto kernel = utils::make<ir::compat::Kernel>("kernel_" + utils::to_string(k), plat, 7, 32, 10);
+        for (utils::UInt i = 0; i < 20; i++) {
+            auto a = (k * 3 + i * 5) % 7;
+            auto b = (a + 1 + (k + i) % 6) % 7;
+            kernel->cnot(a, b);
+        }
+        program->add(kernel);
+    }
+    auto ir = ir::convert_old_to_new(program);
+
+    // Merge the per-block matrices serially as the reference.
+    SparseInteractionMatrix expected{ir::get_num_qubits(ir->platform)};
+    for (const auto &block : ir->program->blocks) {
+        expected.merge(SparseInteractionMatrix::from_block(ir, block));
+    }
+    auto expected_entries = expected.get_entries();
+    ASSERT_FALSE(expected_entries.empty());
+
+    for (utils::UInt num_threads : {1, 2, 4, 8}) {
+        auto entries = SparseInteractionMatrix::from_program(ir, num_threads).get_entries();
+        ASSERT_EQ(entries.size(), expected_entries.size());
+        for (utils::UInt i = 0; i < entries.size(); i++) {
+            expect_entry(
+                entries[i],
+                expected_entries[i].first,
+                expected_entries[i].second,
+                expected_entries[i].count
+            );
+        }
+    }
+}
+
+TEST(ql_com_ana_interaction_matrix, template_operands) {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    auto ir = ir::convert_old_to_new(plat);
+    auto qubit_type = ir::find_type(ir, "qubit");
+
+    // Add a two-qubit instruction that is specialized for q2 only, and one
+    // that is specialized for both q4 and q5.
+    auto add_type = [&](const utils::Str &name, const utils::Vec<utils::UInt> &qubits) {
+        auto insn = utils::make<ir::InstructionType>();
+        insn->name = name;
+        insn->cqasm_name = name;
+        insn->operand_types.emplace(prim::OperandMode::UPDATE, qubit_type);
+        insn->operand_types.emplace(prim::OperandMode::UPDATE, qubit_type);
+        insn->duration = 20;
+        utils::Any<ir::Expression> template_operands;
+        for (auto q : qubits) {
+            template_operands.add(ir::make_qubit_ref(ir->platform, q));
+        }
+        ir::add_instruction_type(ir, insn, template_operands);
+    };
+    add_type("halfgate", {2});
+    add_type("pairgate", {4, 5});
+
+    auto make_insn = [&](const utils::Str &name, utils::UInt a, utils::UInt b) {
+        utils::Any<ir::Expression> operands;
+        operands.add(ir::make_qubit_ref(ir->platform, a));
+        operands.add(ir::make_qubit_ref(ir->platform, b));
+        return ir::make_instruction(ir->platform, name, operands);
+    };
+    auto block = utils::make<ir::Block>();
+    block->statements.add(make_insn("halfgate", 2, 0));
+    block->statements.add(make_insn("pairgate", 4, 5));
+    block->statements.add(make_insn("pairgate", 4, 5));
+
+    // Make sure the operands actually ended up in the instruction types.
+    auto pairgate = block->statements[1]->as_custom_instruction();
+    ASSERT_NE(pairgate, nullptr);
+    EXPECT_TRUE(pairgate->operands.empty());
+    auto halfgate = block->statements[0]->as_custom_instruction();
+    ASSERT_NE(halfgate, nullptr);
+    EXPECT_EQ(halfgate->operands.size(), 1);
+
+    auto matrix = SparseInteractionMatrix::from_block(ir, block.as<ir::BlockBase>());
+    auto entries = matrix.get_entries();
+    ASSERT_EQ(entries.size(), 2);
+    expect_entry(entries[0], 2, 0, 1);
+    expect_entry(entries[1], 4, 5, 2);
+}
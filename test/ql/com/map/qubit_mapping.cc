@@ -0,0 +1,86 @@
+#include "ql/com/map/qubit_mapping.h"
+
+#include <gtest/gtest.h>
+
+
+namespace ql::com::map {
+
+// Checks that the forward and backward maps are each other's inverse.
+static void expect_consistent(const QubitMapping &victim, utils::UInt num_qubits) {
+    for (utils::UInt virt = 0; virt < num_qubits; virt++) {
+        auto real = victim[virt];
+        if (real != UNDEFINED_QUBIT) {
+            EXPECT_EQ(victim.get_virtual(real), virt);
+        }
+    }
+    for (utils::UInt real = 0; real < num_qubits; real++) {
+        auto virt = victim.get_virtual(real);
+        if (virt != UNDEFINED_QUBIT) {
+            EXPECT_EQ(victim[virt], real);
+        }
+    }
+}
+
+TEST(ql_com_map, qubit_mapping__one_to_one) {
+    QubitMapping victim(4, true, QubitState::LIVE);
+
+    for (utils::UInt q = 0; q < 4; q++) {
+        EXPECT_EQ(victim[q], q);
+        EXPECT_EQ(victim.get_virtual(q), q);
+        EXPECT_EQ(victim.get_state(q), QubitState::LIVE);
+    }
+
+    victim.swap(0, 3);
+    EXPECT_EQ(victim[0], 3);
+    EXPECT_EQ(victim[3], 0);
+    EXPECT_EQ(victim.get_virtual(0), 3);
+    EXPECT_EQ(victim.get_virtual(3), 0);
+    expect_consistent(victim, 4);
+}
+
+TEST(ql_com_map, qubit_mapping__swap_with_free_qubit) {
+    QubitMapping victim(3, false, QubitState::NONE);
+
+    auto r0 = victim.allocate(0);
+    auto r1 = victim.allocate(1);
+    EXPECT_NE(r0, r1);
+    victim.set_state(r0, QubitState::LIVE);
+    expect_consistent(victim, 3);
+
+    // Exactly one real qubit is left unmapped.
+    utils::UInt free_real = 0;
+    while (free_real == r0 || free_real == r1) {
+        free_real++;
+    }
+    EXPECT_EQ(victim.get_virtual(free_real), UNDEFINED_QUBIT);
+
+    // Move virtual qubit 0 into the free real qubit; its old location should
+    // become the free one, and its state should move along.
+    victim.swap(r0, free_real);
+    EXPECT_EQ(victim[0], free_real);
+    EXPECT_EQ(victim.get_virtual(r0), UNDEFINED_QUBIT);
+    EXPECT_EQ(victim.get_state(free_real), QubitState::LIVE);
+    EXPECT_EQ(victim.get_state(r0), QubitState::NONE);
+    expect_consistent(victim, 3);
+
+    // The only remaining allocation must use the freed qubit.
+    EXPECT_EQ(victim.allocate(2), r0);
+    expect_consistent(victim, 3);
+}
+
+TEST(ql_com_map, qubit_mapping__snapshot_restore) {
+    QubitMapping victim(5, true, QubitState::INITIALIZED);
+    QubitMapping snapshot = victim;
+
+    victim.swap(1, 2);
+    victim.set_state(4, QubitState::LIVE);
+    EXPECT_EQ(victim[1], 2);
+
+    victim.restore(snapshot);
+    EXPECT_EQ(victim.get_virt_to_real(), snapshot.get_virt_to_real());
+    EXPECT_EQ(victim.get_real_to_virt(), snapshot.get_real_to_virt());
+    EXPECT_EQ(victim.get_state(), snapshot.get_state());
+    expect_consistent(victim, 5);
+}
+
+} // namespace ql::com::map
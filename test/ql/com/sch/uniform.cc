@@ -0,0 +1,166 @@
+#include "ql/com/sch/uniform.h"
+
+#include "ql/ir/ops.h"
+#include "ql/ir/describe.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/cqasm/read.h"
+#include "ql/pmgr/manager.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+
+namespace ql::com::sch {
+
+class UniformTest : public ::testing::Test {
+protected:
+
+    // A long dependency chain on q0 next to a bunch of independent gates, so
+    // the critical path heuristic crams all the independent gates into the
+    // first (ASAP) or last (ALAP) cycle.
+    static constexpr const char *SKEWED = R"(
+x q[0]
+y q[0]
+h q[0]
+cz q[0], q[2]
+x q[0]
+y q[0]
+h q[0]
+z q[0]
+x q[1]
+y q[3]
+h q[4]
+x q[5]
+y q[6]
+z q[2]
+)";
+
+    static ir::Ref read(const utils::Str &circuit) {
+        auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+        auto ir = ir::convert_old_to_new(plat);
+        ir::cqasm::read(ir, "version 1.2\n" + circuit);
+        return ir;
+    }
+
+    static void schedule(
+        const ir::Ref &ir,
+        const utils::Str &target,
+        const utils::Str &heuristic,
+        utils::Bool resource_constraints
+    ) {
+        pmgr::Manager manager;
+        manager.append_pass("sch.ListSchedule", "scheduler", {
+            {"scheduler_target", target},
+            {"scheduler_heuristic", heuristic},
+            {"resource_constraints", resource_constraints ? "yes" : "no"}
+        });
+        manager.compile(ir);
+    }
+
+    // Returns the statements that operate on each qubit, in order.
+    static utils::Vec<utils::Vec<utils::Str>> get_qubit_order(const ir::Ref &ir) {
+        utils::Vec<utils::Vec<utils::Str>> order(ir->platform->qubits->shape[0]);
+        for (const auto &stmt : ir->program->blocks[0]->statements) {
+            for (const auto &op : ir::get_operands(stmt.as<ir::Instruction>())) {
+                auto ref = op->as_reference();
+                if (ref && ref->target == ir->platform->qubits) {
+                    order[ref->indices[0]->as_int_literal()->value].push_back(ir::describe(stmt));
+                }
+            }
+        }
+        return order;
+    }
+
+    // Checks that the schedule respects the dependencies, i.e. that statements
+    // operating on the same qubit are kept in order and don't overlap.
+    static void check_dependencies(const ir::Ref &ir, const utils::Vec<utils::Vec<utils::Str>> &expected) {
+        const auto &statements = ir->program->blocks[0]->statements;
+        utils::Vec<utils::Int> busy_until(ir->platform->qubits->shape[0], 0);
+        for (utils::UInt i = 0; i < statements.size(); i++) {
+            const auto &stmt = statements[i];
+            if (i > 0) {
+                ASSERT_GE(stmt->cycle, statements[i - 1]->cycle);
+            }
+            for (const auto &op : ir::get_operands(stmt.as<ir::Instruction>())) {
+                auto ref = op->as_reference();
+                if (ref && ref->target == ir->platform->qubits) {
+                    auto &busy = busy_until[ref->indices[0]->as_int_literal()->value];
+                    EXPECT_GE(stmt->cycle, busy) << ir::describe(stmt);
+                    busy = stmt->cycle + (utils::Int)ir::get_duration_of_statement(stmt);
+                }
+            }
+        }
+        EXPECT_EQ(get_qubit_order(ir), expected);
+    }
+
+    // Checks that the schedule respects the resource constraints, by replaying
+    // it on a fresh resource state.
+    static void check_resources(const ir::Ref &ir) {
+        rmgr::CRef resources = *ir->platform->resources;
+        auto state = resources->build(rmgr::Direction::UNDEFINED);
+        for (const auto &stmt : ir->program->blocks[0]->statements) {
+            EXPECT_TRUE(state.available(stmt->cycle, stmt)) << ir::describe(stmt);
+            state.reserve(stmt->cycle, stmt);
+        }
+    }
+
+    // Returns the number of statements starting in each cycle.
+    static utils::Vec<utils::UInt> get_bundle_sizes(const ir::Ref &ir) {
+        const auto &block = ir->program->blocks[0];
+        utils::Vec<utils::UInt> sizes(ir::get_duration_of_block(block), 0);
+        for (const auto &stmt : block->statements) {
+            sizes.at(stmt->cycle)++;
+        }
+        return sizes;
+    }
+
+};
+
+TEST_F(UniformTest, no_longer_than_critical_path) {
+
+    // Without resource constraints, the critical path heuristic yields the
+    // critical path length, which the uniform scheduler must not exceed.
+    for (const auto &target : {"asap", "alap"}) {
+        auto reference = read(SKEWED);
+        schedule(reference, target, "critical_path", false);
+        auto uniform = read(SKEWED);
+        schedule(uniform, target, "uniform", false);
+        EXPECT_LE(
+            ir::get_duration_of_block(uniform->program->blocks[0]),
+            ir::get_duration_of_block(reference->program->blocks[0])
+        ) << target;
+    }
+}
+
+TEST_F(UniformTest, respects_dependencies_and_resources) {
+    for (const auto &target : {"asap", "alap"}) {
+        for (auto resource_constraints : {false, true}) {
+            auto ir = read(SKEWED);
+            auto expected = get_qubit_order(ir);
+            schedule(ir, target, "uniform", resource_constraints);
+            check_dependencies(ir, expected);
+            if (resource_constraints) {
+                check_resources(ir);
+            }
+        }
+    }
+}
+
+TEST_F(UniformTest, more_uniform_than_critical_path) {
+    for (const auto &target : {"asap", "alap"}) {
+        auto reference = read(SKEWED);
+        schedule(reference, target, "critical_path", false);
+        auto uniform = read(SKEWED);
+        schedule(uniform, target, "uniform", false);
+
+        // The independent gates are spread out over the cycles in which the
+        // chain on q0 is running, instead of all being put in the same bundle.
+        auto reference_sizes = get_bundle_sizes(reference);
+        auto uniform_sizes = get_bundle_sizes(uniform);
+        auto reference_max = *std::max_element(reference_sizes.begin(), reference_sizes.end());
+        auto uniform_max = *std::max_element(uniform_sizes.begin(), uniform_sizes.end());
+        EXPECT_GE(reference_max, 6) << target;
+        EXPECT_LE(uniform_max, 3) << target;
+    }
+}
+
+} // namespace ql::com::sch
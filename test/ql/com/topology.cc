@@ -231,4 +231,36 @@ TEST(ql_com, topology__get_min_hops__multi_core__all_qubits_are_comm_qubits) {
     EXPECT_EQ(victim.get_min_hops(0, 4), 2);  // comm to comm
 }
 
+TEST(ql_com, topology__get_path_neighbors__multi_core) {
+    std::uint64_t qubit_count = 12;
+    auto victim = Topology(qubit_count, ql::utils::Json(R"({
+        "number_of_cores": 3, "connectivity": "full", "form": "irregular", "comm_qubits_per_core": 2
+    })"_json));
+
+    // Cores are 0-3, 4-7 and 8-11, of which the first two qubits are comm qubits
+    EXPECT_EQ(victim.get_neighbors(2), (Topology::Neighbors{0, 1, 3}));
+    EXPECT_EQ(victim.get_neighbors(0), (Topology::Neighbors{1, 2, 3, 4, 5, 8, 9}));
+
+    EXPECT_EQ(victim.get_path_neighbors(2, 6, 3), (Topology::Neighbors{0, 1}));  // normal to normal
+    EXPECT_EQ(victim.get_path_neighbors(0, 6, 2), (Topology::Neighbors{4, 5}));  // comm to normal
+    EXPECT_EQ(victim.get_path_neighbors(0, 4, 2), (Topology::Neighbors{1, 4, 5}));  // comm to comm
+    EXPECT_EQ(victim.get_path_neighbors(0, 4, 1), (Topology::Neighbors{4}));
+    EXPECT_EQ(victim.get_path_neighbors(2, 3, 1), (Topology::Neighbors{3}));
+
+    // Apart from detours via other cores, this matches filtering the neighbors
+    for (Topology::Qubit src = 0; src < qubit_count; src++) {
+        for (Topology::Qubit tgt = 0; tgt < qubit_count; tgt++) {
+            if (src == tgt) continue;
+            auto budget = victim.get_min_hops(src, tgt);
+            Topology::Neighbors expected;
+            for (auto n : victim.get_neighbors(src)) {
+                auto core = victim.get_core_index(n);
+                if (core != victim.get_core_index(src) && core != victim.get_core_index(tgt)) continue;
+                if (victim.get_distance(n, tgt) < budget) expected.push_back(n);
+            }
+            EXPECT_EQ(victim.get_path_neighbors(src, tgt, budget), expected);
+        }
+    }
+}
+
 }  // namespace ql::com
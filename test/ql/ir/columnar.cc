@@ -0,0 +1,57 @@
+#include "ql/ir/columnar.h"
+
+#include "ql/ir/compat/gate.h"
+#include "ql/ir/cqasm/read.h"
+#include "ql/ir/old_to_new.h"
+
+#include <gtest/gtest.h>
+
+using namespace ql;
+
+TEST(ql_ir_columnar, export_block) {
+    utils::Str circuit = R"(
+version 1.2
+
+pragma @ql.platform("cc_light.s7")
+
+{ x q[0] | y q[1] }
+cnot q[0], q[1]
+cond (b[2]) x q[3]
+)";
+    auto platform = ir::cqasm::read_platform(circuit);
+    auto ir = ir::convert_old_to_new(platform);
+    ir::cqasm::read(ir, circuit);
+    auto columnar = ir::export_columnar(ir, ir->program->blocks[0]);
+
+    ASSERT_EQ(columnar.num_instructions, 4u);
+    EXPECT_EQ(columnar.num_qubit_operands, 2u);
+    EXPECT_EQ(columnar.data.size(), columnar.get_offset(ir::Column::CONDITION_BITS) + 2 * 4);
+
+    auto insn = columnar.get_column(ir::Column::INSTRUCTION);
+    EXPECT_EQ(columnar.instruction_names[insn[0]], "x");
+    EXPECT_EQ(columnar.instruction_names[insn[1]], "y");
+    EXPECT_EQ(columnar.instruction_names[insn[2]], "cnot");
+    EXPECT_EQ(columnar.instruction_names[insn[3]], "x");
+
+    auto cycle = columnar.get_column(ir::Column::CYCLE);
+    EXPECT_EQ(cycle[0], cycle[1]);
+    EXPECT_LT(cycle[1], cycle[2]);
+    EXPECT_LT(cycle[2], cycle[3]);
+
+    auto qubits = columnar.get_column(ir::Column::QUBITS);
+    EXPECT_EQ(qubits[0], 0);
+    EXPECT_EQ(qubits[1], -1);
+    EXPECT_EQ(qubits[4], 0);
+    EXPECT_EQ(qubits[5], 1);
+    EXPECT_EQ(qubits[6], 3);
+
+    auto condition = columnar.get_column(ir::Column::CONDITION);
+    auto condition_bits = columnar.get_column(ir::Column::CONDITION_BITS);
+    EXPECT_EQ(condition[0], (utils::Int)ir::compat::ConditionType::ALWAYS);
+    EXPECT_EQ(condition[3], (utils::Int)ir::compat::ConditionType::UNARY);
+    EXPECT_EQ(condition_bits[6], 2);
+    EXPECT_EQ(condition_bits[7], -1);
+
+    EXPECT_EQ(ir::parse_column("condition_bits"), ir::Column::CONDITION_BITS);
+    EXPECT_THROW(ir::parse_column("foo"), utils::Exception);
+}
@@ -0,0 +1,65 @@
+#include "ql/ir/consistency.h"
+
+#include "ql/ir/cqasm/read.h"
+#include "ql/ir/old_to_new.h"
+
+#include <gtest/gtest.h>
+
+using namespace ql;
+
+TEST(ql_ir_consistency, identifiers) {
+    EXPECT_TRUE(ir::is_identifier("x"));
+    EXPECT_TRUE(ir::is_identifier("_q0"));
+    EXPECT_TRUE(ir::is_identifier("Measure_Z2"));
+    EXPECT_FALSE(ir::is_identifier(""));
+    EXPECT_FALSE(ir::is_identifier("0q"));
+    EXPECT_FALSE(ir::is_identifier("a-b"));
+    EXPECT_FALSE(ir::is_identifier("a b"));
+    EXPECT_FALSE(ir::is_identifier("\xc3\xa9"));
+}
+
+TEST(ql_ir_consistency, levels) {
+    utils::Str circuit = R"(
+version 1.2
+
+pragma @ql.platform("cc_light.s7")
+
+.first
+x q[0]
+cnot q[0], q[1]
+
+.second
+measure q[1]
+cond (b[1]) x q[0]
+
+.third
+y q[2]
+)";
+    auto platform = ir::cqasm::read_platform(circuit);
+    auto ir = ir::convert_old_to_new(platform);
+    ir::cqasm::read(ir, circuit);
+    ASSERT_GE(ir->program->blocks.size(), 2u);
+
+    for (auto threads : {1, 4}) {
+        EXPECT_NO_THROW(ir::check_consistency(ir, ir::ConsistencyCheckLevel::FULL, threads));
+    }
+
+    // A duplicate block name is a structural error.
+    auto name = ir->program->blocks[1]->name;
+    ir->program->blocks[1]->name = ir->program->blocks[0]->name;
+    EXPECT_NO_THROW(ir::check_consistency(ir, ir::ConsistencyCheckLevel::NONE));
+    EXPECT_THROW(ir::check_consistency(ir, ir::ConsistencyCheckLevel::STRUCTURAL), utils::Exception);
+    EXPECT_THROW(ir::check_consistency(ir, ir::ConsistencyCheckLevel::FULL, 4), utils::Exception);
+    ir->program->blocks[1]->name = name;
+
+    // An out-of-range qubit index is only found by the full check.
+    ir::CustomInstructionRef insn;
+    for (const auto &statement : ir->program->blocks[0]->statements) {
+        insn = statement.as<ir::CustomInstruction>();
+        if (!insn.empty()) break;
+    }
+    ASSERT_FALSE(insn.empty());
+    insn->operands[0].as<ir::Reference>()->indices[0].as<ir::IntLiteral>()->value = 100;
+    EXPECT_NO_THROW(ir::check_consistency(ir, ir::ConsistencyCheckLevel::STRUCTURAL));
+    EXPECT_THROW(ir::check_consistency(ir, ir::ConsistencyCheckLevel::FULL, 4), utils::Exception);
+}
@@ -0,0 +1,76 @@
+#include "ql/ir/ops.h"
+
+#include <atomic>
+#include "ql/ir/old_to_new.h"
+#include "ql/utils/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+using namespace ql;
+
+static utils::Any<ir::Expression> qubit_pair(
+    const ir::PlatformRef &platform,
+    utils::UInt a,
+    utils::UInt b
+) {
+    utils::Any<ir::Expression> operands;
+    operands.add(ir::make_qubit_ref(platform, a));
+    operands.add(ir::make_qubit_ref(platform, b));
+    return operands;
+}
+
+TEST(ql_ir_ops, concurrent_specialization) {
+    auto plat = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+    auto ir = ir::convert_old_to_new(plat);
+    auto num_qubits = ir::get_num_qubits(ir->platform);
+    auto qubit_type = ir::find_type(ir, "qubit");
+
+    // Add a two-qubit instruction with a specialization for every qubit pair,
+    // each with a unique duration.
+    for (utils::UInt a = 0; a < num_qubits; a++) {
+        for (utils::UInt b = 0; b < num_qubits; b++) {
+            if (a == b) continue;
+            auto insn = utils::make<ir::InstructionType>();
+            insn->name = "pairgate";
+            insn->cqasm_name = "pairgate";
+            insn->operand_types.emplace(prim::OperandMode::UPDATE, qubit_type);
+            insn->operand_types.emplace(prim::OperandMode::UPDATE, qubit_type);
+            insn->duration = a * num_qubits + b + 1;
+            ir::add_instruction_type(ir, insn, qubit_pair(ir->platform, a, b));
+        }
+    }
+
+    // Build and respecialize instructions from many threads at once, like the
+    // router and the block-parallel passes do. The platform must only be read
+    // while doing so (run this under ThreadSanitizer to check that).
+    std::atomic<utils::UInt> failures{0};
+    utils::parallel_for(10000, 8, [&](utils::UInt i) {
+        auto a = i % num_qubits;
+        auto b = (i / num_qubits + 1 + a) % num_qubits;
+        if (a == b) return;
+        auto insn = ir::make_instruction(
+            ir->platform, "pairgate", qubit_pair(ir->platform, a, b)
+        );
+        auto custom = insn->as_custom_instruction();
+        if (
+            !custom ||
+            !custom->operands.empty() ||
+            custom->instruction_type->duration != a * num_qubits + b + 1
+        ) {
+            failures++;
+            return;
+        }
+        ir::generalize_instruction(insn);
+        if (custom->operands.size() != 2) {
+            failures++;
+        }
+        ir::specialize_instruction(insn);
+        if (
+            !custom->operands.empty() ||
+            custom->instruction_type->duration != a * num_qubits + b + 1
+        ) {
+            failures++;
+        }
+    });
+    EXPECT_EQ(failures.load(), 0);
+}
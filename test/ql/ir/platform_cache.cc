@@ -0,0 +1,109 @@
+#include "ql/ir/platform_cache.h"
+
+#include "ql/ir/old_to_new.h"
+#include "ql/com/options.h"
+#include "ql/utils/filesystem.h"
+
+#include <cstdio>
+#include <gtest/gtest.h>
+
+using namespace ql;
+
+namespace {
+
+/**
+ * Appends whether each instruction type (including specializations) has the
+ * PrototypeInferred annotation to the given string.
+ */
+void get_inferred(const utils::Any<ir::InstructionType> &types, utils::Str &inferred) {
+    for (const auto &type : types) {
+        inferred += type->has_annotation<ir::PrototypeInferred>() ? '1' : '0';
+        get_inferred(type->specializations, inferred);
+    }
+}
+
+} // anonymous namespace
+
+class PlatformCacheTest : public ::testing::Test {
+protected:
+
+    void SetUp() override {
+        com::options::global["platform_cache_dir"] = "test_output/platform_cache";
+        old = ir::compat::Platform::build("test_plat", utils::Str("cc_light"));
+        key = ir::get_platform_cache_key(old);
+        filename = ir::get_platform_cache_file(key);
+        std::remove(filename.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(filename.c_str());
+        com::options::global["platform_cache_dir"].reset();
+    }
+
+    ir::compat::PlatformRef old;
+    utils::Str key;
+    utils::Str filename;
+
+};
+
+TEST_F(PlatformCacheTest, round_trip) {
+    ASSERT_FALSE(filename.empty());
+    EXPECT_TRUE(ir::load_platform_cache(filename, key, old).empty());
+
+    // Convert without the cache for reference.
+    com::options::global["platform_cache_dir"].reset();
+    auto reference = ir::convert_old_to_new(old);
+    com::options::global["platform_cache_dir"] = "test_output/platform_cache";
+
+    ir::store_platform_cache(filename, key, reference);
+    ASSERT_TRUE(utils::is_file(filename));
+
+    // The reference must not have been modified by storing it.
+    EXPECT_TRUE(reference->platform->topology.is_populated());
+    EXPECT_TRUE(reference->platform->architecture.is_populated());
+
+    auto loaded = ir::load_platform_cache(filename, key, old);
+    ASSERT_FALSE(loaded.empty());
+    EXPECT_EQ(
+        utils::tree::base::serialize(loaded),
+        utils::tree::base::serialize(reference)
+    );
+    utils::Str loaded_inferred, reference_inferred;
+    get_inferred(loaded->platform->instructions, loaded_inferred);
+    get_inferred(reference->platform->instructions, reference_inferred);
+    EXPECT_EQ(loaded_inferred, reference_inferred);
+
+    // The topology and architecture are shared with the old platform rather
+    // than reconstructed.
+    EXPECT_EQ(&*loaded->platform->topology, &*old->topology);
+    EXPECT_EQ(loaded->platform->architecture, reference->platform->architecture);
+    EXPECT_TRUE(loaded->platform->resources.is_populated());
+    EXPECT_EQ(loaded->platform->name, old->name);
+
+    // convert_old_to_new() now hits the cache.
+    auto cached = ir::convert_old_to_new(old);
+    EXPECT_EQ(
+        utils::tree::base::serialize(cached),
+        utils::tree::base::serialize(reference)
+    );
+}
+
+TEST_F(PlatformCacheTest, stale_key) {
+    com::options::global["platform_cache_dir"].reset();
+    auto reference = ir::convert_old_to_new(old);
+    com::options::global["platform_cache_dir"] = "test_output/platform_cache";
+
+    // A file stored under a different key, e.g. due to a hash collision or a
+    // different OpenQL version, must not be loaded.
+    ir::store_platform_cache(filename, key + "stale", reference);
+    ASSERT_TRUE(utils::is_file(filename));
+    EXPECT_TRUE(ir::load_platform_cache(filename, key, old).empty());
+
+    // convert_old_to_new() falls back to conversion and replaces the file.
+    auto converted = ir::convert_old_to_new(old);
+    EXPECT_EQ(
+        utils::tree::base::serialize(converted),
+        utils::tree::base::serialize(reference)
+    );
+    EXPECT_FALSE(ir::load_platform_cache(filename, key, old).empty());
+}
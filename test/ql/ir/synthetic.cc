@@ -0,0 +1,74 @@
+#include "ql/ir/synthetic.h"
+
+#include <gtest/gtest.h>
+
+using namespace ql::ir::synthetic;
+
+TEST(ql_ir_synthetic, random_is_deterministic) {
+    Parameters parameters;
+    parameters.num_qubits = 8;
+    parameters.num_gates = 100;
+    parameters.seed = 42;
+    auto first = generate_cqasm(parameters);
+    EXPECT_EQ(first, generate_cqasm(parameters));
+    parameters.seed = 43;
+    EXPECT_NE(first, generate_cqasm(parameters));
+}
+
+/**
+ * Sink that only counts what it receives.
+ */
+struct CountingSink : public Sink {
+    ql::utils::UInt num_qubits = 0;
+    ql::utils::UInt max_loop_depth = 0;
+    ql::utils::UInt num_operations = 0;
+    ql::utils::UInt num_conditional = 0;
+    ql::utils::UInt num_loops = 0;
+
+    void begin(ql::utils::UInt nq, ql::utils::UInt depth) override {
+        num_qubits = nq;
+        max_loop_depth = depth;
+    }
+
+    void operation(const Operation &op) override {
+        num_operations++;
+        if (op.conditional) num_conditional++;
+        for (auto q : op.qubits) {
+            EXPECT_LT(q, num_qubits);
+        }
+    }
+
+    void begin_loop(ql::utils::UInt) override {
+        num_loops++;
+    }
+
+    void end_loop() override {
+    }
+
+    void end() override {
+    }
+};
+
+TEST(ql_ir_synthetic, surface_code) {
+    Parameters parameters;
+    parameters.family = Family::SURFACE_CODE;
+    parameters.distance = 5;
+    parameters.num_rounds = 3;
+    CountingSink sink;
+    generate(parameters, sink);
+    EXPECT_EQ(sink.num_qubits, 49u);
+    EXPECT_EQ(sink.num_conditional, 3u * 24u);
+}
+
+TEST(ql_ir_synthetic, nested_loops) {
+    Parameters parameters;
+    parameters.family = Family::NESTED_LOOPS;
+    parameters.num_gates = 10;
+    parameters.loop_depth = 3;
+    CountingSink sink;
+    generate(parameters, sink);
+    EXPECT_EQ(sink.max_loop_depth, 3u);
+    EXPECT_EQ(sink.num_loops, 3u);
+    EXPECT_EQ(sink.num_operations, 40u);
+    EXPECT_NE(generate_cqasm(parameters).find("foreach (i2 = 0..9) {"), ql::utils::Str::npos);
+}
@@ -15,7 +15,10 @@ It does not test whether routing is done optimally, based on the various options
 #include "ql/com/map/qubit_mapping.h"
 #include "ql/com/map/reference_updater.h"
 #include "ql/pmgr/factory.h"
+#include "ql/pass/ana/statistics/annotations.h"
 
+#include <algorithm>
+#include <sstream>
 #include <gtest/gtest.h>
 
 
@@ -105,14 +108,17 @@ protected:
         EXPECT_TRUE(ddgs_are_equal(ir1->program->blocks[0], ir2->program->blocks[0]));
     }
 
-    static void deswapCircuit(const ir::Ref &ir) {
+    // Undoes the swaps and moves inserted by the router. r2v is the initial real-to-virtual qubit mapping
+    // used by the router; when empty, the identity mapping is assumed.
+    static void deswapCircuit(const ir::Ref &ir, std::vector<utils::UInt> r2v = {}) {
         ASSERT_EQ(ir->program->blocks.size(), 1);
 
-        std::vector<utils::UInt> r2v;
-        r2v.resize(ir::get_num_qubits(ir->platform));
+        if (r2v.empty()) {
+            r2v.resize(ir::get_num_qubits(ir->platform));
 
-        for (utils::UInt i = 0; i < r2v.size(); ++i) {
-            r2v[i] = i;
+            for (utils::UInt i = 0; i < r2v.size(); ++i) {
+                r2v[i] = i;
+            }
         }
 
         utils::Any<ir::Statement> output_statements;
@@ -166,6 +172,54 @@ protected:
         checkCircuitSemanticsAreTheSame(input, output);
     }
 
+    // Returns the initial real-to-virtual qubit mapping that the router started from, as reported in the
+    // statistics of the block. This differs from the identity when the router chooses its own initial
+    // placement, as the sabre heuristic does.
+    static std::vector<utils::UInt> getInitialRealToVirtual(const ir::Ref &ir) {
+        const std::string prefix = "virt2real map before mapper:";
+        std::vector<utils::UInt> r2v(ir::get_num_qubits(ir->platform), com::map::UNDEFINED_QUBIT);
+        for (const auto &line: pass::ana::statistics::AdditionalStats::pop(ir->program->blocks[0])) {
+            if (line.rfind(prefix, 0) != 0) {
+                continue;
+            }
+            std::istringstream ss(line.substr(prefix.size()));
+            char separator;
+            ss >> separator;
+            utils::UInt real;
+            for (utils::UInt virt = 0; ss >> real; ++virt) {
+                if (real < r2v.size()) {
+                    r2v[real] = virt;
+                }
+                ss >> separator;
+            }
+            return r2v;
+        }
+        ADD_FAILURE() << "initial mapping not found in router statistics";
+        return r2v;
+    }
+
+    // Like runAndCheck(), but also handles an initial placement chosen by the router, and checks that all
+    // two-qubit gates in the output are nearest-neighbor.
+    void runAndCheckWithPlacement(const std::string &circuit) {
+        auto input = read(circuit);
+
+        auto output = run(input);
+
+        for (const auto &st: output->program->blocks[0]->statements) {
+            auto custom_instr = st.as<ir::CustomInstruction>();
+            ASSERT_FALSE(custom_instr.empty());
+            ir::OperandsHelper ops(output->platform, *custom_instr);
+            if (ops.numberOfQubitOperands() == 2) {
+                auto qops = ops.get2QGateOperands();
+                EXPECT_EQ(output->platform->topology->get_distance(qops.first, qops.second), 1);
+            }
+        }
+
+        deswapCircuit(output, getInitialRealToVirtual(output));
+
+        checkCircuitSemanticsAreTheSame(input, output);
+    }
+
     ir::Ref read(const std::string &circuit) {
         auto platform = ir::cqasm::read_platform(circuit);
         auto input = ir::convert_old_to_new(platform);
@@ -330,6 +384,19 @@ TEST_F(MapLotOfCzsOnS7Test, min_extend_route_heuristic) {
 }
 
 
+TEST_F(MapLotOfCzsOnS7Test, sabre_route_heuristic) {
+    set_option("route_heuristic", "sabre");
+    runAndCheckWithPlacement(circuit.str());
+}
+
+
+TEST_F(MapLotOfCzsOnS7Test, portfolio) {
+    set_option("portfolio", "route_heuristic=minextend; lookahead_mode=all; seed=7, tie_break_method=random");
+    set_option("portfolio_threads", "2");
+    runAndCheck(circuit.str());
+}
+
+
 class MapLotOfCnotsOnS17Test : public MapTest {
 protected:
     std::stringstream circuit{};
@@ -372,6 +439,59 @@ TEST_F(MapLotOfCnotsOnS17Test, min_extend_route_heuristic) {
 }
 
 
+TEST_F(MapLotOfCnotsOnS17Test, sabre_route_heuristic) {
+    set_option("route_heuristic", "sabre");
+    runAndCheckWithPlacement(circuit.str());
+}
+
+
+TEST_F(MapLotOfCnotsOnS17Test, sabre_route_heuristic_no_lookahead) {
+    set_option("route_heuristic", "sabre");
+    set_option("lookahead_mode", "no");
+    runAndCheckWithPlacement(circuit.str());
+}
+
+
+TEST_F(MapLotOfCnotsOnS17Test, sabre_route_heuristic_random_tie_break) {
+    set_option("route_heuristic", "sabre");
+    set_option("tie_break_method", "random");
+    runAndCheckWithPlacement(circuit.str());
+}
+
+
+TEST_F(MapLotOfCnotsOnS17Test, windowed_routing) {
+    set_option("routing_window_size", "5");
+
+    auto input = read(circuit.str());
+    auto output = run(input);
+
+    utils::UInt num_swaps = 0;
+    for (const auto &st: output->program->blocks[0]->statements) {
+        auto custom_instr = st.as<ir::CustomInstruction>();
+        ASSERT_FALSE(custom_instr.empty());
+        if (custom_instr->instruction_type->name == "swap" || custom_instr->instruction_type->name == "move") {
+            num_swaps++;
+        }
+    }
+    EXPECT_GT(num_swaps, 0);
+
+    auto stats = pass::ana::statistics::AdditionalStats::pop(output->program);
+    auto expected = "Total no. of swaps added by router pass: " + utils::to_string(num_swaps);
+    EXPECT_NE(std::find(stats.begin(), stats.end(), expected), stats.end());
+
+    deswapCircuit(output);
+    checkCircuitSemanticsAreTheSame(input, output);
+}
+
+
+TEST_F(MapLotOfCnotsOnS17Test, portfolio_depth_objective) {
+    set_option("portfolio", "route_heuristic=minextend;route_heuristic=sabre,sabre_layout_iterations=0");
+    set_option("portfolio_objective", "depth");
+    set_option("portfolio_threads", "auto");
+    runAndCheck(circuit.str());
+}
+
+
 // TEST_CASE_FIXTURE(MapTest, "Criticality") {
 //     auto circuit = R"(
 // version 1.2
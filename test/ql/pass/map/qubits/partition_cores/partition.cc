@@ -0,0 +1,122 @@
+#include "ql/pass/map/qubits/partition_cores/detail/partition.h"
+
+#include <algorithm>
+#include <random>
+#include <gtest/gtest.h>
+
+namespace ql::pass::map::qubits::partition_cores::detail {
+
+using namespace utils;
+
+class PartitionTest : public ::testing::Test {
+protected:
+
+    void check_balanced(const Vec<UInt> &parts, UInt num_parts, UInt capacity) {
+        Vec<UInt> loads(num_parts, 0);
+        for (auto part : parts) {
+            ASSERT_LT(part, num_parts);
+            loads[part]++;
+        }
+        for (auto load : loads) {
+            EXPECT_LE(load, capacity);
+        }
+    }
+
+};
+
+TEST_F(PartitionTest, TwoCliques) {
+    Graph graph(8);
+    for (UInt a = 0; a < 4; a++) {
+        for (UInt b = a + 1; b < 4; b++) {
+            graph.add_edge(a * 2, b * 2, 1.0);
+            graph.add_edge(a * 2 + 1, b * 2 + 1, 1.0);
+        }
+    }
+    graph.add_edge(0, 1, 0.5);
+    auto parts = partition(graph, 2, 4);
+    check_balanced(parts, 2, 4);
+    EXPECT_EQ(get_cut(graph, parts), 0.5);
+
+    auto qubits = assign_qubits(graph, parts, 2, 4, 1);
+    Vec<Bool> used(8, false);
+    for (auto qubit : qubits) {
+        ASSERT_LT(qubit, 8);
+        EXPECT_FALSE(used[qubit]);
+        used[qubit] = true;
+    }
+
+    // The qubits connected across the cut go to the communication qubits.
+    EXPECT_EQ(qubits[0] % 4, 0);
+    EXPECT_EQ(qubits[1] % 4, 0);
+}
+
+TEST_F(PartitionTest, PlantedPartition) {
+    const UInt num_parts = 8;
+    const UInt capacity = 64;
+    const UInt n = num_parts * capacity;
+
+    // Scramble which vertices belong to which planted cluster.
+    std::mt19937 rng(42);
+    Vec<UInt> cluster(n);
+    for (UInt v = 0; v < n; v++) {
+        cluster[v] = v % num_parts;
+    }
+    std::shuffle(cluster.begin(), cluster.end(), rng);
+
+    // Dense interaction within clusters, sparse between them.
+    Graph graph(n);
+    Real planted_cut = 0.0;
+    std::uniform_int_distribution<UInt> vertex(0, n - 1);
+    for (UInt i = 0; i < 20 * n; i++) {
+        auto a = vertex(rng);
+        auto b = vertex(rng);
+        if (a == b) continue;
+        if (cluster[a] == cluster[b] || i % 20 == 0) {
+            graph.add_edge(a, b, 1.0);
+            if (cluster[a] != cluster[b]) {
+                planted_cut += 1.0;
+            }
+        }
+    }
+
+    auto parts = partition(graph, num_parts, capacity);
+    check_balanced(parts, num_parts, capacity);
+    EXPECT_LE(get_cut(graph, parts), planted_cut * 1.1);
+}
+
+TEST_F(PartitionTest, ManyBoundaryVertices) {
+    const UInt num_parts = 8;
+    const UInt capacity = 128;
+    const UInt n = num_parts * capacity;
+
+    // A random graph with all parts full has hundreds of boundary vertices,
+    // so refinement passes can stop before all overload is resolved.
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<UInt> vertex(0, n - 1);
+    Graph graph(n);
+    for (UInt i = 0; i < 4 * n; i++) {
+        graph.add_edge(vertex(rng), vertex(rng), 1.0 + (Real)(i % 3));
+    }
+
+    // Without any refinement passes, only the forced rebalancing step removes
+    // the overload.
+    for (UInt max_passes : {0, 1, 8}) {
+        Options options;
+        options.max_passes = max_passes;
+        auto parts = partition(graph, num_parts, capacity, options);
+        check_balanced(parts, num_parts, capacity);
+
+        UInt boundary = 0;
+        for (UInt v = 0; v < n; v++) {
+            for (const auto &edge : graph.edges[v]) {
+                if (parts[edge.first] != parts[v]) {
+                    boundary++;
+                    break;
+                }
+            }
+        }
+        EXPECT_GT(boundary, 100);
+    }
+}
+
+} // namespace ql::pass::map::qubits::partition_cores::detail
@@ -0,0 +1,149 @@
+#include "ql/pass/opt/cancel/cancel.h"
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include "../helpers.h"
+
+namespace ql::pass::opt::cancel {
+
+class CancelTest : public ::testing::Test {
+protected:
+
+    static ir::Ref read(const utils::Str &circuit) {
+        return test::read_circuit(ir::compat::Platform::build("test_plat", utils::Str("none")), circuit);
+    }
+
+    static void run(const ir::Ref &ir) {
+        test::run_pass(ir, "opt.Cancel");
+    }
+
+    // Returns the angle operand of the given rotation statement.
+    static utils::Real get_angle(const ir::Ref &ir, utils::UInt index) {
+        const auto &stmt = ir->program->blocks[0]->statements[index];
+        auto operands = ir::get_operands(stmt.as<ir::Instruction>());
+        return operands.back()->as_real_literal()->value;
+    }
+
+};
+
+TEST_F(CancelTest, cz_commutes_with_rz) {
+    auto ir = read(R"(
+cz q[0], q[1]
+rz q[0], 0.5
+cz q[1], q[0]
+)");
+    run(ir);
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"rz q0"}));
+}
+
+TEST_F(CancelTest, nested_pairs) {
+    auto ir = read(R"(
+h q[0]
+x q[0]
+x q[0]
+h q[0]
+x q[1]
+)");
+    run(ir);
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"x q1"}));
+}
+
+TEST_F(CancelTest, inverse_pairs) {
+    auto ir = read(R"(
+s q[0]
+sdag q[0]
+sdag q[1]
+s q[1]
+s q[2]
+s q[2]
+)");
+    run(ir);
+
+    // s;s is a z gate, not the identity.
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"s q2", "s q2"}));
+}
+
+TEST_F(CancelTest, rotations) {
+    auto ir = read(R"(
+rz q[0], 0.5
+rz q[0], 0.25
+rx q[1], 3.14159265358979323846
+rx q[1], 3.14159265358979323846
+)");
+    run(ir);
+
+    // The merged rotation takes the place of the first one, and rotations
+    // that add up to a multiple of 2pi disappear.
+    ASSERT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"rz q0"}));
+    EXPECT_NEAR(get_angle(ir, 0), 0.75, 1.0e-12);
+
+    // Merged angles are normalized.
+    ir = read(R"(
+rz q[0], 3.0
+rz q[0], 3.5
+)");
+    run(ir);
+    ASSERT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"rz q0"}));
+    EXPECT_NEAR(get_angle(ir, 0), 6.5 - 2 * utils::PI, 1.0e-12);
+}
+
+TEST_F(CancelTest, non_commuting) {
+    auto ir = read(R"(
+x q[0]
+h q[0]
+x q[0]
+z q[1]
+x q[1]
+z q[1]
+cz q[2], q[3]
+x q[2]
+cz q[2], q[3]
+)");
+    run(ir);
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({
+        "x q0", "h q0", "x q0",
+        "z q1", "x q1", "z q1",
+        "cz q2 q3", "x q2", "cz q2 q3"
+    }));
+}
+
+TEST_F(CancelTest, conditional) {
+    auto ir = read(R"(
+cond (b[1]) x q[0]
+cond (b[1]) x q[0]
+x q[2]
+cond (b[1]) x q[2]
+)");
+    run(ir);
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({
+        "x q0 (cond)", "x q0 (cond)", "x q2", "x q2 (cond)"
+    }));
+}
+
+TEST_F(CancelTest, sub_blocks) {
+    auto ir = read(R"(
+x q[0]
+if (b[1]) {
+    h q[0]
+    h q[0]
+}
+x q[0]
+y q[2]
+if (b[1]) {
+    h q[0]
+}
+y q[2]
+)");
+    run(ir);
+
+    // The gates in the if statement are cancelled within their own block, but
+    // the x gates around it can't cancel, because the if statement depends on
+    // q0 as it was before cancellation. The y gates commute with everything in
+    // between them.
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"x q0", "if", "x q0", "if"}));
+    auto if_else = ir->program->blocks[0]->statements[1]->as_if_else();
+    ASSERT_NE(if_else, nullptr);
+    EXPECT_TRUE(test::describe_gates(ir, if_else->branches[0]->body).empty());
+}
+
+} // namespace ql::pass::opt::cancel
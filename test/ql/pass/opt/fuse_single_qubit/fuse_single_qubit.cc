@@ -0,0 +1,214 @@
+#include "ql/pass/opt/fuse_single_qubit/fuse_single_qubit.h"
+
+#include "ql/utils/json.h"
+
+#include <gtest/gtest.h>
+#include "../helpers.h"
+
+namespace ql::pass::opt::fuse_single_qubit {
+
+class FuseSingleQubitTest : public ::testing::Test {
+protected:
+
+    // Returns a platform configuration with the given single-qubit gates
+    // (name, duration in ns, optional unitary in JSON form) and a cz.
+    static utils::Str make_platform(const utils::Vec<std::tuple<utils::Str, utils::UInt, utils::Str>> &gates) {
+        utils::StrStrm ss;
+        ss << R"({
+            "eqasm_compiler": "none",
+            "hardware_settings": {
+                "qubit_number": 3,
+                "cycle_time": 20
+            },
+            "instructions": {
+                "cz": {
+                    "prototype": ["Z:qubit", "Z:qubit"],
+                    "duration": 40
+                })";
+        for (const auto &gate : gates) {
+            ss << R"(,
+                ")" << std::get<0>(gate) << R"(": {
+                    "prototype": ["U:qubit"],
+                    "duration": )" << std::get<1>(gate);
+            if (!std::get<2>(gate).empty()) {
+                ss << R"(,
+                    "unitary": )" << std::get<2>(gate);
+            }
+            ss << R"(
+                })";
+        }
+        ss << R"(
+            }
+        })";
+        return ss.str();
+    }
+
+    static utils::Str default_platform() {
+        return make_platform({
+            {"x", 20, ""},
+            {"y", 20, ""},
+            {"z", 20, ""},
+            {"h", 20, ""},
+            {"s", 20, ""}
+        });
+    }
+
+    static ir::Ref read(const utils::Str &circuit, const utils::Str &platform = default_platform()) {
+        return test::read_circuit(
+            ir::compat::Platform::build("test_plat", utils::parse_json(platform)),
+            circuit
+        );
+    }
+
+    static void run(const ir::Ref &ir) {
+        test::run_pass(ir, "opt.FuseSingleQubitGates");
+    }
+
+};
+
+TEST_F(FuseSingleQubitTest, fuses_run) {
+    auto ir = read(R"(
+h q[0]
+z q[0]
+h q[0]
+)");
+    run(ir);
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"x q0"}));
+}
+
+TEST_F(FuseSingleQubitTest, runs_interleave_across_qubits) {
+    auto ir = read(R"(
+h q[0]
+x q[1]
+h q[0]
+)");
+    run(ir);
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"x q1"}));
+}
+
+TEST_F(FuseSingleQubitTest, runs_split_at_non_fusable) {
+    auto ir = read(R"(
+h q[0]
+cz q[0], q[1]
+h q[0]
+h q[2]
+h q[2]
+)");
+    run(ir);
+
+    // The cz ends the run on q0, but not the one on q2.
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"h q0", "cz q0 q1", "h q0"}));
+}
+
+TEST_F(FuseSingleQubitTest, runs_split_at_conditional) {
+    auto ir = read(R"(
+h q[0]
+cond (b[1]) x q[0]
+h q[0]
+h q[1]
+cond (b[1]) x q[2]
+h q[1]
+)");
+    run(ir);
+
+    // Conditional gates are never fused, and they end the runs on both their
+    // operands and the qubits associated with their condition bits.
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({
+        "h q0", "x q0 (cond)", "h q0", "h q1", "x q2 (cond)", "h q1"
+    }));
+}
+
+TEST_F(FuseSingleQubitTest, duration_rule) {
+
+    // x;y is z up to global phase, which is shorter, so it is accepted.
+    auto ir = read(R"(
+x q[0]
+y q[0]
+)");
+    run(ir);
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"z q0"}));
+
+    // h;s can't be done with a single native gate; a different sequence of
+    // two gates with the same total duration is no improvement.
+    ir = read(R"(
+h q[0]
+s q[0]
+)");
+    run(ir);
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"h q0", "s q0"}));
+
+    // When the only equivalent single gate is slower than the run, the run is
+    // kept as well.
+    ir = read(R"(
+x q[0]
+y q[0]
+)", make_platform({{"x", 20, ""}, {"y", 20, ""}, {"z", 60, ""}}));
+    run(ir);
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"x q0", "y q0"}));
+}
+
+TEST_F(FuseSingleQubitTest, unitary_key) {
+
+    // "flip" is unknown by name, but its unitary says it's an X gate, so it
+    // cancels against x.
+    auto platform = make_platform({
+        {"x", 20, ""},
+        {"h", 20, ""},
+        {"flip", 20, "[[0, 0], [1, 0], [1, 0], [0, 0]]"}
+    });
+    auto ir = read(R"(
+flip q[0]
+x q[0]
+h q[1]
+)", platform);
+    run(ir);
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"h q1"}));
+
+    // Without the unitary key, it is not fusable.
+    ir = read(R"(
+flip q[0]
+x q[0]
+)", make_platform({{"x", 20, ""}, {"flip", 20, ""}}));
+    run(ir);
+    EXPECT_EQ(test::describe_gates(ir), utils::Vec<utils::Str>({"flip q0", "x q0"}));
+}
+
+TEST_F(FuseSingleQubitTest, invalid_unitary) {
+    for (const auto &unitary : {
+        "[[1, 0], [1, 0], [0, 0], [1, 0]]",     // not unitary
+        "[[1, 0], [0, 0], [0, 0]]",             // wrong size
+        "[[1, 0], [0, 0], [0, 0], [1]]",        // wrong element shape
+        "[[1, 0], [0, 0], [0, 0], [\"1\", 0]]", // not a number
+        "\"identity\""                          // not an array
+    }) {
+        auto ir = read("x q[0]\n", make_platform({{"x", 20, ""}, {"bad", 20, unitary}}));
+        try {
+            run(ir);
+            ADD_FAILURE() << "no error for unitary " << unitary;
+        } catch (utils::Exception &e) {
+            EXPECT_NE(utils::Str(e.what()).find("invalid unitary for instruction bad"), utils::Str::npos) << e.what();
+        }
+    }
+}
+
+TEST_F(FuseSingleQubitTest, cycles_invalidated) {
+    auto ir = read(R"(
+h q[0]
+h q[0]
+)");
+    ir->program->blocks[0]->set_annotation<ir::KernelCyclesValid>({true});
+    run(ir);
+    EXPECT_TRUE(test::describe_gates(ir).empty());
+    EXPECT_FALSE(ir->program->blocks[0]->has_annotation<ir::KernelCyclesValid>());
+
+    // Blocks that aren't changed keep their schedule.
+    ir = read(R"(
+h q[0]
+s q[0]
+)");
+    ir->program->blocks[0]->set_annotation<ir::KernelCyclesValid>({true});
+    run(ir);
+    EXPECT_TRUE(ir->program->blocks[0]->has_annotation<ir::KernelCyclesValid>());
+}
+
+} // namespace ql::pass::opt::fuse_single_qubit
@@ -0,0 +1,81 @@
+#include "ql/pass/opt/fuse_single_qubit/detail/synthesis.h"
+
+#include <random>
+#include <gtest/gtest.h>
+
+namespace ql::pass::opt::fuse_single_qubit::detail {
+
+using namespace utils;
+
+class SynthesisTest : public ::testing::Test {
+protected:
+
+    Vec<NativeGate> make_natives(const Vec<Pair<Str, UInt>> &gates) {
+        Vec<NativeGate> natives;
+        for (const auto &it : gates) {
+            NativeGate gate;
+            EXPECT_TRUE(get_default_semantics(it.first, gate));
+            gate.duration = it.second;
+            natives.push_back(gate);
+        }
+        return natives;
+    }
+
+    void check_universal(const Vec<NativeGate> &natives) {
+        Synthesizer synthesizer(natives, 16);
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<Real> angle(-PI, PI);
+        for (UInt i = 0; i < 100; i++) {
+            auto u = Matrix::rotation(Axis::Z, angle(rng))
+                   * Matrix::rotation(Axis::Y, angle(rng))
+                   * Matrix::rotation(Axis::X, angle(rng));
+            Sequence seq;
+            ASSERT_TRUE(synthesizer.synthesize(u, seq));
+            EXPECT_TRUE(synthesizer.get_matrix(seq).equivalent(u));
+            EXPECT_LE(seq.size(), 5);
+        }
+    }
+
+};
+
+TEST_F(SynthesisTest, EulerAnglePairs) {
+    check_universal(make_natives({{"rz", 1}, {"ry", 1}}));
+    check_universal(make_natives({{"rx", 1}, {"rz", 1}}));
+    check_universal(make_natives({{"ry", 1}, {"rx", 1}}));
+}
+
+TEST_F(SynthesisTest, VirtualRzWithQuarterTurns) {
+    check_universal(make_natives({{"rz", 0}, {"x90", 1}, {"xm90", 1}}));
+    check_universal(make_natives({{"rz", 0}, {"x90", 1}}));
+    check_universal(make_natives({{"rx", 1}, {"ym90", 1}}));
+}
+
+TEST_F(SynthesisTest, FixedProducts) {
+    auto natives = make_natives({{"x", 1}, {"y", 1}, {"h", 1}, {"s", 1}, {"sdag", 1}});
+    Synthesizer synthesizer(natives, 16);
+    Sequence seq;
+
+    // H*X*H = Z up to phase, which can be made from two S gates.
+    auto u = natives[2].matrix * natives[0].matrix * natives[2].matrix;
+    ASSERT_TRUE(synthesizer.synthesize(u, seq));
+    EXPECT_EQ(seq.size(), 2);
+    EXPECT_TRUE(synthesizer.get_matrix(seq).equivalent(u));
+
+    // S*Sdag is the identity.
+    u = natives[3].matrix * natives[4].matrix;
+    ASSERT_TRUE(synthesizer.synthesize(u, seq));
+    EXPECT_TRUE(seq.empty());
+
+    // T is not in the group generated by these gates.
+    EXPECT_FALSE(synthesizer.synthesize(Matrix::rotation(Axis::Z, PI / 4), seq));
+}
+
+TEST_F(SynthesisTest, PrefersShorterDuration) {
+    auto natives = make_natives({{"rz", 0}, {"rx", 4}, {"x90", 1}, {"xm90", 1}});
+    Synthesizer synthesizer(natives, 16);
+    Sequence seq;
+    ASSERT_TRUE(synthesizer.synthesize(Matrix::rotation(Axis::X, 0.3), seq));
+    EXPECT_EQ(synthesizer.get_duration(seq), 2);
+}
+
+} // namespace ql::pass::opt::fuse_single_qubit::detail
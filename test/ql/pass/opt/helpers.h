@@ -0,0 +1,76 @@
+/** \file
+ * Helpers shared by the tests of the optimization passes.
+ */
+
+#pragma once
+
+#include "ql/utils/str.h"
+#include "ql/utils/vec.h"
+#include "ql/ir/ir.h"
+#include "ql/ir/ops.h"
+#include "ql/ir/old_to_new.h"
+#include "ql/ir/cqasm/read.h"
+#include "ql/pmgr/manager.h"
+
+namespace ql::pass::opt::test {
+
+/**
+ * Builds the IR for the given platform and reads the given cQASM 1.2 circuit
+ * into it. The version header is added automatically.
+ */
+inline ir::Ref read_circuit(const ir::compat::PlatformRef &platform, const utils::Str &circuit) {
+    auto ir = ir::convert_old_to_new(platform);
+    ir::cqasm::read(ir, "version 1.2\n" + circuit);
+    return ir;
+}
+
+/**
+ * Runs a single pass of the given type on the given IR.
+ */
+inline void run_pass(const ir::Ref &ir, const utils::Str &type) {
+    pmgr::Manager manager;
+    manager.append_pass(type);
+    manager.compile(ir);
+}
+
+/**
+ * Describes the statements of the given block as "<name> q<i>...", with
+ * " (cond)" appended for conditional gates. If-else statements are described
+ * as "if", and other statements as "?".
+ */
+inline utils::Vec<utils::Str> describe_gates(const ir::Ref &ir, const ir::BlockBaseRef &block) {
+    utils::Vec<utils::Str> gates;
+    for (const auto &stmt : block->statements) {
+        if (stmt->as_if_else()) {
+            gates.push_back("if");
+            continue;
+        }
+        auto custom = stmt->as_custom_instruction();
+        if (!custom) {
+            gates.push_back("?");
+            continue;
+        }
+        utils::StrStrm ss;
+        ss << custom->instruction_type->name;
+        for (const auto &op : ir::get_operands(stmt.as<ir::Instruction>())) {
+            auto ref = op->as_reference();
+            if (ref && ref->target == ir->platform->qubits && ref->indices.size() == 1) {
+                ss << " q" << ref->indices[0]->as_int_literal()->value;
+            }
+        }
+        if (!custom->condition->as_bit_literal()) {
+            ss << " (cond)";
+        }
+        gates.push_back(ss.str());
+    }
+    return gates;
+}
+
+/**
+ * Shorthand for describe_gates() on the first block of the program.
+ */
+inline utils::Vec<utils::Str> describe_gates(const ir::Ref &ir) {
+    return describe_gates(ir, ir->program->blocks[0]);
+}
+
+} // namespace ql::pass::opt::test
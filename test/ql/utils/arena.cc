@@ -0,0 +1,48 @@
+#include "ql/utils/arena.h"
+
+#include <gtest/gtest.h>
+
+using namespace ql::utils;
+
+TEST(ql_utils, arena_scope) {
+    EXPECT_FALSE(get_current_arena());
+
+    auto outer = std::make_shared<Arena>();
+    {
+        ArenaScope outer_scope(outer);
+        EXPECT_EQ(get_current_arena(), outer.get());
+        {
+            ArenaScope inner_scope(nullptr);
+            EXPECT_FALSE(get_current_arena());
+        }
+        EXPECT_EQ(get_current_arena(), outer.get());
+    }
+    EXPECT_FALSE(get_current_arena());
+}
+
+TEST(ql_utils, arena_scope_keeps_arena_alive) {
+    std::weak_ptr<Arena> weak;
+    {
+        auto arena = std::make_shared<Arena>();
+        weak = arena;
+        ArenaScope scope(std::move(arena));
+        EXPECT_FALSE(weak.expired());
+        EXPECT_EQ(get_current_arena(), weak.lock().get());
+    }
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(ql_utils, arena_allocation) {
+    auto arena = std::make_shared<Arena>();
+    {
+        auto value = std::allocate_shared<UInt>(ArenaAllocator<UInt>(arena.get()), 42);
+        EXPECT_EQ(*value, 42u);
+        EXPECT_GE(arena->get_bytes_allocated(), sizeof(UInt));
+
+        // Objects allocated from the arena only hold a plain pointer to it,
+        // so they don't touch its reference count.
+        EXPECT_EQ(arena.use_count(), 1);
+        EXPECT_EQ(sizeof(ArenaAllocator<UInt>), sizeof(Arena*));
+    }
+    EXPECT_EQ(arena.use_count(), 1);
+}
@@ -0,0 +1,35 @@
+#include "ql/utils/filesystem.h"
+
+#include <gtest/gtest.h>
+
+using namespace ql::utils;
+
+TEST(ql_utils, output_sink) {
+    Ptr<MemoryOutputSink> memory;
+    memory.emplace();
+    Ptr<OutputSink> sink;
+    sink = memory;
+
+    auto path = Str("this/directory/should/not/be/created/out.txt");
+    {
+        WithOutputSink with_sink{sink};
+        EXPECT_TRUE(get_output_sink().has_value());
+
+        // Stored on close().
+        OutFile file(path);
+        file << "hello " << 42;
+        file.write("\n");
+        file.close();
+
+        // Stored on destruction, overwriting the previous contents.
+        OutFile(path) << "overwritten";
+        OutFile("other.txt").unwrap() << "other";
+    }
+    EXPECT_FALSE(get_output_sink().has_value());
+    EXPECT_FALSE(path_exists("this"));
+
+    auto files = memory->get_files();
+    ASSERT_EQ(files.size(), 2u);
+    EXPECT_EQ(files.at(path), "overwritten");
+    EXPECT_EQ(files.at("other.txt"), "other");
+}
@@ -0,0 +1,51 @@
+#include "ql/utils/logger.h"
+
+#include <sstream>
+#include <gtest/gtest.h>
+
+using namespace ql::utils;
+
+TEST(ql_utils, logger_module) {
+    EXPECT_EQ(logger::get_module("/home/x/OpenQL/src/ql/pass/map/qubits/map/detail/mapper.cc"), "pass/map/qubits/map/detail/mapper");
+    EXPECT_EQ(logger::get_module("C:\\OpenQL\\include\\ql\\com\\sch\\scheduler.h"), "com/sch/scheduler");
+    EXPECT_EQ(logger::get_module("ql/utils/logger.cc"), "utils/logger");
+}
+
+TEST(ql_utils, logger_levels) {
+    logger::set_log_level("LOG_WARNING");
+    EXPECT_FALSE(QL_IS_LOG_DEBUG);
+
+    // This file is module utils/logger.
+    logger::set_module_log_level("utils", "LOG_DEBUG");
+    EXPECT_TRUE(QL_IS_LOG_DEBUG);
+    logger::set_module_log_levels("utils=LOG_DEBUG, utils/logger=LOG_INFO");
+    EXPECT_FALSE(QL_IS_LOG_DEBUG);
+    EXPECT_TRUE(QL_LOG_ENABLED(LOG_INFO));
+    logger::set_module_log_levels("utils/log=LOG_DEBUG");
+    EXPECT_FALSE(QL_LOG_ENABLED(LOG_INFO));
+    logger::set_module_log_levels("");
+    EXPECT_TRUE(QL_LOG_ENABLED(LOG_WARNING));
+
+    EXPECT_THROW(logger::set_module_log_levels("utils"), Exception);
+    logger::set_log_level("LOG_NOTHING");
+}
+
+TEST(ql_utils, logger_async) {
+    logger::set_log_level("LOG_DEBUG");
+    testing::internal::CaptureStdout();
+    for (UInt i = 0; i < 10000; i++) {
+        QL_DOUT("line " << i);
+    }
+    logger::flush();
+    auto output = testing::internal::GetCapturedStdout();
+    logger::set_log_level("LOG_NOTHING");
+
+    std::istringstream ss(output);
+    Str line;
+    UInt count = 0;
+    while (std::getline(ss, line)) {
+        EXPECT_EQ(line.substr(line.rfind(' ') + 1), to_string(count));
+        count++;
+    }
+    EXPECT_EQ(count, 10000);
+}
@@ -1,3 +1,4 @@
+import numpy as np
 import openql as ql
 import os
 import unittest
@@ -136,5 +137,88 @@ class TestKernel(unittest.TestCase):
         p.compile()
 
 
+    # Returns the cQASM that the given kernel compiles to, written to memory.
+    def _compile_to_cqasm(self, k):
+        p = ql.Program('bulk_program', platform, 2, 0, 2)
+        p.add_kernel(k)
+        c = ql.Compiler()
+        c.append_pass('io.cqasm.Report', 'report', {
+            'output_prefix': '%n',
+            'output_suffix': '.cq'
+        })
+        ql.set_option('output_to_memory', 'yes')
+        try:
+            files = c.compile(p)
+        finally:
+            ql.set_option('output_to_memory', 'no')
+        self.assertEqual(len(files), 1)
+        return list(files.values())[0]
+
+    def test_bulk_gates(self):
+        names = ['x', 'h', 'cz']
+
+        # The reference kernel, built gate by gate.
+        ref = ql.Kernel('bulk', platform, 2, 0, 2)
+        ref.gate('x', [0])
+        ref.gate('h', [1])
+        ref.gate('cz', [0, 1])
+        ref.gate('x', [1], 0, 0.0, [], 'COND_UNARY', [1])
+        expected = self._compile_to_cqasm(ref)
+        self.assertIn(b'cz q[0], q[1]', expected)
+
+        # Signed integer arrays, using -1 for padding and unconditional gates.
+        for dtype in (np.int32, np.int64):
+            k = ql.Kernel('bulk', platform, 2, 0, 2)
+            k.gates(
+                names,
+                np.array([0, 1, 2, 0], dtype=dtype),
+                np.array([[0, -1], [1, -1], [0, 1], [1, -1]], dtype=dtype),
+                None,
+                np.zeros(4),
+                np.array([-1, -1, -1, 1], dtype=dtype)
+            )
+            self.assertEqual(self._compile_to_cqasm(k), expected, str(dtype))
+
+        # Unsigned arrays can't hold -1, so the maximum value is used instead.
+        none = np.iinfo(np.uint64).max
+        k = ql.Kernel('bulk', platform, 2, 0, 2)
+        k.gates(
+            names,
+            np.array([0, 1, 2, 0], dtype=np.uint8),
+            np.array([[0, none], [1, none], [0, 1], [1, none]], dtype=np.uint64),
+            np.zeros(4, dtype=np.uint32),
+            None,
+            np.array([none, none, none, 1], dtype=np.uint64)
+        )
+        self.assertEqual(self._compile_to_cqasm(k), expected)
+
+        # Plain (flattened) lists.
+        k = ql.Kernel('bulk', platform, 2, 0, 2)
+        k.gates(names, [0, 1, 2, 0], [0, -1, 1, -1, 0, 1, 1, -1], [], [], [-1, -1, -1, 1])
+        self.assertEqual(self._compile_to_cqasm(k), expected)
+
+    def test_bulk_gates_errors(self):
+        k = ql.Kernel('bulk', platform, 2, 0, 2)
+
+        # Gate IDs must be integers.
+        with self.assertRaisesRegex(TypeError, 'unsupported array element type'):
+            k.gates(['x'], np.array([0.0]), np.array([0]))
+
+        # The operand matrix must have a row for each gate.
+        with self.assertRaisesRegex(RuntimeError, 'is not a multiple of the number of gates'):
+            k.gates(['x'], np.array([0, 0]), np.array([0, 1, 0]))
+
+        # Optional arrays must have one value per gate.
+        with self.assertRaisesRegex(RuntimeError, 'condition_bits must be empty or specify one value per gate'):
+            k.gates(['x'], np.array([0, 0]), np.array([0, 1]), None, None, np.array([-1]))
+
+        # Gate IDs must be in range of the name table.
+        with self.assertRaisesRegex(RuntimeError, 'out of range'):
+            k.gates(['x'], np.array([1]), np.array([0]))
+
+        # Nothing should have been added by the failed calls.
+        ref = ql.Kernel('bulk', platform, 2, 0, 2)
+        self.assertEqual(self._compile_to_cqasm(k), self._compile_to_cqasm(ref))
+
 if __name__ == '__main__':
     unittest.main()
@@ -1,3 +1,4 @@
+import numpy as np
 import openql as ql
 import os
 import unittest
@@ -127,5 +128,96 @@ class TestProgram(unittest.TestCase):
         p.compile()
 
 
+    def test_schedule_export(self):
+        k = ql.Kernel('export_kernel', platform, 2, 0, 2)
+        k.gate('x', [0])
+        k.gate('h', [1])
+        k.gate('cz', [0, 1])
+        k.gate('x', [0], 0, 0.0, [], 'COND_UNARY', [1])
+        p = ql.Program('export_program', platform, 2, 0, 2)
+        p.add_kernel(k)
+
+        # Nothing is available before compilation.
+        self.assertEqual(list(p.get_schedule_names()), [])
+
+        c = ql.Compiler()
+        c.append_pass('sch.ListSchedule', 'scheduler', {
+            'scheduler_target': 'asap',
+            'resource_constraints': 'no'
+        })
+        p.set_compiler(c)
+        p.compile()
+
+        names = list(p.get_schedule_names())
+        self.assertEqual(len(names), 1)
+        s = p.get_schedule(names[0])
+        self.assertEqual(s.num_instructions, 4)
+        self.assertEqual(s.num_qubit_operands, 2)
+        self.assertEqual(
+            list(s.column_names),
+            ['instruction', 'cycle', 'duration', 'qubits', 'bits', 'condition', 'condition_bits']
+        )
+
+        # Check the columns through memoryviews.
+        instruction = s.get_column('instruction')
+        self.assertEqual(instruction.format, 'q')
+        self.assertTrue(instruction.readonly)
+        self.assertEqual(instruction.shape, (4,))
+        self.assertEqual([s.instruction_names[i] for i in instruction.tolist()], ['x', 'h', 'cz', 'x'])
+        qubits = s.get_column('qubits')
+        self.assertEqual(qubits.shape, (4, 2))
+        self.assertEqual(qubits.tolist(), [[0, -1], [1, -1], [0, 1], [0, -1]])
+        self.assertEqual(s.get_column('duration').tolist(), [8, 8, 8, 8])
+        cycle = s.get_column('cycle').tolist()
+        self.assertEqual(cycle[1], cycle[0])
+        self.assertEqual(cycle[2], cycle[0] + 8)
+        self.assertEqual(cycle[3], cycle[0] + 16)
+        self.assertEqual(s.get_column('condition').tolist(), [0, 0, 0, 2])
+        condition_bits = s.get_column('condition_bits').tolist()
+        self.assertEqual(condition_bits[:3], [[-1, -1]] * 3)
+        self.assertGreaterEqual(condition_bits[3][0], 0)
+        self.assertEqual(condition_bits[3][1], -1)
+
+        # The same data through numpy, which should not copy it.
+        buf = np.asarray(s.get_buffer())
+        self.assertEqual(buf.dtype, np.int64)
+        self.assertEqual(buf.shape, (s.get_size(),))
+        self.assertFalse(buf.flags.writeable)
+        qubits_np = np.asarray(s.get_column('qubits'))
+        self.assertEqual(qubits_np.shape, (4, 2))
+        offset = s.get_column_offset('qubits')
+        np.testing.assert_array_equal(buf[offset:offset + 8].reshape(4, 2), qubits_np)
+        self.assertTrue(np.shares_memory(buf, qubits_np))
+
+        # The views keep the data alive on their own.
+        del s
+        del p
+        self.assertEqual(qubits.tolist(), [[0, -1], [1, -1], [0, 1], [0, -1]])
+        self.assertEqual(qubits_np[2].tolist(), [0, 1])
+
+    def test_schedule_export_via_compiler(self):
+        k = ql.Kernel('export_kernel', platform, 2, 0, 2)
+        k.gate('x', [0])
+        k.gate('cz', [0, 1])
+        p = ql.Program('export_program', platform, 2, 0, 2)
+        p.add_kernel(k)
+
+        c = ql.Compiler()
+        c.append_pass('sch.ListSchedule', 'scheduler', {
+            'scheduler_target': 'asap',
+            'resource_constraints': 'no'
+        })
+        c.compile(p)
+
+        # Compiling through the compiler records the result on the program
+        # just like Program.compile() does.
+        names = list(p.get_schedule_names())
+        self.assertEqual(len(names), 1)
+        s = p.get_schedule(names[0])
+        self.assertEqual(s.num_instructions, 2)
+        self.assertEqual([s.instruction_names[i] for i in s.get_column('instruction').tolist()], ['x', 'cz'])
+        cycle = s.get_column('cycle').tolist()
+        self.assertEqual(cycle[1], cycle[0] + 8)
+
 if __name__ == '__main__':
     unittest.main()
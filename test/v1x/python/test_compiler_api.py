@@ -399,6 +399,50 @@ with_timing: yes
 """.strip())
 
 
+    def test_compile_output_to_memory(self):
+        platform = ql.Platform('mem_platform', 'cc_light')
+        k = ql.Kernel('kernel', platform, 2)
+        k.gate('x', [0])
+        k.gate('cz', [0, 1])
+        p = ql.Program('mem_program', platform, 2)
+        p.add_kernel(k)
+
+        with tempfile.TemporaryDirectory() as d:
+            c = ql.Compiler()
+            c.append_pass('io.cqasm.Report', 'report', {
+                'output_prefix': os.path.join(d, '%n'),
+                'output_suffix': '.cq'
+            })
+
+            # Without the option, the files are written to disk.
+            self.assertEqual(c.compile(p), {})
+            self.assertEqual(sorted(os.listdir(d)), ['mem_program.cq'])
+            os.remove(os.path.join(d, 'mem_program.cq'))
+
+            # With the option, they are returned as bytes instead.
+            ql.set_option('output_to_memory', 'yes')
+            try:
+                files = c.compile(p)
+            finally:
+                ql.set_option('output_to_memory', 'no')
+            self.assertEqual(os.listdir(d), [])
+            self.assertIsInstance(files, dict)
+            self.assertEqual(list(files.keys()), [os.path.join(d, 'mem_program.cq')])
+            contents = files[os.path.join(d, 'mem_program.cq')]
+            self.assertIsInstance(contents, bytes)
+            self.assertIn(b'version 1.2', contents)
+            self.assertIn(b'x q[0]', contents)
+            self.assertIn(b'cz q[0], q[1]', contents)
+
+            # Program.compile() behaves the same way.
+            p.set_compiler(c)
+            ql.set_option('output_to_memory', 'yes')
+            try:
+                self.assertEqual(p.compile(), files)
+            finally:
+                ql.set_option('output_to_memory', 'no')
+            self.assertEqual(os.listdir(d), [])
+
 if __name__ == '__main__':
     # ql.set_option('log_level', 'LOG_DEBUG')
     unittest.main()